@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <benchmark/benchmark.h>
+
+#include <KaitoTokyo/Memory/AlignedAllocator.hpp>
+#include <KaitoTokyo/SelfieSegmenter/BoundingBox.hpp>
+#include <KaitoTokyo/SelfieSegmenter/SimdDispatch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace KaitoTokyo;
+using namespace KaitoTokyo::SelfieSegmenter;
+
+namespace {
+
+constexpr std::uint32_t kWidth = 256;
+constexpr std::uint32_t kHeight = 144;
+
+/**
+ * @brief Builds a 256x144 mask with a filled rectangle, or an empty mask when the rectangle is empty.
+ */
+std::vector<std::uint8_t, Memory::AlignedAllocator<std::uint8_t>> makeMask(std::uint32_t left, std::uint32_t top,
+									     std::uint32_t right, std::uint32_t bottom)
+{
+	std::vector<std::uint8_t, Memory::AlignedAllocator<std::uint8_t>> mask(
+		kWidth * kHeight, 0, Memory::AlignedAllocator<std::uint8_t>(32));
+	for (std::uint32_t y = top; y < bottom; ++y) {
+		for (std::uint32_t x = left; x < right; ++x) {
+			mask[y * kWidth + x] = 255;
+		}
+	}
+	return mask;
+}
+
+void BM_BoundingBoxCentredSubject(benchmark::State &state)
+{
+	const auto mask = makeMask(96, 24, 160, 144);
+	BoundingBox boundingBox;
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(boundingBox.calculateBoundingBoxFrom256x144(mask.data(), 127));
+	}
+
+	state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * kWidth * kHeight));
+}
+
+void BM_BoundingBoxEmptyMask(benchmark::State &state)
+{
+	// The worst case: every row has to be scanned before giving up
+	const auto mask = makeMask(0, 0, 0, 0);
+	BoundingBox boundingBox;
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(boundingBox.calculateBoundingBoxFrom256x144(mask.data(), 127));
+	}
+
+	state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * kWidth * kHeight));
+}
+
+void BM_BoundingBoxEmptyMaskTier(benchmark::State &state, const SimdKernels *kernels)
+{
+	const auto mask = makeMask(0, 0, 0, 0);
+	BoundingBox boundingBox;
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(kernels->calculateBoundingBox256x144(&boundingBox, mask.data(), 127));
+	}
+
+	state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * kWidth * kHeight));
+}
+
+[[maybe_unused]] const bool kTierBenchmarksRegistered = [] {
+	for (SimdTier tier : {SimdTier::Scalar, SimdTier::SSE41, SimdTier::AVX2, SimdTier::AVX512BW, SimdTier::NEON}) {
+		if (isSimdTierSupported(tier)) {
+			benchmark::RegisterBenchmark(
+				(std::string("BM_BoundingBoxEmptyMask/") + getSimdTierName(tier)).c_str(),
+				BM_BoundingBoxEmptyMaskTier, &getSimdKernelsForTier(tier));
+		}
+	}
+	return true;
+}();
+
+} // namespace
+
+BENCHMARK(BM_BoundingBoxCentredSubject);
+BENCHMARK(BM_BoundingBoxEmptyMask);
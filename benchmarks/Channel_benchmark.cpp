@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <benchmark/benchmark.h>
+
+#include <KaitoTokyo/Async/BoundedChannel.hpp>
+#include <KaitoTokyo/Async/Channel.hpp>
+#include <KaitoTokyo/Async/Join.hpp>
+#include <KaitoTokyo/Async/Task.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace KaitoTokyo::Async;
+
+namespace {
+
+constexpr int kMessageCount = 1 << 16;
+constexpr std::size_t kBoundedCapacity = 256;
+
+template<typename ChannelType> Task<void> receiveAll(ChannelType &channel, std::int64_t &sum)
+{
+	while (std::optional<int> value = co_await channel.receive()) {
+		sum += *value;
+	}
+}
+
+Task<void> asyncSendAll(BoundedChannel<int> &channel, int count)
+{
+	for (int i = 0; i < count; ++i) {
+		co_await channel.async_send(i);
+	}
+}
+
+/**
+ * @brief Moves kMessageCount messages from state.range(0) producer threads to one consumer thread.
+ *
+ * Each iteration gets a fresh channel from @p makeChannel, and each producer calls @p sendAll with its share.
+ */
+template<typename ChannelType, typename MakeChannel, typename SendAll>
+void runProducersAndConsumer(benchmark::State &state, MakeChannel makeChannel, SendAll sendAll)
+{
+	const int producerCount = static_cast<int>(state.range(0));
+	const int messagesPerProducer = kMessageCount / producerCount;
+
+	for (auto _ : state) {
+		ChannelType &channel = makeChannel();
+		std::int64_t sum = 0;
+		std::thread consumer([&channel, &sum] { join(receiveAll(channel, sum)); });
+
+		std::vector<std::thread> producers;
+		for (int p = 0; p < producerCount; ++p) {
+			producers.emplace_back([&channel, &sendAll, messagesPerProducer] {
+				sendAll(channel, messagesPerProducer);
+			});
+		}
+		for (std::thread &producer : producers) {
+			producer.join();
+		}
+		channel.close();
+		consumer.join();
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * producerCount * messagesPerProducer);
+}
+
+void BM_ChannelSend(benchmark::State &state)
+{
+	std::optional<Channel<int>> channel;
+	runProducersAndConsumer<Channel<int>>(
+		state, [&channel]() -> Channel<int> & { return channel.emplace(); },
+		[](Channel<int> &channel, int count) {
+			for (int i = 0; i < count; ++i) {
+				channel.send(i);
+			}
+		});
+}
+
+void BM_BoundedChannelSend(benchmark::State &state)
+{
+	// Sized to hold every message, so that send() never refuses one and the ring is compared with Channel's queue
+	// under the same non-waiting send
+	std::optional<BoundedChannel<int>> channel;
+	runProducersAndConsumer<BoundedChannel<int>>(
+		state, [&channel]() -> BoundedChannel<int> & { return channel.emplace(kMessageCount); },
+		[](BoundedChannel<int> &channel, int count) {
+			for (int i = 0; i < count; ++i) {
+				channel.send(i);
+			}
+		});
+}
+
+void BM_BoundedChannelAsyncSend(benchmark::State &state)
+{
+	// The producers suspend whenever the consumer falls kBoundedCapacity messages behind
+	std::optional<BoundedChannel<int>> channel;
+	runProducersAndConsumer<BoundedChannel<int>>(
+		state, [&channel]() -> BoundedChannel<int> & { return channel.emplace(kBoundedCapacity); },
+		[](BoundedChannel<int> &channel, int count) { join(asyncSendAll(channel, count)); });
+}
+
+} // namespace
+
+BENCHMARK(BM_ChannelSend)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK(BM_BoundedChannelSend)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK(BM_BoundedChannelAsyncSend)->Arg(1)->Arg(4)->UseRealTime();
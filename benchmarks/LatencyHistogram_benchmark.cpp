@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <benchmark/benchmark.h>
+
+#include <KaitoTokyo/Profiling/LatencyHistogram.hpp>
+
+#include <chrono>
+
+using namespace KaitoTokyo;
+
+namespace {
+
+void BM_LatencyHistogramRecord(benchmark::State &state)
+{
+	static Profiling::LatencyHistogram histogram;
+	std::chrono::nanoseconds duration(1);
+
+	for (auto _ : state) {
+		histogram.record(duration);
+		duration = std::chrono::nanoseconds((duration.count() * 7 + 13) & 0xFFFFFF);
+	}
+}
+
+void BM_ScopedLatencyTimer(benchmark::State &state)
+{
+	Profiling::LatencyHistogram histogram;
+
+	for (auto _ : state) {
+		Profiling::ScopedLatencyTimer timer(histogram);
+	}
+}
+
+void BM_LatencyHistogramSummarize(benchmark::State &state)
+{
+	Profiling::LatencyHistogram histogram;
+	for (int i = 0; i < 10000; ++i) {
+		histogram.record(std::chrono::microseconds(i));
+	}
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(histogram.snapshot().summarize());
+	}
+}
+
+} // namespace
+
+BENCHMARK(BM_LatencyHistogramRecord)->Threads(1)->Threads(4);
+BENCHMARK(BM_ScopedLatencyTimer);
+BENCHMARK(BM_LatencyHistogramSummarize);
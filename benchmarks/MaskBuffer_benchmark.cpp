@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <benchmark/benchmark.h>
+
+#include <KaitoTokyo/SelfieSegmenter/MaskBuffer.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+using namespace KaitoTokyo::SelfieSegmenter;
+
+namespace {
+
+constexpr std::size_t kMaskSize = 256 * 144;
+
+/**
+ * @brief The previous MaskBuffer: a mutex-guarded triple buffer with a type-erased writer and a single reader.
+ */
+class LegacyMaskBuffer {
+	using BlockType = std::vector<std::uint8_t, KaitoTokyo::Memory::AlignedAllocator<std::uint8_t>>;
+
+public:
+	explicit LegacyMaskBuffer(std::size_t size)
+		: buffers_{BlockType(size, 0, KaitoTokyo::Memory::AlignedAllocator<std::uint8_t>(32)),
+			   BlockType(size, 0, KaitoTokyo::Memory::AlignedAllocator<std::uint8_t>(32)),
+			   BlockType(size, 0, KaitoTokyo::Memory::AlignedAllocator<std::uint8_t>(32))}
+	{
+	}
+
+	void write(std::function<void(std::uint8_t *)> writeFunc)
+	{
+		std::lock_guard<std::mutex> lock(bufferMutex_);
+		auto &buffer = buffers_[writerIndex_];
+		writeFunc(buffer.data());
+		writerIndex_ = freshIndex_.exchange(writerIndex_);
+		hasNewFrame_.store(true, std::memory_order_release);
+	}
+
+	const std::uint8_t *read() const
+	{
+		if (hasNewFrame_.exchange(false, std::memory_order_acq_rel)) {
+			readerIndex_ = freshIndex_.exchange(readerIndex_, std::memory_order_acq_rel);
+		}
+		return buffers_[readerIndex_].data();
+	}
+
+private:
+	std::array<BlockType, 3> buffers_;
+	mutable std::size_t readerIndex_ = 0;
+	std::size_t writerIndex_ = 1;
+	mutable std::atomic<std::size_t> freshIndex_ = 2;
+	mutable std::atomic<bool> hasNewFrame_ = false;
+	mutable std::mutex bufferMutex_;
+};
+
+// A write that captures more than fits in std::function's small buffer, like the segmenter's conversion does
+struct WriteArguments {
+	const std::uint8_t *source;
+	std::size_t size;
+	std::size_t offset;
+	std::size_t stride;
+};
+
+template<typename Buffer> void publish(Buffer &maskBuffer, const WriteArguments &arguments)
+{
+	maskBuffer.write([arguments](std::uint8_t *dst) { dst[arguments.offset] = arguments.source[arguments.offset]; });
+}
+
+template<typename Buffer> void BM_Publish(benchmark::State &state)
+{
+	Buffer maskBuffer(kMaskSize);
+	std::vector<std::uint8_t> source(kMaskSize, 128);
+	const WriteArguments arguments{source.data(), kMaskSize, 0, 1};
+
+	// The write itself is a single byte so that the hand-off dominates
+	for (auto _ : state) {
+		publish(maskBuffer, arguments);
+		benchmark::DoNotOptimize(maskBuffer.read());
+	}
+}
+
+template<typename Buffer> void BM_MaskBufferWrite(benchmark::State &state)
+{
+	Buffer maskBuffer(kMaskSize);
+	std::vector<std::uint8_t> source(kMaskSize, 128);
+
+	for (auto _ : state) {
+		maskBuffer.write([&source](std::uint8_t *dst) { std::memcpy(dst, source.data(), kMaskSize); });
+	}
+
+	state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * kMaskSize));
+}
+
+template<typename Buffer> void BM_MaskBufferRead(benchmark::State &state)
+{
+	Buffer maskBuffer(kMaskSize);
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(maskBuffer.read());
+	}
+}
+
+template<typename Buffer> void BM_MaskBufferWriteThenRead(benchmark::State &state)
+{
+	Buffer maskBuffer(kMaskSize);
+	std::vector<std::uint8_t> source(kMaskSize, 128);
+	std::vector<std::uint8_t> destination(kMaskSize);
+
+	// Mirrors one inference result being published and then uploaded by the render thread
+	for (auto _ : state) {
+		maskBuffer.write([&source](std::uint8_t *dst) { std::memcpy(dst, source.data(), kMaskSize); });
+		std::memcpy(destination.data(), maskBuffer.read(), kMaskSize);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * kMaskSize * 2));
+}
+
+/**
+ * @brief Thread 0 publishes while the other threads each poll through their own reader.
+ */
+void BM_MaskBufferContended(benchmark::State &state)
+{
+	// Shared by every thread of every run, and sized for the largest thread count below
+	static MaskBuffer maskBuffer(kMaskSize, 8);
+
+	if (state.thread_index() == 0) {
+		std::vector<std::uint8_t> source(kMaskSize, 128);
+		const WriteArguments arguments{source.data(), kMaskSize, 0, 1};
+		for (auto _ : state) {
+			publish(maskBuffer, arguments);
+		}
+	} else {
+		MaskBuffer::Reader reader = maskBuffer.makeReader();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(reader.read());
+		}
+		state.counters["skipped"] = benchmark::Counter(static_cast<double>(reader.getSkippedCount()),
+								benchmark::Counter::kAvgThreads);
+	}
+}
+
+} // namespace
+
+BENCHMARK(BM_Publish<LegacyMaskBuffer>);
+BENCHMARK(BM_Publish<MaskBuffer>);
+BENCHMARK(BM_MaskBufferWrite<LegacyMaskBuffer>);
+BENCHMARK(BM_MaskBufferWrite<MaskBuffer>);
+BENCHMARK(BM_MaskBufferRead<LegacyMaskBuffer>);
+BENCHMARK(BM_MaskBufferRead<MaskBuffer>);
+BENCHMARK(BM_MaskBufferWriteThenRead<LegacyMaskBuffer>);
+BENCHMARK(BM_MaskBufferWriteThenRead<MaskBuffer>);
+BENCHMARK(BM_MaskBufferContended)->Threads(2)->Threads(4)->UseRealTime();
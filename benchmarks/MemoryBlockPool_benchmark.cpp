@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <benchmark/benchmark.h>
+
+#include <KaitoTokyo/Logger/NullLogger.hpp>
+#include <KaitoTokyo/Memory/MemoryBlockPool.hpp>
+
+#include <cstddef>
+#include <vector>
+
+using namespace KaitoTokyo;
+
+namespace {
+
+constexpr std::size_t kSegmenterInputSize = 256 * 144 * 4;
+
+void BM_MemoryBlockPoolAcquireRelease(benchmark::State &state)
+{
+	auto pool = Memory::MemoryBlockPool::create(Logger::NullLogger::instance(), kSegmenterInputSize);
+
+	for (auto _ : state) {
+		auto block = pool->acquire();
+		benchmark::DoNotOptimize(block->data());
+	}
+}
+
+void BM_MemoryBlockPoolAcquireManyThenRelease(benchmark::State &state)
+{
+	auto pool = Memory::MemoryBlockPool::create(Logger::NullLogger::instance(), kSegmenterInputSize);
+	const std::size_t heldCount = static_cast<std::size_t>(state.range(0));
+
+	std::vector<Memory::MemoryBlockPool::MemoryBlockSharedPtr> blocks;
+	blocks.reserve(heldCount);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < heldCount; ++i) {
+			blocks.push_back(pool->acquire());
+		}
+		blocks.clear();
+	}
+
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * heldCount));
+}
+
+} // namespace
+
+BENCHMARK(BM_MemoryBlockPoolAcquireRelease)->ThreadRange(1, 4);
+BENCHMARK(BM_MemoryBlockPoolAcquireManyThenRelease)->Arg(4)->Arg(32);
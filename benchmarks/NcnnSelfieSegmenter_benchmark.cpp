@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <benchmark/benchmark.h>
+
+#include <KaitoTokyo/SelfieSegmenter/NcnnModelRegistry.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnPoolAllocator.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnSelfieSegmenter.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace KaitoTokyo::SelfieSegmenter;
+
+extern "C" const unsigned char mediapipe_selfie_segmentation_landscape_int8_ncnn_bin[];
+extern "C" const unsigned int mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len;
+extern "C" const char mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text[];
+
+namespace {
+
+void BM_NcnnSelfieSegmenterProcess(benchmark::State &state)
+{
+	const int numThreads = static_cast<int>(state.range(0));
+	NcnnSelfieSegmenter selfieSegmenter(mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text,
+					    mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len,
+					    mediapipe_selfie_segmentation_landscape_int8_ncnn_bin, numThreads);
+
+	std::vector<std::uint8_t> input(selfieSegmenter.getPixelCount() * 4);
+	for (std::size_t i = 0; i < input.size(); ++i) {
+		input[i] = static_cast<std::uint8_t>(i * 31);
+	}
+
+	// The first run pays for ncnn's lazy allocations, which is not what a steady stream of frames sees
+	selfieSegmenter.process(input.data());
+
+	for (auto _ : state) {
+		selfieSegmenter.process(input.data());
+		benchmark::DoNotOptimize(selfieSegmenter.getMask());
+	}
+
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+/**
+ * @brief Runs the network with either ncnn's per-extractor local pools or a persistent NcnnPoolAllocator.
+ *
+ * Reports the median and the 99th percentile of single inferences, since allocator churn shows up as
+ * occasional slow frames rather than as a shift of the mean.
+ */
+void BM_NcnnExtractorAllocator(benchmark::State &state)
+{
+	const bool usePoolAllocator = state.range(0) != 0;
+	const auto net = NcnnModelRegistry::loadNet(mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text,
+						    mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len,
+						    mediapipe_selfie_segmentation_landscape_int8_ncnn_bin);
+	NcnnPoolAllocator poolAllocator;
+
+	ncnn::Mat input(256, 144, 3);
+	input.fill(0.5f);
+
+	std::vector<double> latencies;
+	for (auto _ : state) {
+		const auto start = std::chrono::steady_clock::now();
+		{
+			ncnn::Mat output;
+			ncnn::Extractor ex = net->create_extractor();
+			ex.set_num_threads(2);
+			if (usePoolAllocator) {
+				ex.set_blob_allocator(&poolAllocator);
+				ex.set_workspace_allocator(&poolAllocator);
+			}
+			ex.input("in0", input);
+			ex.extract("out0", output);
+		}
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		state.SetIterationTime(elapsed.count());
+		latencies.push_back(elapsed.count() * 1e3);
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	const auto percentile = [&latencies](double p) {
+		return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+	};
+	state.counters["p50_ms"] = percentile(0.50);
+	state.counters["p99_ms"] = percentile(0.99);
+	state.counters["max_ms"] = latencies.back();
+}
+
+} // namespace
+
+BENCHMARK(BM_NcnnExtractorAllocator)
+	->ArgName("pool")
+	->Arg(0)
+	->Arg(1)
+	->Iterations(500)
+	->Unit(benchmark::kMillisecond)
+	->UseManualTime();
+
+BENCHMARK(BM_NcnnSelfieSegmenterProcess)
+	->ArgName("threads")
+	->Arg(1)
+	->Arg(2)
+	->Arg(4)
+	->Arg(8)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
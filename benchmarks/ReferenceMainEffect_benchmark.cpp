@@ -0,0 +1,234 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <benchmark/benchmark.h>
+
+#include <ReferenceMainEffect.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect;
+
+namespace {
+
+constexpr std::uint32_t kSubsamplingRate = 4;
+constexpr std::uint32_t kBoxRadius = 8;
+
+std::uint32_t bitCeil(std::uint32_t x)
+{
+	std::uint32_t result = 1;
+	while (result < x) {
+		result *= 2;
+	}
+	return result;
+}
+
+Texture makeFrame(std::uint32_t width, std::uint32_t height)
+{
+	std::vector<std::uint8_t> bgrx(static_cast<std::size_t>(width) * height * 4);
+	for (std::size_t i = 0; i < bgrx.size(); ++i) {
+		bgrx[i] = static_cast<std::uint8_t>((i * 2654435761u) >> 24);
+	}
+	Texture frame(width, height, TextureFormat::BGRX);
+	frame.setImage(bgrx.data(), width * 4);
+	return frame;
+}
+
+/**
+ * @brief The textures of a RenderingContext, allocated the same way for a given frame size.
+ */
+struct Pipeline {
+	Pipeline(std::uint32_t width, std::uint32_t height, int blurSize)
+		: subWidth((width / kSubsamplingRate) & ~1u),
+		  subHeight((height / kSubsamplingRate) & ~1u),
+		  frame(makeFrame(width, height)),
+		  bgrxSource(width, height, TextureFormat::BGRX),
+		  r32fLuma(width, height, TextureFormat::R32F),
+		  r32fSubLumas{Texture(subWidth, subHeight, TextureFormat::R32F),
+			       Texture(subWidth, subHeight, TextureFormat::R32F)},
+		  r32fSubPaddedSquaredMotion(bitCeil(subWidth), bitCeil(subHeight), TextureFormat::R32F),
+		  r8SegmentationMask(256, 144, TextureFormat::R8),
+		  r32fSubGFSource(subWidth, subHeight, TextureFormat::R32F),
+		  rgba32fSubGFIntermediate(subWidth, subHeight, TextureFormat::RGBA32F),
+		  rgba32fSubGFMeans(subWidth, subHeight, TextureFormat::RGBA32F),
+		  r32fSubGFA(subWidth, subHeight, TextureFormat::R32F),
+		  r32fSubGFB(subWidth, subHeight, TextureFormat::R32F),
+		  r8GuidedFilterResult(width, height, TextureFormat::R8),
+		  r8TimeAveragedMasks{Texture(width, height, TextureFormat::R8),
+				      Texture(width, height, TextureFormat::R8)},
+		  output(width, height, TextureFormat::BGRA),
+		  blurSize(blurSize)
+	{
+		std::uint32_t reducedWidth = r32fSubPaddedSquaredMotion.getWidth();
+		std::uint32_t reducedHeight = r32fSubPaddedSquaredMotion.getHeight();
+		while (reducedWidth > 1 || reducedHeight > 1) {
+			reducedWidth = std::max(1u, (reducedWidth + 1) / 2);
+			reducedHeight = std::max(1u, (reducedHeight + 1) / 2);
+			reductionPyramid.emplace_back(reducedWidth, reducedHeight, TextureFormat::R32F);
+		}
+
+		std::uint32_t blurWidth = width;
+		std::uint32_t blurHeight = height;
+		dualKawasePyramid.emplace_back(blurWidth, blurHeight, TextureFormat::BGRX);
+		for (int i = 0; i < blurSize; ++i) {
+			blurWidth = std::max(1u, (blurWidth + 1) / 2);
+			blurHeight = std::max(1u, (blurHeight + 1) / 2);
+			dualKawasePyramid.emplace_back(blurWidth, blurHeight, TextureFormat::BGRX);
+		}
+	}
+
+	/**
+	 * @brief Runs the passes of RenderingContext::videoRender at the time-averaged filter level.
+	 */
+	void render(const ReferenceMainEffect &effect)
+	{
+		effect.drawSource(bgrxSource, frame);
+
+		effect.convertToLuma(r32fLuma, bgrxSource);
+		const Texture &lastSubLuma = r32fSubLumas[currentSubLumaIndex];
+		Texture &currentSubLuma = r32fSubLumas[1 - currentSubLumaIndex];
+		effect.resampleByNearestR8(currentSubLuma, r32fLuma);
+		effect.calculateSquaredMotion(r32fSubPaddedSquaredMotion, currentSubLuma, lastSubLuma);
+		currentSubLumaIndex = 1 - currentSubLumaIndex;
+		effect.reduce(reductionPyramid, r32fSubPaddedSquaredMotion);
+
+		if (blurSize > 0) {
+			dualKawasePyramid[0] = bgrxSource;
+			effect.dualKawaseBlur(dualKawasePyramid, blurSize);
+		}
+
+		const Texture &subLuma = r32fSubLumas[currentSubLumaIndex];
+		effect.resampleByNearestR8(r32fSubGFSource, r8SegmentationMask);
+		effect.applyGuidedFilterMeans(rgba32fSubGFMeans, subLuma, r32fSubGFSource, rgba32fSubGFIntermediate,
+					      kBoxRadius);
+		effect.calculateGuidedFilterAAndBFromMeans(r32fSubGFA, r32fSubGFB, rgba32fSubGFMeans, 1e-4f);
+		effect.finalizeGuidedFilter(r8GuidedFilterResult, r32fLuma, r32fSubGFA, r32fSubGFB);
+
+		const std::size_t nextIndex = 1 - currentTimeAveragedMaskIndex;
+		effect.timeAveragedFiltering(r8TimeAveragedMasks[nextIndex],
+					     r8TimeAveragedMasks[currentTimeAveragedMaskIndex], r8GuidedFilterResult,
+					     0.5f);
+		currentTimeAveragedMaskIndex = nextIndex;
+
+		if (blurSize > 0) {
+			effect.directDrawWithRefinedBlurredBackground(output, bgrxSource,
+								      r8TimeAveragedMasks[currentTimeAveragedMaskIndex],
+								      2.0, 0.1, 0.1, dualKawasePyramid[0]);
+		} else {
+			effect.directDrawWithRefinedMask(output, bgrxSource,
+							 r8TimeAveragedMasks[currentTimeAveragedMaskIndex], 2.0, 0.1,
+							 0.1);
+		}
+	}
+
+	const std::uint32_t subWidth;
+	const std::uint32_t subHeight;
+
+	const Texture frame;
+	Texture bgrxSource;
+	Texture r32fLuma;
+	std::vector<Texture> r32fSubLumas;
+	std::size_t currentSubLumaIndex = 0;
+	Texture r32fSubPaddedSquaredMotion;
+	std::vector<Texture> reductionPyramid;
+	Texture r8SegmentationMask;
+	Texture r32fSubGFSource;
+	Texture rgba32fSubGFIntermediate;
+	Texture rgba32fSubGFMeans;
+	Texture r32fSubGFA;
+	Texture r32fSubGFB;
+	Texture r8GuidedFilterResult;
+	std::vector<Texture> r8TimeAveragedMasks;
+	std::size_t currentTimeAveragedMaskIndex = 0;
+	std::vector<Texture> dualKawasePyramid;
+	Texture output;
+	const int blurSize;
+};
+
+void BM_ReferencePipeline(benchmark::State &state)
+{
+	const ReferenceMainEffect effect;
+	Pipeline pipeline(static_cast<std::uint32_t>(state.range(0)), static_cast<std::uint32_t>(state.range(1)),
+			  static_cast<int>(state.range(2)));
+
+	for (auto _ : state) {
+		pipeline.render(effect);
+		benchmark::DoNotOptimize(pipeline.output.data());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ReferenceBoxFilter(benchmark::State &state)
+{
+	const ReferenceMainEffect effect;
+	const std::uint32_t width = 1920 / kSubsamplingRate;
+	const std::uint32_t height = 1080 / kSubsamplingRate;
+	const Texture source(width, height, TextureFormat::R32F);
+	Texture intermediate(width, height, TextureFormat::R32F);
+	Texture target(width, height, TextureFormat::R32F);
+
+	for (auto _ : state) {
+		effect.applyBoxFilterR8KS17(target, source, intermediate);
+		benchmark::DoNotOptimize(target.data());
+	}
+}
+
+void BM_ReferenceGuidedFilterMeans(benchmark::State &state)
+{
+	const ReferenceMainEffect effect;
+	const std::uint32_t width = 1920 / kSubsamplingRate;
+	const std::uint32_t height = 1080 / kSubsamplingRate;
+	const Texture guide(width, height, TextureFormat::R32F);
+	const Texture source(width, height, TextureFormat::R32F);
+
+	if (state.range(0) == 0) {
+		Texture intermediate(width, height, TextureFormat::R32F);
+		std::vector<Texture> means(4, Texture(width, height, TextureFormat::R32F));
+		for (auto _ : state) {
+			effect.applyBoxFilterR8KS17(means[0], guide, intermediate);
+			effect.applyBoxFilterR8KS17(means[1], source, intermediate);
+			effect.applyBoxFilterWithMulR8KS17(means[2], guide, source, intermediate);
+			effect.applyBoxFilterWithSqR8KS17(means[3], guide, intermediate);
+			benchmark::DoNotOptimize(means[3].data());
+		}
+	} else {
+		Texture intermediate(width, height, TextureFormat::RGBA32F);
+		Texture means(width, height, TextureFormat::RGBA32F);
+		for (auto _ : state) {
+			effect.applyGuidedFilterMeans(means, guide, source, intermediate, kBoxRadius);
+			benchmark::DoNotOptimize(means.data());
+		}
+	}
+}
+
+void BM_ReferenceGuidedFilterMeansRadius(benchmark::State &state)
+{
+	const ReferenceMainEffect effect;
+	const std::uint32_t width = 1920 / kSubsamplingRate;
+	const std::uint32_t height = 1080 / kSubsamplingRate;
+	const Texture guide(width, height, TextureFormat::R32F);
+	const Texture source(width, height, TextureFormat::R32F);
+	Texture intermediate(width, height, TextureFormat::RGBA32F);
+	Texture means(width, height, TextureFormat::RGBA32F);
+	const auto boxRadius = static_cast<std::uint32_t>(state.range(0));
+
+	for (auto _ : state) {
+		effect.applyGuidedFilterMeans(means, guide, source, intermediate, boxRadius);
+		benchmark::DoNotOptimize(means.data());
+	}
+}
+
+} // namespace
+
+BENCHMARK(BM_ReferencePipeline)
+	->Args({1280, 720, 0})
+	->Args({1920, 1080, 0})
+	->Args({1920, 1080, 4})
+	->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReferenceBoxFilter)->Unit(benchmark::kMicrosecond);
+// 0 runs the four separate box filters and 1 the fused RGBA32F pass pair
+BENCHMARK(BM_ReferenceGuidedFilterMeans)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+// Radii above 8 switch from direct summation to running sums
+BENCHMARK(BM_ReferenceGuidedFilterMeansRadius)->Arg(5)->Arg(8)->Arg(16)->Arg(33)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <benchmark/benchmark.h>
+
+#include <KaitoTokyo/Memory/AlignedAllocator.hpp>
+#include <KaitoTokyo/SelfieSegmenter/ShapeConverter.hpp>
+#include <KaitoTokyo/SelfieSegmenter/SimdDispatch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace KaitoTokyo;
+using namespace KaitoTokyo::SelfieSegmenter;
+
+namespace {
+
+constexpr std::size_t kPixelCount = 256 * 144;
+
+// One extra element lets the unaligned variants be fed pointers offset from the 32-byte boundary
+template<typename T> using AlignedVector = std::vector<T, Memory::AlignedAllocator<T>>;
+
+struct ShapeConverterBuffers {
+	AlignedVector<std::uint8_t> bgra{AlignedVector<std::uint8_t>((kPixelCount + 1) * 4, 0,
+								     Memory::AlignedAllocator<std::uint8_t>(32))};
+	AlignedVector<float> r{AlignedVector<float>(kPixelCount + 1, 0.0f, Memory::AlignedAllocator<float>(32))};
+	AlignedVector<float> g{AlignedVector<float>(kPixelCount + 1, 0.0f, Memory::AlignedAllocator<float>(32))};
+	AlignedVector<float> b{AlignedVector<float>(kPixelCount + 1, 0.0f, Memory::AlignedAllocator<float>(32))};
+	AlignedVector<std::uint8_t> mask{
+		AlignedVector<std::uint8_t>(kPixelCount + 1, 0, Memory::AlignedAllocator<std::uint8_t>(32))};
+
+	ShapeConverterBuffers()
+	{
+		for (std::size_t i = 0; i < bgra.size(); ++i) {
+			bgra[i] = static_cast<std::uint8_t>(i * 7);
+		}
+		for (std::size_t i = 0; i < r.size(); ++i) {
+			r[i] = static_cast<float>(i % 256) / 255.0f;
+		}
+	}
+};
+
+template<auto Kernel> void BM_CopyR8BgraToFloatChw(benchmark::State &state)
+{
+	ShapeConverterBuffers buffers;
+	const std::size_t offset = static_cast<std::size_t>(state.range(0));
+
+	for (auto _ : state) {
+		Kernel(buffers.r.data() + offset, buffers.g.data() + offset, buffers.b.data() + offset,
+		       buffers.bgra.data() + offset * 4, kPixelCount);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kPixelCount));
+	state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * kPixelCount * 4));
+}
+
+template<auto Kernel> void BM_CopyFloat32ToR8(benchmark::State &state)
+{
+	ShapeConverterBuffers buffers;
+	const std::size_t offset = static_cast<std::size_t>(state.range(0));
+
+	for (auto _ : state) {
+		Kernel(buffers.mask.data() + offset, buffers.r.data() + offset, kPixelCount);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kPixelCount));
+	state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * kPixelCount * sizeof(float)));
+}
+
+void BM_CopyR8BgraToFloatChwTier(benchmark::State &state, const SimdKernels *kernels)
+{
+	ShapeConverterBuffers buffers;
+	const std::size_t offset = static_cast<std::size_t>(state.range(0));
+
+	for (auto _ : state) {
+		kernels->copyR8BgraToFloatChw(buffers.r.data() + offset, buffers.g.data() + offset,
+					      buffers.b.data() + offset, buffers.bgra.data() + offset * 4, kPixelCount);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kPixelCount));
+	state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * kPixelCount * 4));
+}
+
+void BM_CopyFloat32ToR8Tier(benchmark::State &state, const SimdKernels *kernels)
+{
+	ShapeConverterBuffers buffers;
+	const std::size_t offset = static_cast<std::size_t>(state.range(0));
+
+	for (auto _ : state) {
+		kernels->copyFloat32ToR8(buffers.mask.data() + offset, buffers.r.data() + offset, kPixelCount);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kPixelCount));
+	state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * kPixelCount * sizeof(float)));
+}
+
+// Registered at runtime so that machines without a tier simply skip it; offset 1 exercises unaligned buffers
+[[maybe_unused]] const bool kTierBenchmarksRegistered = [] {
+	for (SimdTier tier : {SimdTier::Scalar, SimdTier::SSE41, SimdTier::AVX2, SimdTier::AVX512BW, SimdTier::NEON}) {
+		if (!isSimdTierSupported(tier)) {
+			continue;
+		}
+
+		const SimdKernels *kernels = &getSimdKernelsForTier(tier);
+		const std::string tierName = getSimdTierName(tier);
+		benchmark::RegisterBenchmark(("CopyR8BgraToFloatChw/" + tierName).c_str(), BM_CopyR8BgraToFloatChwTier,
+					     kernels)
+			->Arg(0)
+			->Arg(1);
+		benchmark::RegisterBenchmark(("CopyFloat32ToR8/" + tierName).c_str(), BM_CopyFloat32ToR8Tier, kernels)
+			->Arg(0)
+			->Arg(1);
+	}
+	return true;
+}();
+
+} // namespace
+
+// The dispatchers, as called from NcnnSelfieSegmenter
+BENCHMARK(BM_CopyR8BgraToFloatChw<copy_r8_bgra_to_float_chw>)->Name("CopyR8BgraToFloatChw/Dispatch")->Arg(0);
+BENCHMARK(BM_CopyFloat32ToR8<copy_float32_to_r8>)->Name("CopyFloat32ToR8/Dispatch")->Arg(0);
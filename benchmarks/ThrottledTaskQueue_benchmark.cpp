@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <benchmark/benchmark.h>
+
+#include <KaitoTokyo/Logger/NullLogger.hpp>
+#include <KaitoTokyo/TaskQueue/ThrottledTaskQueue.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace KaitoTokyo;
+
+namespace {
+
+void BM_ThrottledTaskQueuePush(benchmark::State &state)
+{
+	const std::size_t maxQueueSize = static_cast<std::size_t>(state.range(0));
+	TaskQueue::ThrottledTaskQueue queue(Logger::NullLogger::instance(), maxQueueSize);
+	std::atomic<std::size_t> executedCount = 0;
+
+	for (auto _ : state) {
+		queue.push([&executedCount](const TaskQueue::ThrottledTaskQueue::CancellationToken &) {
+			executedCount.fetch_add(1, std::memory_order_relaxed);
+		});
+	}
+
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	queue.shutdown();
+	state.counters["ExecutedRatio"] = static_cast<double>(executedCount.load()) /
+					  static_cast<double>(state.iterations());
+}
+
+void BM_ThrottledTaskQueueKeyedPush(benchmark::State &state)
+{
+	// Producers push round-robin into a queue with one slot per producer
+	const std::size_t keyCount = static_cast<std::size_t>(state.range(0));
+	TaskQueue::ThrottledTaskQueue queue(Logger::NullLogger::instance(), keyCount);
+	std::atomic<std::size_t> executedCount = 0;
+
+	std::vector<std::string> keys;
+	for (std::size_t i = 0; i < keyCount; ++i) {
+		keys.push_back("producer" + std::to_string(i));
+	}
+
+	std::size_t keyIndex = 0;
+	for (auto _ : state) {
+		queue.push(keys[keyIndex], [&executedCount](const TaskQueue::ThrottledTaskQueue::CancellationToken &) {
+			executedCount.fetch_add(1, std::memory_order_relaxed);
+		});
+		keyIndex = keyIndex + 1 == keyCount ? 0 : keyIndex + 1;
+	}
+
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	queue.shutdown();
+	state.counters["ExecutedRatio"] = static_cast<double>(executedCount.load()) /
+					  static_cast<double>(state.iterations());
+}
+
+void BM_ThrottledTaskQueueMixedPriorityPush(benchmark::State &state)
+{
+	// One interactive task for every fifteen normal ones
+	const std::size_t maxQueueSize = static_cast<std::size_t>(state.range(0));
+	TaskQueue::ThrottledTaskQueue queue(Logger::NullLogger::instance(), maxQueueSize);
+	std::atomic<std::size_t> executedCount = 0;
+
+	std::size_t pushCount = 0;
+	for (auto _ : state) {
+		const auto priority = pushCount++ % 16 == 0 ? TaskQueue::ThrottledTaskQueue::Priority::Interactive
+							    : TaskQueue::ThrottledTaskQueue::Priority::Normal;
+		queue.push(
+			[&executedCount](const TaskQueue::ThrottledTaskQueue::CancellationToken &) {
+				executedCount.fetch_add(1, std::memory_order_relaxed);
+			},
+			priority);
+	}
+
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	queue.shutdown();
+	state.counters["ExecutedRatio"] = static_cast<double>(executedCount.load()) /
+					  static_cast<double>(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_ThrottledTaskQueuePush)->Arg(1)->Arg(16)->Arg(1024)->UseRealTime();
+BENCHMARK(BM_ThrottledTaskQueueKeyedPush)->Arg(1)->Arg(16)->Arg(256)->UseRealTime();
+BENCHMARK(BM_ThrottledTaskQueueMixedPriorityPush)->Arg(1)->Arg(16)->Arg(1024)->UseRealTime();
@@ -55,7 +55,21 @@ ncnn2table model-opt.ncnn.param model-opt.ncnn.bin imagelist.txt model.table \
 
 ncnn2int8 model-opt.ncnn.param model-opt.ncnn.bin model-int8.ncnn.param model-int8.ncnn.bin model.table
 
-ls -l model-int8.ncnn.*
+# Raw input variant: takes 0-255 RGB straight from ncnn::Mat::from_pixels, with 1/255 folded into the first conv
+python ../../fold_input_normalization.py model-opt.ncnn.param model-opt.ncnn.bin model-rawinput-opt.ncnn.bin
+
+ncnn2table model-opt.ncnn.param model-rawinput-opt.ncnn.bin imagelist.txt model-rawinput.table \
+           mean="[0,0,0]" norm="[1,1,1]" \
+           shape="[256,144,3]" pixel=RGB method=kl
+
+ncnn2int8 model-opt.ncnn.param model-rawinput-opt.ncnn.bin model-rawinput-int8.ncnn.param model-rawinput-int8.ncnn.bin \
+          model-rawinput.table
+
+ls -l model-int8.ncnn.* model-rawinput-int8.ncnn.*
 
 cp model-int8.ncnn.param ../../../../data/models/mediapipe_selfie_segmentation_landscape_int8.ncnn.param
 cp model-int8.ncnn.bin ../../../../data/models/mediapipe_selfie_segmentation_landscape_int8.ncnn.bin
+cp model-rawinput-int8.ncnn.param \
+   ../../../../data/models/mediapipe_selfie_segmentation_landscape_rawinput_int8.ncnn.param
+cp model-rawinput-int8.ncnn.bin \
+   ../../../../data/models/mediapipe_selfie_segmentation_landscape_rawinput_int8.ncnn.bin
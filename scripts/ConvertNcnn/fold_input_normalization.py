@@ -0,0 +1,67 @@
+# SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Folds the 1/255 input normalization into the first convolution of an fp32 ncnn model.
+
+The resulting model takes raw 0-255 pixel values, so the caller can feed it straight from
+ncnn::Mat::from_pixels without a separate normalization pass. Only the weights change; biases
+are applied after the multiplication and stay as they are.
+
+Usage: fold_input_normalization.py model.ncnn.param model.ncnn.bin folded.ncnn.bin
+"""
+
+import struct
+import sys
+
+# Layer types that own weights in the .bin file, in the order ncnn serializes them
+WEIGHTED_LAYER_TYPES = {"Convolution", "ConvolutionDepthWise", "InnerProduct", "Deconvolution"}
+
+# ncnn prefixes raw fp32 weight blobs with a zero tag
+FP32_TAG = 0
+
+
+def find_first_weighted_layer(param_path):
+    with open(param_path) as param_file:
+        lines = [line.split() for line in param_file.read().splitlines()[2:] if line.strip()]
+
+    for fields in lines:
+        layer_type, layer_name, bottom_count = fields[0], fields[1], int(fields[2])
+        if layer_type in WEIGHTED_LAYER_TYPES:
+            bottoms = fields[4 : 4 + bottom_count]
+            params = dict(field.split("=", 1) for field in fields[4 + bottom_count + int(fields[3]) :])
+            return layer_type, layer_name, bottoms, params
+        if layer_type not in ("Input", "Split"):
+            raise SystemExit(f"{layer_name} ({layer_type}) transforms the input before any convolution")
+
+    raise SystemExit("no weighted layer found")
+
+
+def main():
+    param_path, bin_path, output_path = sys.argv[1:4]
+
+    layer_type, layer_name, bottoms, params = find_first_weighted_layer(param_path)
+    if layer_type != "Convolution":
+        raise SystemExit(f"expected the first weighted layer to be a Convolution, got {layer_type}")
+    if bottoms != ["in0"]:
+        raise SystemExit(f"{layer_name} does not consume the network input directly")
+
+    weight_count = int(params["6"])
+
+    data = bytearray(open(bin_path, "rb").read())
+    (tag,) = struct.unpack_from("<I", data, 0)
+    if tag != FP32_TAG:
+        raise SystemExit(f"{layer_name} weights are not stored as fp32 (tag 0x{tag:08x}); run ncnnoptimize with 0")
+
+    weight_format = f"<{weight_count}f"
+    weights = struct.unpack_from(weight_format, data, 4)
+    struct.pack_into(weight_format, data, 4, *(weight / 255.0 for weight in weights))
+
+    with open(output_path, "wb") as output_file:
+        output_file.write(data)
+
+    print(f"Folded 1/255 into {weight_count} weights of {layer_name}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,541 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Channel.hpp"
+
+namespace KaitoTokyo::Async {
+
+/**
+ * @brief A fixed-capacity ring that any number of threads push to and pop from without a lock.
+ *
+ * @details
+ * Each slot carries a sequence number that tells a producer whether the slot is free for its
+ * lap and a consumer whether it has been published, so claiming a slot is a single
+ * compare-and-swap on the tail or the head.
+ */
+template<ChannelMessage T> class BoundedRing {
+public:
+	/**
+	 * @param capacity The number of slots, rounded up to a power of two and to at least 2, as a single slot
+	 * cannot tell a filled lap from a free one.
+	 * @throws std::invalid_argument If capacity is 0.
+	 */
+	explicit BoundedRing(std::size_t capacity)
+		: mask_(capacity > 0 ? std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1
+				     : throw std::invalid_argument("CapacityIsZeroError(BoundedRing::BoundedRing)")),
+		  slots_(std::make_unique<Slot[]>(mask_ + 1))
+	{
+		for (std::size_t i = 0; i <= mask_; ++i) {
+			slots_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	~BoundedRing() noexcept
+	{
+		std::optional<T> item;
+		while (try_pop(item)) {
+			item.reset();
+		}
+	}
+
+	BoundedRing(const BoundedRing &) = delete;
+	BoundedRing &operator=(const BoundedRing &) = delete;
+	BoundedRing(BoundedRing &&) = delete;
+	BoundedRing &operator=(BoundedRing &&) = delete;
+
+	std::size_t capacity() const noexcept { return mask_ + 1; }
+
+	/**
+	 * @brief Moves @p value into the ring if there is a free slot.
+	 *
+	 * @return false if the ring is full, in which case @p value is left untouched.
+	 */
+	bool try_push(T &value) noexcept
+	{
+		std::size_t position = tail_.load(std::memory_order_relaxed);
+		Slot *slot;
+		while (true) {
+			slot = &slots_[position & mask_];
+			const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+			if (diff == 0) {
+				if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (diff < 0) {
+				return false;
+			} else {
+				position = tail_.load(std::memory_order_relaxed);
+			}
+		}
+
+		new (slot->storage) T(std::move(value));
+		slot->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Moves the oldest published value into @p out.
+	 *
+	 * @return false if nothing is published, including while a push has claimed a slot but not yet filled it.
+	 */
+	bool try_pop(std::optional<T> &out) noexcept
+	{
+		std::size_t position = head_.load(std::memory_order_relaxed);
+		Slot *slot;
+		while (true) {
+			slot = &slots_[position & mask_];
+			const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			const std::size_t published = position + 1;
+			const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(published);
+			if (diff == 0) {
+				if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (diff < 0) {
+				return false;
+			} else {
+				position = head_.load(std::memory_order_relaxed);
+			}
+		}
+
+		T *value = std::launder(reinterpret_cast<T *>(slot->storage));
+		out.emplace(std::move(*value));
+		value->~T();
+		slot->sequence.store(position + mask_ + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	struct Slot {
+		std::atomic<std::size_t> sequence;
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	const std::size_t mask_;
+	const std::unique_ptr<Slot[]> slots_;
+
+	// Producers and the consumer each hammer their own index, so they live on separate cache lines
+	alignas(64) std::atomic<std::size_t> tail_ = 0;
+	alignas(64) std::atomic<std::size_t> head_ = 0;
+};
+
+/**
+ * @brief What a BoundedChannel does with a message that arrives while it is full.
+ */
+enum class OverflowPolicy {
+	/// `async_send()` suspends the sender until there is room. `send()` fails instead of waiting.
+	Suspend,
+	/// The oldest queued message is discarded to make room.
+	DropOldest,
+	/// The new message is discarded.
+	DropNewest,
+};
+
+/**
+ * @brief A thread-safe asynchronous MPSC channel with a fixed capacity.
+ *
+ * @details
+ * Unlike `Channel`, whose queue grows without limit when the consumer falls behind, this
+ * channel holds at most `capacity()` messages and applies an `OverflowPolicy` beyond that.
+ * Messages travel through a lock-free `BoundedRing`. The mutex is taken only to park or wake
+ * a coroutine: the receiver when the channel is empty, and senders when it is full under
+ * `OverflowPolicy::Suspend`.
+ *
+ * The contract is otherwise the same as `Channel`: any number of producers, at most one
+ * coroutine awaiting `receive()` at a time, and `close()` lets the receiver drain what was
+ * accepted before returning `std::nullopt`.
+ *
+ * A woken coroutine resumes inline on the thread that woke it, as with `Channel`.
+ *
+ * @warning The channel must not be destroyed while a coroutine is suspended on it.
+ *
+ * @tparam T The type of message to transport. Must satisfy `ChannelMessage`.
+ */
+template<ChannelMessage T> class BoundedChannel {
+	struct SendAwaiter;
+	struct ReceiveAwaiter;
+
+public:
+	/**
+	 * @param capacity The maximum number of queued messages, rounded up as in BoundedRing.
+	 * @throws std::invalid_argument If capacity is 0.
+	 */
+	explicit BoundedChannel(std::size_t capacity, OverflowPolicy policy = OverflowPolicy::Suspend)
+		: ring_(capacity),
+		  policy_(policy)
+	{
+	}
+
+	~BoundedChannel() noexcept = default;
+
+	// Non-copyable and Non-movable because suspended coroutines refer to this object.
+	BoundedChannel(const BoundedChannel &) = delete;
+	BoundedChannel &operator=(const BoundedChannel &) = delete;
+	BoundedChannel(BoundedChannel &&) = delete;
+	BoundedChannel &operator=(BoundedChannel &&) = delete;
+
+	std::size_t capacity() const noexcept { return ring_.capacity(); }
+
+	OverflowPolicy policy() const noexcept { return policy_; }
+
+	/**
+	 * @brief The number of messages discarded or refused because the channel was full.
+	 */
+	std::size_t dropped_count() const noexcept { return droppedCount_.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Sends a value without waiting.
+	 *
+	 * This method is thread-safe and can be called concurrently by multiple producers.
+	 * A full channel applies the policy: DropOldest discards the oldest message and
+	 * accepts this one, while DropNewest and Suspend refuse this one.
+	 *
+	 * @return `true` if the value was queued.
+	 * @return `false` if the channel is closed or refused the value.
+	 */
+	bool send(T value)
+	{
+		if (!beginSend()) {
+			return false;
+		}
+
+		bool pushed = ring_.try_push(value);
+		if (!pushed && policy_ == OverflowPolicy::DropOldest) {
+			std::optional<T> oldest;
+			while (!pushed) {
+				if (ring_.try_pop(oldest)) {
+					oldest.reset();
+					droppedCount_.fetch_add(1, std::memory_order_relaxed);
+				}
+				pushed = ring_.try_push(value);
+			}
+		}
+		endSend();
+
+		if (!pushed) {
+			droppedCount_.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		wakeReceiver();
+		return true;
+	}
+
+	/**
+	 * @brief Asynchronously sends a value, waiting for room under OverflowPolicy::Suspend.
+	 *
+	 * Under the drop policies this completes immediately with the result of `send()`.
+	 *
+	 * @return An awaitable that yields `true` once the value is queued, or `false` if the
+	 * channel was closed first or the value was dropped.
+	 */
+	[[nodiscard("You must co_await the send operation.")]]
+	SendAwaiter async_send(T value)
+	{
+		return SendAwaiter{*this, std::move(value)};
+	}
+
+	/**
+	 * @brief Closes the channel for new submissions.
+	 *
+	 * Senders suspended in `async_send()` resume with `false`. A waiting receiver is resumed,
+	 * and `receive()` keeps yielding queued messages until the channel is empty.
+	 */
+	void close()
+	{
+		if (state_.fetch_or(kClosedBit, std::memory_order_acq_rel) & kClosedBit) {
+			return;
+		}
+
+		std::vector<std::coroutine_handle<>> handles;
+		{
+			std::scoped_lock lock(mutex_);
+
+			// Let sends that passed the closed check finish, so the receiver sees every accepted message
+			while ((state_.load(std::memory_order_acquire) & ~kClosedBit) != 0) {
+				std::this_thread::yield();
+			}
+			drained_.store(true, std::memory_order_release);
+
+			for (SendAwaiter *sender : senders_) {
+				sender->result = false;
+				handles.push_back(sender->handle);
+			}
+			waitingSenderCount_.fetch_sub(senders_.size(), std::memory_order_relaxed);
+			senders_.clear();
+
+			if (receiver_) {
+				handles.push_back(receiver_->handle);
+				receiver_ = nullptr;
+				waitingReceiverCount_.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+
+		for (std::coroutine_handle<> h : handles) {
+			h.resume();
+		}
+	}
+
+	/**
+	 * @brief Asynchronously receives a value from the channel.
+	 *
+	 * @warning This method follows the **Single Consumer** contract. It must NOT be
+	 * awaited concurrently by multiple coroutines. Doing so results in undefined behavior.
+	 *
+	 * @return An awaitable object that yields `std::optional<T>`.
+	 * - Returns `T` (wrapped in optional) if data is available.
+	 * - Returns `std::nullopt` if the channel is closed and empty.
+	 */
+	[[nodiscard("You must co_await the received value.")]]
+	ReceiveAwaiter receive() noexcept
+	{
+		return ReceiveAwaiter{*this};
+	}
+
+private:
+	struct SendAwaiter {
+		BoundedChannel &ch;
+		T value;
+		bool result = false;
+		std::coroutine_handle<> handle = nullptr;
+
+		bool await_ready()
+		{
+			if (ch.policy_ != OverflowPolicy::Suspend) {
+				result = ch.send(std::move(value));
+				return true;
+			}
+
+			if (!ch.beginSend()) {
+				return true;
+			}
+			result = ch.ring_.try_push(value);
+			ch.endSend();
+
+			if (result) {
+				ch.wakeReceiver();
+			}
+			return result;
+		}
+
+		bool await_suspend(std::coroutine_handle<> h)
+		{
+			handle = h;
+			return ch.parkSender(*this);
+		}
+
+		bool await_resume() const noexcept { return result; }
+	};
+
+	struct ReceiveAwaiter {
+		BoundedChannel &ch;
+		std::optional<T> item = std::nullopt;
+		std::coroutine_handle<> handle = nullptr;
+
+		bool await_ready() { return ch.tryReceive(item); }
+
+		bool await_suspend(std::coroutine_handle<> h)
+		{
+			handle = h;
+			return ch.parkReceiver(*this);
+		}
+
+		std::optional<T> await_resume()
+		{
+			// Woken by close() rather than handed a message
+			if (!item) {
+				ch.tryReceive(item);
+			}
+			return std::move(item);
+		}
+	};
+
+	static constexpr std::size_t kClosedBit = 1;
+	static constexpr std::size_t kSendIncrement = 2;
+
+	/**
+	 * @brief Registers an in-flight send unless the channel is closed.
+	 */
+	bool beginSend() noexcept
+	{
+		if (state_.fetch_add(kSendIncrement, std::memory_order_acq_rel) & kClosedBit) {
+			endSend();
+			return false;
+		}
+		return true;
+	}
+
+	void endSend() noexcept { state_.fetch_sub(kSendIncrement, std::memory_order_release); }
+
+	/**
+	 * @brief Pops a message into @p out, or reports that the channel is closed and drained.
+	 *
+	 * @return `false` if the receiver has to wait.
+	 */
+	bool tryReceive(std::optional<T> &out)
+	{
+		if (ring_.try_pop(out)) {
+			wakeSenders();
+			return true;
+		}
+		if (drained_.load(std::memory_order_acquire)) {
+			if (ring_.try_pop(out)) {
+				wakeSenders();
+			}
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Parks the receiver, unless a message or close() arrived after `await_ready()`.
+	 *
+	 * @return `true` if the receiver is parked.
+	 */
+	bool parkReceiver(ReceiveAwaiter &awaiter)
+	{
+		{
+			std::scoped_lock lock(mutex_);
+			receiver_ = &awaiter;
+			// Pairs with the RMW in wakeReceiver(): either it sees the receiver or we see its message
+			waitingReceiverCount_.fetch_add(1, std::memory_order_acq_rel);
+
+			if (!ring_.try_pop(awaiter.item) && !drained_.load(std::memory_order_acquire)) {
+				return true;
+			}
+			receiver_ = nullptr;
+			waitingReceiverCount_.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		if (awaiter.item) {
+			wakeSenders();
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Hands the next message to a parked receiver after a producer pushed one.
+	 */
+	void wakeReceiver()
+	{
+		if (waitingReceiverCount_.fetch_add(0, std::memory_order_acq_rel) == 0) {
+			return;
+		}
+
+		std::coroutine_handle<> receiverHandle = nullptr;
+		std::vector<std::coroutine_handle<>> senderHandles;
+		{
+			std::scoped_lock lock(mutex_);
+			// Another producer may already have served the receiver, or a DropOldest send taken the message
+			if (!receiver_ || !ring_.try_pop(receiver_->item)) {
+				return;
+			}
+			receiverHandle = receiver_->handle;
+			receiver_ = nullptr;
+			waitingReceiverCount_.fetch_sub(1, std::memory_order_relaxed);
+			pushParkedSendersLocked(senderHandles);
+		}
+
+		for (std::coroutine_handle<> h : senderHandles) {
+			h.resume();
+		}
+		receiverHandle.resume();
+	}
+
+	/**
+	 * @brief Parks a sender, unless room or close() arrived after `await_ready()`.
+	 *
+	 * @return `true` if the sender is parked.
+	 */
+	bool parkSender(SendAwaiter &awaiter)
+	{
+		{
+			std::scoped_lock lock(mutex_);
+			if (state_.load(std::memory_order_acquire) & kClosedBit) {
+				awaiter.result = false;
+				return false;
+			}
+
+			senders_.push_back(&awaiter);
+			// Pairs with the RMW in wakeSenders(): either it sees the sender or we see the free slot
+			waitingSenderCount_.fetch_add(1, std::memory_order_acq_rel);
+
+			if (!ring_.try_push(awaiter.value)) {
+				return true;
+			}
+			senders_.pop_back();
+			waitingSenderCount_.fetch_sub(1, std::memory_order_relaxed);
+			awaiter.result = true;
+		}
+
+		wakeReceiver();
+		return false;
+	}
+
+	/**
+	 * @brief Moves the values of parked senders into the slots the receiver freed.
+	 */
+	void wakeSenders()
+	{
+		if (waitingSenderCount_.fetch_add(0, std::memory_order_acq_rel) == 0) {
+			return;
+		}
+
+		std::vector<std::coroutine_handle<>> handles;
+		{
+			std::scoped_lock lock(mutex_);
+			pushParkedSendersLocked(handles);
+		}
+		for (std::coroutine_handle<> h : handles) {
+			h.resume();
+		}
+	}
+
+	void pushParkedSendersLocked(std::vector<std::coroutine_handle<>> &handles)
+	{
+		while (!senders_.empty() && ring_.try_push(senders_.front()->value)) {
+			senders_.front()->result = true;
+			handles.push_back(senders_.front()->handle);
+			senders_.pop_front();
+			waitingSenderCount_.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	BoundedRing<T> ring_;
+	const OverflowPolicy policy_;
+
+	/// The closed flag in bit 0 and the number of in-flight sends above it.
+	std::atomic<std::size_t> state_ = 0;
+	/// Set by close() once no accepted message can still be on its way into the ring.
+	std::atomic<bool> drained_ = false;
+	std::atomic<std::size_t> droppedCount_ = 0;
+
+	std::mutex mutex_;
+	ReceiveAwaiter *receiver_ = nullptr;
+	std::deque<SendAwaiter *> senders_;
+	// Mirror the waiters above for the lock-free fast paths. Every write is an RMW so that a
+	// waker's read-modify-write and a parker's always synchronize, whichever comes first.
+	std::atomic<std::size_t> waitingReceiverCount_ = 0;
+	std::atomic<std::size_t> waitingSenderCount_ = 0;
+};
+
+} // namespace KaitoTokyo::Async
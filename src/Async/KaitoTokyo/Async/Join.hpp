@@ -4,61 +4,76 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <exception>
+#include <memory>
 #include <mutex>
-#include <thread>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 
 #include "Task.hpp"
 
 namespace KaitoTokyo::Async {
 
-struct [[nodiscard]] JoinTask {
+/**
+ * @brief A wrapper coroutine that destroys itself when it finishes and then transfers to the handle it returned.
+ */
+struct [[nodiscard]] DetachedJoinTask {
 	struct promise_type {
-		JoinTask get_return_object()
+		std::coroutine_handle<> next = nullptr;
+
+		DetachedJoinTask get_return_object()
 		{
-			return JoinTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+			return DetachedJoinTask{std::coroutine_handle<promise_type>::from_promise(*this)};
 		}
 		std::suspend_always initial_suspend() noexcept { return {}; }
 
-		std::suspend_always final_suspend() noexcept { return {}; }
+		auto final_suspend() noexcept
+		{
+			struct FinalAwaiter {
+				bool await_ready() noexcept { return false; }
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+				{
+					std::coroutine_handle<> next = h.promise().next;
+					h.destroy();
+					return next ? next : std::noop_coroutine();
+				}
 
-		void return_void() noexcept {}
+				void await_resume() noexcept {}
+			};
+			return FinalAwaiter{};
+		}
+
+		void return_value(std::coroutine_handle<> h) noexcept { next = h; }
 		[[noreturn]] void unhandled_exception() { std::terminate(); }
 	};
 
-	explicit JoinTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+	explicit DetachedJoinTask(std::coroutine_handle<promise_type> h) : handle(h) {}
 
-	~JoinTask()
+	~DetachedJoinTask()
 	{
 		if (handle)
 			handle.destroy();
 	}
 
 	// Move only
-	JoinTask(const JoinTask &) = delete;
-	JoinTask &operator=(const JoinTask &) = delete;
-	JoinTask(JoinTask &&other) noexcept : handle(other.handle) { other.handle = nullptr; }
-	JoinTask &operator=(JoinTask &&other) noexcept
-	{
-		if (this != &other) {
-			if (handle) {
-				handle.destroy();
-			}
-			handle = other.handle;
-			other.handle = nullptr;
-		}
-		return *this;
-	}
-
-	void start()
-	{
-		if (handle && !handle.done())
-			handle.resume();
-	}
+	DetachedJoinTask(const DetachedJoinTask &) = delete;
+	DetachedJoinTask &operator=(const DetachedJoinTask &) = delete;
+	DetachedJoinTask(DetachedJoinTask &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+	DetachedJoinTask &operator=(DetachedJoinTask &&) = delete;
 
-	bool is_done() const { return handle && handle.done(); }
+	/**
+	 * @brief Starts the wrapper and gives up ownership; the frame destroys itself when it finishes.
+	 */
+	void start() { std::exchange(handle, nullptr).resume(); }
 
 private:
 	std::coroutine_handle<promise_type> handle;
@@ -78,35 +93,287 @@ inline void join(Task<void> task)
 
 	JoinState state;
 
-	auto wrapper = [&state](Task<void> t) -> JoinTask {
+	auto wrapper = [](Task<void> t, JoinState &state) -> DetachedJoinTask {
 		try {
 			co_await t;
 		} catch (...) {
 			state.error = std::current_exception();
 		}
 
+		// Notified under the lock because join() returns and destroys state as soon as it can take the lock.
+		// The wrapper may run on another thread once the task moves onto an executor.
 		{
 			std::scoped_lock lock(state.mutex);
 			state.done = true;
+			state.cv.notify_one();
 		}
-		state.cv.notify_one();
+		co_return nullptr;
 	};
 
-	auto join_task = wrapper(std::move(task));
-	join_task.start();
+	wrapper(std::move(task), state).start();
 
 	{
 		std::unique_lock lock(state.mutex);
 		state.cv.wait(lock, [&state] { return state.done; });
 	}
 
-	while (!join_task.is_done()) {
-		std::this_thread::yield();
-	}
-
 	if (state.error) {
 		std::rethrow_exception(state.error);
 	}
 }
 
+// -----------------------------------------------------------------------------
+// when_all / when_any
+// Each child task runs in a detached wrapper, as in join(). The wrappers
+// share their state with the awaiting coroutine through a shared_ptr,
+// so a child that finishes late never touches a destroyed frame.
+// -----------------------------------------------------------------------------
+
+template<typename T> using JoinResult = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+/**
+ * @brief The state an awaiting coroutine shares with its children.
+ *
+ * The awaiting coroutine counts as one arrival, so it cannot be resumed before it has started every child.
+ */
+struct JoinGroupState {
+	explicit JoinGroupState(std::size_t arrivals) : remaining(arrivals) {}
+
+	/**
+	 * @brief Records one arrival and returns the awaiting coroutine if this was the last one.
+	 */
+	std::coroutine_handle<> arrive() noexcept
+	{
+		if (remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+			return nullptr;
+		}
+		std::scoped_lock lock(mutex);
+		return std::exchange(continuation, nullptr);
+	}
+
+	void set_error(std::exception_ptr e) noexcept
+	{
+		std::scoped_lock lock(mutex);
+		if (!error)
+			error = std::move(e);
+	}
+
+	std::mutex mutex;
+	std::atomic<std::size_t> remaining;
+	std::coroutine_handle<> continuation = nullptr;
+	std::exception_ptr error = nullptr;
+};
+
+/**
+ * @brief Suspends the awaiting coroutine, starts the children and resumes it when the group state says so.
+ *
+ * Keep it in a named variable rather than awaiting a temporary. GCC destroys such a temporary twice when the
+ * coroutine throws after resuming.
+ */
+struct JoinGroupAwaiter {
+	std::shared_ptr<JoinGroupState> state;
+	std::vector<DetachedJoinTask> children;
+
+	// The children start in await_suspend, so the group is never ready before suspending.
+	bool await_ready() const noexcept { return false; }
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> h)
+	{
+		{
+			std::scoped_lock lock(state->mutex);
+			state->continuation = h;
+		}
+		for (DetachedJoinTask &child : children) {
+			child.start();
+		}
+		std::coroutine_handle<> next = state->arrive();
+		return next ? next : std::noop_coroutine();
+	}
+
+	void await_resume() const noexcept {}
+
+	// A destroyed awaiting coroutine must not be resumed by a child that finishes later.
+	~JoinGroupAwaiter()
+	{
+		if (state) {
+			std::scoped_lock lock(state->mutex);
+			state->continuation = nullptr;
+		}
+	}
+};
+
+template<typename T> struct WhenAllState : JoinGroupState {
+	explicit WhenAllState(std::size_t count) : JoinGroupState(count + 1), results(count) {}
+
+	std::vector<std::optional<JoinResult<T>>> results;
+};
+
+template<typename T>
+DetachedJoinTask when_all_child(Task<T> task, std::shared_ptr<WhenAllState<T>> state, std::size_t index)
+{
+	try {
+		if constexpr (std::is_void_v<T>) {
+			co_await task;
+			state->results[index].emplace();
+		} else {
+			state->results[index].emplace(co_await task);
+		}
+	} catch (...) {
+		state->set_error(std::current_exception());
+	}
+	co_return state->arrive();
+}
+
+template<typename T> std::shared_ptr<WhenAllState<T>> start_when_all_group(std::vector<Task<T>> &tasks,
+									    std::vector<DetachedJoinTask> &children)
+{
+	auto state = std::make_shared<WhenAllState<T>>(tasks.size());
+	children.reserve(tasks.size());
+	for (std::size_t i = 0; i < tasks.size(); ++i) {
+		children.push_back(when_all_child(std::move(tasks[i]), state, i));
+	}
+	return state;
+}
+
+/**
+ * @brief Runs every task concurrently and completes when all of them have finished.
+ *
+ * The tasks start on the awaiting thread and run wherever they schedule themselves, so they only overlap if
+ * they move onto an executor such as a ThreadPool. The awaiting coroutine resumes on the thread that finishes
+ * the last task.
+ *
+ * @return The results in the order of @p tasks.
+ * @throws The first exception thrown by any task, after every task has finished.
+ */
+template<typename T>
+	requires(!std::is_void_v<T>)
+Task<std::vector<T>> when_all(std::vector<Task<T>> tasks)
+{
+	std::vector<DetachedJoinTask> children;
+	auto state = start_when_all_group(tasks, children);
+	JoinGroupAwaiter awaiter{state, std::move(children)};
+	co_await awaiter;
+
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+	std::vector<T> values;
+	values.reserve(state->results.size());
+	for (std::optional<T> &result : state->results) {
+		values.push_back(std::move(*result));
+	}
+	co_return values;
+}
+
+/**
+ * @brief Runs every task concurrently and completes when all of them have finished.
+ *
+ * @throws The first exception thrown by any task, after every task has finished.
+ */
+inline Task<void> when_all(std::vector<Task<void>> tasks)
+{
+	std::vector<DetachedJoinTask> children;
+	auto state = start_when_all_group(tasks, children);
+	JoinGroupAwaiter awaiter{state, std::move(children)};
+	co_await awaiter;
+
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+}
+
+template<typename T> struct WhenAnyState : JoinGroupState {
+	// The winner and the awaiting coroutine are the two arrivals.
+	WhenAnyState() : JoinGroupState(2) {}
+
+	std::atomic<bool> decided = false;
+	std::size_t index = 0;
+	std::optional<JoinResult<T>> result;
+};
+
+template<typename T>
+DetachedJoinTask when_any_child(Task<T> task, std::shared_ptr<WhenAnyState<T>> state, std::size_t index)
+{
+	std::optional<JoinResult<T>> result;
+	std::exception_ptr error = nullptr;
+	try {
+		if constexpr (std::is_void_v<T>) {
+			co_await task;
+			result.emplace();
+		} else {
+			result.emplace(co_await task);
+		}
+	} catch (...) {
+		error = std::current_exception();
+	}
+
+	if (state->decided.exchange(true, std::memory_order_acq_rel)) {
+		co_return nullptr;
+	}
+	state->index = index;
+	state->result = std::move(result);
+	state->error = std::move(error);
+	co_return state->arrive();
+}
+
+template<typename T> std::shared_ptr<WhenAnyState<T>> start_when_any_group(std::vector<Task<T>> &tasks,
+									    std::vector<DetachedJoinTask> &children)
+{
+	if (tasks.empty()) {
+		throw std::invalid_argument("TasksAreEmptyError(when_any)");
+	}
+
+	auto state = std::make_shared<WhenAnyState<T>>();
+	children.reserve(tasks.size());
+	for (std::size_t i = 0; i < tasks.size(); ++i) {
+		children.push_back(when_any_child(std::move(tasks[i]), state, i));
+	}
+	return state;
+}
+
+/**
+ * @brief Runs every task concurrently and completes when the first of them finishes.
+ *
+ * The other tasks cannot be cancelled and keep running to completion in the background, so whatever they
+ * refer to, including the executor they run on, must outlive them.
+ *
+ * @return The index of the first task to finish and its result.
+ * @throws std::invalid_argument If @p tasks is empty.
+ * @throws The exception thrown by the first task to finish.
+ */
+template<typename T>
+	requires(!std::is_void_v<T>)
+Task<std::pair<std::size_t, T>> when_any(std::vector<Task<T>> tasks)
+{
+	std::vector<DetachedJoinTask> children;
+	auto state = start_when_any_group(tasks, children);
+	JoinGroupAwaiter awaiter{state, std::move(children)};
+	co_await awaiter;
+
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+	co_return std::pair<std::size_t, T>{state->index, std::move(*state->result)};
+}
+
+/**
+ * @brief Runs every task concurrently and completes when the first of them finishes.
+ *
+ * @return The index of the first task to finish.
+ * @throws std::invalid_argument If @p tasks is empty.
+ * @throws The exception thrown by the first task to finish.
+ */
+inline Task<std::size_t> when_any(std::vector<Task<void>> tasks)
+{
+	std::vector<DetachedJoinTask> children;
+	auto state = start_when_any_group(tasks, children);
+	JoinGroupAwaiter awaiter{state, std::move(children)};
+	co_await awaiter;
+
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+	co_return state->index;
+}
+
 } // namespace KaitoTokyo::Async
@@ -0,0 +1,306 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace KaitoTokyo::Async {
+
+/**
+ * @brief A work-stealing executor that resumes coroutines on a fixed set of threads.
+ *
+ * @details
+ * Without an executor, a coroutine resumes inline on whatever thread wakes it, such as the
+ * producer that calls `Channel::send()`. Awaiting `schedule_on(pool)` moves the rest of the
+ * coroutine onto one of the pool's threads, and awaiting `pool.schedule_after(duration)` does
+ * the same once the duration has elapsed.
+ *
+ * Key Features:
+ * - **Work Stealing**: Each worker owns a queue. A coroutine scheduled from a worker goes to
+ * that worker's queue, so a chain of steps stays on one core while the pool is busy. Idle
+ * workers steal from the others.
+ * - **Timers**: A dedicated timer thread hands coroutines to the workers when their deadline
+ * passes, so sleeping never occupies a worker.
+ *
+ * @warning The pool does not own the coroutines it resumes. Coroutines still queued or waiting
+ * on a timer when the pool is destroyed are never resumed, so every chain scheduled on the pool
+ * must have finished before then.
+ */
+class ThreadPool {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief Resumes the awaiting coroutine on a worker.
+	 */
+	struct ScheduleAwaiter {
+		ThreadPool &pool;
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> h) { pool.post(h); }
+		void await_resume() const noexcept {}
+	};
+
+	/**
+	 * @brief Resumes the awaiting coroutine on a worker once the deadline has passed.
+	 */
+	struct TimerAwaiter {
+		ThreadPool &pool;
+		Clock::time_point deadline;
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> h) { pool.addTimer(deadline, h); }
+		void await_resume() const noexcept {}
+	};
+
+	/**
+	 * @brief Starts the workers and the timer thread.
+	 *
+	 * @param threadCount The number of worker threads. Must be at least 1.
+	 * @throws std::invalid_argument If threadCount is 0.
+	 */
+	explicit ThreadPool(std::size_t threadCount)
+	{
+		if (threadCount == 0) {
+			throw std::invalid_argument("ThreadCountIsZeroError(ThreadPool::ThreadPool)");
+		}
+
+		for (std::size_t i = 0; i < threadCount; ++i) {
+			workerQueues_.push_back(std::make_unique<WorkerQueue>());
+		}
+		workers_.reserve(threadCount);
+		for (std::size_t i = 0; i < threadCount; ++i) {
+			workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+		}
+		timerThread_ = std::thread(&ThreadPool::timerLoop, this);
+	}
+
+	/**
+	 * @brief Stops and joins every thread. Queued coroutines are not resumed.
+	 */
+	~ThreadPool() noexcept
+	{
+		{
+			std::scoped_lock lock(sleepMutex_, timerMutex_);
+			stopped_ = true;
+		}
+		sleepCv_.notify_all();
+		timerCv_.notify_all();
+
+		for (std::thread &worker : workers_) {
+			worker.join();
+		}
+		timerThread_.join();
+	}
+
+	// Non-copyable and Non-movable because the threads refer to this object.
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+	ThreadPool(ThreadPool &&) = delete;
+	ThreadPool &operator=(ThreadPool &&) = delete;
+
+	std::size_t thread_count() const noexcept { return workers_.size(); }
+
+	/**
+	 * @brief Queues @p handle to be resumed by a worker.
+	 *
+	 * Called from a worker of this pool, the handle goes to that worker's own queue. Otherwise
+	 * the workers' queues are filled round-robin.
+	 */
+	void post(std::coroutine_handle<> handle)
+	{
+		const WorkerContext &context = currentWorker();
+		std::size_t index = context.index;
+		if (context.pool != this) {
+			index = nextQueue_.fetch_add(1, std::memory_order_relaxed) % workerQueues_.size();
+		}
+		{
+			WorkerQueue &queue = *workerQueues_[index];
+			std::scoped_lock lock(queue.mutex);
+			queue.handles.push_back(handle);
+		}
+		{
+			std::scoped_lock lock(sleepMutex_);
+			++pendingCount_;
+		}
+		sleepCv_.notify_one();
+	}
+
+	/**
+	 * @brief Returns an awaitable that resumes the awaiting coroutine on a worker.
+	 */
+	[[nodiscard("You must co_await the schedule operation.")]]
+	ScheduleAwaiter schedule() noexcept
+	{
+		return ScheduleAwaiter{*this};
+	}
+
+	/**
+	 * @brief Returns an awaitable that resumes the awaiting coroutine on a worker after @p delay.
+	 */
+	[[nodiscard("You must co_await the timer.")]]
+	TimerAwaiter schedule_after(Clock::duration delay) { return schedule_at(Clock::now() + delay); }
+
+	/**
+	 * @brief Returns an awaitable that resumes the awaiting coroutine on a worker at @p deadline.
+	 *
+	 * A deadline in the past behaves like `schedule()`.
+	 */
+	[[nodiscard("You must co_await the timer.")]]
+	TimerAwaiter schedule_at(Clock::time_point deadline) noexcept
+	{
+		return TimerAwaiter{*this, deadline};
+	}
+
+private:
+	struct WorkerQueue {
+		std::mutex mutex;
+		std::deque<std::coroutine_handle<>> handles;
+	};
+
+	struct Timer {
+		Clock::time_point deadline;
+		std::coroutine_handle<> handle;
+
+		// Inverted so that std::priority_queue yields the earliest deadline first
+		bool operator<(const Timer &other) const noexcept { return deadline > other.deadline; }
+	};
+
+	struct WorkerContext {
+		const ThreadPool *pool = nullptr;
+		std::size_t index = 0;
+	};
+
+	static WorkerContext &currentWorker() noexcept
+	{
+		thread_local WorkerContext context;
+		return context;
+	}
+
+	void addTimer(Clock::time_point deadline, std::coroutine_handle<> handle)
+	{
+		{
+			std::scoped_lock lock(timerMutex_);
+			timers_.push(Timer{deadline, handle});
+		}
+		timerCv_.notify_one();
+	}
+
+	std::optional<std::coroutine_handle<>> tryPop(std::size_t index)
+	{
+		WorkerQueue &queue = *workerQueues_[index];
+		std::scoped_lock lock(queue.mutex);
+		if (queue.handles.empty()) {
+			return std::nullopt;
+		}
+		std::coroutine_handle<> handle = queue.handles.front();
+		queue.handles.pop_front();
+		return handle;
+	}
+
+	std::optional<std::coroutine_handle<>> tryPopOrSteal(std::size_t index)
+	{
+		if (auto handle = tryPop(index)) {
+			return handle;
+		}
+		for (std::size_t offset = 1; offset < workerQueues_.size(); ++offset) {
+			if (auto handle = tryPop((index + offset) % workerQueues_.size())) {
+				return handle;
+			}
+		}
+		return std::nullopt;
+	}
+
+	void workerLoop(std::size_t index)
+	{
+		currentWorker() = WorkerContext{this, index};
+
+		while (true) {
+			if (std::optional<std::coroutine_handle<>> handle = tryPopOrSteal(index)) {
+				{
+					std::scoped_lock lock(sleepMutex_);
+					--pendingCount_;
+				}
+				handle->resume();
+				continue;
+			}
+
+			// A handle counted as pending but not yet popped by its taker makes this loop retry
+			std::unique_lock lock(sleepMutex_);
+			sleepCv_.wait(lock, [this] { return stopped_ || pendingCount_ > 0; });
+			if (stopped_) {
+				return;
+			}
+		}
+	}
+
+	void timerLoop()
+	{
+		std::unique_lock lock(timerMutex_);
+		while (!stopped_) {
+			if (timers_.empty()) {
+				timerCv_.wait(lock);
+				continue;
+			}
+
+			const Clock::time_point deadline = timers_.top().deadline;
+			if (Clock::now() < deadline) {
+				timerCv_.wait_until(lock, deadline);
+				continue;
+			}
+
+			std::coroutine_handle<> handle = timers_.top().handle;
+			timers_.pop();
+			lock.unlock();
+			post(handle);
+			lock.lock();
+		}
+	}
+
+	std::vector<std::unique_ptr<WorkerQueue>> workerQueues_;
+	std::atomic<std::size_t> nextQueue_ = 0;
+
+	std::mutex sleepMutex_;
+	std::condition_variable sleepCv_;
+	std::size_t pendingCount_ = 0;
+	bool stopped_ = false;
+
+	std::mutex timerMutex_;
+	std::condition_variable timerCv_;
+	std::priority_queue<Timer> timers_;
+
+	std::vector<std::thread> workers_;
+	std::thread timerThread_;
+};
+
+/**
+ * @brief Returns an awaitable that moves the awaiting coroutine onto @p pool.
+ *
+ * @code
+ * Task<void> process(ThreadPool &pool) {
+ *         co_await schedule_on(pool);
+ *         // Runs on a worker of pool from here on
+ * }
+ * @endcode
+ */
+[[nodiscard("You must co_await the schedule operation.")]]
+inline ThreadPool::ScheduleAwaiter schedule_on(ThreadPool &pool) noexcept
+{
+	return pool.schedule();
+}
+
+} // namespace KaitoTokyo::Async
@@ -4,6 +4,7 @@
 
 #include "GlobalContext.hpp"
 
+#include <chrono>
 #include <regex>
 #include <string_view>
 #include <utility>
@@ -11,9 +12,28 @@
 #include <curl/curl.h>
 
 #include <KaitoTokyo/CurlHelper/CurlWriteCallback.hpp>
+#include <KaitoTokyo/ObsBridgeUtils/ObsUnique.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnAutoTuner.hpp>
+#include <KaitoTokyo/SelfieSegmenter/SimdDispatch.hpp>
+
+#include <MainEffect.hpp>
 
 namespace KaitoTokyo::LiveBackgroundRemovalLite::Global {
 
+namespace {
+
+// Room for the textures of several 1080p filters with blur, so that rebuilding them allocates nothing
+constexpr std::size_t kTexturePoolBudgetBytes = 256 * 1024 * 1024;
+
+// Context builds are short and rare, so two workers keep one slow build from delaying the others without
+// competing with inference for more cores
+constexpr std::size_t kSharedWorkerCount = 2;
+
+// Tuning runs for seconds, so it gets a worker of its own that no context build ever waits for
+constexpr std::size_t kTuningWorkerCount = 1;
+
+} // anonymous namespace
+
 GlobalContext::GlobalContext(std::shared_ptr<PluginConfig> pluginConfig, std::shared_ptr<const Logger::ILogger> logger,
 			     std::string pluginName, std::string pluginVersion, std::string latestVersionUrl)
 	: pluginName_(std::move(pluginName)),
@@ -23,12 +43,41 @@ GlobalContext::GlobalContext(std::shared_ptr<PluginConfig> pluginConfig, std::sh
 	  latestVersionUrl_(std::move(latestVersionUrl)),
 	  pluginConfig_(pluginConfig
 				? std::move(pluginConfig)
-				: throw std::invalid_argument("PluginConfigIsNullError(GlobalContext::GlobalContext)"))
+				: throw std::invalid_argument("PluginConfigIsNullError(GlobalContext::GlobalContext)")),
+	  modelRegistry_(std::make_shared<SelfieSegmenter::NcnnModelRegistry>(logger_)),
+	  inferenceScheduler_(std::make_shared<SelfieSegmenter::InferenceScheduler>(logger_)),
+	  texturePool_(std::make_shared<ObsBridgeUtils::GsTexturePool>(kTexturePoolBudgetBytes)),
+	  workerPool_(std::make_shared<TaskQueue::SharedWorkerPool>(logger_, kSharedWorkerCount)),
+	  tuningWorkerPool_(std::make_shared<TaskQueue::SharedWorkerPool>(logger_, kTuningWorkerCount)),
+	  cpuModelName_(SelfieSegmenter::NcnnAutoTuner::getCpuModelName())
 {
+	ObsBridgeUtils::GsTexturePool::install(texturePool_);
+
+	if (!cpuModelName_) {
+		logger_->warn("CpuModelNameUnavailable");
+	} else if (auto options = pluginConfig_->loadNcnnInferenceOptions(*cpuModelName_)) {
+		ncnnInferenceOptions_ = *options;
+		logger_->info("NcnnInferenceOptionsLoaded",
+			      {{"cpuModelName", *cpuModelName_}, {"options", ncnnInferenceOptions_.serialize()}});
+	}
+
+	// Resolving the kernels here probes the CPU once at plugin load rather than on the first frame
+	const SelfieSegmenter::SimdKernels &simdKernels = SelfieSegmenter::getSimdKernels();
+	logger_->info("SimdKernelsSelected", {{"tier", SelfieSegmenter::getSimdTierName(simdKernels.tier)}});
 }
 
 GlobalContext::~GlobalContext() noexcept
 {
+	tuningWorkerPool_->shutdown();
+	workerPool_->shutdown();
+
+	ObsBridgeUtils::GsUnique::setTextureRecycler(nullptr);
+	texturePool_->trim(0);
+	{
+		ObsBridgeUtils::GraphicsContextGuard graphicsContextGuard;
+		ObsBridgeUtils::GsUnique::drain();
+	}
+
 	if (fetchLatestVersionThread_.joinable()) {
 		fetchLatestVersionThread_.request_stop();
 		try {
@@ -65,6 +114,85 @@ std::optional<std::string> GlobalContext::getLatestVersion() const
 	return latestVersion_;
 }
 
+std::shared_ptr<SelfieSegmenter::NcnnModelRegistry> GlobalContext::getModelRegistry() const noexcept
+{
+	return modelRegistry_;
+}
+
+std::shared_ptr<SelfieSegmenter::InferenceScheduler> GlobalContext::getInferenceScheduler() const noexcept
+{
+	return inferenceScheduler_;
+}
+
+std::shared_ptr<ObsBridgeUtils::GsTexturePool> GlobalContext::getTexturePool() const noexcept
+{
+	return texturePool_;
+}
+
+std::shared_ptr<TaskQueue::SharedWorkerPool> GlobalContext::getWorkerPool() const noexcept
+{
+	return workerPool_;
+}
+
+std::shared_ptr<TaskQueue::SharedWorkerPool> GlobalContext::getTuningWorkerPool() const noexcept
+{
+	return tuningWorkerPool_;
+}
+
+SelfieSegmenter::NcnnInferenceOptions GlobalContext::getNcnnInferenceOptions() const
+{
+	std::lock_guard lock(mutex_);
+	return ncnnInferenceOptions_;
+}
+
+void GlobalContext::setNcnnInferenceOptions(const SelfieSegmenter::NcnnInferenceOptions &options)
+{
+	{
+		std::lock_guard lock(mutex_);
+		ncnnInferenceOptions_ = options;
+	}
+
+	if (cpuModelName_) {
+		pluginConfig_->saveNcnnInferenceOptions(*cpuModelName_, options);
+		logger_->info("NcnnInferenceOptionsSaved",
+			      {{"cpuModelName", *cpuModelName_}, {"options", options.serialize()}});
+	}
+}
+
+std::shared_ptr<const MainFilter::MainEffect> GlobalContext::acquireMainEffect()
+{
+	const auto millisecondsSince = [](std::chrono::steady_clock::time_point startTime) {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	};
+	const auto requestTime = std::chrono::steady_clock::now();
+
+	{
+		std::lock_guard lock(mainEffectMutex_);
+		if (std::shared_ptr<const MainFilter::MainEffect> mainEffect = mainEffect_.lock()) {
+			// Not counting the copy held here
+			logger_->info("MainEffectReused",
+				      {{"existingUserCount", std::to_string(mainEffect.use_count() - 1)},
+				       {"elapsedMs", std::to_string(millisecondsSince(requestTime))},
+				       {"initialCreationMs", std::to_string(mainEffectCreationMs_)}});
+			return mainEffect;
+		}
+	}
+
+	// Compiled without the lock; if another instance finishes first, its effect is kept and this one is dropped
+	auto mainEffect = std::make_shared<const MainFilter::MainEffect>(
+		logger_, ObsBridgeUtils::unique_obs_module_file("effects/main.effect"));
+	const double creationMs = millisecondsSince(requestTime);
+
+	std::lock_guard lock(mainEffectMutex_);
+	if (std::shared_ptr<const MainFilter::MainEffect> existing = mainEffect_.lock()) {
+		return existing;
+	}
+	mainEffect_ = mainEffect;
+	mainEffectCreationMs_ = creationMs;
+	logger_->info("MainEffectCreated", {{"elapsedMs", std::to_string(creationMs)}});
+	return mainEffect;
+}
+
 void GlobalContext::checkForUpdates()
 {
 	if (pluginConfig_->isAutoCheckForUpdateEnabled()) {
@@ -16,9 +16,18 @@
 
 #include <KaitoTokyo/CurlHelper/CurlHandle.hpp>
 #include <KaitoTokyo/Logger/ILogger.hpp>
+#include <KaitoTokyo/ObsBridgeUtils/GsTexturePool.hpp>
+#include <KaitoTokyo/SelfieSegmenter/InferenceScheduler.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnInferenceOptions.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnModelRegistry.hpp>
+#include <KaitoTokyo/TaskQueue/SharedWorkerPool.hpp>
 
 #include "PluginConfig.hpp"
 
+namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter {
+struct MainEffect;
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter
+
 namespace KaitoTokyo::LiveBackgroundRemovalLite::Global {
 
 #ifdef __APPLE__
@@ -39,6 +48,41 @@ public:
 	std::string getQtResourcePrefix() const noexcept;
 	std::shared_ptr<const Logger::ILogger> getLogger() const noexcept;
 	std::optional<std::string> getLatestVersion() const;
+	std::shared_ptr<SelfieSegmenter::NcnnModelRegistry> getModelRegistry() const noexcept;
+	std::shared_ptr<SelfieSegmenter::InferenceScheduler> getInferenceScheduler() const noexcept;
+	std::shared_ptr<ObsBridgeUtils::GsTexturePool> getTexturePool() const noexcept;
+
+	/**
+	 * @brief Returns the worker pool that background tasks of every filter instance share.
+	 */
+	std::shared_ptr<TaskQueue::SharedWorkerPool> getWorkerPool() const noexcept;
+
+	/**
+	 * @brief Returns the single-worker pool that ncnn tuning runs of every filter instance take turns on.
+	 */
+	std::shared_ptr<TaskQueue::SharedWorkerPool> getTuningWorkerPool() const noexcept;
+
+	/**
+	 * @brief Returns the inference options tuned on this CPU, or the defaults if it has not been tuned.
+	 */
+	SelfieSegmenter::NcnnInferenceOptions getNcnnInferenceOptions() const;
+
+	/**
+	 * @brief Makes @p options the inference options of later loads and stores them for this CPU.
+	 *
+	 * The options still apply to this session if the CPU cannot be identified and nothing is stored.
+	 *
+	 * @throw std::runtime_error If the options cannot be stored.
+	 */
+	void setNcnnInferenceOptions(const SelfieSegmenter::NcnnInferenceOptions &options);
+
+	/**
+	 * @brief Returns the MainEffect shared by every filter instance, compiling it if no one holds it any more.
+	 *
+	 * The context keeps the effect weakly, so it lives as long as its last user. Must be called within the graphics
+	 * context. A reuse is logged with its own elapsed time next to the initial compile time.
+	 */
+	std::shared_ptr<const MainFilter::MainEffect> acquireMainEffect();
 
 	void checkForUpdates();
 
@@ -48,9 +92,20 @@ private:
 	const std::shared_ptr<const Logger::ILogger> logger_;
 	const std::string latestVersionUrl_;
 	const std::shared_ptr<PluginConfig> pluginConfig_;
+	const std::shared_ptr<SelfieSegmenter::NcnnModelRegistry> modelRegistry_;
+	const std::shared_ptr<SelfieSegmenter::InferenceScheduler> inferenceScheduler_;
+	const std::shared_ptr<ObsBridgeUtils::GsTexturePool> texturePool_;
+	const std::shared_ptr<TaskQueue::SharedWorkerPool> workerPool_;
+	const std::shared_ptr<TaskQueue::SharedWorkerPool> tuningWorkerPool_;
+	const std::optional<std::string> cpuModelName_;
 
 	mutable std::mutex mutex_;
 	CurlHelper::CurlHandle curl_;
+	SelfieSegmenter::NcnnInferenceOptions ncnnInferenceOptions_;
+
+	std::mutex mainEffectMutex_;
+	std::weak_ptr<const MainFilter::MainEffect> mainEffect_;
+	double mainEffectCreationMs_ = 0.0;
 
 	std::optional<std::string> latestVersion_{std::nullopt};
 	jthread_ns::jthread fetchLatestVersionThread_;
@@ -6,6 +6,7 @@
 
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 
 #include <KaitoTokyo/ObsBridgeUtils/ObsUnique.hpp>
 
@@ -16,6 +17,7 @@ namespace {
 constexpr auto kFirstRunOccurredFileName = "live-backgroundremoval-lite_PluginConfig_HasFirstRunOccurred.txt";
 constexpr auto kAutoCheckForUpdateDisabledFileName =
 	"live-backgroundremoval-lite_PluginConfig_AutoCheckForUpdateDisabled.txt";
+constexpr auto kNcnnInferenceOptionsFileNamePrefix = "live-backgroundremoval-lite_PluginConfig_NcnnInferenceOptions_";
 
 /**
  * @brief Converts an OBS path (C-style UTF-8 string) to a std::filesystem::path.
@@ -30,6 +32,23 @@ std::filesystem::path obsToPath(const char *obsPath)
 #endif
 }
 
+/**
+ * @brief Returns the file name that holds the tuning result of the CPU named @p cpuModelName.
+ *
+ * Characters that are not safe in file names on every platform are replaced, and the original name is kept on the
+ * first line of the file so that two CPUs whose names differ only there cannot share a result.
+ */
+std::string getNcnnInferenceOptionsFileName(const std::string &cpuModelName)
+{
+	std::string fileName = kNcnnInferenceOptionsFileNamePrefix;
+	for (const char c : cpuModelName) {
+		const bool isSafe = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+				    c == '-' || c == '.';
+		fileName += isSafe ? c : '_';
+	}
+	return fileName + ".txt";
+}
+
 } // anonymous namespace
 
 PluginConfig::~PluginConfig() noexcept = default;
@@ -99,6 +118,55 @@ bool PluginConfig::isAutoCheckForUpdateEnabled() const noexcept
 	return !disableAutoCheckForUpdate_;
 }
 
+std::optional<SelfieSegmenter::NcnnInferenceOptions>
+PluginConfig::loadNcnnInferenceOptions(const std::string &cpuModelName) const noexcept
+try {
+	const std::string fileName = getNcnnInferenceOptionsFileName(cpuModelName);
+	ObsBridgeUtils::unique_bfree_char_t configPathRaw(obs_module_config_path(fileName.c_str()));
+	if (!configPathRaw)
+		return std::nullopt;
+
+	std::ifstream ifs(obsToPath(configPathRaw.get()));
+	if (!ifs)
+		return std::nullopt;
+
+	std::string storedCpuModelName;
+	if (!std::getline(ifs, storedCpuModelName) || storedCpuModelName != cpuModelName)
+		return std::nullopt;
+
+	const std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	std::optional<SelfieSegmenter::NcnnInferenceOptions> options =
+		SelfieSegmenter::NcnnInferenceOptions::parse(text);
+	if (!options) {
+		logger_->warn("NcnnInferenceOptionsParseError", {{"configFile", fileName}});
+	}
+	return options;
+} catch (...) {
+	return std::nullopt;
+}
+
+void PluginConfig::saveNcnnInferenceOptions(const std::string &cpuModelName,
+					    const SelfieSegmenter::NcnnInferenceOptions &options)
+{
+	const std::string fileName = getNcnnInferenceOptionsFileName(cpuModelName);
+	ObsBridgeUtils::unique_bfree_char_t configPathRaw(obs_module_config_path(fileName.c_str()));
+
+	if (!configPathRaw) {
+		logger_->error("ModuleConfigPathError", {{"configFile", fileName}});
+		throw std::runtime_error("ModuleConfigPathError(PluginConfig::saveNcnnInferenceOptions)");
+	}
+
+	const std::filesystem::path path(obsToPath(configPathRaw.get()));
+	std::filesystem::create_directories(path.parent_path());
+
+	std::ofstream ofs(path, std::ios::trunc);
+	ofs << cpuModelName << '\n' << options.serialize();
+	ofs.close();
+	if (!ofs) {
+		throw std::runtime_error("FileWriteError(PluginConfig::saveNcnnInferenceOptions)");
+	}
+}
+
 PluginConfig::PluginConfig(std::shared_ptr<const Logger::ILogger> logger)
 	: logger_(logger ? std::move(logger)
 			 : throw std::invalid_argument("LoggerIsNullError(PluginConfig::PluginConfig)"))
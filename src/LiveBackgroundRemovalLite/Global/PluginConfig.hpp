@@ -6,8 +6,11 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
+#include <string>
 
 #include <KaitoTokyo/Logger/ILogger.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnInferenceOptions.hpp>
 
 namespace KaitoTokyo::LiveBackgroundRemovalLite::Global {
 
@@ -25,6 +28,22 @@ public:
 	void setAutoCheckForUpdateDisabled();
 	bool isAutoCheckForUpdateEnabled() const noexcept;
 
+	/**
+	 * @brief Reads the inference options tuned on the CPU named @p cpuModelName.
+	 *
+	 * @return std::nullopt if the CPU has not been tuned or its file cannot be read.
+	 */
+	std::optional<SelfieSegmenter::NcnnInferenceOptions>
+	loadNcnnInferenceOptions(const std::string &cpuModelName) const noexcept;
+
+	/**
+	 * @brief Stores @p options as the tuning result of the CPU named @p cpuModelName.
+	 *
+	 * @throw std::runtime_error If the file cannot be written.
+	 */
+	void saveNcnnInferenceOptions(const std::string &cpuModelName,
+				      const SelfieSegmenter::NcnnInferenceOptions &options);
+
 	static std::unique_ptr<PluginConfig> load(std::shared_ptr<const Logger::ILogger> logger);
 	static std::unique_ptr<PluginConfig> fallback(std::shared_ptr<const Logger::ILogger> logger);
 
@@ -29,10 +29,6 @@ const char *textureR32fSubPaddedSquaredMotion = "r32fSubPaddedSquaredMotion";
 const char *textureBgrxSegmenterInput = "bgrxSegmenterInput";
 const char *textureR8SegmentationMask = "r8SegmentationMask";
 const char *textureR32fSubGFSource = "r32fSubGFSource";
-const char *textureR32fSubGFMeanGuide = "r32fSubGFMeanGuide";
-const char *textureR32fSubGFMeanSource = "r32fSubGFMeanSource";
-const char *textureR32fSubGFMeanGuideSource = "r32fSubGFMeanGuideSource";
-const char *textureR32fSubGFMeanGuideSq = "r32fSubGFMeanGuideSq";
 const char *textureR32fSubGFA = "r32fSubGFA";
 const char *textureR32fSubGFB = "r32fSubGFB";
 const char *textureR8GuidedFilterResult = "r8GuidedFilterResult";
@@ -48,10 +44,6 @@ const std::vector<const char *> textureNames = {
 	textureBgrxSegmenterInput,
 	textureR8SegmentationMask,
 	textureR32fSubGFSource,
-	textureR32fSubGFMeanGuide,
-	textureR32fSubGFMeanSource,
-	textureR32fSubGFMeanGuideSource,
-	textureR32fSubGFMeanGuideSq,
 	textureR32fSubGFA,
 	textureR32fSubGFB,
 	textureR8GuidedFilterResult,
@@ -66,10 +58,8 @@ const std::vector<const char *> r32fTextures = {textureR32fLuma};
 const std::vector<const char *> bgrxSegmenterInputTextures = {textureBgrxSegmenterInput};
 const std::vector<const char *> r8MaskRoiTextures = {textureR8SegmentationMask};
 const std::vector<const char *> r32fSubPaddedTextures = {textureR32fSubPaddedSquaredMotion};
-const std::vector<const char *> r32fSubTextures = {
-	textureR32fSubLumas0,        textureR32fSubLumas1,       textureR32fSubGFSource,
-	textureR32fSubGFMeanGuide,   textureR32fSubGFMeanSource, textureR32fSubGFMeanGuideSource,
-	textureR32fSubGFMeanGuideSq, textureR32fSubGFA,          textureR32fSubGFB};
+const std::vector<const char *> r32fSubTextures = {textureR32fSubLumas0, textureR32fSubLumas1, textureR32fSubGFSource,
+						   textureR32fSubGFA, textureR32fSubGFB};
 
 } // namespace
 
@@ -82,6 +72,7 @@ DebugWindow::DebugWindow(std::weak_ptr<MainFilterContext> weakMainFilterContext,
 	  layout_(new QVBoxLayout(this)),
 	  previewTextureSelector_(new QComboBox(this)),
 	  previewImageLabel_(new QLabel(this)),
+	  statsLabel_(new QLabel(this)),
 	  updateTimer_(new QTimer(this))
 {
 	for (const auto &textureName : textureNames) {
@@ -98,6 +89,8 @@ DebugWindow::DebugWindow(std::weak_ptr<MainFilterContext> weakMainFilterContext,
 
 	layout_->addWidget(previewImageLabel_);
 
+	layout_->addWidget(statsLabel_);
+
 	setLayout(layout_);
 
 	connect(updateTimer_, &QTimer::timeout, this, &DebugWindow::updatePreview);
@@ -155,18 +148,6 @@ void DebugWindow::videoRender()
 		} else if (selectedPreviewTextureName == textureR32fSubGFSource) {
 			currentReader = r32fSubReader_;
 			currentTexture = renderingContext->r32fSubGFSource_.get();
-		} else if (selectedPreviewTextureName == textureR32fSubGFMeanGuide) {
-			currentReader = r32fSubReader_;
-			currentTexture = renderingContext->r32fSubGFMeanGuide_.get();
-		} else if (selectedPreviewTextureName == textureR32fSubGFMeanSource) {
-			currentReader = r32fSubReader_;
-			currentTexture = renderingContext->r32fSubGFMeanSource_.get();
-		} else if (selectedPreviewTextureName == textureR32fSubGFMeanGuideSource) {
-			currentReader = r32fSubReader_;
-			currentTexture = renderingContext->r32fSubGFMeanGuideSource_.get();
-		} else if (selectedPreviewTextureName == textureR32fSubGFMeanGuideSq) {
-			currentReader = r32fSubReader_;
-			currentTexture = renderingContext->r32fSubGFMeanGuideSq_.get();
 		} else if (selectedPreviewTextureName == textureR32fSubGFA) {
 			currentReader = r32fSubReader_;
 			currentTexture = renderingContext->r32fSubGFA_.get();
@@ -215,6 +196,37 @@ void DebugWindow::updatePreview()
 		return;
 	}
 
+	const auto inferenceStats = renderingContext->getInferenceStats();
+	QString statsText = QString("Segmentation mask age: %1 frames\n"
+				    "Inference latency: last %2 ms, mean %3 ms, max %4 ms\n"
+				    "Inference count: %5 processed, %6 dropped, %7 failed")
+				    .arg(renderingContext->getSegmentationMaskAge())
+				    .arg(inferenceStats.lastLatency.count() / 1000.0, 0, 'f', 1)
+				    .arg(inferenceStats.meanLatency.count() / 1000.0, 0, 'f', 1)
+				    .arg(inferenceStats.maxLatency.count() / 1000.0, 0, 'f', 1)
+				    .arg(inferenceStats.processedCount)
+				    .arg(inferenceStats.droppedCount)
+				    .arg(inferenceStats.failedCount);
+
+	// Durations in milliseconds over the last second, as p50 / p95 / p99
+	for (const auto &timing : renderingContext->getStageTimings()) {
+		if (timing.cpu.count == 0) {
+			continue;
+		}
+		statsText += QString("\n%1: CPU %2 / %3 / %4 ms")
+				     .arg(timing.name)
+				     .arg(timing.cpu.p50.count() / 1e6, 0, 'f', 2)
+				     .arg(timing.cpu.p95.count() / 1e6, 0, 'f', 2)
+				     .arg(timing.cpu.p99.count() / 1e6, 0, 'f', 2);
+		if (timing.gpu.count > 0) {
+			statsText += QString(", GPU %1 / %2 / %3 ms")
+					     .arg(timing.gpu.p50.count() / 1e6, 0, 'f', 2)
+					     .arg(timing.gpu.p95.count() / 1e6, 0, 'f', 2)
+					     .arg(timing.gpu.p99.count() / 1e6, 0, 'f', 2);
+		}
+	}
+	statsLabel_->setText(statsText);
+
 	std::shared_ptr<AsyncTextureReader> bgrxReader;
 	std::shared_ptr<AsyncTextureReader> r8Reader;
 	std::shared_ptr<AsyncTextureReader> r32fReader;
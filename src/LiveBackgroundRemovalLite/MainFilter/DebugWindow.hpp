@@ -41,6 +41,7 @@ private:
 	QVBoxLayout *layout_;
 	QComboBox *previewTextureSelector_;
 	QLabel *previewImageLabel_;
+	QLabel *statsLabel_;
 	QTimer *updateTimer_;
 
 	std::atomic<int> selectedPreviewTextureIndex_ = 0;
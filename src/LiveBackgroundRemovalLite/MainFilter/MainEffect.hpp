@@ -105,9 +105,9 @@ public:
 		  textureImage_(getEffectParam("image")),
 		  floatTexelWidth_(getEffectParam("texelWidth")),
 		  floatTexelHeight_(getEffectParam("texelHeight")),
+		  intKernelSize_(getEffectParam("kernelSize")),
 		  textureImage1_(getEffectParam("image1")),
 		  textureImage2_(getEffectParam("image2")),
-		  textureImage3_(getEffectParam("image3")),
 		  floatEps_(getEffectParam("eps")),
 		  floatGamma_(getEffectParam("gamma")),
 		  floatLowerBound_(getEffectParam("lowerBound")),
@@ -212,79 +212,30 @@ public:
 		}
 	}
 
-	void applyBoxFilterR8KS17(const ObsBridgeUtils::unique_gs_texture_t &targetTexture,
-				  const ObsBridgeUtils::unique_gs_texture_t &sourceTexture,
-				  const ObsBridgeUtils::unique_gs_texture_t &intermediateTexture) const noexcept
+	/**
+	 * @brief Box-filters I, p, I*p and I*I into the channels of one RGBA32F texture with a single pass pair.
+	 *
+	 * @param boxRadius The radius of the box, which spans 2 * boxRadius + 1 texels per axis.
+	 */
+	void applyGuidedFilterMeans(const ObsBridgeUtils::unique_gs_texture_t &targetTexture,
+				    const ObsBridgeUtils::unique_gs_texture_t &sourceGuideTexture,
+				    const ObsBridgeUtils::unique_gs_texture_t &sourceTexture,
+				    const ObsBridgeUtils::unique_gs_texture_t &intermediateTexture,
+				    const int boxRadius) const noexcept
 	{
-		{
-			TextureRenderGuard renderTargetGuard(intermediateTexture);
-
-			float texelWidth = 1.0f / static_cast<float>(gs_texture_get_width(sourceTexture.get()));
+		const int kernelSize = 2 * boxRadius + 1;
 
-			while (gs_effect_loop(gsEffect_.get(), "HorizontalBoxFilterR8KS17")) {
-				gs_effect_set_texture(textureImage_, sourceTexture.get());
-				gs_effect_set_float(floatTexelWidth_, texelWidth);
-				gs_draw_sprite(sourceTexture.get(), 0, 0u, 0u);
-			}
-		}
-
-		{
-			TextureRenderGuard renderTargetGuard(targetTexture);
-
-			float texelHeight = 1.0f / static_cast<float>(gs_texture_get_height(intermediateTexture.get()));
-
-			while (gs_effect_loop(gsEffect_.get(), "VerticalBoxFilterR8KS17")) {
-				gs_effect_set_texture(textureImage_, intermediateTexture.get());
-				gs_effect_set_float(floatTexelHeight_, texelHeight);
-				gs_draw_sprite(intermediateTexture.get(), 0, 0u, 0u);
-			}
-		}
-	}
-
-	void applyBoxFilterWithMulR8KS17(const ObsBridgeUtils::unique_gs_texture_t &targetTexture,
-					 const ObsBridgeUtils::unique_gs_texture_t &sourceTexture1,
-					 const ObsBridgeUtils::unique_gs_texture_t &sourceTexture2,
-					 const ObsBridgeUtils::unique_gs_texture_t &intermediateTexture) const noexcept
-	{
-		{
-			TextureRenderGuard renderTargetGuard(intermediateTexture);
-
-			float texelWidth = 1.0f / static_cast<float>(gs_texture_get_width(sourceTexture1.get()));
-
-			while (gs_effect_loop(gsEffect_.get(), "HorizontalBoxFilterWithMulR8KS17")) {
-				gs_effect_set_texture(textureImage_, sourceTexture1.get());
-				gs_effect_set_texture(textureImage1_, sourceTexture2.get());
-				gs_effect_set_float(floatTexelWidth_, texelWidth);
-				gs_draw_sprite(sourceTexture1.get(), 0, 0u, 0u);
-			}
-		}
-
-		{
-			TextureRenderGuard renderTargetGuard(targetTexture);
-
-			float texelHeight = 1.0f / static_cast<float>(gs_texture_get_height(intermediateTexture.get()));
-
-			while (gs_effect_loop(gsEffect_.get(), "VerticalBoxFilterR8KS17")) {
-				gs_effect_set_texture(textureImage_, intermediateTexture.get());
-				gs_effect_set_float(floatTexelHeight_, texelHeight);
-				gs_draw_sprite(intermediateTexture.get(), 0, 0u, 0u);
-			}
-		}
-	}
-
-	void applyBoxFilterWithSqR8KS17(const ObsBridgeUtils::unique_gs_texture_t &targetTexture,
-					const ObsBridgeUtils::unique_gs_texture_t &sourceTexture,
-					const ObsBridgeUtils::unique_gs_texture_t &intermediateTexture) const noexcept
-	{
 		{
 			TextureRenderGuard renderTargetGuard(intermediateTexture);
 
-			float texelWidth = 1.0f / static_cast<float>(gs_texture_get_width(sourceTexture.get()));
+			float texelWidth = 1.0f / static_cast<float>(gs_texture_get_width(sourceGuideTexture.get()));
 
-			while (gs_effect_loop(gsEffect_.get(), "HorizontalBoxFilterWithSqR8KS17")) {
-				gs_effect_set_texture(textureImage_, sourceTexture.get());
+			while (gs_effect_loop(gsEffect_.get(), "HorizontalBoxFilterGuidedFilterMeans")) {
+				gs_effect_set_texture(textureImage_, sourceGuideTexture.get());
+				gs_effect_set_texture(textureImage1_, sourceTexture.get());
 				gs_effect_set_float(floatTexelWidth_, texelWidth);
-				gs_draw_sprite(sourceTexture.get(), 0, 0u, 0u);
+				gs_effect_set_int(intKernelSize_, kernelSize);
+				gs_draw_sprite(sourceGuideTexture.get(), 0, 0u, 0u);
 			}
 		}
 
@@ -293,43 +244,37 @@ public:
 
 			float texelHeight = 1.0f / static_cast<float>(gs_texture_get_height(intermediateTexture.get()));
 
-			while (gs_effect_loop(gsEffect_.get(), "VerticalBoxFilterR8KS17")) {
+			while (gs_effect_loop(gsEffect_.get(), "VerticalBoxFilterRGBA32F")) {
 				gs_effect_set_texture(textureImage_, intermediateTexture.get());
 				gs_effect_set_float(floatTexelHeight_, texelHeight);
+				gs_effect_set_int(intKernelSize_, kernelSize);
 				gs_draw_sprite(intermediateTexture.get(), 0, 0u, 0u);
 			}
 		}
 	}
 
-	void calculateGuidedFilterAAndB(const ObsBridgeUtils::unique_gs_texture_t &targetATexture,
-					const ObsBridgeUtils::unique_gs_texture_t &targetBTexture,
-					const ObsBridgeUtils::unique_gs_texture_t &sourceMeanGuideSqTexture,
-					const ObsBridgeUtils::unique_gs_texture_t &sourceMeanGuideTexture,
-					const ObsBridgeUtils::unique_gs_texture_t &sourceMeanGuideSourceTexture,
-					const ObsBridgeUtils::unique_gs_texture_t &sourceMeanSourceTexture,
-					const float eps) const noexcept
+	void calculateGuidedFilterAAndBFromMeans(const ObsBridgeUtils::unique_gs_texture_t &targetATexture,
+						 const ObsBridgeUtils::unique_gs_texture_t &targetBTexture,
+						 const ObsBridgeUtils::unique_gs_texture_t &sourceMeansTexture,
+						 const float eps) const noexcept
 	{
 		{
 			TextureRenderGuard renderTargetGuard(targetATexture);
 
-			while (gs_effect_loop(gsEffect_.get(), "CalculateGuidedFilterA")) {
-				gs_effect_set_texture(textureImage_, sourceMeanGuideSqTexture.get());
-				gs_effect_set_texture(textureImage1_, sourceMeanGuideTexture.get());
-				gs_effect_set_texture(textureImage2_, sourceMeanGuideSourceTexture.get());
-				gs_effect_set_texture(textureImage3_, sourceMeanSourceTexture.get());
+			while (gs_effect_loop(gsEffect_.get(), "CalculateGuidedFilterAFromMeans")) {
+				gs_effect_set_texture(textureImage_, sourceMeansTexture.get());
 				gs_effect_set_float(floatEps_, eps);
 
-				gs_draw_sprite(sourceMeanGuideSqTexture.get(), 0, 0u, 0u);
+				gs_draw_sprite(sourceMeansTexture.get(), 0, 0u, 0u);
 			}
 		}
 
 		{
 			TextureRenderGuard renderTargetGuard(targetBTexture);
 
-			while (gs_effect_loop(gsEffect_.get(), "CalculateGuidedFilterB")) {
+			while (gs_effect_loop(gsEffect_.get(), "CalculateGuidedFilterBFromMeans")) {
 				gs_effect_set_texture(textureImage_, targetATexture.get());
-				gs_effect_set_texture(textureImage1_, sourceMeanSourceTexture.get());
-				gs_effect_set_texture(textureImage2_, sourceMeanGuideTexture.get());
+				gs_effect_set_texture(textureImage1_, sourceMeansTexture.get());
 
 				gs_draw_sprite(targetATexture.get(), 0, 0u, 0u);
 			}
@@ -484,10 +429,10 @@ public:
 
 	gs_eparam_t *const floatTexelWidth_ = nullptr;
 	gs_eparam_t *const floatTexelHeight_ = nullptr;
+	gs_eparam_t *const intKernelSize_ = nullptr;
 
 	gs_eparam_t *const textureImage1_ = nullptr;
 	gs_eparam_t *const textureImage2_ = nullptr;
-	gs_eparam_t *const textureImage3_ = nullptr;
 
 	gs_eparam_t *const floatEps_ = nullptr;
 	gs_eparam_t *const floatGamma_ = nullptr;
@@ -4,18 +4,25 @@
 
 #include "MainFilterContext.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <future>
 #include <stdexcept>
+#include <string>
 #include <thread>
+#include <utility>
 
 #include <QApplication>
 
 #include <obs-module.h>
 #include <obs-frontend-api.h>
 
+#include <KaitoTokyo/ObsBridgeUtils/GsTexturePool.hpp>
 #include <KaitoTokyo/ObsBridgeUtils/GsUnique.hpp>
 #include <KaitoTokyo/ObsBridgeUtils/ObsLogger.hpp>
 #include <KaitoTokyo/ObsBridgeUtils/ObsUnique.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnAutoTuner.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnSelfieSegmenter.hpp>
 
 #include <PluginConfigDialog.hpp>
 
@@ -23,11 +30,33 @@
 #include "RenderingContext.hpp"
 #include "TroubleshootDialog.hpp"
 
+extern "C" const unsigned char mediapipe_selfie_segmentation_landscape_int8_ncnn_bin[];
+extern "C" const unsigned int mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len;
+extern "C" const char mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text[];
+
 using namespace KaitoTokyo::Logger;
 using namespace KaitoTokyo::ObsBridgeUtils;
 
 namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter {
 
+namespace {
+
+// Enough inferences per trial for a stable median while the whole search stays within a few seconds
+constexpr int kNcnnTuningWarmupCount = 3;
+constexpr int kNcnnTuningIterationCount = 15;
+
+// Half of the cores at most, so that live inference keeps its share and the measured timings stay representative
+constexpr int kNcnnTuningMaxThreadCount = 4;
+
+// A newer build replaces a queued build of the same key
+constexpr auto kRenderingContextBuildTaskKey = "RenderingContextBuild";
+constexpr std::size_t kRenderingContextBuilderQueueSize = 2;
+
+// Pressing the tuning button again while a run is queued replaces that run
+constexpr std::size_t kNcnnTunerQueueSize = 1;
+
+} // anonymous namespace
+
 MainFilterContext::MainFilterContext(obs_data_t *settings, obs_source_t *source,
 				     std::shared_ptr<Global::PluginConfig> pluginConfig,
 				     std::shared_ptr<Global::GlobalContext> globalContext)
@@ -42,14 +71,36 @@ MainFilterContext::MainFilterContext(obs_data_t *settings, obs_source_t *source,
 	  logger_(globalContext_->getLogger()
 			  ? globalContext_->getLogger()
 			  : throw std::invalid_argument("LoggerIsNullError(MainFilterContext::MainFilterContext)")),
-	  mainEffect_(logger_, unique_obs_module_file("effects/main.effect")),
-	  selfieSegmenterTaskQueue_(logger_, 1)
+	  mainEffect_(globalContext_->acquireMainEffect()),
+	  renderingContextBuilder_(globalContext_->getWorkerPool()->createQueue("RenderingContextBuilder",
+										    kRenderingContextBuilderQueueSize)),
+	  ncnnTuner_(globalContext_->getTuningWorkerPool()->createQueue("NcnnTuner", kNcnnTunerQueueSize))
 {
 	update(settings);
 }
 
 void MainFilterContext::shutdown() noexcept
 {
+	// Tuning ends by requesting a build, so it stops first
+	ncnnTuner_->shutdown();
+	renderingContextBuilder_->shutdown();
+
+	try {
+		const TaskQueue::SharedWorkerPool::QueueStats builderStats = renderingContextBuilder_->getStats();
+		const auto toMilliseconds = [](std::chrono::nanoseconds duration) {
+			return std::to_string(std::chrono::duration<double, std::milli>(duration).count());
+		};
+		logger_->info("RenderingContextBuilderStats",
+			      {{"completedCount", std::to_string(builderStats.completedCount)},
+			       {"coalescedCount", std::to_string(builderStats.coalescedCount)},
+			       {"droppedCount", std::to_string(builderStats.droppedCount)},
+			       {"totalWaitMs", toMilliseconds(builderStats.totalWaitTime)},
+			       {"maxWaitMs", toMilliseconds(builderStats.maxWaitTime)},
+			       {"totalRunMs", toMilliseconds(builderStats.totalRunTime)}});
+	} catch (...) {
+		// Ignore
+	}
+
 	{
 		std::lock_guard<std::mutex> lock(debugWindowMutex_);
 		if (debugWindow_) {
@@ -65,7 +116,6 @@ void MainFilterContext::shutdown() noexcept
 		std::lock_guard<std::mutex> lock(renderingContextMutex_);
 		renderingContext_.reset();
 	}
-	selfieSegmenterTaskQueue_.shutdown();
 }
 
 MainFilterContext::~MainFilterContext() noexcept {}
@@ -96,6 +146,8 @@ void MainFilterContext::getDefaults(obs_data_t *data)
 	obs_data_set_default_bool(data, "advancedSettings", false);
 
 	obs_data_set_default_double(data, "guidedFilterEpsPowDb", defaultProperty.guidedFilterEpsPowDb);
+	obs_data_set_default_bool(data, "guidedFilterBoxRadiusAuto", defaultProperty.guidedFilterBoxRadiusAuto);
+	obs_data_set_default_int(data, "guidedFilterBoxRadius", defaultProperty.guidedFilterBoxRadius);
 
 	obs_data_set_default_int(data, "blurSize", defaultProperty.blurSize);
 
@@ -210,6 +262,18 @@ obs_properties_t *MainFilterContext::getProperties()
 	// Guided filter
 	obs_properties_add_float_slider(propsAdvancedSettings, "guidedFilterEpsPowDb",
 					obs_module_text("guidedFilterEpsPowDb"), -60.0, -20.0, 0.1);
+	obs_property_t *pGuidedFilterBoxRadiusAuto = obs_properties_add_bool(
+		propsAdvancedSettings, "guidedFilterBoxRadiusAuto", obs_module_text("guidedFilterBoxRadiusAuto"));
+	obs_property_set_modified_callback(
+		pGuidedFilterBoxRadiusAuto, [](obs_properties_t *props, obs_property_t *, obs_data_t *settings) {
+			// The slider only takes effect while the radius is not picked automatically
+			obs_property_set_enabled(obs_properties_get(props, "guidedFilterBoxRadius"),
+						 !obs_data_get_bool(settings, "guidedFilterBoxRadiusAuto"));
+			return true;
+		});
+	obs_properties_add_int_slider(propsAdvancedSettings, "guidedFilterBoxRadius",
+				      obs_module_text("guidedFilterBoxRadius"), kMinGuidedFilterBoxRadius,
+				      kMaxGuidedFilterBoxRadius, 1);
 
 	// Mask application
 	obs_properties_add_float_slider(propsAdvancedSettings, "maskGamma", obs_module_text("maskGamma"), 0.5, 3.0,
@@ -235,6 +299,23 @@ obs_properties_t *MainFilterContext::getProperties()
 		},
 		this);
 
+	// Inference tuning button
+	obs_properties_add_button2(
+		props, "tuneInference", obs_module_text("tuneInference"),
+		[](obs_properties_t *, obs_property_t *, void *data) {
+			auto this_ = static_cast<MainFilterContext *>(data);
+			try {
+				this_->ncnnTuner_->push(
+					[this_](const TaskQueue::SharedWorkerPool::CancellationToken &token) {
+						this_->tuneNcnnInference(token);
+					});
+			} catch (const std::exception &e) {
+				this_->logger_->error("NcnnTuningRequestError", {{"message", e.what()}});
+			}
+			return false;
+		},
+		this);
+
 	// Debug button
 	obs_properties_add_button2(
 		props, "showDebugWindow", obs_module_text("showDebugWindow"),
@@ -295,6 +376,9 @@ void MainFilterContext::update(obs_data_t *settings)
 	bool advancedSettingsEnabled = obs_data_get_bool(settings, "advancedSettings");
 	if (advancedSettingsEnabled) {
 		newPluginProperty.guidedFilterEpsPowDb = obs_data_get_double(settings, "guidedFilterEpsPowDb");
+		newPluginProperty.guidedFilterBoxRadiusAuto = obs_data_get_bool(settings, "guidedFilterBoxRadiusAuto");
+		newPluginProperty.guidedFilterBoxRadius =
+			static_cast<int>(obs_data_get_int(settings, "guidedFilterBoxRadius"));
 
 		newPluginProperty.maskGamma = obs_data_get_double(settings, "maskGamma");
 		newPluginProperty.maskLowerBoundAmpDb = obs_data_get_double(settings, "maskLowerBoundAmpDb");
@@ -316,13 +400,13 @@ void MainFilterContext::update(obs_data_t *settings)
 		pluginProperty_ = newPluginProperty;
 		renderingContext = renderingContext_;
 
+		// The current context keeps serving frames at the same size until the new one is swapped in
 		if (renderingContext && doesRenewRenderingContext) {
-			GraphicsContextGuard graphicsContextGuard;
-			std::shared_ptr<RenderingContext> newRenderingContext = createRenderingContext(
-				renderingContext->region_.width, renderingContext->region_.height, newBlurSize);
-			renderingContext_ = newRenderingContext;
-			renderingContext = newRenderingContext;
-			GsUnique::drain();
+			requestRenderingContext(
+				{renderingContext->region_.width, renderingContext->region_.height, newBlurSize});
+		} else if (pendingRenderingContextRequest_ && doesRenewRenderingContext) {
+			requestRenderingContext({pendingRenderingContextRequest_->width,
+						 pendingRenderingContextRequest_->height, newBlurSize});
 		}
 	}
 
@@ -333,29 +417,37 @@ void MainFilterContext::update(obs_data_t *settings)
 
 void MainFilterContext::activate()
 {
-	if (renderingContext_) {
-		renderingContext_->activate();
+	if (auto renderingContext = getRenderingContext()) {
+		renderingContext->activate();
 	}
 }
 
 void MainFilterContext::deactivate()
 {
-	if (renderingContext_) {
-		renderingContext_->deactivate();
+	if (auto renderingContext = getRenderingContext()) {
+		renderingContext->deactivate();
 	}
 }
 
 void MainFilterContext::show()
 {
-	if (renderingContext_) {
-		renderingContext_->show();
+	if (auto renderingContext = getRenderingContext()) {
+		renderingContext->show();
+		return;
+	}
+
+	// Shown before its context is ready, so the viewer is waiting on the build
+	std::lock_guard<std::mutex> lock(renderingContextMutex_);
+	if (pendingRenderingContextRequest_) {
+		requestRenderingContext(*pendingRenderingContextRequest_,
+					TaskQueue::SharedWorkerPool::Priority::Interactive);
 	}
 }
 
 void MainFilterContext::hide()
 {
-	if (renderingContext_) {
-		renderingContext_->hide();
+	if (auto renderingContext = getRenderingContext()) {
+		renderingContext->hide();
 	}
 }
 
@@ -385,6 +477,7 @@ void MainFilterContext::videoTick(float seconds)
 
 		if (targetWidth == 0 || targetHeight == 0) {
 			logger_->debug("TargetSourceHasZeroWidthOrHeight");
+			cancelRenderingContextRequest();
 			renderingContext_.reset();
 			return;
 		}
@@ -392,6 +485,7 @@ void MainFilterContext::videoTick(float seconds)
 		const std::uint32_t minSize = 2 * static_cast<std::uint32_t>(pluginProperty_.subsamplingRate);
 		if (targetWidth < minSize || targetHeight < minSize) {
 			logger_->debug("TargetSourceTooSmall");
+			cancelRenderingContextRequest();
 			renderingContext_.reset();
 			return;
 		}
@@ -399,10 +493,11 @@ void MainFilterContext::videoTick(float seconds)
 		renderingContext = renderingContext_;
 		if (!renderingContext || renderingContext->region_.width != targetWidth ||
 		    renderingContext->region_.height != targetHeight) {
-			GraphicsContextGuard graphicsContextGuard;
-			renderingContext_ = createRenderingContext(targetWidth, targetHeight, pluginProperty_.blurSize);
-			GsUnique::drain();
-			renderingContext = renderingContext_;
+			// A context of another size cannot serve this frame, so the source is passed through until the
+			// new context is swapped in
+			requestRenderingContext({targetWidth, targetHeight, pluginProperty_.blurSize});
+			renderingContext_.reset();
+			renderingContext.reset();
 		}
 	}
 
@@ -430,6 +525,10 @@ void MainFilterContext::videoRender()
 
 	if (auto _renderingContext = getRenderingContext()) {
 		_renderingContext->videoRender();
+	} else {
+		// No context exists before the first build or while one for a new size is built, so the source is shown
+		// as it is meanwhile
+		obs_source_skip_video_filter(source_);
 	}
 
 	{
@@ -441,17 +540,154 @@ void MainFilterContext::videoRender()
 	}
 }
 
-std::shared_ptr<RenderingContext> MainFilterContext::createRenderingContext(std::uint32_t targetWidth,
-									    std::uint32_t targetHeight, int blurSize)
+void MainFilterContext::requestRenderingContext(const RenderingContextRequest &request,
+						TaskQueue::SharedWorkerPool::Priority priority)
+{
+	const bool isPending = pendingRenderingContextRequest_ == request;
+	if (isPending && priority == TaskQueue::SharedWorkerPool::Priority::Normal) {
+		return;
+	}
+
+	// Re-requesting the pending build keeps its id, so that a build of it already running is still accepted
+	const std::uint64_t requestId = isPending ? renderingContextRequestId_ : ++renderingContextRequestId_;
+	pendingRenderingContextRequest_ = request;
+	renderingContextBuilder_->push(
+		kRenderingContextBuildTaskKey,
+		[this, requestId, request, pluginProperty = pluginProperty_](
+			const TaskQueue::SharedWorkerPool::CancellationToken &token) {
+			buildRenderingContext(requestId, request, pluginProperty, token);
+		},
+		priority);
+}
+
+void MainFilterContext::cancelRenderingContextRequest() noexcept
+{
+	++renderingContextRequestId_;
+	pendingRenderingContextRequest_.reset();
+}
+
+void MainFilterContext::buildRenderingContext(std::uint64_t requestId, const RenderingContextRequest &request,
+					      const PluginProperty &pluginProperty,
+					      const TaskQueue::SharedWorkerPool::CancellationToken &token)
+try {
+	{
+		std::lock_guard<std::mutex> lock(renderingContextMutex_);
+		if (requestId != renderingContextRequestId_ || !pendingRenderingContextRequest_) {
+			// Superseded, or served by an earlier push of the same request
+			return;
+		}
+	}
+
+	const auto buildStartTime = std::chrono::steady_clock::now();
+	const SelfieSegmenter::NcnnInferenceOptions inferenceOptions = globalContext_->getNcnnInferenceOptions();
+
+	// Loading the model and setting up the segmenter are the CPU-heavy part and run without the graphics context
+	std::shared_ptr<const ncnn::Net> selfieSegmenterNet = globalContext_->getModelRegistry()->acquire(
+		"mediapipe_selfie_segmentation_landscape_int8", mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text,
+		static_cast<int>(mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len),
+		mediapipe_selfie_segmentation_landscape_int8_ncnn_bin, inferenceOptions);
+	auto selfieSegmenter = std::make_shared<KaitoTokyo::SelfieSegmenter::NcnnSelfieSegmenter>(
+		std::move(selfieSegmenterNet), inferenceOptions.numThreads);
+	if (token->load()) {
+		return;
+	}
+
+	// The render thread waits for the graphics context only while the textures are created
+	std::shared_ptr<RenderingContext> renderingContext;
+	std::chrono::steady_clock::duration graphicsHeldDuration;
+	{
+		GraphicsContextGuard graphicsContextGuard;
+		const auto graphicsStartTime = std::chrono::steady_clock::now();
+		renderingContext = std::make_shared<RenderingContext>(
+			source_, logger_, *mainEffect_, *globalContext_->getInferenceScheduler(), pluginConfig_,
+			globalContext_->getTexturePool(), std::move(selfieSegmenter), pluginProperty.subsamplingRate,
+			request.width, request.height, inferenceOptions.numThreads, request.blurSize);
+		graphicsHeldDuration = std::chrono::steady_clock::now() - graphicsStartTime;
+	}
+	const auto buildEndTime = std::chrono::steady_clock::now();
+
+	std::shared_ptr<RenderingContext> replacedRenderingContext;
+	{
+		std::lock_guard<std::mutex> lock(renderingContextMutex_);
+		if (token->load() || requestId != renderingContextRequestId_) {
+			logger_->debug("RenderingContextBuildDiscarded");
+			replacedRenderingContext = std::move(renderingContext);
+		} else {
+			// The latest properties rather than those at request time, as update may have run meanwhile
+			renderingContext->applyPluginProperty(pluginProperty_);
+			// A rebuild at the same size starts from the current masks rather than from passthrough
+			renderingContext->inheritSegmentationMask(renderingContext_);
+			replacedRenderingContext = std::exchange(renderingContext_, renderingContext);
+			pendingRenderingContextRequest_.reset();
+		}
+	}
+	if (!renderingContext) {
+		return;
+	}
+
+	const auto toMilliseconds = [](std::chrono::steady_clock::duration duration) {
+		return std::to_string(std::chrono::duration<double, std::milli>(duration).count());
+	};
+	logger_->info("RenderingContextBuilt", {{"width", std::to_string(request.width)},
+						{"height", std::to_string(request.height)},
+						{"blurSize", std::to_string(request.blurSize)},
+						{"buildMs", toMilliseconds(buildEndTime - buildStartTime)},
+						{"graphicsBlockedMs", toMilliseconds(graphicsHeldDuration)}});
+
+	const GsTexturePool::Stats texturePoolStats = globalContext_->getTexturePool()->getStats();
+	logger_->info("TexturePoolStats", {{"hitCount", std::to_string(texturePoolStats.hitCount)},
+					   {"missCount", std::to_string(texturePoolStats.missCount)},
+					   {"evictedCount", std::to_string(texturePoolStats.evictedCount)},
+					   {"idleBytes", std::to_string(texturePoolStats.idleBytes)}});
+} catch (const std::exception &e) {
+	logger_->error("RenderingContextBuildError", {{"message", e.what()}});
+	forgetRenderingContextRequest(requestId);
+} catch (...) {
+	logger_->error("RenderingContextBuildError");
+	forgetRenderingContextRequest(requestId);
+}
+
+void MainFilterContext::forgetRenderingContextRequest(std::uint64_t requestId) noexcept
+{
+	// Clearing the pending request lets the next video tick retry the build
+	std::lock_guard<std::mutex> lock(renderingContextMutex_);
+	if (requestId == renderingContextRequestId_) {
+		pendingRenderingContextRequest_.reset();
+	}
+}
+
+void MainFilterContext::tuneNcnnInference(const TaskQueue::SharedWorkerPool::CancellationToken &token)
 {
-	auto renderingContext = std::make_shared<RenderingContext>(source_, logger_, mainEffect_,
-								   selfieSegmenterTaskQueue_, pluginConfig_,
-								   pluginProperty_.subsamplingRate, targetWidth,
-								   targetHeight, pluginProperty_.numThreads, blurSize);
+	const int maxNumThreads =
+		std::clamp(static_cast<int>(std::thread::hardware_concurrency()) / 2, 1, kNcnnTuningMaxThreadCount);
+	const SelfieSegmenter::NcnnAutoTuner tuner(logger_, maxNumThreads);
+	const SelfieSegmenter::NcnnAutoTuner::Result result = tuner.tune(
+		mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text,
+		static_cast<int>(mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len),
+		mediapipe_selfie_segmentation_landscape_int8_ncnn_bin, kNcnnTuningWarmupCount,
+		kNcnnTuningIterationCount, token.get());
+	if (token->load()) {
+		return;
+	}
 
-	renderingContext->applyPluginProperty(pluginProperty_);
+	try {
+		globalContext_->setNcnnInferenceOptions(result.bestOptions);
+	} catch (const std::exception &e) {
+		// The options are already in effect for this session even if saving them failed
+		logger_->error("NcnnInferenceOptionsSaveError", {{"message", e.what()}});
+	}
 
-	return renderingContext;
+	// The latest wanted context is requested again so that it is built with the tuned options
+	std::lock_guard<std::mutex> lock(renderingContextMutex_);
+	std::optional<RenderingContextRequest> request = pendingRenderingContextRequest_;
+	if (!request && renderingContext_) {
+		request = RenderingContextRequest{renderingContext_->region_.width, renderingContext_->region_.height,
+						  pluginProperty_.blurSize};
+	}
+	cancelRenderingContextRequest();
+	if (request) {
+		requestRenderingContext(*request);
+	}
 }
 
 } // namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter
@@ -9,12 +9,14 @@
 #include <obs.h>
 
 #include <atomic>
+#include <cstdint>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 #include <KaitoTokyo/Logger/ILogger.hpp>
-#include <KaitoTokyo/TaskQueue/ThrottledTaskQueue.hpp>
+#include <KaitoTokyo/TaskQueue/SharedWorkerPool.hpp>
 
 #include <GlobalContext.hpp>
 #include <PluginConfig.hpp>
@@ -65,8 +67,51 @@ public:
 	}
 
 private:
-	std::shared_ptr<RenderingContext> createRenderingContext(std::uint32_t targetWidth, std::uint32_t targetHeight,
-								 int blurSize);
+	struct RenderingContextRequest {
+		std::uint32_t width;
+		std::uint32_t height;
+		int blurSize;
+
+		bool operator==(const RenderingContextRequest &) const noexcept = default;
+	};
+
+	/**
+	 * @brief Queues a build of a rendering context for @p request unless the same one is already pending.
+	 *
+	 * An Interactive request for the pending one queues it again ahead of the builder's normal work, without
+	 * discarding a build of it that is already running.
+	 *
+	 * The caller must hold renderingContextMutex_.
+	 */
+	void requestRenderingContext(
+		const RenderingContextRequest &request,
+		TaskQueue::SharedWorkerPool::Priority priority = TaskQueue::SharedWorkerPool::Priority::Normal);
+
+	/**
+	 * @brief Makes any pending or running build discard its result.
+	 *
+	 * The caller must hold renderingContextMutex_.
+	 */
+	void cancelRenderingContextRequest() noexcept;
+
+	/**
+	 * @brief Builds a rendering context on the builder thread and swaps it in if it is still the latest request.
+	 */
+	void buildRenderingContext(std::uint64_t requestId, const RenderingContextRequest &request,
+				   const PluginProperty &pluginProperty,
+				   const TaskQueue::SharedWorkerPool::CancellationToken &token);
+
+	/**
+	 * @brief Drops the pending request @p requestId after its build failed so that the next video tick retries it.
+	 */
+	void forgetRenderingContextRequest(std::uint64_t requestId) noexcept;
+
+	/**
+	 * @brief Benchmarks the ncnn inference options on the tuner queue, stores the fastest for this CPU and
+	 * rebuilds the rendering context with them.
+	 */
+	void tuneNcnnInference(const TaskQueue::SharedWorkerPool::CancellationToken &token);
+
 	void applyPluginProperty(const std::shared_ptr<RenderingContext> &_renderingContext);
 
 	obs_source_t *const source_;
@@ -75,16 +120,24 @@ private:
 
 	const std::shared_ptr<const Logger::ILogger> logger_;
 
-	const MainEffect mainEffect_;
-	TaskQueue::ThrottledTaskQueue selfieSegmenterTaskQueue_;
+	// Shared by every filter instance through the GlobalContext so that the effect is loaded once per process
+	const std::shared_ptr<const MainEffect> mainEffect_;
 
 	PluginProperty pluginProperty_;
 
 	mutable std::mutex renderingContextMutex_;
 	std::shared_ptr<RenderingContext> renderingContext_ = nullptr;
+	std::uint64_t renderingContextRequestId_ = 0;
+	std::optional<RenderingContextRequest> pendingRenderingContextRequest_;
 
 	DebugWindow *debugWindow_ = nullptr;
 	mutable std::mutex debugWindowMutex_;
+
+	// Declared last so that a running build finishes before anything it touches is destroyed
+	const std::shared_ptr<TaskQueue::SharedWorkerPool::Queue> renderingContextBuilder_;
+	// On the tuning worker pool so that a tuning run of several seconds never holds a worker that builds wait for.
+	// Declared after the builder because tuning requests a build when it finishes.
+	const std::shared_ptr<TaskQueue::SharedWorkerPool::Queue> ncnnTuner_;
 };
 
 } // namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter
@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
 namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter {
 
 enum class FilterLevel : int {
@@ -15,8 +19,22 @@ enum class FilterLevel : int {
 	TimeAveragedFilter = 500,
 };
 
+constexpr int kMinGuidedFilterBoxRadius = 5;
+constexpr int kMaxGuidedFilterBoxRadius = 33;
+
+/**
+ * @brief Returns the guided filter box radius for a subsampled frame of @p subHeight rows.
+ *
+ * The radius scales with the frame so that the box covers the same share of it, starting from 8 at 1080p with
+ * subsampling 4.
+ */
+inline int getAutoGuidedFilterBoxRadius(std::uint32_t subHeight) noexcept
+{
+	const auto radius = static_cast<int>(std::lround(8.0 * static_cast<double>(subHeight) / 270.0));
+	return std::clamp(radius, kMinGuidedFilterBoxRadius, kMaxGuidedFilterBoxRadius);
+}
+
 struct PluginProperty {
-	int numThreads = 1;
 	int subsamplingRate = 4;
 
 	FilterLevel filterLevel = FilterLevel::Default;
@@ -24,6 +42,10 @@ struct PluginProperty {
 	double motionIntensityThresholdPowDb = -40.0;
 
 	double guidedFilterEpsPowDb = -40.0;
+	/// Picks the radius from the frame size and ignores guidedFilterBoxRadius.
+	bool guidedFilterBoxRadiusAuto = true;
+	/// Clamped to [kMinGuidedFilterBoxRadius, kMaxGuidedFilterBoxRadius].
+	int guidedFilterBoxRadius = 8;
 
 	double timeAveragedFilteringAlpha = 0.25;
 
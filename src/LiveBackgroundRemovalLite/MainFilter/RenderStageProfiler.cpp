@@ -0,0 +1,287 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "RenderStageProfiler.hpp"
+
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter {
+
+const char *getRenderStageName(RenderStage stage) noexcept
+{
+	switch (stage) {
+	case RenderStage::DrawSource:
+		return "drawSource";
+	case RenderStage::SegmenterInput:
+		return "segmenterInput";
+	case RenderStage::MotionReduction:
+		return "motionReduction";
+	case RenderStage::MotionReadback:
+		return "motionReadback";
+	case RenderStage::DualKawaseBlur:
+		return "dualKawaseBlur";
+	case RenderStage::ReadbackSync:
+		return "readbackSync";
+	case RenderStage::GuidedFilter:
+		return "guidedFilter";
+	case RenderStage::TimeAveragedFilter:
+		return "timeAveragedFilter";
+	case RenderStage::MaskUpload:
+		return "maskUpload";
+	case RenderStage::FinalDraw:
+		return "finalDraw";
+	}
+	return "unknown";
+}
+
+#ifdef LIVE_BACKGROUND_REMOVAL_LITE_ENABLE_STAGE_PROFILING
+
+namespace {
+
+std::string formatMicroseconds(std::chrono::nanoseconds duration)
+{
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%.1f", static_cast<double>(duration.count()) / 1000.0);
+	return buffer;
+}
+
+} // anonymous namespace
+
+RenderStageProfiler::FrameScope::FrameScope(RenderStageProfiler &profiler) noexcept : profiler_(profiler)
+{
+	profiler_.beginFrame();
+}
+
+RenderStageProfiler::FrameScope::~FrameScope() noexcept
+{
+	profiler_.endFrame();
+}
+
+RenderStageProfiler::StageScope::StageScope(RenderStageProfiler &profiler, RenderStage stage, bool measuresGpu) noexcept
+	: profiler_(profiler),
+	  stageIndex_(static_cast<std::size_t>(stage)),
+	  gpuTimer_(measuresGpu ? profiler.beginGpuStage(stageIndex_) : nullptr),
+	  start_(std::chrono::steady_clock::now())
+{
+}
+
+RenderStageProfiler::StageScope::~StageScope() noexcept
+{
+	const auto end = std::chrono::steady_clock::now();
+	if (gpuTimer_) {
+		gs_timer_end(gpuTimer_);
+	}
+	profiler_.cpuDurations_[stageIndex_].record(end - start_);
+}
+
+RenderStageProfiler::RenderStageProfiler(std::shared_ptr<const Logger::ILogger> logger,
+					 const Profiling::LatencyHistogram *inferenceDurations)
+	: logger_(logger ? std::move(logger)
+			 : throw std::invalid_argument("LoggerIsNullError(RenderStageProfiler::RenderStageProfiler)")),
+	  inferenceDurations_(inferenceDurations),
+	  windowStart_(std::chrono::steady_clock::now()),
+	  logStart_(windowStart_),
+	  windowStartSnapshots_(std::make_unique<Snapshots>()),
+	  logStartSnapshots_(std::make_unique<Snapshots>())
+{
+	// Timer queries are optional in libobs; without them only the CPU side is measured
+	try {
+		for (GpuFrame &frame : gpuFrames_) {
+			frame.range = ObsBridgeUtils::make_unique_gs_timer_range();
+			for (auto &timer : frame.timers) {
+				timer = ObsBridgeUtils::make_unique_gs_timer();
+			}
+		}
+		isGpuTimingAvailable_ = true;
+	} catch (const std::exception &e) {
+		logger_->warn("GpuStageTimingUnavailable", {{"message", e.what()}});
+	}
+
+	takeSnapshots(*windowStartSnapshots_);
+	*logStartSnapshots_ = *windowStartSnapshots_;
+}
+
+RenderStageProfiler::~RenderStageProfiler() noexcept = default;
+
+std::vector<RenderStageTiming> RenderStageProfiler::getStageTimings() const
+{
+	std::lock_guard<std::mutex> lock(stageTimingsMutex_);
+	return stageTimings_;
+}
+
+void RenderStageProfiler::beginFrame() noexcept
+{
+	if (!isGpuTimingAvailable_) {
+		return;
+	}
+
+	// The slot about to be reused was issued kGpuFramesInFlight frames ago, so its queries are normally done
+	GpuFrame &frame = gpuFrames_[currentGpuFrame_];
+	collectGpuFrame(frame);
+
+	frame.usedStages = 0;
+	gs_timer_range_begin(frame.range.get());
+	isGpuFrameActive_ = true;
+}
+
+void RenderStageProfiler::endFrame() noexcept
+{
+	if (isGpuFrameActive_) {
+		GpuFrame &frame = gpuFrames_[currentGpuFrame_];
+		gs_timer_range_end(frame.range.get());
+		frame.pending = true;
+		currentGpuFrame_ = (currentGpuFrame_ + 1) % kGpuFramesInFlight;
+		isGpuFrameActive_ = false;
+	}
+
+	publishIfDue();
+}
+
+gs_timer_t *RenderStageProfiler::beginGpuStage(std::size_t stageIndex) noexcept
+{
+	if (!isGpuFrameActive_) {
+		return nullptr;
+	}
+
+	// A stage that runs twice in a frame is only timed on the GPU the first time
+	GpuFrame &frame = gpuFrames_[currentGpuFrame_];
+	const std::uint32_t stageBit = std::uint32_t{1} << stageIndex;
+	if ((frame.usedStages & stageBit) != 0) {
+		return nullptr;
+	}
+	frame.usedStages |= stageBit;
+
+	gs_timer_t *timer = frame.timers[stageIndex].get();
+	gs_timer_begin(timer);
+	return timer;
+}
+
+void RenderStageProfiler::collectGpuFrame(GpuFrame &frame) noexcept
+{
+	if (!frame.pending) {
+		return;
+	}
+	frame.pending = false;
+
+	// Results that are still not ready, or whose clock was disjoint, are dropped rather than waited for
+	bool disjoint = true;
+	std::uint64_t frequency = 0;
+	if (!gs_timer_range_get_data(frame.range.get(), &disjoint, &frequency) || disjoint || frequency == 0) {
+		return;
+	}
+
+	for (std::size_t i = 0; i < kRenderStageCount; ++i) {
+		if ((frame.usedStages & (std::uint32_t{1} << i)) == 0) {
+			continue;
+		}
+
+		std::uint64_t ticks = 0;
+		if (gs_timer_get_data(frame.timers[i].get(), &ticks)) {
+			const double nanoseconds = static_cast<double>(ticks) * 1e9 / static_cast<double>(frequency);
+			gpuDurations_[i].record(std::chrono::nanoseconds(static_cast<std::int64_t>(nanoseconds)));
+		}
+	}
+}
+
+void RenderStageProfiler::publishIfDue() noexcept
+{
+	const auto now = std::chrono::steady_clock::now();
+	if (now - windowStart_ < kWindowInterval) {
+		return;
+	}
+
+	try {
+		auto current = std::make_unique<Snapshots>();
+		takeSnapshots(*current);
+
+		std::vector<RenderStageTiming> timings = summarize(*current, *windowStartSnapshots_);
+		{
+			std::lock_guard<std::mutex> lock(stageTimingsMutex_);
+			stageTimings_ = std::move(timings);
+		}
+		windowStart_ = now;
+
+		if (now - logStart_ >= kLogInterval) {
+			logTimings(summarize(*current, *logStartSnapshots_));
+			*logStartSnapshots_ = *current;
+			logStart_ = now;
+		}
+
+		windowStartSnapshots_ = std::move(current);
+	} catch (const std::exception &e) {
+		logger_->error("StageTimingPublishError", {{"message", e.what()}});
+	}
+}
+
+void RenderStageProfiler::takeSnapshots(Snapshots &snapshots) const noexcept
+{
+	for (std::size_t i = 0; i < kRenderStageCount; ++i) {
+		snapshots.cpu[i] = cpuDurations_[i].snapshot();
+		snapshots.gpu[i] = gpuDurations_[i].snapshot();
+	}
+	if (inferenceDurations_) {
+		snapshots.inference = inferenceDurations_->snapshot();
+	}
+}
+
+std::vector<RenderStageTiming> RenderStageProfiler::summarize(const Snapshots &newer, const Snapshots &older) const
+{
+	std::vector<RenderStageTiming> timings;
+	timings.reserve(kRenderStageCount + 1);
+
+	for (std::size_t i = 0; i < kRenderStageCount; ++i) {
+		timings.push_back({getRenderStageName(static_cast<RenderStage>(i)), (newer.cpu[i] - older.cpu[i]).summarize(),
+				   (newer.gpu[i] - older.gpu[i]).summarize()});
+	}
+
+	// Inference runs on the scheduler's workers, so it has a wall-clock duration but no GPU side
+	if (inferenceDurations_) {
+		timings.push_back({"inference", (newer.inference - older.inference).summarize(), {}});
+	}
+
+	return timings;
+}
+
+void RenderStageProfiler::logTimings(const std::vector<RenderStageTiming> &timings) const
+{
+	for (const RenderStageTiming &timing : timings) {
+		if (timing.cpu.count == 0) {
+			continue;
+		}
+
+		const std::string samples = std::to_string(timing.cpu.count);
+		const std::string cpuP50 = formatMicroseconds(timing.cpu.p50);
+		const std::string cpuP95 = formatMicroseconds(timing.cpu.p95);
+		const std::string cpuP99 = formatMicroseconds(timing.cpu.p99);
+
+		if (timing.gpu.count == 0) {
+			logger_->info("RenderStageTiming", {{"stage", timing.name},
+							    {"samples", samples},
+							    {"cpuP50Us", cpuP50},
+							    {"cpuP95Us", cpuP95},
+							    {"cpuP99Us", cpuP99}});
+			continue;
+		}
+
+		const std::string gpuP50 = formatMicroseconds(timing.gpu.p50);
+		const std::string gpuP95 = formatMicroseconds(timing.gpu.p95);
+		const std::string gpuP99 = formatMicroseconds(timing.gpu.p99);
+		logger_->info("RenderStageTiming", {{"stage", timing.name},
+						    {"samples", samples},
+						    {"cpuP50Us", cpuP50},
+						    {"cpuP95Us", cpuP95},
+						    {"cpuP99Us", cpuP99},
+						    {"gpuP50Us", gpuP50},
+						    {"gpuP95Us", gpuP95},
+						    {"gpuP99Us", gpuP99}});
+	}
+}
+
+#endif // LIVE_BACKGROUND_REMOVAL_LITE_ENABLE_STAGE_PROFILING
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter
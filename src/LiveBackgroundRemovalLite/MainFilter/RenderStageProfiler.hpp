@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <KaitoTokyo/Logger/ILogger.hpp>
+#include <KaitoTokyo/ObsBridgeUtils/GsUnique.hpp>
+#include <KaitoTokyo/Profiling/LatencyHistogram.hpp>
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter {
+
+/**
+ * @brief The parts of RenderingContext::videoRender that are timed separately.
+ */
+enum class RenderStage : std::size_t {
+	DrawSource,
+	SegmenterInput,
+	MotionReduction,
+	/// Waiting for the 1x1 result of MotionReduction.
+	MotionReadback,
+	DualKawaseBlur,
+	/// Waiting for the segmenter input to be read back.
+	ReadbackSync,
+	GuidedFilter,
+	TimeAveragedFilter,
+	MaskUpload,
+	FinalDraw,
+};
+
+constexpr std::size_t kRenderStageCount = static_cast<std::size_t>(RenderStage::FinalDraw) + 1;
+
+const char *getRenderStageName(RenderStage stage) noexcept;
+
+/**
+ * @brief Percentiles of one stage over the last profiling window.
+ *
+ * The GPU summary is empty for stages that only run on the CPU and when the renderer has no timer queries.
+ */
+struct RenderStageTiming {
+	const char *name;
+	Profiling::LatencySummary cpu;
+	Profiling::LatencySummary gpu;
+};
+
+#ifdef LIVE_BACKGROUND_REMOVAL_LITE_ENABLE_STAGE_PROFILING
+
+/**
+ * @brief Times the stages of one RenderingContext on the CPU and, where libobs has timer queries, on the GPU.
+ *
+ * Everything except getStageTimings must be called on the graphics thread. GPU results are read
+ * kGpuFramesInFlight frames after they were issued so that collecting them never stalls the pipeline.
+ * Once per kWindowInterval the samples of the elapsed window are summarized for getStageTimings, and once per
+ * kLogInterval the samples since the previous log are written to the log.
+ */
+class RenderStageProfiler {
+public:
+	/**
+	 * @brief Brackets one call to videoRender. Stages are only timed on the GPU inside a frame scope.
+	 */
+	class FrameScope {
+	public:
+		explicit FrameScope(RenderStageProfiler &profiler) noexcept;
+		~FrameScope() noexcept;
+
+		FrameScope(const FrameScope &) = delete;
+		FrameScope &operator=(const FrameScope &) = delete;
+		FrameScope(FrameScope &&) = delete;
+		FrameScope &operator=(FrameScope &&) = delete;
+
+	private:
+		RenderStageProfiler &profiler_;
+	};
+
+	/**
+	 * @brief Times one stage from its construction to its destruction.
+	 */
+	class StageScope {
+	public:
+		StageScope(RenderStageProfiler &profiler, RenderStage stage, bool measuresGpu) noexcept;
+		~StageScope() noexcept;
+
+		StageScope(const StageScope &) = delete;
+		StageScope &operator=(const StageScope &) = delete;
+		StageScope(StageScope &&) = delete;
+		StageScope &operator=(StageScope &&) = delete;
+
+	private:
+		RenderStageProfiler &profiler_;
+		const std::size_t stageIndex_;
+		gs_timer_t *const gpuTimer_;
+		const std::chrono::steady_clock::time_point start_;
+	};
+
+	constexpr static std::size_t kGpuFramesInFlight = 4;
+	constexpr static std::chrono::seconds kWindowInterval{1};
+	constexpr static std::chrono::seconds kLogInterval{60};
+
+	/**
+	 * @param logger The logger that receives the periodic timing summaries.
+	 * @param inferenceDurations Durations of the inference runs, reported alongside the stages. May be null.
+	 */
+	RenderStageProfiler(std::shared_ptr<const Logger::ILogger> logger,
+			    const Profiling::LatencyHistogram *inferenceDurations);
+	~RenderStageProfiler() noexcept;
+
+	RenderStageProfiler(const RenderStageProfiler &) = delete;
+	RenderStageProfiler &operator=(const RenderStageProfiler &) = delete;
+	RenderStageProfiler(RenderStageProfiler &&) = delete;
+	RenderStageProfiler &operator=(RenderStageProfiler &&) = delete;
+
+	[[nodiscard]]
+	FrameScope measureFrame() noexcept
+	{
+		return FrameScope(*this);
+	}
+
+	/**
+	 * @brief Times a stage that issues GPU work on both the CPU and the GPU.
+	 */
+	[[nodiscard]]
+	StageScope measure(RenderStage stage) noexcept
+	{
+		return StageScope(*this, stage, true);
+	}
+
+	/**
+	 * @brief Times a stage on the CPU only, e.g. a wait for a readback.
+	 */
+	[[nodiscard]]
+	StageScope measureCpu(RenderStage stage) noexcept
+	{
+		return StageScope(*this, stage, false);
+	}
+
+	/**
+	 * @brief Returns the timings of the last complete window. Safe to call from any thread.
+	 */
+	std::vector<RenderStageTiming> getStageTimings() const;
+
+private:
+	struct GpuFrame {
+		ObsBridgeUtils::unique_gs_timer_range_t range;
+		std::array<ObsBridgeUtils::unique_gs_timer_t, kRenderStageCount> timers;
+		std::uint32_t usedStages = 0;
+		bool pending = false;
+	};
+
+	struct Snapshots {
+		std::array<Profiling::LatencyHistogram::Snapshot, kRenderStageCount> cpu;
+		std::array<Profiling::LatencyHistogram::Snapshot, kRenderStageCount> gpu;
+		Profiling::LatencyHistogram::Snapshot inference;
+	};
+
+	void beginFrame() noexcept;
+	void endFrame() noexcept;
+	gs_timer_t *beginGpuStage(std::size_t stageIndex) noexcept;
+	void collectGpuFrame(GpuFrame &frame) noexcept;
+	void publishIfDue() noexcept;
+
+	void takeSnapshots(Snapshots &snapshots) const noexcept;
+	std::vector<RenderStageTiming> summarize(const Snapshots &newer, const Snapshots &older) const;
+	void logTimings(const std::vector<RenderStageTiming> &timings) const;
+
+	const std::shared_ptr<const Logger::ILogger> logger_;
+	const Profiling::LatencyHistogram *const inferenceDurations_;
+
+	std::array<Profiling::LatencyHistogram, kRenderStageCount> cpuDurations_;
+	std::array<Profiling::LatencyHistogram, kRenderStageCount> gpuDurations_;
+
+	std::array<GpuFrame, kGpuFramesInFlight> gpuFrames_;
+	std::size_t currentGpuFrame_ = 0;
+	bool isGpuTimingAvailable_ = false;
+	bool isGpuFrameActive_ = false;
+
+	std::chrono::steady_clock::time_point windowStart_;
+	std::chrono::steady_clock::time_point logStart_;
+	std::unique_ptr<Snapshots> windowStartSnapshots_;
+	std::unique_ptr<Snapshots> logStartSnapshots_;
+
+	mutable std::mutex stageTimingsMutex_;
+	std::vector<RenderStageTiming> stageTimings_;
+};
+
+#else // LIVE_BACKGROUND_REMOVAL_LITE_ENABLE_STAGE_PROFILING
+
+/**
+ * @brief The stand-in used when stage profiling is compiled out. Every call is empty and inlined away.
+ */
+class RenderStageProfiler {
+public:
+	struct FrameScope {
+		~FrameScope() noexcept {}
+	};
+
+	struct StageScope {
+		~StageScope() noexcept {}
+	};
+
+	RenderStageProfiler(std::shared_ptr<const Logger::ILogger>, const Profiling::LatencyHistogram *) noexcept {}
+
+	[[nodiscard]]
+	FrameScope measureFrame() noexcept
+	{
+		return {};
+	}
+
+	[[nodiscard]]
+	StageScope measure(RenderStage) noexcept
+	{
+		return {};
+	}
+
+	[[nodiscard]]
+	StageScope measureCpu(RenderStage) noexcept
+	{
+		return {};
+	}
+
+	std::vector<RenderStageTiming> getStageTimings() const { return {}; }
+};
+
+#endif // LIVE_BACKGROUND_REMOVAL_LITE_ENABLE_STAGE_PROFILING
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter
@@ -4,12 +4,10 @@
 
 #include "RenderingContext.hpp"
 
-#include <KaitoTokyo/SelfieSegmenter/BoundingBox.hpp>
-#include <KaitoTokyo/SelfieSegmenter/NcnnSelfieSegmenter.hpp>
+#include <algorithm>
+#include <cmath>
 
-extern "C" const unsigned char mediapipe_selfie_segmentation_landscape_int8_ncnn_bin[];
-extern "C" const unsigned int mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len;
-extern "C" const char mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text[];
+#include <KaitoTokyo/SelfieSegmenter/NcnnSelfieSegmenter.hpp>
 
 namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter {
 
@@ -35,8 +33,10 @@ ObsBridgeUtils::unique_gs_texture_t RenderingContext::makeTexture(std::uint32_t
 								  enum gs_color_format color_format,
 								  std::uint32_t flags) const noexcept
 {
+	// Pooled textures keep the contents of their previous owner, which the initialization below overwrites
 	ObsBridgeUtils::unique_gs_texture_t texture =
-		ObsBridgeUtils::make_unique_gs_texture(width, height, color_format, 1, NULL, flags);
+		texturePool_ ? texturePool_->acquire(width, height, color_format, flags)
+			     : ObsBridgeUtils::make_unique_gs_texture(width, height, color_format, 1, NULL, flags);
 	if ((flags & GS_RENDER_TARGET) == GS_RENDER_TARGET) {
 		TextureRenderGuard renderTargetGuard(texture);
 		vec4 clearColor{0.0f, 0.0f, 0.0f, 1.0f};
@@ -110,23 +110,26 @@ RenderingContext::createDualKawasePyramid(std::uint32_t width, std::uint32_t hei
 }
 
 RenderingContext::RenderingContext(obs_source_t *const source, std::shared_ptr<const Logger::ILogger> logger,
-				   const MainEffect &mainEffect,
-				   TaskQueue::ThrottledTaskQueue &selfieSegmenterTaskQueue,
+				   const MainEffect &mainEffect, SelfieSegmenter::InferenceScheduler &inferenceScheduler,
 				   std::shared_ptr<Global::PluginConfig> pluginConfig,
-				   const std::uint32_t subsamplingRate, const std::uint32_t width,
-				   const std::uint32_t height, const int numThreads, int blurSize)
+				   std::shared_ptr<ObsBridgeUtils::GsTexturePool> texturePool,
+				   std::shared_ptr<SelfieSegmenter::ISelfieSegmenter> selfieSegmenter,
+				   const std::uint32_t subsamplingRate, const std::uint32_t width, const std::uint32_t height,
+				   const int numThreads, int blurSize)
 	: source_(source),
 	  logger_(std::move(logger)),
 	  mainEffect_(mainEffect),
-	  selfieSegmenterTaskQueue_(selfieSegmenterTaskQueue),
 	  pluginConfig_(pluginConfig),
+	  texturePool_(std::move(texturePool)),
 	  subsamplingRate_(subsamplingRate),
 	  numThreads_(numThreads),
 	  blurSize_(blurSize),
-	  selfieSegmenter_(std::make_unique<KaitoTokyo::SelfieSegmenter::NcnnSelfieSegmenter>(
-		  mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text,
-		  static_cast<int>(mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len),
-		  mediapipe_selfie_segmentation_landscape_int8_ncnn_bin, numThreads_)),
+	  selfieSegmenter_(selfieSegmenter ? std::move(selfieSegmenter)
+					   : throw std::invalid_argument(
+						     "SelfieSegmenterIsNullError(RenderingContext::RenderingContext)")),
+	  inferenceClient_(inferenceScheduler.registerClient(
+		  selfieSegmenter_, obs_source_get_name(source_) ? obs_source_get_name(source_) : "")),
+	  stageProfiler_(logger_, &inferenceClient_->getInferenceDurations()),
 	  selfieSegmenterMemoryBlockPool_(
 		  Memory::MemoryBlockPool::create(logger_, selfieSegmenter_->getPixelCount() * 4)),
 	  region_{0, 0, width, height},
@@ -148,26 +151,44 @@ RenderingContext::RenderingContext(obs_source_t *const source, std::shared_ptr<c
 	  r32fMeanSquaredMotionReductionPyramid_(
 		  createReductionPyramid(subPaddedRegion_.width, subPaddedRegion_.height)),
 	  r32fReducedMeanSquaredMotionReader_(1, 1, GS_R32F),
-	  segmenterRoi_(region_),
+	  segmenterRoiTracker_(static_cast<double>(region_.width), static_cast<double>(region_.height),
+			       static_cast<double>(selfieSegmenter_->getWidth()) /
+				       static_cast<double>(selfieSegmenter_->getHeight())),
+	  segmenterInputTransform_(segmenterRoiTracker_.getInputTransform(
+		  static_cast<std::uint32_t>(selfieSegmenter_->getWidth()),
+		  static_cast<std::uint32_t>(selfieSegmenter_->getHeight()))),
 	  bgrxSegmenterInput_(makeTexture(static_cast<std::uint32_t>(selfieSegmenter_->getWidth()),
 					  static_cast<std::uint32_t>(selfieSegmenter_->getHeight()), GS_BGRX,
 					  GS_RENDER_TARGET)),
 	  bgrxSegmenterInputReader_(static_cast<std::uint32_t>(selfieSegmenter_->getWidth()),
 				    static_cast<std::uint32_t>(selfieSegmenter_->getHeight()), GS_BGRX),
-	  segmenterInputBuffer_(selfieSegmenter_->getPixelCount() * 4),
-	  r8SegmentationMask_(makeTexture(maskRoi_.width, maskRoi_.height, GS_R8, GS_DYNAMIC)),
-	  r32fSubGFIntermediate_(makeTexture(subRegion_.width, subRegion_.height, GS_R32F, GS_RENDER_TARGET)),
+	  r8SegmenterOutput_(makeTexture(static_cast<std::uint32_t>(selfieSegmenter_->getWidth()),
+					 static_cast<std::uint32_t>(selfieSegmenter_->getHeight()), GS_R8, GS_DYNAMIC)),
+	  r8SegmentationMask_(makeTexture(maskRoi_.width, maskRoi_.height, GS_R8, GS_RENDER_TARGET)),
 	  r32fSubGFSource_(makeTexture(subRegion_.width, subRegion_.height, GS_R32F, GS_RENDER_TARGET)),
-	  r32fSubGFMeanGuide_(makeTexture(subRegion_.width, subRegion_.height, GS_R32F, GS_RENDER_TARGET)),
-	  r32fSubGFMeanSource_(makeTexture(subRegion_.width, subRegion_.height, GS_R32F, GS_RENDER_TARGET)),
-	  r32fSubGFMeanGuideSource_(makeTexture(subRegion_.width, subRegion_.height, GS_R32F, GS_RENDER_TARGET)),
-	  r32fSubGFMeanGuideSq_(makeTexture(subRegion_.width, subRegion_.height, GS_R32F, GS_RENDER_TARGET)),
+	  rgba32fSubGFIntermediate_(makeTexture(subRegion_.width, subRegion_.height, GS_RGBA32F, GS_RENDER_TARGET)),
+	  rgba32fSubGFMeans_(makeTexture(subRegion_.width, subRegion_.height, GS_RGBA32F, GS_RENDER_TARGET)),
 	  r32fSubGFA_(makeTexture(subRegion_.width, subRegion_.height, GS_R32F, GS_RENDER_TARGET)),
 	  r32fSubGFB_(makeTexture(subRegion_.width, subRegion_.height, GS_R32F, GS_RENDER_TARGET)),
 	  r8GuidedFilterResult_(makeTexture(region_.width, region_.height, GS_R8, GS_RENDER_TARGET)),
 	  r8TimeAveragedMasks_{makeTexture(region_.width, region_.height, GS_R8, GS_RENDER_TARGET),
 			       makeTexture(region_.width, region_.height, GS_R8, GS_RENDER_TARGET)},
 	  bgrxDualKawaseBlurReductionPyramid_(createDualKawasePyramid(region_.width, region_.height, blurSize_))
+{
+	segmentationMaskRecord_.transform = segmenterInputTransform_;
+}
+
+RenderingContext::RenderingContext(obs_source_t *const source, std::shared_ptr<const Logger::ILogger> logger,
+				   const MainEffect &mainEffect, SelfieSegmenter::InferenceScheduler &inferenceScheduler,
+				   std::shared_ptr<Global::PluginConfig> pluginConfig,
+				   std::shared_ptr<ObsBridgeUtils::GsTexturePool> texturePool,
+				   std::shared_ptr<const ncnn::Net> selfieSegmenterNet, const std::uint32_t subsamplingRate,
+				   const std::uint32_t width, const std::uint32_t height, const int numThreads, int blurSize)
+	: RenderingContext(source, std::move(logger), mainEffect, inferenceScheduler, std::move(pluginConfig),
+			   std::move(texturePool),
+			   std::make_shared<KaitoTokyo::SelfieSegmenter::NcnnSelfieSegmenter>(
+				   std::move(selfieSegmenterNet), numThreads),
+			   subsamplingRate, width, height, numThreads, blurSize)
 {
 }
 
@@ -201,6 +222,7 @@ void RenderingContext::videoRender()
 	const float motionIntensityThreshold = motionIntensityThreshold_.load(std::memory_order_relaxed);
 
 	const float guidedFilterEps = guidedFilterEps_.load(std::memory_order_relaxed);
+	const int guidedFilterBoxRadius = guidedFilterBoxRadius_.load(std::memory_order_relaxed);
 
 	const float maskGamma = maskGamma_.load(std::memory_order_relaxed);
 	const float maskLowerBound = maskLowerBound_.load(std::memory_order_relaxed);
@@ -212,30 +234,33 @@ void RenderingContext::videoRender()
 	const bool forceProcessingFrame =
 		shouldNextVideoRenderForceProcessFrame_.exchange(false, std::memory_order_acquire);
 
-	if (processingFrame && filterLevel >= FilterLevel::Passthrough) {
-		mainEffect_.drawSource(bgrxSource_, source_);
+	if (processingFrame) {
+		++processedFrameCount_;
 	}
 
-	if (processingFrame && filterLevel >= FilterLevel::Segmentation) {
-		constexpr vec4 blackColor = {0.0f, 0.0f, 0.0f, 1.0f};
-
-		const double targetW = static_cast<double>(selfieSegmenter_->getWidth());
-		const double targetH = static_cast<double>(selfieSegmenter_->getHeight());
+	const auto frameScope = stageProfiler_.measureFrame();
 
-		double fitScaleX = targetW / static_cast<double>(segmenterRoi_.width);
-		double fitScaleY = targetH / static_cast<double>(segmenterRoi_.height);
-		double scale = std::min(fitScaleX, fitScaleY);
+	if (segmentationMaskPredecessor_) {
+		copyPredecessorSegmentationMask();
+	}
 
-		std::uint32_t width = static_cast<std::uint32_t>(std::round(region_.width * scale));
-		std::uint32_t height = static_cast<std::uint32_t>(std::round(region_.height * scale));
+	if (processingFrame && filterLevel >= FilterLevel::Passthrough) {
+		const auto stageScope = stageProfiler_.measure(RenderStage::DrawSource);
+		mainEffect_.drawSource(bgrxSource_, source_);
+	}
 
-		double roiCenterX = segmenterRoi_.x + segmenterRoi_.width / 2.0;
-		double roiCenterY = segmenterRoi_.y + segmenterRoi_.height / 2.0;
+	if (filterLevel >= FilterLevel::Segmentation) {
+		const auto stageScope = stageProfiler_.measure(RenderStage::MaskUpload);
+		uploadSegmentationMask();
+	}
 
-		float x = static_cast<float>((targetW / 2.0) - (roiCenterX * scale));
-		float y = static_cast<float>((targetH / 2.0) - (roiCenterY * scale));
+	if (processingFrame && filterLevel >= FilterLevel::Segmentation) {
+		const auto stageScope = stageProfiler_.measure(RenderStage::SegmenterInput);
+		constexpr vec4 blackColor = {0.0f, 0.0f, 0.0f, 1.0f};
 
-		mainEffect_.drawRoi(bgrxSegmenterInput_, bgrxSource_, &blackColor, width, height, x, y);
+		mainEffect_.drawRoi(bgrxSegmenterInput_, bgrxSource_, &blackColor, segmenterInputTransform_.width,
+				    segmenterInputTransform_.height, segmenterInputTransform_.x,
+				    segmenterInputTransform_.y);
 
 		bgrxSegmenterInputReader_.stage(bgrxSegmenterInput_);
 	}
@@ -243,6 +268,7 @@ void RenderingContext::videoRender()
 	float motionIntensity = (filterLevel < FilterLevel::MotionIntensityThresholding) ? 1.0f : 0.0f;
 
 	if (processingFrame && filterLevel >= FilterLevel::MotionIntensityThresholding) {
+		const auto stageScope = stageProfiler_.measure(RenderStage::MotionReduction);
 		mainEffect_.convertToLuma(r32fLuma_, bgrxSource_);
 
 		const auto &lastSubLuma = r32fSubLumas_[currentSubLumaIndex_];
@@ -259,20 +285,16 @@ void RenderingContext::videoRender()
 	}
 
 	if (processingFrame && filterLevel >= FilterLevel::Segmentation && blurSize_ > 0) {
+		const auto stageScope = stageProfiler_.measure(RenderStage::DualKawaseBlur);
 		gs_copy_texture(bgrxDualKawaseBlurReductionPyramid_[0].get(), bgrxSource_.get());
 		mainEffect_.dualKawaseBlur(bgrxDualKawaseBlurReductionPyramid_, blurSize_);
 	}
 
-	if (processingFrame && filterLevel >= FilterLevel::Segmentation) {
-		try {
-			bgrxSegmenterInputReader_.sync();
-		} catch (const std::exception &e) {
-			logger_->error("TextureSyncError", {{"message", e.what()}});
-		}
-	}
-
 	if (processingFrame && filterLevel >= FilterLevel::MotionIntensityThresholding) {
-		r32fReducedMeanSquaredMotionReader_.sync();
+		{
+			const auto stageScope = stageProfiler_.measureCpu(RenderStage::MotionReadback);
+			r32fReducedMeanSquaredMotionReader_.sync();
+		}
 
 		const float *meanSquaredMotionPtr =
 			reinterpret_cast<const float *>(r32fReducedMeanSquaredMotionReader_.getBuffer().data());
@@ -282,24 +304,22 @@ void RenderingContext::videoRender()
 	const bool isCurrentMotionIntense = (motionIntensity >= motionIntensityThreshold);
 
 	if (processingFrame && filterLevel >= FilterLevel::GuidedFilter) {
+		const auto stageScope = stageProfiler_.measure(RenderStage::GuidedFilter);
 		const ObsBridgeUtils::unique_gs_texture_t &currentSubLuma = r32fSubLumas_[currentSubLumaIndex_];
 		mainEffect_.resampleByNearestR8(r32fSubGFSource_, r8SegmentationMask_);
 
-		mainEffect_.applyBoxFilterR8KS17(r32fSubGFMeanGuide_, currentSubLuma, r32fSubGFIntermediate_);
-		mainEffect_.applyBoxFilterR8KS17(r32fSubGFMeanSource_, r32fSubGFSource_, r32fSubGFIntermediate_);
-
-		mainEffect_.applyBoxFilterWithMulR8KS17(r32fSubGFMeanGuideSource_, currentSubLuma, r32fSubGFSource_,
-							r32fSubGFIntermediate_);
-		mainEffect_.applyBoxFilterWithSqR8KS17(r32fSubGFMeanGuideSq_, currentSubLuma, r32fSubGFIntermediate_);
+		// One pass pair over RGBA32F replaces four over R32F, so the box filters take a quarter of the draws
+		mainEffect_.applyGuidedFilterMeans(rgba32fSubGFMeans_, currentSubLuma, r32fSubGFSource_,
+						   rgba32fSubGFIntermediate_, guidedFilterBoxRadius);
 
-		mainEffect_.calculateGuidedFilterAAndB(r32fSubGFA_, r32fSubGFB_, r32fSubGFMeanGuideSq_,
-						       r32fSubGFMeanGuide_, r32fSubGFMeanGuideSource_,
-						       r32fSubGFMeanSource_, guidedFilterEps);
+		mainEffect_.calculateGuidedFilterAAndBFromMeans(r32fSubGFA_, r32fSubGFB_, rgba32fSubGFMeans_,
+								guidedFilterEps);
 
 		mainEffect_.finalizeGuidedFilter(r8GuidedFilterResult_, r32fLuma_, r32fSubGFA_, r32fSubGFB_);
 	}
 
 	if (processingFrame && filterLevel >= FilterLevel::TimeAveragedFilter) {
+		const auto stageScope = stageProfiler_.measure(RenderStage::TimeAveragedFilter);
 		std::size_t nextIndex = 1 - currentTimeAveragedMaskIndex_;
 		mainEffect_.timeAveragedFiltering(r8TimeAveragedMasks_[nextIndex],
 						  r8TimeAveragedMasks_[currentTimeAveragedMaskIndex_],
@@ -309,27 +329,13 @@ void RenderingContext::videoRender()
 
 	if (processingFrame && filterLevel >= FilterLevel::Segmentation &&
 	    (isCurrentMotionIntense || forceProcessingFrame)) {
-		auto &bgrxSegmenterInputReaderBuffer = bgrxSegmenterInputReader_.getBuffer();
-		auto segmenterInputBuffer = selfieSegmenterMemoryBlockPool_->acquire();
-		if (!segmenterInputBuffer) {
-			logger_->error("MemoryBlockAcquisitionError");
-			return;
-		}
-
-		std::copy(bgrxSegmenterInputReaderBuffer.begin(), bgrxSegmenterInputReaderBuffer.end(),
-			  segmenterInputBuffer->begin());
-
-		selfieSegmenter_->process(segmenterInputBuffer.get()->data());
-
-		const std::uint8_t *segmentationMaskData =
-			selfieSegmenter_->getMask() + (maskRoi_.y * selfieSegmenter_->getWidth() + maskRoi_.x);
-
-		// gs_texture_set_image immediately uploads the data to GPU memory
-		gs_texture_set_image(r8SegmentationMask_.get(), segmentationMaskData,
-				     static_cast<std::uint32_t>(selfieSegmenter_->getWidth()), 0);
+		submitSegmenterInput(processedFrameCount_, segmenterInputTransform_);
 	}
 
-	if (filterLevel == FilterLevel::Passthrough) {
+	const auto finalDrawScope = stageProfiler_.measure(RenderStage::FinalDraw);
+	if (filterLevel == FilterLevel::Passthrough ||
+	    (filterLevel >= FilterLevel::Segmentation && !hasUploadedSegmentationMask_)) {
+		// The mask textures hold nothing meaningful until the model delivers its first mask
 		mainEffect_.directDraw(bgrxSource_);
 	} else if (filterLevel == FilterLevel::Segmentation ||
 		   filterLevel == FilterLevel::MotionIntensityThresholding) {
@@ -364,6 +370,118 @@ void RenderingContext::videoRender()
 	}
 }
 
+void RenderingContext::submitSegmenterInput(std::uint64_t frameIndex,
+					    const SelfieSegmenter::SegmenterInputTransform &transform)
+{
+	auto segmenterInputBuffer = selfieSegmenterMemoryBlockPool_->acquire();
+	if (!segmenterInputBuffer) {
+		logger_->error("MemoryBlockAcquisitionError");
+		return;
+	}
+
+	// Read the staged segmenter input straight into the block handed to the inference worker
+	try {
+		const auto stageScope = stageProfiler_.measureCpu(RenderStage::ReadbackSync);
+		if (!bgrxSegmenterInputReader_.syncInto(segmenterInputBuffer->data(), segmenterInputBuffer->size())) {
+			return;
+		}
+	} catch (const std::exception &e) {
+		logger_->error("TextureSyncError", {{"message", e.what()}});
+		return;
+	}
+
+	// A pending input that has not started yet is replaced by this one, so the freshest frame always wins
+	inferenceClient_->submit(std::move(segmenterInputBuffer), [weakSelf = weak_from_this(), frameIndex, transform] {
+		if (auto self = weakSelf.lock()) {
+			// The inference worker calls this right after process, so the latest mask belongs to this input
+			const std::uint64_t generation = self->selfieSegmenter_->getPublishedMaskGeneration();
+			{
+				std::lock_guard<std::mutex> lock(self->segmentationMaskRecordMutex_);
+				self->segmentationMaskRecord_ = {generation, frameIndex, transform};
+			}
+			self->hasNewSegmentationMask_.store(true, std::memory_order_release);
+		}
+	});
+}
+
+void RenderingContext::inheritSegmentationMask(std::shared_ptr<const RenderingContext> predecessor) noexcept
+{
+	if (predecessor && predecessor->getWidth() == getWidth() && predecessor->getHeight() == getHeight() &&
+	    predecessor->subsamplingRate_ == subsamplingRate_) {
+		segmentationMaskPredecessor_ = std::move(predecessor);
+	}
+}
+
+void RenderingContext::copyPredecessorSegmentationMask()
+{
+	// A predecessor replaced before its own first frame still points at the context whose masks it would have taken
+	const RenderingContext *source = segmentationMaskPredecessor_.get();
+	while (source && !source->hasUploadedSegmentationMask_) {
+		source = source->segmentationMaskPredecessor_.get();
+	}
+
+	if (source && !hasUploadedSegmentationMask_) {
+		gs_copy_texture(r8SegmentationMask_.get(), source->r8SegmentationMask_.get());
+		gs_copy_texture(r8GuidedFilterResult_.get(), source->r8GuidedFilterResult_.get());
+		gs_copy_texture(r8TimeAveragedMasks_[currentTimeAveragedMaskIndex_].get(),
+				source->r8TimeAveragedMasks_[source->currentTimeAveragedMaskIndex_].get());
+		hasUploadedSegmentationMask_ = true;
+	}
+
+	segmentationMaskPredecessor_.reset();
+}
+
+void RenderingContext::uploadSegmentationMask()
+{
+	if (hasNewSegmentationMask_.exchange(false, std::memory_order_acquire)) {
+		SegmentationMaskRecord record;
+		{
+			std::lock_guard<std::mutex> lock(segmentationMaskRecordMutex_);
+			record = segmentationMaskRecord_;
+		}
+
+		const std::uint8_t *segmentationMaskData = selfieSegmenter_->getMask();
+		if (selfieSegmenter_->getMaskGeneration() != record.generation) {
+			// A later input published its mask before its record. Its completion raises the flag again,
+			// and the next frame maps that mask with its own transform.
+			logger_->debug("SegmentationMaskRecordBehind");
+		} else {
+			mapSegmentationMask(segmentationMaskData, record);
+		}
+	}
+
+	segmentationMaskAge_.store(processedFrameCount_ - uploadedSegmentationMaskFrameIndex_,
+				   std::memory_order_relaxed);
+}
+
+void RenderingContext::mapSegmentationMask(const std::uint8_t *segmentationMaskData,
+					   const SegmentationMaskRecord &record)
+{
+	const SelfieSegmenter::SegmenterInputTransform &transform = record.transform;
+
+	// gs_texture_set_image immediately uploads the data to GPU memory
+	gs_texture_set_image(r8SegmenterOutput_.get(), segmentationMaskData,
+			     static_cast<std::uint32_t>(selfieSegmenter_->getWidth()), 0);
+
+	const auto segmenterWidth = static_cast<std::uint32_t>(selfieSegmenter_->getWidth());
+	const auto segmenterHeight = static_cast<std::uint32_t>(selfieSegmenter_->getHeight());
+
+	// Map the mask back from the segmenter input onto the frame; anything outside the crop is background
+	constexpr vec4 blackColor = {0.0f, 0.0f, 0.0f, 1.0f};
+	const SelfieSegmenter::SegmenterOutputPlacement placement = SelfieSegmenter::getSegmenterOutputPlacement(
+		transform, segmenterWidth, segmenterHeight,
+		static_cast<double>(maskRoi_.width) / static_cast<double>(region_.width),
+		static_cast<double>(maskRoi_.height) / static_cast<double>(region_.height));
+	mainEffect_.drawRoi(r8SegmentationMask_, r8SegmenterOutput_, &blackColor, placement.width, placement.height,
+			    placement.x, placement.y);
+
+	segmenterRoiTracker_.updateFromMask(segmentationMaskData, transform, segmenterWidth, segmenterHeight);
+	segmenterInputTransform_ = segmenterRoiTracker_.getInputTransform(segmenterWidth, segmenterHeight);
+
+	uploadedSegmentationMaskFrameIndex_ = record.frameIndex;
+	hasUploadedSegmentationMask_ = true;
+}
+
 void RenderingContext::applyPluginProperty(const PluginProperty &pluginProperty)
 {
 	FilterLevel newFilterLevel = (pluginProperty.filterLevel == FilterLevel::Default)
@@ -375,6 +493,11 @@ void RenderingContext::applyPluginProperty(const PluginProperty &pluginProperty)
 
 	float newGuidedFilterEps = static_cast<float>(std::pow(10.0, pluginProperty.guidedFilterEpsPowDb / 10.0));
 
+	int newGuidedFilterBoxRadius = pluginProperty.guidedFilterBoxRadiusAuto
+					       ? getAutoGuidedFilterBoxRadius(subRegion_.height)
+					       : std::clamp(pluginProperty.guidedFilterBoxRadius,
+							    kMinGuidedFilterBoxRadius, kMaxGuidedFilterBoxRadius);
+
 	float newTimeAveragedFilteringAlpha = static_cast<float>(pluginProperty.timeAveragedFilteringAlpha);
 
 	float newMaskGamma = static_cast<float>(pluginProperty.maskGamma);
@@ -387,6 +510,7 @@ void RenderingContext::applyPluginProperty(const PluginProperty &pluginProperty)
 	filterLevel_.store(newFilterLevel, std::memory_order_relaxed);
 	motionIntensityThreshold_.store(newMotionIntensityThreshold, std::memory_order_relaxed);
 	guidedFilterEps_.store(newGuidedFilterEps, std::memory_order_relaxed);
+	guidedFilterBoxRadius_.store(newGuidedFilterBoxRadius, std::memory_order_relaxed);
 	timeAveragedFilteringAlpha_.store(newTimeAveragedFilteringAlpha, std::memory_order_relaxed);
 	maskGamma_.store(newMaskGamma, std::memory_order_relaxed);
 	maskLowerBound_.store(newMaskLowerBound, std::memory_order_relaxed);
@@ -397,6 +521,8 @@ void RenderingContext::applyPluginProperty(const PluginProperty &pluginProperty)
 	logger_->info("PluginPropertySet",
 		      {{"key", "motionIntensityThreshold"}, {"value", std::to_string(newMotionIntensityThreshold)}});
 	logger_->info("PluginPropertySet", {{"key", "guidedFilterEps"}, {"value", std::to_string(newGuidedFilterEps)}});
+	logger_->info("PluginPropertySet",
+		      {{"key", "guidedFilterBoxRadius"}, {"value", std::to_string(newGuidedFilterBoxRadius)}});
 	logger_->info("PluginPropertySet", {{"key", "timeAveragedFilteringAlpha"},
 					    {"value", std::to_string(newTimeAveragedFilteringAlpha)}});
 	logger_->info("PluginPropertySet", {{"key", "maskGamma"}, {"value", std::to_string(newMaskGamma)}});
@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 
 #ifdef PREFIXED_NCNN_HEADERS
 #include <ncnn/net.h>
@@ -19,13 +20,16 @@
 #include <KaitoTokyo/Logger/ILogger.hpp>
 #include <KaitoTokyo/Memory/MemoryBlockPool.hpp>
 #include <KaitoTokyo/ObsBridgeUtils/AsyncTextureReader.hpp>
+#include <KaitoTokyo/ObsBridgeUtils/GsTexturePool.hpp>
 #include <KaitoTokyo/ObsBridgeUtils/GsUnique.hpp>
+#include <KaitoTokyo/SelfieSegmenter/InferenceScheduler.hpp>
 #include <KaitoTokyo/SelfieSegmenter/ISelfieSegmenter.hpp>
-#include <KaitoTokyo/TaskQueue/ThrottledTaskQueue.hpp>
+#include <KaitoTokyo/SelfieSegmenter/RoiTracker.hpp>
 
 #include "MainEffect.hpp"
 #include "PluginConfig.hpp"
 #include "PluginProperty.hpp"
+#include "RenderStageProfiler.hpp"
 
 namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter {
 
@@ -55,9 +59,27 @@ private:
 	createDualKawasePyramid(std::uint32_t width, std::uint32_t height, int blurSize) const;
 
 public:
+	/**
+	 * @param texturePool The pool textures are drawn from, or null to create them directly.
+	 * @param selfieSegmenter The segmenter registered with @p inferenceScheduler for this context.
+	 * @throw std::invalid_argument If @p selfieSegmenter is null or the size is too small for @p subsamplingRate.
+	 */
 	RenderingContext(obs_source_t *const source, std::shared_ptr<const Logger::ILogger> logger,
-			 const MainEffect &mainEffect, TaskQueue::ThrottledTaskQueue &selfieSegmenterTaskQueue,
-			 std::shared_ptr<Global::PluginConfig> pluginConfig, const std::uint32_t subsamplingRate,
+			 const MainEffect &mainEffect, SelfieSegmenter::InferenceScheduler &inferenceScheduler,
+			 std::shared_ptr<Global::PluginConfig> pluginConfig,
+			 std::shared_ptr<ObsBridgeUtils::GsTexturePool> texturePool,
+			 std::shared_ptr<SelfieSegmenter::ISelfieSegmenter> selfieSegmenter,
+			 const std::uint32_t subsamplingRate, const std::uint32_t width, const std::uint32_t height,
+			 const int numThreads, int blurSize);
+
+	/**
+	 * @brief Runs the model in @p selfieSegmenterNet with an NcnnSelfieSegmenter of @p numThreads threads.
+	 */
+	RenderingContext(obs_source_t *const source, std::shared_ptr<const Logger::ILogger> logger,
+			 const MainEffect &mainEffect, SelfieSegmenter::InferenceScheduler &inferenceScheduler,
+			 std::shared_ptr<Global::PluginConfig> pluginConfig,
+			 std::shared_ptr<ObsBridgeUtils::GsTexturePool> texturePool,
+			 std::shared_ptr<const ncnn::Net> selfieSegmenterNet, const std::uint32_t subsamplingRate,
 			 const std::uint32_t width, const std::uint32_t height, const int numThreads, int blurSize);
 	~RenderingContext() noexcept;
 
@@ -71,25 +93,67 @@ public:
 
 	void applyPluginProperty(const PluginProperty &pluginProperty);
 
+	/**
+	 * @brief Has the first rendered frame take over the masks of @p predecessor, so that a rebuild at the same size
+	 * keeps the background hidden instead of passing the source through until its own first mask.
+	 *
+	 * Call before the context is shared with the render thread. A predecessor of another size is ignored.
+	 */
+	void inheritSegmentationMask(std::shared_ptr<const RenderingContext> predecessor) noexcept;
+
 	std::uint32_t getWidth() const noexcept { return region_.width; }
 	std::uint32_t getHeight() const noexcept { return region_.height; }
 
+	/**
+	 * @brief Returns how many processed frames old the currently uploaded segmentation mask is.
+	 */
+	std::uint64_t getSegmentationMaskAge() const noexcept
+	{
+		return segmentationMaskAge_.load(std::memory_order_relaxed);
+	}
+
+	SelfieSegmenter::InferenceScheduler::ClientStats getInferenceStats() const
+	{
+		return inferenceClient_->getStats();
+	}
+
+	/**
+	 * @brief Returns the per-stage timings of the last profiling window, or nothing if profiling is compiled out.
+	 */
+	std::vector<RenderStageTiming> getStageTimings() const { return stageProfiler_.getStageTimings(); }
+
+private:
+	struct SegmentationMaskRecord {
+		std::uint64_t generation = 0;
+		std::uint64_t frameIndex = 0;
+		SelfieSegmenter::SegmenterInputTransform transform;
+	};
+
+	void submitSegmenterInput(std::uint64_t frameIndex, const SelfieSegmenter::SegmenterInputTransform &transform);
+	void uploadSegmentationMask();
+	void mapSegmentationMask(const std::uint8_t *segmentationMaskData, const SegmentationMaskRecord &record);
+	void copyPredecessorSegmentationMask();
+
 private:
 	obs_source_t *const source_;
 	const std::shared_ptr<const Logger::ILogger> logger_;
 	const MainEffect &mainEffect_;
-	TaskQueue::ThrottledTaskQueue &selfieSegmenterTaskQueue_;
 	const std::shared_ptr<Global::PluginConfig> pluginConfig_;
+	const std::shared_ptr<ObsBridgeUtils::GsTexturePool> texturePool_;
 
 public:
 	const std::uint32_t subsamplingRate_;
 	const int numThreads_;
 	const int blurSize_;
 
-	std::unique_ptr<SelfieSegmenter::ISelfieSegmenter> selfieSegmenter_;
+	const std::shared_ptr<SelfieSegmenter::ISelfieSegmenter> selfieSegmenter_;
+	const std::shared_ptr<SelfieSegmenter::InferenceScheduler::Client> inferenceClient_;
+	RenderStageProfiler stageProfiler_;
 	std::shared_ptr<Memory::MemoryBlockPool> selfieSegmenterMemoryBlockPool_;
-	bool hasNewSegmenterInput_ = false;
 	std::atomic<bool> hasNewSegmentationMask_ = false;
+	// Describes the mask of the given generation, so that a mask is only ever mapped with its own transform
+	std::mutex segmentationMaskRecordMutex_;
+	SegmentationMaskRecord segmentationMaskRecord_;
 
 	const RenderingContextRegion region_;
 	const RenderingContextRegion subRegion_;
@@ -106,22 +170,19 @@ public:
 	const std::vector<ObsBridgeUtils::unique_gs_texture_t> r32fMeanSquaredMotionReductionPyramid_;
 	ObsBridgeUtils::AsyncTextureReader r32fReducedMeanSquaredMotionReader_;
 
-	RenderingContextRegion segmenterRoi_;
+	SelfieSegmenter::RoiTracker segmenterRoiTracker_;
+	SelfieSegmenter::SegmenterInputTransform segmenterInputTransform_;
 
 	const ObsBridgeUtils::unique_gs_texture_t bgrxSegmenterInput_;
 	ObsBridgeUtils::AsyncTextureReader bgrxSegmenterInputReader_;
 
-	std::vector<std::uint8_t> segmenterInputBuffer_;
-
+	const ObsBridgeUtils::unique_gs_texture_t r8SegmenterOutput_;
 	const ObsBridgeUtils::unique_gs_texture_t r8SegmentationMask_;
 
-	const ObsBridgeUtils::unique_gs_texture_t r32fSubGFIntermediate_;
-
 	const ObsBridgeUtils::unique_gs_texture_t r32fSubGFSource_;
-	const ObsBridgeUtils::unique_gs_texture_t r32fSubGFMeanGuide_;
-	const ObsBridgeUtils::unique_gs_texture_t r32fSubGFMeanSource_;
-	const ObsBridgeUtils::unique_gs_texture_t r32fSubGFMeanGuideSource_;
-	const ObsBridgeUtils::unique_gs_texture_t r32fSubGFMeanGuideSq_;
+	const ObsBridgeUtils::unique_gs_texture_t rgba32fSubGFIntermediate_;
+	// Mean I, mean p, mean I*p and mean I*I in the R, G, B and A channels
+	const ObsBridgeUtils::unique_gs_texture_t rgba32fSubGFMeans_;
 	const ObsBridgeUtils::unique_gs_texture_t r32fSubGFA_;
 	const ObsBridgeUtils::unique_gs_texture_t r32fSubGFB_;
 	const ObsBridgeUtils::unique_gs_texture_t r8GuidedFilterResult_;
@@ -137,6 +198,7 @@ private:
 	std::atomic<float> motionIntensityThreshold_;
 
 	std::atomic<float> guidedFilterEps_;
+	std::atomic<int> guidedFilterBoxRadius_;
 
 	std::atomic<float> maskGamma_;
 	std::atomic<float> maskLowerBound_;
@@ -146,6 +208,13 @@ private:
 
 	std::atomic<bool> shouldNextVideoRenderProcessFrame_ = true;
 	std::atomic<bool> shouldNextVideoRenderForceProcessFrame_ = true;
+
+	std::uint64_t processedFrameCount_ = 0;
+	std::uint64_t uploadedSegmentationMaskFrameIndex_ = 0;
+	bool hasUploadedSegmentationMask_ = false;
+	// Released on the first rendered frame, once its masks have been copied
+	std::shared_ptr<const RenderingContext> segmentationMaskPredecessor_;
+	std::atomic<std::uint64_t> segmentationMaskAge_ = 0;
 };
 
 } // namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter
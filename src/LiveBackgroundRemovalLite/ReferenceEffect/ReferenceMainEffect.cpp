@@ -0,0 +1,793 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ReferenceMainEffect.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect {
+
+namespace {
+
+/// The radius of the fixed KS17 box filters.
+constexpr std::uint32_t kKS17BoxRadius = 8;
+
+/// Boxes up to this radius are summed tap by tap like the shaders; larger ones use a running sum.
+constexpr std::uint32_t kMaxDirectSumBoxRadius = 8;
+
+/**
+ * @brief Source texel pairs and weights that a linear sampler reads along one axis.
+ *
+ * Entry i describes the sample taken at the center of sprite pixel i, shifted by a fixed number of source
+ * texels as the shaders do with texelWidth and texelHeight.
+ */
+struct LinearTaps {
+	std::vector<std::uint32_t> first;
+	std::vector<std::uint32_t> second;
+	std::vector<float> weight;
+};
+
+LinearTaps makeLinearTaps(std::uint32_t sourceSize, std::uint32_t spriteSize, double texelOffset)
+{
+	LinearTaps taps;
+	taps.first.resize(spriteSize);
+	taps.second.resize(spriteSize);
+	taps.weight.resize(spriteSize);
+
+	const double maxIndex = static_cast<double>(sourceSize - 1);
+	for (std::uint32_t i = 0; i < spriteSize; ++i) {
+		const double coord = (i + 0.5) * sourceSize / spriteSize + texelOffset - 0.5;
+		const double base = std::floor(coord);
+		taps.first[i] = static_cast<std::uint32_t>(std::clamp(base, 0.0, maxIndex));
+		taps.second[i] = static_cast<std::uint32_t>(std::clamp(base + 1.0, 0.0, maxIndex));
+		taps.weight[i] = static_cast<float>(coord - base);
+	}
+	return taps;
+}
+
+std::vector<std::uint32_t> makePointTaps(std::uint32_t sourceSize, std::uint32_t spriteSize)
+{
+	std::vector<std::uint32_t> taps(spriteSize);
+	for (std::uint32_t i = 0; i < spriteSize; ++i) {
+		const auto index = static_cast<std::uint32_t>(std::floor((i + 0.5) * sourceSize / spriteSize));
+		taps[i] = std::min(index, sourceSize - 1);
+	}
+	return taps;
+}
+
+float sampleLinear(const Texture &texture, const LinearTaps &tapsX, const LinearTaps &tapsY, std::uint32_t x,
+		   std::uint32_t y, std::uint32_t channel) noexcept
+{
+	const std::uint32_t channelCount = texture.getChannelCount();
+	const float *row0 = texture.getRow(tapsY.first[y]);
+	const float *row1 = texture.getRow(tapsY.second[y]);
+	const std::size_t i0 = static_cast<std::size_t>(tapsX.first[x]) * channelCount + channel;
+	const std::size_t i1 = static_cast<std::size_t>(tapsX.second[x]) * channelCount + channel;
+
+	const float top = row0[i0] + (row0[i1] - row0[i0]) * tapsX.weight[x];
+	const float bottom = row1[i0] + (row1[i1] - row1[i0]) * tapsX.weight[x];
+	return top + (bottom - top) * tapsY.weight[y];
+}
+
+/**
+ * @brief Adds @p scale times the bilinear sample of all four channels of @p texture to @p sum.
+ */
+void accumulateLinear4(float *sum, float scale, const Texture &texture, const LinearTaps &tapsX,
+		       const LinearTaps &tapsY, std::uint32_t x, std::uint32_t y) noexcept
+{
+	const float *row0 = texture.getRow(tapsY.first[y]);
+	const float *row1 = texture.getRow(tapsY.second[y]);
+	const float *t00 = row0 + static_cast<std::size_t>(tapsX.first[x]) * 4;
+	const float *t01 = row0 + static_cast<std::size_t>(tapsX.second[x]) * 4;
+	const float *t10 = row1 + static_cast<std::size_t>(tapsX.first[x]) * 4;
+	const float *t11 = row1 + static_cast<std::size_t>(tapsX.second[x]) * 4;
+	const float weightX = tapsX.weight[x];
+	const float weightY = tapsY.weight[y];
+
+	for (std::size_t c = 0; c < 4; ++c) {
+		const float top = t00[c] + (t01[c] - t00[c]) * weightX;
+		const float bottom = t10[c] + (t11[c] - t10[c]) * weightX;
+		sum[c] += (top + (bottom - top) * weightY) * scale;
+	}
+}
+
+/**
+ * @brief Returns a texel as the float4 a shader would sample, in RGBA order.
+ */
+std::array<float, 4> readRgba(const Texture &texture, const float *texel) noexcept
+{
+	if (texture.getChannelCount() == 1) {
+		return {texel[0], 0.0f, 0.0f, 1.0f};
+	}
+	if (texture.getFormat() == TextureFormat::RGBA32F) {
+		return {texel[0], texel[1], texel[2], texel[3]};
+	}
+	return {texel[2], texel[1], texel[0], texel[3]};
+}
+
+void writeRgba(const Texture &texture, float *texel, const std::array<float, 4> &rgba) noexcept
+{
+	if (texture.getChannelCount() == 1) {
+		texel[0] = rgba[0];
+	} else if (texture.getFormat() == TextureFormat::RGBA32F) {
+		std::copy(rgba.begin(), rgba.end(), texel);
+	} else {
+		texel[0] = rgba[2];
+		texel[1] = rgba[1];
+		texel[2] = rgba[0];
+		texel[3] = rgba[3];
+	}
+}
+
+void requireSameSize(const Texture &a, const Texture &b, const char *error)
+{
+	if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight()) {
+		throw std::invalid_argument(error);
+	}
+}
+
+/**
+ * @brief Draws @p sourceTexture with the Draw technique as a sprite of the given size placed at (x, y).
+ *
+ * A target pixel is covered when its center falls inside the sprite, as with the GPU rasterizer.
+ */
+void drawSprite(Texture &targetTexture, const Texture &sourceTexture, std::uint32_t spriteWidth,
+		std::uint32_t spriteHeight, float x, float y)
+{
+	const std::uint32_t targetChannels = targetTexture.getChannelCount();
+	const std::uint32_t sourceChannels = sourceTexture.getChannelCount();
+
+	// An unscaled sprite on whole pixels is a plain copy of the overlapping rows
+	if (spriteWidth == sourceTexture.getWidth() && spriteHeight == sourceTexture.getHeight() &&
+	    targetChannels == sourceChannels &&
+	    Texture::getRedChannel(targetTexture.getFormat()) == Texture::getRedChannel(sourceTexture.getFormat()) &&
+	    x == std::floor(x) && y == std::floor(y)) {
+		const auto left = static_cast<std::int64_t>(x);
+		const auto top = static_cast<std::int64_t>(y);
+		const std::int64_t beginX = std::max<std::int64_t>(0, left);
+		const std::int64_t endX = std::min<std::int64_t>(targetTexture.getWidth(), left + spriteWidth);
+		if (beginX < endX) {
+			for (std::int64_t py = std::max<std::int64_t>(0, top);
+			     py < std::min<std::int64_t>(targetTexture.getHeight(), top + spriteHeight); ++py) {
+				const float *sourceRow = sourceTexture.getRow(static_cast<std::uint32_t>(py - top));
+				std::copy(sourceRow + (beginX - left) * sourceChannels, sourceRow + (endX - left) * sourceChannels,
+					  targetTexture.getRow(static_cast<std::uint32_t>(py)) + beginX * targetChannels);
+			}
+		}
+		targetTexture.resolve();
+		return;
+	}
+
+	const std::vector<std::uint32_t> tapsX = makePointTaps(sourceTexture.getWidth(), spriteWidth);
+	const std::vector<std::uint32_t> tapsY = makePointTaps(sourceTexture.getHeight(), spriteHeight);
+
+	for (std::uint32_t py = 0; py < targetTexture.getHeight(); ++py) {
+		const double spriteY = py + 0.5 - y;
+		if (spriteY < 0.0 || spriteY >= spriteHeight) {
+			continue;
+		}
+		const float *sourceRow = sourceTexture.getRow(tapsY[static_cast<std::uint32_t>(spriteY)]);
+		float *targetRow = targetTexture.getRow(py);
+
+		for (std::uint32_t px = 0; px < targetTexture.getWidth(); ++px) {
+			const double spriteX = px + 0.5 - x;
+			if (spriteX < 0.0 || spriteX >= spriteWidth) {
+				continue;
+			}
+			const float *sourceTexel =
+				sourceRow + static_cast<std::size_t>(tapsX[static_cast<std::uint32_t>(spriteX)]) *
+						    sourceChannels;
+			writeRgba(targetTexture, targetRow + static_cast<std::size_t>(px) * targetChannels,
+				  readRgba(sourceTexture, sourceTexel));
+		}
+	}
+	targetTexture.resolve();
+}
+
+/**
+ * @brief The horizontal pass of a box filter of 2 * boxRadius + 1 taps, with clamp addressing at the edges.
+ *
+ * Every channel of the target is filtered independently.
+ *
+ * @param loadRow Writes the width texels of filter inputs in row y, interleaved like the target, to the given buffer.
+ */
+template<typename LoadRow>
+void applyHorizontalBoxFilter(Texture &targetTexture, std::uint32_t width, std::uint32_t height,
+			      std::uint32_t boxRadius, LoadRow loadRow)
+{
+	const std::size_t channelCount = targetTexture.getChannelCount();
+	const std::size_t rowSize = width * channelCount;
+	const std::size_t padSize = boxRadius * channelCount;
+	const auto boxSize = static_cast<float>(2 * boxRadius + 1);
+	std::vector<float> padded(rowSize + 2 * padSize);
+	std::vector<double> sums(channelCount);
+	float *inner = padded.data() + padSize;
+
+	for (std::uint32_t y = 0; y < height; ++y) {
+		loadRow(y, inner);
+		for (std::size_t i = 0; i < padSize; i += channelCount) {
+			std::copy(inner, inner + channelCount, padded.begin() + static_cast<std::ptrdiff_t>(i));
+			std::copy(inner + rowSize - channelCount, inner + rowSize,
+				  padded.end() - static_cast<std::ptrdiff_t>(padSize - i));
+		}
+
+		float *targetRow = targetTexture.getRow(y);
+		if (boxRadius <= kMaxDirectSumBoxRadius) {
+			std::copy(padded.begin(), padded.begin() + static_cast<std::ptrdiff_t>(rowSize), targetRow);
+			for (std::uint32_t k = 1; k < 2 * boxRadius + 1; ++k) {
+				const float *tap = padded.data() + k * channelCount;
+				for (std::size_t i = 0; i < rowSize; ++i) {
+					targetRow[i] += tap[i];
+				}
+			}
+			for (std::size_t i = 0; i < rowSize; ++i) {
+				targetRow[i] /= boxSize;
+			}
+			continue;
+		}
+
+		// The sums are kept in double so that the sliding updates do not drift across the row
+		std::fill(sums.begin(), sums.end(), 0.0);
+		for (std::size_t i = 0; i < 2 * padSize + channelCount; ++i) {
+			sums[i % channelCount] += padded[i];
+		}
+		for (std::size_t i = 0; i < rowSize; ++i) {
+			const std::size_t channel = i % channelCount;
+			targetRow[i] = static_cast<float>(sums[channel] / boxSize);
+			if (i + 2 * padSize + channelCount < padded.size()) {
+				sums[channel] += padded[i + 2 * padSize + channelCount] - padded[i];
+			}
+		}
+	}
+	targetTexture.resolve();
+}
+
+/**
+ * @brief The vertical pass of a box filter of 2 * boxRadius + 1 taps, with clamp addressing at the edges.
+ */
+void applyVerticalBoxFilter(Texture &targetTexture, const Texture &intermediateTexture, std::uint32_t boxRadius)
+{
+	const std::size_t rowSize = intermediateTexture.getRowStride();
+	const auto height = static_cast<std::int64_t>(intermediateTexture.getHeight());
+	const auto radius = static_cast<std::int64_t>(boxRadius);
+	const auto boxSize = static_cast<float>(2 * boxRadius + 1);
+	const auto clampedRow = [&](std::int64_t y) {
+		const auto clampedY = static_cast<std::uint32_t>(std::clamp<std::int64_t>(y, 0, height - 1));
+		return intermediateTexture.getRow(clampedY);
+	};
+
+	if (boxRadius <= kMaxDirectSumBoxRadius) {
+		for (std::int64_t y = 0; y < height; ++y) {
+			float *targetRow = targetTexture.getRow(static_cast<std::uint32_t>(y));
+			const float *firstRow = clampedRow(y - radius);
+			std::copy(firstRow, firstRow + rowSize, targetRow);
+			for (std::int64_t k = 1 - radius; k <= radius; ++k) {
+				const float *row = clampedRow(y + k);
+				for (std::size_t i = 0; i < rowSize; ++i) {
+					targetRow[i] += row[i];
+				}
+			}
+			for (std::size_t i = 0; i < rowSize; ++i) {
+				targetRow[i] /= boxSize;
+			}
+		}
+		targetTexture.resolve();
+		return;
+	}
+
+	std::vector<double> sums(rowSize);
+	for (std::int64_t k = -radius; k <= radius; ++k) {
+		const float *row = clampedRow(k);
+		for (std::size_t i = 0; i < rowSize; ++i) {
+			sums[i] += row[i];
+		}
+	}
+	for (std::int64_t y = 0; y < height; ++y) {
+		float *targetRow = targetTexture.getRow(static_cast<std::uint32_t>(y));
+		const float *enteringRow = clampedRow(y + radius + 1);
+		const float *leavingRow = clampedRow(y - radius);
+		for (std::size_t i = 0; i < rowSize; ++i) {
+			targetRow[i] = static_cast<float>(sums[i] / boxSize);
+			sums[i] += enteringRow[i] - leavingRow[i];
+		}
+	}
+	targetTexture.resolve();
+}
+
+/**
+ * @brief Returns the alpha that DrawWithRefinedMask and DrawWithRefinedBlurredBackground derive from the raw mask.
+ */
+float refineMask(float rawMask, float gamma, float lowerBound, float upperBound) noexcept
+{
+	const float gammaCorrected = std::pow(std::clamp(rawMask, 0.0f, 1.0f), gamma);
+	const float t = std::clamp((gammaCorrected - lowerBound) / (upperBound - lowerBound), 0.0f, 1.0f);
+	return t * t * (3.0f - 2.0f * t);
+}
+
+/**
+ * @brief Runs one of the direct draw composites. @p shade maps the sprite pixel (x, y) to an RGBA color.
+ */
+template<typename Shade> void composite(Texture &outputTexture, const Texture &sourceTexture, Shade shade)
+{
+	const std::uint32_t width = std::min(outputTexture.getWidth(), sourceTexture.getWidth());
+	const std::uint32_t height = std::min(outputTexture.getHeight(), sourceTexture.getHeight());
+	const std::uint32_t channelCount = outputTexture.getChannelCount();
+
+	for (std::uint32_t y = 0; y < height; ++y) {
+		float *outputRow = outputTexture.getRow(y);
+		for (std::uint32_t x = 0; x < width; ++x) {
+			writeRgba(outputTexture, outputRow + static_cast<std::size_t>(x) * channelCount, shade(x, y));
+		}
+	}
+	outputTexture.resolve();
+}
+
+} // anonymous namespace
+
+void ReferenceMainEffect::drawSource(Texture &targetTexture, const Texture &frameTexture) const
+{
+	drawSprite(targetTexture, frameTexture, frameTexture.getWidth(), frameTexture.getHeight(), 0.0f, 0.0f);
+}
+
+void ReferenceMainEffect::drawRoi(Texture &targetTexture, const Texture &sourceTexture,
+				  const std::array<float, 4> &color, const std::uint32_t width,
+				  const std::uint32_t height, const float x, const float y) const
+{
+	targetTexture.clear(color);
+	drawSprite(targetTexture, sourceTexture, width > 0 ? width : sourceTexture.getWidth(),
+		   height > 0 ? height : sourceTexture.getHeight(), x, y);
+}
+
+void ReferenceMainEffect::convertToLuma(Texture &targetTexture, const Texture &sourceTexture) const
+{
+	requireSameSize(targetTexture, sourceTexture, "SizeMismatchError(ReferenceMainEffect::convertToLuma)");
+
+	const std::uint32_t width = sourceTexture.getWidth();
+	for (std::uint32_t y = 0; y < sourceTexture.getHeight(); ++y) {
+		const float *bgrx = sourceTexture.getRow(y);
+		float *luma = targetTexture.getRow(y);
+		for (std::uint32_t x = 0; x < width; ++x) {
+			luma[x] = 0.2126f * bgrx[x * 4 + 2] + 0.7152f * bgrx[x * 4 + 1] + 0.0722f * bgrx[x * 4 + 0];
+		}
+	}
+	targetTexture.resolve();
+}
+
+void ReferenceMainEffect::resampleByNearestR8(Texture &targetTexture, const Texture &sourceTexture) const
+{
+	const std::vector<std::uint32_t> tapsX = makePointTaps(sourceTexture.getWidth(), targetTexture.getWidth());
+	const std::vector<std::uint32_t> tapsY = makePointTaps(sourceTexture.getHeight(), targetTexture.getHeight());
+	const std::uint32_t sourceChannels = sourceTexture.getChannelCount();
+	const std::uint32_t red = Texture::getRedChannel(sourceTexture.getFormat());
+
+	for (std::uint32_t y = 0; y < targetTexture.getHeight(); ++y) {
+		const float *sourceRow = sourceTexture.getRow(tapsY[y]);
+		float *targetRow = targetTexture.getRow(y);
+		for (std::uint32_t x = 0; x < targetTexture.getWidth(); ++x) {
+			targetRow[x] = sourceRow[static_cast<std::size_t>(tapsX[x]) * sourceChannels + red];
+		}
+	}
+	targetTexture.resolve();
+}
+
+void ReferenceMainEffect::calculateSquaredMotion(Texture &targetTexture, const Texture &currentLumaTexture,
+						 const Texture &lastLumaTexture) const
+{
+	requireSameSize(currentLumaTexture, lastLumaTexture,
+			"SizeMismatchError(ReferenceMainEffect::calculateSquaredMotion)");
+
+	// The sprite has the size of the luma, so a padded target keeps its cleared border
+	const std::uint32_t width = std::min(targetTexture.getWidth(), currentLumaTexture.getWidth());
+	const std::uint32_t height = std::min(targetTexture.getHeight(), currentLumaTexture.getHeight());
+	for (std::uint32_t y = 0; y < height; ++y) {
+		const float *current = currentLumaTexture.getRow(y);
+		const float *last = lastLumaTexture.getRow(y);
+		float *target = targetTexture.getRow(y);
+		for (std::uint32_t x = 0; x < width; ++x) {
+			const float diff = current[x] - last[x];
+			target[x] = diff * diff;
+		}
+	}
+	targetTexture.resolve();
+}
+
+void ReferenceMainEffect::reduce(std::vector<Texture> &reductionPyramidTextures, const Texture &sourceTexture) const
+{
+	const Texture *currentSourceTexture = &sourceTexture;
+
+	for (Texture &currentTargetTexture : reductionPyramidTextures) {
+		const std::uint32_t targetWidth = currentTargetTexture.getWidth();
+		const std::uint32_t targetHeight = currentTargetTexture.getHeight();
+		const LinearTaps tapsX = makeLinearTaps(currentSourceTexture->getWidth(), targetWidth, 0.0);
+		const LinearTaps tapsY = makeLinearTaps(currentSourceTexture->getHeight(), targetHeight, 0.0);
+
+		for (std::uint32_t y = 0; y < targetHeight; ++y) {
+			float *targetRow = currentTargetTexture.getRow(y);
+			for (std::uint32_t x = 0; x < targetWidth; ++x) {
+				targetRow[x] = sampleLinear(*currentSourceTexture, tapsX, tapsY, x, y, 0) * 4.0f;
+			}
+		}
+		currentTargetTexture.resolve();
+
+		currentSourceTexture = &currentTargetTexture;
+	}
+}
+
+void ReferenceMainEffect::applyBoxFilterR8KS17(Texture &targetTexture, const Texture &sourceTexture,
+					       Texture &intermediateTexture) const
+{
+	requireSameSize(intermediateTexture, sourceTexture, "SizeMismatchError(ReferenceMainEffect::applyBoxFilterR8KS17)");
+
+	// Each pair of bilinear taps in the shader averages two neighbors, so the result is an exact 17-tap box
+	const std::uint32_t width = sourceTexture.getWidth();
+	applyHorizontalBoxFilter(intermediateTexture, width, sourceTexture.getHeight(), kKS17BoxRadius,
+				 [&](std::uint32_t y, float *row) {
+					 const float *source = sourceTexture.getRow(y);
+					 std::copy(source, source + width, row);
+				 });
+	applyVerticalBoxFilter(targetTexture, intermediateTexture, kKS17BoxRadius);
+}
+
+void ReferenceMainEffect::applyBoxFilterWithMulR8KS17(Texture &targetTexture, const Texture &sourceTexture1,
+						      const Texture &sourceTexture2,
+						      Texture &intermediateTexture) const
+{
+	requireSameSize(intermediateTexture, sourceTexture1,
+			"SizeMismatchError(ReferenceMainEffect::applyBoxFilterWithMulR8KS17)");
+	requireSameSize(sourceTexture1, sourceTexture2,
+			"SizeMismatchError(ReferenceMainEffect::applyBoxFilterWithMulR8KS17)");
+
+	const std::uint32_t width = sourceTexture1.getWidth();
+	applyHorizontalBoxFilter(intermediateTexture, width, sourceTexture1.getHeight(), kKS17BoxRadius,
+				 [&](std::uint32_t y, float *row) {
+					 const float *source1 = sourceTexture1.getRow(y);
+					 const float *source2 = sourceTexture2.getRow(y);
+					 for (std::uint32_t x = 0; x < width; ++x) {
+						 row[x] = source1[x] * source2[x];
+					 }
+				 });
+	applyVerticalBoxFilter(targetTexture, intermediateTexture, kKS17BoxRadius);
+}
+
+void ReferenceMainEffect::applyBoxFilterWithSqR8KS17(Texture &targetTexture, const Texture &sourceTexture,
+						     Texture &intermediateTexture) const
+{
+	requireSameSize(intermediateTexture, sourceTexture,
+			"SizeMismatchError(ReferenceMainEffect::applyBoxFilterWithSqR8KS17)");
+
+	const std::uint32_t width = sourceTexture.getWidth();
+	applyHorizontalBoxFilter(intermediateTexture, width, sourceTexture.getHeight(), kKS17BoxRadius,
+				 [&](std::uint32_t y, float *row) {
+					 const float *source = sourceTexture.getRow(y);
+					 for (std::uint32_t x = 0; x < width; ++x) {
+						 row[x] = source[x] * source[x];
+					 }
+				 });
+	applyVerticalBoxFilter(targetTexture, intermediateTexture, kKS17BoxRadius);
+}
+
+void ReferenceMainEffect::applyGuidedFilterMeans(Texture &targetTexture, const Texture &sourceGuideTexture,
+						 const Texture &sourceTexture, Texture &intermediateTexture,
+						 std::uint32_t boxRadius) const
+{
+	if (boxRadius == 0) {
+		throw std::invalid_argument("BoxRadiusOutOfRangeError(ReferenceMainEffect::applyGuidedFilterMeans)");
+	}
+	requireSameSize(intermediateTexture, sourceGuideTexture,
+			"SizeMismatchError(ReferenceMainEffect::applyGuidedFilterMeans)");
+	requireSameSize(sourceGuideTexture, sourceTexture,
+			"SizeMismatchError(ReferenceMainEffect::applyGuidedFilterMeans)");
+	if (targetTexture.getFormat() != TextureFormat::RGBA32F ||
+	    intermediateTexture.getFormat() != TextureFormat::RGBA32F) {
+		throw std::invalid_argument("FormatMismatchError(ReferenceMainEffect::applyGuidedFilterMeans)");
+	}
+
+	const std::uint32_t width = sourceGuideTexture.getWidth();
+	applyHorizontalBoxFilter(intermediateTexture, width, sourceGuideTexture.getHeight(), boxRadius,
+				 [&](std::uint32_t y, float *row) {
+					 const float *guide = sourceGuideTexture.getRow(y);
+					 const float *source = sourceTexture.getRow(y);
+					 for (std::uint32_t x = 0; x < width; ++x) {
+						 row[x * 4 + 0] = guide[x];
+						 row[x * 4 + 1] = source[x];
+						 row[x * 4 + 2] = guide[x] * source[x];
+						 row[x * 4 + 3] = guide[x] * guide[x];
+					 }
+				 });
+	applyVerticalBoxFilter(targetTexture, intermediateTexture, boxRadius);
+}
+
+void ReferenceMainEffect::calculateGuidedFilterAAndB(Texture &targetATexture, Texture &targetBTexture,
+						     const Texture &sourceMeanGuideSqTexture,
+						     const Texture &sourceMeanGuideTexture,
+						     const Texture &sourceMeanGuideSourceTexture,
+						     const Texture &sourceMeanSourceTexture, const float eps) const
+{
+	requireSameSize(targetATexture, sourceMeanGuideSqTexture,
+			"SizeMismatchError(ReferenceMainEffect::calculateGuidedFilterAAndB)");
+	requireSameSize(targetBTexture, sourceMeanGuideSqTexture,
+			"SizeMismatchError(ReferenceMainEffect::calculateGuidedFilterAAndB)");
+
+	const std::uint32_t width = sourceMeanGuideSqTexture.getWidth();
+	for (std::uint32_t y = 0; y < sourceMeanGuideSqTexture.getHeight(); ++y) {
+		const float *meanGuideSq = sourceMeanGuideSqTexture.getRow(y);
+		const float *meanGuide = sourceMeanGuideTexture.getRow(y);
+		const float *meanGuideSource = sourceMeanGuideSourceTexture.getRow(y);
+		const float *meanSource = sourceMeanSourceTexture.getRow(y);
+		float *a = targetATexture.getRow(y);
+		for (std::uint32_t x = 0; x < width; ++x) {
+			const float covGuideSource = meanGuideSource[x] - meanGuide[x] * meanSource[x];
+			const float varGuide = meanGuideSq[x] - meanGuide[x] * meanGuide[x];
+			a[x] = covGuideSource / (varGuide + eps);
+		}
+	}
+	targetATexture.resolve();
+
+	// B reads A back from its target, so an 8-bit A target would be rounded first as on the GPU
+	for (std::uint32_t y = 0; y < sourceMeanGuideSqTexture.getHeight(); ++y) {
+		const float *a = targetATexture.getRow(y);
+		const float *meanSource = sourceMeanSourceTexture.getRow(y);
+		const float *meanGuide = sourceMeanGuideTexture.getRow(y);
+		float *b = targetBTexture.getRow(y);
+		for (std::uint32_t x = 0; x < width; ++x) {
+			b[x] = meanSource[x] - a[x] * meanGuide[x];
+		}
+	}
+	targetBTexture.resolve();
+}
+
+void ReferenceMainEffect::calculateGuidedFilterAAndBFromMeans(Texture &targetATexture, Texture &targetBTexture,
+							      const Texture &sourceMeansTexture, const float eps) const
+{
+	requireSameSize(targetATexture, sourceMeansTexture,
+			"SizeMismatchError(ReferenceMainEffect::calculateGuidedFilterAAndBFromMeans)");
+	requireSameSize(targetBTexture, sourceMeansTexture,
+			"SizeMismatchError(ReferenceMainEffect::calculateGuidedFilterAAndBFromMeans)");
+	if (sourceMeansTexture.getFormat() != TextureFormat::RGBA32F) {
+		throw std::invalid_argument(
+			"FormatMismatchError(ReferenceMainEffect::calculateGuidedFilterAAndBFromMeans)");
+	}
+
+	const std::uint32_t width = sourceMeansTexture.getWidth();
+	for (std::uint32_t y = 0; y < sourceMeansTexture.getHeight(); ++y) {
+		const float *means = sourceMeansTexture.getRow(y);
+		float *a = targetATexture.getRow(y);
+		for (std::uint32_t x = 0; x < width; ++x) {
+			const float meanGuide = means[x * 4 + 0];
+			const float meanSource = means[x * 4 + 1];
+			const float covGuideSource = means[x * 4 + 2] - meanGuide * meanSource;
+			const float varGuide = means[x * 4 + 3] - meanGuide * meanGuide;
+			a[x] = covGuideSource / (varGuide + eps);
+		}
+	}
+	targetATexture.resolve();
+
+	for (std::uint32_t y = 0; y < sourceMeansTexture.getHeight(); ++y) {
+		const float *a = targetATexture.getRow(y);
+		const float *means = sourceMeansTexture.getRow(y);
+		float *b = targetBTexture.getRow(y);
+		for (std::uint32_t x = 0; x < width; ++x) {
+			b[x] = means[x * 4 + 1] - a[x] * means[x * 4 + 0];
+		}
+	}
+	targetBTexture.resolve();
+}
+
+void ReferenceMainEffect::finalizeGuidedFilter(Texture &targetTexture, const Texture &sourceGuideTexture,
+					       const Texture &sourceATexture, const Texture &sourceBTexture) const
+{
+	requireSameSize(targetTexture, sourceGuideTexture,
+			"SizeMismatchError(ReferenceMainEffect::finalizeGuidedFilter)");
+	requireSameSize(sourceATexture, sourceBTexture, "SizeMismatchError(ReferenceMainEffect::finalizeGuidedFilter)");
+
+	const std::uint32_t width = sourceGuideTexture.getWidth();
+	const std::uint32_t coefficientWidth = sourceATexture.getWidth();
+	const LinearTaps tapsX = makeLinearTaps(coefficientWidth, width, 0.0);
+	const LinearTaps tapsY = makeLinearTaps(sourceATexture.getHeight(), sourceGuideTexture.getHeight(), 0.0);
+
+	// Interpolate the coefficient rows vertically first so the per-pixel work is one horizontal lerp each
+	std::vector<float> aRow(coefficientWidth);
+	std::vector<float> bRow(coefficientWidth);
+
+	for (std::uint32_t y = 0; y < sourceGuideTexture.getHeight(); ++y) {
+		const float weightY = tapsY.weight[y];
+		const float *a0 = sourceATexture.getRow(tapsY.first[y]);
+		const float *a1 = sourceATexture.getRow(tapsY.second[y]);
+		const float *b0 = sourceBTexture.getRow(tapsY.first[y]);
+		const float *b1 = sourceBTexture.getRow(tapsY.second[y]);
+		for (std::uint32_t x = 0; x < coefficientWidth; ++x) {
+			aRow[x] = a0[x] + (a1[x] - a0[x]) * weightY;
+			bRow[x] = b0[x] + (b1[x] - b0[x]) * weightY;
+		}
+
+		const float *guide = sourceGuideTexture.getRow(y);
+		float *target = targetTexture.getRow(y);
+		for (std::uint32_t x = 0; x < width; ++x) {
+			const std::uint32_t i0 = tapsX.first[x];
+			const std::uint32_t i1 = tapsX.second[x];
+			const float a = aRow[i0] + (aRow[i1] - aRow[i0]) * tapsX.weight[x];
+			const float b = bRow[i0] + (bRow[i1] - bRow[i0]) * tapsX.weight[x];
+			target[x] = a * guide[x] + b;
+		}
+	}
+	targetTexture.resolve();
+}
+
+void ReferenceMainEffect::timeAveragedFiltering(Texture &targetTexture, const Texture &previousMaskTexture,
+						const Texture &sourceTexture, const float alpha) const
+{
+	requireSameSize(targetTexture, sourceTexture, "SizeMismatchError(ReferenceMainEffect::timeAveragedFiltering)");
+	requireSameSize(previousMaskTexture, sourceTexture,
+			"SizeMismatchError(ReferenceMainEffect::timeAveragedFiltering)");
+
+	const std::size_t count = sourceTexture.size();
+	const float *source = sourceTexture.data();
+	const float *previous = previousMaskTexture.data();
+	float *target = targetTexture.data();
+	for (std::size_t i = 0; i < count; ++i) {
+		target[i] = alpha * source[i] + (1.0f - alpha) * previous[i];
+	}
+	targetTexture.resolve();
+}
+
+void ReferenceMainEffect::dualKawaseBlur(std::vector<Texture> &texturePyramid, int blurSize) const
+{
+	if (blurSize < 0 || static_cast<std::size_t>(blurSize) >= texturePyramid.size()) {
+		throw std::invalid_argument("BlurSizeOutOfRangeError(ReferenceMainEffect::dualKawaseBlur)");
+	}
+
+	const auto level = [&](int i) -> Texture & { return texturePyramid[static_cast<std::size_t>(i)]; };
+
+	for (int i = 0; i < blurSize; ++i) {
+		const Texture &source = level(i);
+		Texture &target = level(i + 1);
+		const std::uint32_t width = target.getWidth();
+		const std::uint32_t height = target.getHeight();
+
+		const LinearTaps leftX = makeLinearTaps(source.getWidth(), width, -1.0);
+		const LinearTaps centerX = makeLinearTaps(source.getWidth(), width, 0.0);
+		const LinearTaps rightX = makeLinearTaps(source.getWidth(), width, 1.0);
+		const LinearTaps topY = makeLinearTaps(source.getHeight(), height, -1.0);
+		const LinearTaps centerY = makeLinearTaps(source.getHeight(), height, 0.0);
+		const LinearTaps bottomY = makeLinearTaps(source.getHeight(), height, 1.0);
+
+		for (std::uint32_t y = 0; y < height; ++y) {
+			float *targetRow = target.getRow(y);
+			for (std::uint32_t x = 0; x < width; ++x) {
+				float *sum = targetRow + static_cast<std::size_t>(x) * 4;
+				std::fill(sum, sum + 4, 0.0f);
+				accumulateLinear4(sum, 4.0f / 8.0f, source, centerX, centerY, x, y);
+				accumulateLinear4(sum, 1.0f / 8.0f, source, leftX, topY, x, y);
+				accumulateLinear4(sum, 1.0f / 8.0f, source, leftX, bottomY, x, y);
+				accumulateLinear4(sum, 1.0f / 8.0f, source, rightX, topY, x, y);
+				accumulateLinear4(sum, 1.0f / 8.0f, source, rightX, bottomY, x, y);
+			}
+		}
+		target.resolve();
+	}
+
+	for (int i = blurSize; i > 0; --i) {
+		const Texture &source = level(i);
+		Texture &target = level(i - 1);
+		const std::uint32_t width = target.getWidth();
+		const std::uint32_t height = target.getHeight();
+
+		const LinearTaps leftX = makeLinearTaps(source.getWidth(), width, -1.0);
+		const LinearTaps halfLeftX = makeLinearTaps(source.getWidth(), width, -0.5);
+		const LinearTaps centerX = makeLinearTaps(source.getWidth(), width, 0.0);
+		const LinearTaps halfRightX = makeLinearTaps(source.getWidth(), width, 0.5);
+		const LinearTaps rightX = makeLinearTaps(source.getWidth(), width, 1.0);
+		const LinearTaps topY = makeLinearTaps(source.getHeight(), height, -1.0);
+		const LinearTaps halfTopY = makeLinearTaps(source.getHeight(), height, -0.5);
+		const LinearTaps centerY = makeLinearTaps(source.getHeight(), height, 0.0);
+		const LinearTaps halfBottomY = makeLinearTaps(source.getHeight(), height, 0.5);
+		const LinearTaps bottomY = makeLinearTaps(source.getHeight(), height, 1.0);
+
+		for (std::uint32_t y = 0; y < height; ++y) {
+			float *targetRow = target.getRow(y);
+			for (std::uint32_t x = 0; x < width; ++x) {
+				float *sum = targetRow + static_cast<std::size_t>(x) * 4;
+				std::fill(sum, sum + 4, 0.0f);
+				accumulateLinear4(sum, 1.0f / 12.0f, source, leftX, centerY, x, y);
+				accumulateLinear4(sum, 1.0f / 12.0f, source, rightX, centerY, x, y);
+				accumulateLinear4(sum, 1.0f / 12.0f, source, centerX, topY, x, y);
+				accumulateLinear4(sum, 1.0f / 12.0f, source, centerX, bottomY, x, y);
+				accumulateLinear4(sum, 2.0f / 12.0f, source, halfLeftX, halfTopY, x, y);
+				accumulateLinear4(sum, 2.0f / 12.0f, source, halfLeftX, halfBottomY, x, y);
+				accumulateLinear4(sum, 2.0f / 12.0f, source, halfRightX, halfTopY, x, y);
+				accumulateLinear4(sum, 2.0f / 12.0f, source, halfRightX, halfBottomY, x, y);
+			}
+		}
+		target.resolve();
+	}
+}
+
+void ReferenceMainEffect::directDraw(Texture &outputTexture, const Texture &sourceTexture) const
+{
+	drawSprite(outputTexture, sourceTexture, sourceTexture.getWidth(), sourceTexture.getHeight(), 0.0f, 0.0f);
+}
+
+void ReferenceMainEffect::directDrawWithMask(Texture &outputTexture, const Texture &sourceTexture,
+					     const Texture &maskTexture) const
+{
+	const LinearTaps tapsX = makeLinearTaps(maskTexture.getWidth(), sourceTexture.getWidth(), 0.0);
+	const LinearTaps tapsY = makeLinearTaps(maskTexture.getHeight(), sourceTexture.getHeight(), 0.0);
+	const std::uint32_t maskRed = Texture::getRedChannel(maskTexture.getFormat());
+
+	composite(outputTexture, sourceTexture, [&](std::uint32_t x, std::uint32_t y) {
+		std::array<float, 4> color = readRgba(sourceTexture, sourceTexture.getRow(y) + x * 4);
+		color[3] = sampleLinear(maskTexture, tapsX, tapsY, x, y, maskRed);
+		return color;
+	});
+}
+
+void ReferenceMainEffect::directDrawWithBlurredBackground(Texture &outputTexture, const Texture &sourceTexture,
+							  const Texture &maskTexture,
+							  const Texture &blurredBackgroundTexture) const
+{
+	requireSameSize(sourceTexture, blurredBackgroundTexture,
+			"SizeMismatchError(ReferenceMainEffect::directDrawWithBlurredBackground)");
+
+	const LinearTaps tapsX = makeLinearTaps(maskTexture.getWidth(), sourceTexture.getWidth(), 0.0);
+	const LinearTaps tapsY = makeLinearTaps(maskTexture.getHeight(), sourceTexture.getHeight(), 0.0);
+	const std::uint32_t maskRed = Texture::getRedChannel(maskTexture.getFormat());
+
+	composite(outputTexture, sourceTexture, [&](std::uint32_t x, std::uint32_t y) {
+		const float a = sampleLinear(maskTexture, tapsX, tapsY, x, y, maskRed);
+		const auto foreground = readRgba(sourceTexture, sourceTexture.getRow(y) + x * 4);
+		const auto background = readRgba(blurredBackgroundTexture, blurredBackgroundTexture.getRow(y) + x * 4);
+		return std::array<float, 4>{a * foreground[0] + (1.0f - a) * background[0],
+					    a * foreground[1] + (1.0f - a) * background[1],
+					    a * foreground[2] + (1.0f - a) * background[2], 1.0f};
+	});
+}
+
+void ReferenceMainEffect::directDrawWithRefinedMask(Texture &outputTexture, const Texture &sourceTexture,
+						    const Texture &maskTexture, const double gamma,
+						    const double lowerBound, const double upperBoundMargin) const
+{
+	const std::vector<std::uint32_t> tapsX = makePointTaps(maskTexture.getWidth(), sourceTexture.getWidth());
+	const std::vector<std::uint32_t> tapsY = makePointTaps(maskTexture.getHeight(), sourceTexture.getHeight());
+	const std::uint32_t maskChannels = maskTexture.getChannelCount();
+	const std::uint32_t maskRed = Texture::getRedChannel(maskTexture.getFormat());
+
+	composite(outputTexture, sourceTexture, [&](std::uint32_t x, std::uint32_t y) {
+		const float rawMask = maskTexture.getRow(tapsY[y])[tapsX[x] * maskChannels + maskRed];
+		std::array<float, 4> color = readRgba(sourceTexture, sourceTexture.getRow(y) + x * 4);
+		color[3] = refineMask(rawMask, static_cast<float>(gamma), static_cast<float>(lowerBound),
+				      static_cast<float>(1.0 - upperBoundMargin));
+		return color;
+	});
+}
+
+void ReferenceMainEffect::directDrawWithRefinedBlurredBackground(Texture &outputTexture,
+								 const Texture &sourceTexture,
+								 const Texture &maskTexture, const double gamma,
+								 const double lowerBound,
+								 const double upperBoundMargin,
+								 const Texture &blurredBackgroundTexture) const
+{
+	requireSameSize(sourceTexture, blurredBackgroundTexture,
+			"SizeMismatchError(ReferenceMainEffect::directDrawWithRefinedBlurredBackground)");
+
+	const std::vector<std::uint32_t> tapsX = makePointTaps(maskTexture.getWidth(), sourceTexture.getWidth());
+	const std::vector<std::uint32_t> tapsY = makePointTaps(maskTexture.getHeight(), sourceTexture.getHeight());
+	const std::uint32_t maskChannels = maskTexture.getChannelCount();
+	const std::uint32_t maskRed = Texture::getRedChannel(maskTexture.getFormat());
+
+	composite(outputTexture, sourceTexture, [&](std::uint32_t x, std::uint32_t y) {
+		const float rawMask = maskTexture.getRow(tapsY[y])[tapsX[x] * maskChannels + maskRed];
+		const float a = refineMask(rawMask, static_cast<float>(gamma), static_cast<float>(lowerBound),
+					   static_cast<float>(1.0 - upperBoundMargin));
+		const auto foreground = readRgba(sourceTexture, sourceTexture.getRow(y) + x * 4);
+		const auto background = readRgba(blurredBackgroundTexture, blurredBackgroundTexture.getRow(y) + x * 4);
+		return std::array<float, 4>{a * foreground[0] + (1.0f - a) * background[0],
+					    a * foreground[1] + (1.0f - a) * background[1],
+					    a * foreground[2] + (1.0f - a) * background[2], 1.0f};
+	});
+}
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect
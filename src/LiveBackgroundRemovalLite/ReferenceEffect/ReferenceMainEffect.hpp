@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Texture.hpp"
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect {
+
+/**
+ * @brief A CPU implementation of the techniques in data/effects/main.effect.
+ *
+ * Every method has the call shape of the MainEffect method of the same name, with Texture in place of
+ * unique_gs_texture_t, and reproduces what the GPU computes: the sprite size each draw uses, point and bilinear
+ * sampling with clamp addressing, and UNORM rounding on 8-bit targets. It can render the pipeline on machines
+ * without a GPU and serves as the expected output when testing the shaders.
+ *
+ * The methods that would draw to the current render target take an explicit output texture instead.
+ */
+class ReferenceMainEffect {
+public:
+	/**
+	 * @brief Stands in for drawSource, which draws the filter target with the Draw technique.
+	 */
+	void drawSource(Texture &targetTexture, const Texture &frameTexture) const;
+
+	/**
+	 * @param color The clear color in RGBA order.
+	 */
+	void drawRoi(Texture &targetTexture, const Texture &sourceTexture, const std::array<float, 4> &color,
+		     const std::uint32_t width = 0, const std::uint32_t height = 0, const float x = 0.0f,
+		     const float y = 0.0f) const;
+
+	void convertToLuma(Texture &targetTexture, const Texture &sourceTexture) const;
+
+	void resampleByNearestR8(Texture &targetTexture, const Texture &sourceTexture) const;
+
+	void calculateSquaredMotion(Texture &targetTexture, const Texture &currentLumaTexture,
+				    const Texture &lastLumaTexture) const;
+
+	void reduce(std::vector<Texture> &reductionPyramidTextures, const Texture &sourceTexture) const;
+
+	/**
+	 * @brief Box-filters one plane with a fixed kernel size of 17.
+	 *
+	 * This and the other per-plane KS17 methods below, together with calculateGuidedFilterAAndB, have no shader
+	 * counterpart any more. They keep the separate-plane guided filter as the baseline the fused path is tested
+	 * against.
+	 */
+	void applyBoxFilterR8KS17(Texture &targetTexture, const Texture &sourceTexture,
+				  Texture &intermediateTexture) const;
+
+	void applyBoxFilterWithMulR8KS17(Texture &targetTexture, const Texture &sourceTexture1,
+					 const Texture &sourceTexture2, Texture &intermediateTexture) const;
+
+	void applyBoxFilterWithSqR8KS17(Texture &targetTexture, const Texture &sourceTexture,
+					Texture &intermediateTexture) const;
+
+	/**
+	 * @brief Box-filters the guide, the source, their product and the squared guide in one pass pair.
+	 *
+	 * @param targetTexture An RGBA32F texture that receives mean I, mean p, mean I*p and mean I*I.
+	 * @param intermediateTexture An RGBA32F texture of the source size.
+	 * @param boxRadius The radius of the box, which spans 2 * boxRadius + 1 texels per axis.
+	 */
+	void applyGuidedFilterMeans(Texture &targetTexture, const Texture &sourceGuideTexture,
+				    const Texture &sourceTexture, Texture &intermediateTexture,
+				    std::uint32_t boxRadius) const;
+
+	void calculateGuidedFilterAAndB(Texture &targetATexture, Texture &targetBTexture,
+					const Texture &sourceMeanGuideSqTexture, const Texture &sourceMeanGuideTexture,
+					const Texture &sourceMeanGuideSourceTexture,
+					const Texture &sourceMeanSourceTexture, const float eps) const;
+
+	/**
+	 * @param sourceMeansTexture The packed means written by applyGuidedFilterMeans.
+	 */
+	void calculateGuidedFilterAAndBFromMeans(Texture &targetATexture, Texture &targetBTexture,
+						 const Texture &sourceMeansTexture, const float eps) const;
+
+	void finalizeGuidedFilter(Texture &targetTexture, const Texture &sourceGuideTexture,
+				  const Texture &sourceATexture, const Texture &sourceBTexture) const;
+
+	void timeAveragedFiltering(Texture &targetTexture, const Texture &previousMaskTexture,
+				   const Texture &sourceTexture, const float alpha) const;
+
+	void dualKawaseBlur(std::vector<Texture> &texturePyramid, int blurSize) const;
+
+	void directDraw(Texture &outputTexture, const Texture &sourceTexture) const;
+
+	void directDrawWithMask(Texture &outputTexture, const Texture &sourceTexture,
+				const Texture &maskTexture) const;
+
+	void directDrawWithBlurredBackground(Texture &outputTexture, const Texture &sourceTexture,
+					     const Texture &maskTexture,
+					     const Texture &blurredBackgroundTexture) const;
+
+	void directDrawWithRefinedMask(Texture &outputTexture, const Texture &sourceTexture,
+				       const Texture &maskTexture, const double gamma, const double lowerBound,
+				       const double upperBoundMargin) const;
+
+	void directDrawWithRefinedBlurredBackground(Texture &outputTexture, const Texture &sourceTexture,
+						    const Texture &maskTexture, const double gamma,
+						    const double lowerBound, const double upperBoundMargin,
+						    const Texture &blurredBackgroundTexture) const;
+};
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect
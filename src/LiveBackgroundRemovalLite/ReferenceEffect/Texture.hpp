@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <KaitoTokyo/Memory/AlignedAllocator.hpp>
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect {
+
+/**
+ * @brief The gs_color_format values that main.effect renders to, plus BGRA for the final composite.
+ */
+enum class TextureFormat {
+	BGRA,
+	BGRX,
+	R8,
+	R32F,
+	RGBA32F,
+};
+
+/**
+ * @brief A CPU stand-in for a gs_texture_t render target.
+ *
+ * Texels are stored as interleaved floats in the channel order of the GPU format, so a BGRX texture holds
+ * B, G, R, X per texel, an RGBA32F texture holds R, G, B, A and a single-channel texture holds only R. Writes to
+ * 8-bit formats are rounded to the nearest 1/255 like a UNORM render target would, so the CPU and GPU pipelines
+ * see the same intermediates.
+ */
+class Texture {
+public:
+	constexpr static std::size_t kAlignment = 64;
+
+	Texture(std::uint32_t width, std::uint32_t height, TextureFormat format)
+		: width_(width > 0 ? width : throw std::invalid_argument("WidthIsZeroError(Texture::Texture)")),
+		  height_(height > 0 ? height : throw std::invalid_argument("HeightIsZeroError(Texture::Texture)")),
+		  format_(format),
+		  channelCount_(getChannelCount(format)),
+		  texels_(static_cast<std::size_t>(width) * height * channelCount_, 0.0f,
+			  Memory::AlignedAllocator<float>(kAlignment))
+	{
+		// makeTexture clears render targets to opaque black
+		clear({0.0f, 0.0f, 0.0f, 1.0f});
+	}
+
+	constexpr static std::uint32_t getChannelCount(TextureFormat format) noexcept
+	{
+		return (format == TextureFormat::BGRA || format == TextureFormat::BGRX ||
+			format == TextureFormat::RGBA32F)
+			       ? 4
+			       : 1;
+	}
+
+	/**
+	 * @brief Returns whether texels are stored as 32-bit floats rather than UNORM bytes.
+	 */
+	constexpr static bool isFloat(TextureFormat format) noexcept
+	{
+		return format == TextureFormat::R32F || format == TextureFormat::RGBA32F;
+	}
+
+	/**
+	 * @brief Returns the index of the channel that HLSL reads as `.r`.
+	 */
+	constexpr static std::uint32_t getRedChannel(TextureFormat format) noexcept
+	{
+		return (format == TextureFormat::BGRA || format == TextureFormat::BGRX) ? 2 : 0;
+	}
+
+	std::uint32_t getWidth() const noexcept { return width_; }
+	std::uint32_t getHeight() const noexcept { return height_; }
+	TextureFormat getFormat() const noexcept { return format_; }
+	std::uint32_t getChannelCount() const noexcept { return channelCount_; }
+	std::size_t getRowStride() const noexcept { return static_cast<std::size_t>(width_) * channelCount_; }
+
+	float *getRow(std::uint32_t y) noexcept { return texels_.data() + y * getRowStride(); }
+	const float *getRow(std::uint32_t y) const noexcept { return texels_.data() + y * getRowStride(); }
+
+	float *data() noexcept { return texels_.data(); }
+	const float *data() const noexcept { return texels_.data(); }
+	std::size_t size() const noexcept { return texels_.size(); }
+
+	/**
+	 * @brief Fills the texture like gs_clear(GS_CLEAR_COLOR, ...).
+	 *
+	 * @param rgba The clear color in RGBA order, as in a vec4.
+	 */
+	void clear(const std::array<float, 4> &rgba) noexcept
+	{
+		if (channelCount_ == 1) {
+			std::fill(texels_.begin(), texels_.end(), rgba[0]);
+		} else {
+			const std::array<float, 4> bgra{rgba[2], rgba[1], rgba[0], rgba[3]};
+			const std::array<float, 4> &texel = getRedChannel(format_) == 0 ? rgba : bgra;
+			for (std::size_t i = 0; i < texels_.size(); i += 4) {
+				std::copy(texel.begin(), texel.end(), texels_.begin() + static_cast<std::ptrdiff_t>(i));
+			}
+		}
+		resolve();
+	}
+
+	/**
+	 * @brief Uploads texel data like gs_texture_set_image.
+	 *
+	 * 8-bit formats take one byte per channel and float formats take one float per channel.
+	 */
+	void setImage(const std::uint8_t *data, std::uint32_t linesize) noexcept
+	{
+		for (std::uint32_t y = 0; y < height_; ++y) {
+			const std::uint8_t *src = data + static_cast<std::size_t>(y) * linesize;
+			float *dst = getRow(y);
+			if (isFloat(format_)) {
+				std::memcpy(dst, src, getRowStride() * sizeof(float));
+			} else {
+				for (std::size_t i = 0; i < getRowStride(); ++i) {
+					dst[i] = static_cast<float>(src[i]) * (1.0f / 255.0f);
+				}
+			}
+		}
+		resolve();
+	}
+
+	/**
+	 * @brief Reads the texels back in the layout setImage takes, like a staging surface would.
+	 */
+	void getImage(std::uint8_t *data, std::uint32_t linesize) const noexcept
+	{
+		for (std::uint32_t y = 0; y < height_; ++y) {
+			const float *src = getRow(y);
+			std::uint8_t *dst = data + static_cast<std::size_t>(y) * linesize;
+			if (isFloat(format_)) {
+				std::memcpy(dst, src, getRowStride() * sizeof(float));
+			} else {
+				for (std::size_t i = 0; i < getRowStride(); ++i) {
+					dst[i] = static_cast<std::uint8_t>(std::clamp(src[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Applies the storage rules of the format after a pass has written float results.
+	 */
+	void resolve() noexcept
+	{
+		if (isFloat(format_)) {
+			return;
+		}
+
+		float *texels = texels_.data();
+		const std::size_t count = texels_.size();
+		for (std::size_t i = 0; i < count; ++i) {
+			// Truncation rounds to nearest because the clamped value is never negative
+			const float scaled = std::clamp(texels[i], 0.0f, 1.0f) * 255.0f + 0.5f;
+			texels[i] = static_cast<float>(static_cast<std::int32_t>(scaled)) * (1.0f / 255.0f);
+		}
+
+		if (format_ == TextureFormat::BGRX) {
+			for (std::size_t i = 3; i < count; i += 4) {
+				texels[i] = 1.0f;
+			}
+		}
+	}
+
+private:
+	std::uint32_t width_;
+	std::uint32_t height_;
+	TextureFormat format_;
+	std::uint32_t channelCount_;
+	std::vector<float, Memory::AlignedAllocator<float>> texels_;
+};
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect
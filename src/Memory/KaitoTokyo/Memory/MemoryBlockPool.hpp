@@ -100,6 +100,7 @@ public:
 			if (pool_.empty()) {
 				block = std::make_unique<BlockType>(blockSize_,
 								    AlignedAllocator<std::uint8_t>(alignment_));
+				allocatedCount_++;
 			} else {
 				block = std::move(pool_.back());
 				pool_.pop_back();
@@ -123,6 +124,17 @@ public:
 	 */
 	std::size_t getPixelCount() const noexcept { return blockSize_; }
 
+	/**
+	 * @brief Gets the number of blocks this pool has allocated so far, including those since freed.
+	 *
+	 * A count that keeps growing means that more blocks are in flight at once than the pool keeps idle.
+	 */
+	std::size_t getAllocatedCount() const noexcept
+	{
+		std::lock_guard<std::mutex> lock(poolMutex_);
+		return allocatedCount_;
+	}
+
 private:
 	MemoryBlockPool(const std::shared_ptr<const Logger::ILogger> logger, std::size_t blockSize,
 			std::size_t alignment, std::size_t maxSize)
@@ -138,6 +150,7 @@ private:
 	std::size_t alignment_;
 	std::size_t maxSize_;
 	std::vector<std::unique_ptr<BlockType>> pool_;
+	std::size_t allocatedCount_ = 0;
 	mutable std::mutex poolMutex_;
 };
 
@@ -245,22 +245,46 @@ public:
 
 		const std::size_t backBufferIndex = 1 - activeCpuBufferIndex_.load(std::memory_order_acquire);
 
-		auto &backBuffer = cpuBuffers_[backBufferIndex];
+		copyMappedSurf(cpuBuffers_[backBufferIndex].data(), mappedSurf);
 
-		if (bufferLinesize_ == mappedSurf.getLinesize()) {
-			std::memcpy(backBuffer.data(), mappedSurf.getData(),
-				    static_cast<std::size_t>(height_) * bufferLinesize_);
-		} else {
-			for (std::uint32_t y = 0; y < height_; y++) {
-				const std::uint8_t *srcRow = mappedSurf.getData() + (y * mappedSurf.getLinesize());
-				std::uint8_t *dstRow = backBuffer.data() + (y * bufferLinesize_);
-				std::size_t copyBytes =
-					std::min<std::size_t>(bufferLinesize_, mappedSurf.getLinesize());
-				std::memcpy(dstRow, srcRow, copyBytes);
-			}
+		activeCpuBufferIndex_.store(backBufferIndex, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Synchronizes the latest texture data straight into a caller-provided buffer.
+	 *
+	 * Unlike sync(), the data does not pass through the internal CPU buffers, which saves a
+	 * full copy when the caller needs the pixels in its own memory anyway. The rows are written
+	 * tightly packed with getBufferLinesize() bytes each. getBuffer() is not updated.
+	 *
+	 * @param destination The buffer to write to.
+	 * @param destinationSize The size of destination in bytes. Must be at least getHeight() * getBufferLinesize().
+	 * @return true if data was written, false if there was no staging surface to read.
+	 * @throws std::invalid_argument If destination is null or too small.
+	 * @throws std::runtime_error If mapping the staging surface fails.
+	 */
+	bool syncInto(std::uint8_t *destination, std::size_t destinationSize)
+	{
+		using namespace AsyncTextureReaderDetail;
+
+		if (!destination || destinationSize < static_cast<std::size_t>(height_) * bufferLinesize_) {
+			throw std::invalid_argument("InvalidDestinationError(AsyncTextureReader::syncInto)");
 		}
 
-		activeCpuBufferIndex_.store(backBufferIndex, std::memory_order_release);
+		std::size_t gpuReadIndex;
+		{
+			std::scoped_lock lock(gpuMutex_);
+			gpuReadIndex = 1 - gpuWriteIndex_;
+		}
+		gs_stagesurf_t *const stagesurf = stagesurfs_[gpuReadIndex].get();
+
+		if (!stagesurf) {
+			return false;
+		}
+
+		const ScopedStageSurfMap mappedSurf(stagesurf);
+		copyMappedSurf(destination, mappedSurf);
+		return true;
 	}
 
 	/**
@@ -293,6 +317,24 @@ public:
 	std::uint32_t getBufferLinesize() const noexcept { return bufferLinesize_; }
 
 private:
+	/**
+	 * @brief Copies a mapped staging surface into a tightly packed buffer of height_ rows.
+	 */
+	void copyMappedSurf(std::uint8_t *destination,
+			    const AsyncTextureReaderDetail::ScopedStageSurfMap &mappedSurf) const noexcept
+	{
+		if (bufferLinesize_ == mappedSurf.getLinesize()) {
+			std::memcpy(destination, mappedSurf.getData(), static_cast<std::size_t>(height_) * bufferLinesize_);
+		} else {
+			for (std::uint32_t y = 0; y < height_; y++) {
+				const std::uint8_t *srcRow = mappedSurf.getData() + (y * mappedSurf.getLinesize());
+				std::uint8_t *dstRow = destination + (y * bufferLinesize_);
+				std::size_t copyBytes = std::min<std::size_t>(bufferLinesize_, mappedSurf.getLinesize());
+				std::memcpy(dstRow, srcRow, copyBytes);
+			}
+		}
+	}
+
 	/**
 	 * @brief Texture width in pixels.
 	 */
@@ -0,0 +1,236 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <obs.h>
+
+#include "AsyncTextureReader.hpp"
+#include "GsUnique.hpp"
+
+namespace KaitoTokyo {
+namespace ObsBridgeUtils {
+
+/**
+ * @class GsTexturePool
+ * @brief Keeps released textures for reuse so that rebuilding render resources does not hit driver allocation.
+ *
+ * Textures handed out by acquire() come back through the deferred deletion of unique_gs_texture_t once the pool is
+ * installed as the GsUnique texture recycler. Idle textures are kept per (width, height, format, flags) and the
+ * least recently released ones are destroyed once their total size exceeds the byte budget.
+ *
+ * All methods are thread-safe. A reused texture keeps its old contents, so callers must initialize it. Textures
+ * acquired while no pool is installed are destroyed as usual, so the pool must stay installed while they live.
+ */
+class GsTexturePool final {
+public:
+	struct Stats {
+		/// acquire() calls served by an idle texture.
+		std::uint64_t hitCount;
+		/// acquire() calls that created a texture.
+		std::uint64_t missCount;
+		/// Textures taken back from deferred deletion.
+		std::uint64_t recycledCount;
+		/// Idle textures destroyed to stay within the budget.
+		std::uint64_t evictedCount;
+		std::size_t idleCount;
+		std::size_t idleBytes;
+		/// Textures handed out and not yet taken back.
+		std::size_t outstandingCount;
+	};
+
+	/**
+	 * @param budgetBytes The largest total size of idle textures the pool keeps.
+	 */
+	explicit GsTexturePool(std::size_t budgetBytes) noexcept : budgetBytes_(budgetBytes) {}
+
+	/**
+	 * @brief Schedules every idle texture for deferred deletion.
+	 */
+	~GsTexturePool() noexcept { trim(0); }
+
+	GsTexturePool(const GsTexturePool &) = delete;
+	GsTexturePool &operator=(const GsTexturePool &) = delete;
+	GsTexturePool(GsTexturePool &&) = delete;
+	GsTexturePool &operator=(GsTexturePool &&) = delete;
+
+	/**
+	 * @brief Makes @p pool the GsUnique texture recycler, holding it weakly.
+	 */
+	static void install(const std::shared_ptr<GsTexturePool> &pool)
+	{
+		std::weak_ptr<GsTexturePool> weakPool = pool;
+		GsUnique::setTextureRecycler([weakPool](gs_texture_t *texture) {
+			const std::shared_ptr<GsTexturePool> pool = weakPool.lock();
+			return pool && pool->recycle(texture);
+		});
+	}
+
+	/**
+	 * @brief Returns an idle texture of the given shape or creates one.
+	 *
+	 * This function MUST be called from a thread that has a valid graphics context.
+	 *
+	 * @throws std::runtime_error If texture creation fails.
+	 */
+	[[nodiscard]]
+	unique_gs_texture_t acquire(std::uint32_t width, std::uint32_t height, enum gs_color_format colorFormat,
+				    std::uint32_t flags)
+	{
+		const Key key{width, height, colorFormat, flags};
+		{
+			std::lock_guard lock(mutex_);
+			const auto it = idleByKey_.find(key);
+			if (it != idleByKey_.end() && !it->second.empty()) {
+				const auto entry = it->second.back();
+				it->second.pop_back();
+				gs_texture_t *texture = entry->texture;
+				idleBytes_ -= entry->bytes;
+				idleList_.erase(entry);
+				outstanding_.emplace(texture, key);
+				++hitCount_;
+				return unique_gs_texture_t(texture);
+			}
+			++missCount_;
+		}
+
+		unique_gs_texture_t texture = make_unique_gs_texture(width, height, colorFormat, 1, nullptr, flags);
+		std::lock_guard lock(mutex_);
+		outstanding_.emplace(texture.get(), key);
+		return texture;
+	}
+
+	/**
+	 * @brief Takes back @p texture if this pool handed it out.
+	 *
+	 * Called by GsUnique::drain() through the installed recycler.
+	 *
+	 * @return true if the pool took ownership of @p texture.
+	 */
+	bool recycle(gs_texture_t *texture)
+	{
+		std::lock_guard lock(mutex_);
+		const auto it = outstanding_.find(texture);
+		if (it == outstanding_.end()) {
+			return false;
+		}
+
+		const Key key = it->second;
+		outstanding_.erase(it);
+
+		const std::size_t bytes = getTextureBytes(key);
+		idleList_.push_front(IdleEntry{key, texture, bytes});
+		idleByKey_[key].push_back(idleList_.begin());
+		idleBytes_ += bytes;
+		++recycledCount_;
+
+		evictLocked(budgetBytes_);
+		return true;
+	}
+
+	/**
+	 * @brief Schedules idle textures for deferred deletion, least recently released first, until at most
+	 * @p budgetBytes remain.
+	 */
+	void trim(std::size_t budgetBytes) noexcept
+	{
+		std::lock_guard lock(mutex_);
+		evictLocked(budgetBytes);
+	}
+
+	Stats getStats() const noexcept
+	{
+		std::lock_guard lock(mutex_);
+		Stats stats;
+		stats.hitCount = hitCount_;
+		stats.missCount = missCount_;
+		stats.recycledCount = recycledCount_;
+		stats.evictedCount = evictedCount_;
+		stats.idleCount = idleList_.size();
+		stats.idleBytes = idleBytes_;
+		stats.outstandingCount = outstanding_.size();
+		return stats;
+	}
+
+private:
+	struct Key {
+		std::uint32_t width;
+		std::uint32_t height;
+		gs_color_format colorFormat;
+		std::uint32_t flags;
+
+		bool operator<(const Key &other) const noexcept
+		{
+			return std::tie(width, height, colorFormat, flags) <
+			       std::tie(other.width, other.height, other.colorFormat, other.flags);
+		}
+	};
+
+	struct IdleEntry {
+		Key key;
+		gs_texture_t *texture;
+		std::size_t bytes;
+	};
+
+	using IdleList = std::list<IdleEntry>;
+
+	static std::size_t getTextureBytes(const Key &key) noexcept
+	{
+		try {
+			return static_cast<std::size_t>(key.width) * key.height *
+			       AsyncTextureReader::getBytesPerPixel(key.colorFormat);
+		} catch (...) {
+			// Formats without a fixed pixel size are counted as 4 bytes per pixel
+			return static_cast<std::size_t>(key.width) * key.height * 4;
+		}
+	}
+
+	void evictLocked(std::size_t budgetBytes) noexcept
+	{
+		while (idleBytes_ > budgetBytes && !idleList_.empty()) {
+			const auto entry = std::prev(idleList_.end());
+			std::vector<IdleList::iterator> &entries = idleByKey_[entry->key];
+			std::erase(entries, entry);
+			if (entries.empty()) {
+				idleByKey_.erase(entry->key);
+			}
+
+			// The recycler is bypassed so that the texture is really destroyed on the next drain
+			GsUnique::scheduleResourceToDelete(
+				entry->texture, [](void *p) { gs_texture_destroy(static_cast<gs_texture_t *>(p)); });
+			idleBytes_ -= entry->bytes;
+			idleList_.erase(entry);
+			++evictedCount_;
+		}
+	}
+
+	const std::size_t budgetBytes_;
+
+	mutable std::mutex mutex_;
+	/// Idle textures, most recently released first.
+	IdleList idleList_;
+	std::map<Key, std::vector<IdleList::iterator>> idleByKey_;
+	std::unordered_map<gs_texture_t *, Key> outstanding_;
+	std::size_t idleBytes_ = 0;
+
+	std::uint64_t hitCount_ = 0;
+	std::uint64_t missCount_ = 0;
+	std::uint64_t recycledCount_ = 0;
+	std::uint64_t evictedCount_ = 0;
+};
+
+} // namespace ObsBridgeUtils
+} // namespace KaitoTokyo
@@ -10,6 +10,7 @@
 #include <mutex>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #include <obs.h>
 
@@ -55,6 +56,53 @@ inline std::deque<GsResourceDeleterPair> &getResourceDeque()
 	return resourcesToDelete;
 }
 
+/**
+ * @brief A hook offered every texture that drain() is about to destroy.
+ *
+ * It returns true if it took ownership of the texture, in which case the texture is not destroyed.
+ */
+using TextureRecycler = std::function<bool(gs_texture_t *)>;
+
+/**
+ * @brief Retrieves the installed texture recycler, guarded by getMutex().
+ * @return A reference to the static slot, which is null when no recycler is installed.
+ */
+inline std::shared_ptr<const TextureRecycler> &getTextureRecyclerSlot()
+{
+	static std::shared_ptr<const TextureRecycler> textureRecycler;
+	return textureRecycler;
+}
+
+/**
+ * @brief Installs @p textureRecycler, or uninstalls the current one if it is empty.
+ *
+ * This function is thread-safe. Textures already queued are offered to the recycler installed when they are drained.
+ */
+inline void setTextureRecycler(TextureRecycler textureRecycler)
+{
+	auto slot = textureRecycler ? std::make_shared<const TextureRecycler>(std::move(textureRecycler)) : nullptr;
+	std::lock_guard lock(getMutex());
+	getTextureRecyclerSlot() = std::move(slot);
+}
+
+/**
+ * @brief Offers @p texture to the installed recycler and destroys it if the recycler does not take it.
+ *
+ * This function MUST be called from a thread that has a valid graphics context.
+ */
+inline void recycleOrDestroyTexture(gs_texture_t *texture)
+{
+	std::shared_ptr<const TextureRecycler> textureRecycler;
+	{
+		std::lock_guard lock(getMutex());
+		textureRecycler = getTextureRecyclerSlot();
+	}
+
+	if (!textureRecycler || !(*textureRecycler)(texture)) {
+		gs_texture_destroy(texture);
+	}
+}
+
 /**
  * @brief Schedules a raw resource pointer for deferred deletion.
  *
@@ -108,12 +156,13 @@ struct GsEffectDeleter {
 
 /**
  * @brief Custom deleter for unique_gs_texture_t.
- * Schedules the gs_texture_t for deferred deletion.
+ * Schedules the gs_texture_t for deferred deletion, where the texture recycler may take it back.
  */
 struct GsTextureDeleter {
 	void operator()(gs_texture_t *texture) const noexcept
 	{
-		scheduleResourceToDelete(texture, [](void *p) { gs_texture_destroy(static_cast<gs_texture_t *>(p)); });
+		scheduleResourceToDelete(texture,
+					 [](void *p) { recycleOrDestroyTexture(static_cast<gs_texture_t *>(p)); });
 	}
 };
 
@@ -129,6 +178,29 @@ struct GsStagesurfDeleter {
 	}
 };
 
+/**
+ * @brief Custom deleter for unique_gs_timer_t.
+ * Schedules the gs_timer_t for deferred deletion.
+ */
+struct GsTimerDeleter {
+	void operator()(gs_timer_t *timer) const noexcept
+	{
+		scheduleResourceToDelete(timer, [](void *p) { gs_timer_destroy(static_cast<gs_timer_t *>(p)); });
+	}
+};
+
+/**
+ * @brief Custom deleter for unique_gs_timer_range_t.
+ * Schedules the gs_timer_range_t for deferred deletion.
+ */
+struct GsTimerRangeDeleter {
+	void operator()(gs_timer_range_t *range) const noexcept
+	{
+		scheduleResourceToDelete(range,
+					 [](void *p) { gs_timer_range_destroy(static_cast<gs_timer_range_t *>(p)); });
+	}
+};
+
 } // namespace GsUnique
 
 /**
@@ -146,6 +218,16 @@ using unique_gs_texture_t = std::unique_ptr<gs_texture_t, GsUnique::GsTextureDel
  */
 using unique_gs_stagesurf_t = std::unique_ptr<gs_stagesurf_t, GsUnique::GsStagesurfDeleter>;
 
+/**
+ * @brief A std::unique_ptr for a gs_timer_t (GPU timer query) that uses deferred deletion.
+ */
+using unique_gs_timer_t = std::unique_ptr<gs_timer_t, GsUnique::GsTimerDeleter>;
+
+/**
+ * @brief A std::unique_ptr for a gs_timer_range_t (GPU timer query range) that uses deferred deletion.
+ */
+using unique_gs_timer_range_t = std::unique_ptr<gs_timer_range_t, GsUnique::GsTimerRangeDeleter>;
+
 /**
  * @class GraphicsContextGuard
  * @brief An RAII helper to ensure obs_enter_graphics() and obs_leave_graphics()
@@ -241,5 +323,39 @@ inline unique_gs_stagesurf_t make_unique_gs_stagesurf(std::uint32_t width, std::
 	return unique_gs_stagesurf_t(rawSurface);
 }
 
+/**
+ * @brief Factory function to create a unique_gs_timer_t.
+ *
+ * @return A valid (non-null) unique_gs_timer_t managing the created timer.
+ * @throws std::runtime_error If the renderer does not support timer queries.
+ * This function throws on failure and **never returns an empty (null) pointer.**
+ */
+[[nodiscard]]
+inline unique_gs_timer_t make_unique_gs_timer()
+{
+	gs_timer_t *rawTimer = gs_timer_create();
+	if (!rawTimer) {
+		throw std::runtime_error("gs_timer_create failed");
+	}
+	return unique_gs_timer_t(rawTimer);
+}
+
+/**
+ * @brief Factory function to create a unique_gs_timer_range_t.
+ *
+ * @return A valid (non-null) unique_gs_timer_range_t managing the created range.
+ * @throws std::runtime_error If the renderer does not support timer queries.
+ * This function throws on failure and **never returns an empty (null) pointer.**
+ */
+[[nodiscard]]
+inline unique_gs_timer_range_t make_unique_gs_timer_range()
+{
+	gs_timer_range_t *rawRange = gs_timer_range_create();
+	if (!rawRange) {
+		throw std::runtime_error("gs_timer_range_create failed");
+	}
+	return unique_gs_timer_range_t(rawRange);
+}
+
 } // namespace ObsBridgeUtils
 } // namespace KaitoTokyo
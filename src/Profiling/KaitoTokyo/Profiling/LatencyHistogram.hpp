@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace KaitoTokyo::Profiling {
+
+/**
+ * @brief Percentiles of the durations in a LatencyHistogram::Snapshot.
+ */
+struct LatencySummary {
+	std::uint64_t count;
+	std::chrono::nanoseconds p50;
+	std::chrono::nanoseconds p95;
+	std::chrono::nanoseconds p99;
+};
+
+/**
+ * @brief A fixed-size histogram of durations that any number of threads can record into without locking.
+ *
+ * Buckets are log-linear: durations below 16 ns get one bucket per nanosecond, and every power of two above
+ * that is split into 8 buckets, so a percentile is reported within 1/16 of the true value. Durations of
+ * 2^36 ns (about 69 seconds) or more all land in the last bucket.
+ *
+ * The counters only ever grow. A reader that wants the distribution over an interval takes a snapshot at
+ * both ends and subtracts them, which lets several readers observe different windows of the same histogram.
+ */
+class LatencyHistogram {
+public:
+	constexpr static std::size_t kSubBucketBits = 3;
+	constexpr static std::size_t kSubBucketCount = std::size_t{1} << kSubBucketBits;
+	constexpr static std::size_t kLinearBucketCount = 2 * kSubBucketCount;
+	constexpr static int kFirstLogExponent = 4;
+	constexpr static int kMaxExponent = 36;
+	constexpr static std::size_t kBucketCount =
+		kLinearBucketCount + static_cast<std::size_t>(kMaxExponent - kFirstLogExponent) * kSubBucketCount;
+
+	/**
+	 * @brief A point-in-time copy of the bucket counters.
+	 */
+	struct Snapshot {
+		std::array<std::uint64_t, kBucketCount> counts{};
+
+		std::uint64_t getCount() const noexcept
+		{
+			std::uint64_t count = 0;
+			for (std::uint64_t bucketCount : counts) {
+				count += bucketCount;
+			}
+			return count;
+		}
+
+		/**
+		 * @brief Returns the duration below which the given fraction of the samples fall.
+		 *
+		 * @param fraction A value in (0, 1], e.g. 0.99 for the 99th percentile.
+		 * @return The midpoint of the bucket holding that sample, or zero if the snapshot is empty.
+		 */
+		std::chrono::nanoseconds getPercentile(double fraction) const noexcept
+		{
+			const std::uint64_t count = getCount();
+			if (count == 0) {
+				return std::chrono::nanoseconds(0);
+			}
+
+			const auto rank = std::max<std::uint64_t>(
+				1, static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(count))));
+
+			std::uint64_t cumulative = 0;
+			for (std::size_t i = 0; i < kBucketCount; ++i) {
+				cumulative += counts[i];
+				if (cumulative >= rank) {
+					const std::uint64_t lower = getBucketLowerBound(i);
+					const std::uint64_t upper = getBucketLowerBound(i + 1);
+					return std::chrono::nanoseconds(lower + (upper - lower) / 2);
+				}
+			}
+			return std::chrono::nanoseconds(getBucketLowerBound(kBucketCount - 1));
+		}
+
+		LatencySummary summarize() const noexcept
+		{
+			return {getCount(), getPercentile(0.50), getPercentile(0.95), getPercentile(0.99)};
+		}
+
+		/**
+		 * @brief Returns the samples recorded after @p older was taken.
+		 */
+		Snapshot operator-(const Snapshot &older) const noexcept
+		{
+			Snapshot difference;
+			for (std::size_t i = 0; i < kBucketCount; ++i) {
+				difference.counts[i] = counts[i] - older.counts[i];
+			}
+			return difference;
+		}
+
+		/**
+		 * @brief Adds the samples of @p other, to combine the histograms of several sources.
+		 */
+		Snapshot &operator+=(const Snapshot &other) noexcept
+		{
+			for (std::size_t i = 0; i < kBucketCount; ++i) {
+				counts[i] += other.counts[i];
+			}
+			return *this;
+		}
+	};
+
+	LatencyHistogram() noexcept = default;
+
+	LatencyHistogram(const LatencyHistogram &) = delete;
+	LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+	LatencyHistogram(LatencyHistogram &&) = delete;
+	LatencyHistogram &operator=(LatencyHistogram &&) = delete;
+
+	void record(std::chrono::nanoseconds duration) noexcept
+	{
+		const std::uint64_t nanoseconds =
+			duration.count() > 0 ? static_cast<std::uint64_t>(duration.count()) : std::uint64_t{0};
+		buckets_[getBucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Copies the counters. Samples recorded concurrently may or may not be included.
+	 */
+	Snapshot snapshot() const noexcept
+	{
+		Snapshot snapshot;
+		for (std::size_t i = 0; i < kBucketCount; ++i) {
+			snapshot.counts[i] = buckets_[i].load(std::memory_order_relaxed);
+		}
+		return snapshot;
+	}
+
+	constexpr static std::size_t getBucketIndex(std::uint64_t nanoseconds) noexcept
+	{
+		if (nanoseconds < kLinearBucketCount) {
+			return static_cast<std::size_t>(nanoseconds);
+		}
+
+		const int exponent = std::bit_width(nanoseconds) - 1;
+		if (exponent >= kMaxExponent) {
+			return kBucketCount - 1;
+		}
+
+		const std::size_t subBucket =
+			static_cast<std::size_t>(nanoseconds >> (exponent - static_cast<int>(kSubBucketBits))) &
+			(kSubBucketCount - 1);
+		return kLinearBucketCount + static_cast<std::size_t>(exponent - kFirstLogExponent) * kSubBucketCount +
+		       subBucket;
+	}
+
+	/**
+	 * @brief Returns the smallest duration, in nanoseconds, that falls into the given bucket.
+	 *
+	 * @p index may be kBucketCount, which yields the end of the last bucket.
+	 */
+	constexpr static std::uint64_t getBucketLowerBound(std::size_t index) noexcept
+	{
+		if (index < kLinearBucketCount) {
+			return index;
+		}
+
+		const std::size_t logIndex = index - kLinearBucketCount;
+		const int exponent = kFirstLogExponent + static_cast<int>(logIndex / kSubBucketCount);
+		const std::uint64_t subBucket = logIndex % kSubBucketCount;
+		return (kSubBucketCount + subBucket) << (exponent - static_cast<int>(kSubBucketBits));
+	}
+
+private:
+	std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_{};
+};
+
+/**
+ * @brief Records the time between its construction and destruction into a LatencyHistogram.
+ */
+class ScopedLatencyTimer {
+public:
+	explicit ScopedLatencyTimer(LatencyHistogram &histogram) noexcept
+		: histogram_(histogram),
+		  start_(std::chrono::steady_clock::now())
+	{
+	}
+
+	~ScopedLatencyTimer() noexcept { histogram_.record(std::chrono::steady_clock::now() - start_); }
+
+	ScopedLatencyTimer(const ScopedLatencyTimer &) = delete;
+	ScopedLatencyTimer &operator=(const ScopedLatencyTimer &) = delete;
+	ScopedLatencyTimer(ScopedLatencyTimer &&) = delete;
+	ScopedLatencyTimer &operator=(ScopedLatencyTimer &&) = delete;
+
+private:
+	LatencyHistogram &histogram_;
+	const std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace KaitoTokyo::Profiling
@@ -9,16 +9,19 @@
 #endif // __ARM_NEON
 #endif // defined(_M_ARM64) || defined(__aarch64__)
 
-#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#if defined(_M_X64) || defined(__x86_64__)
+#define SELFIE_SEGMENTER_HAVE_X86_64
 #include <immintrin.h>
 #if defined(_MSC_VER)
 #include <intrin.h>
 #else
 #include <x86intrin.h>
 #endif // defined(_MSC_VER)
-#endif
+#endif // defined(_M_X64) || defined(__x86_64__)
 
 #include "BoundingBox.hpp"
+#include "BoundingBoxKernels.hpp"
+#include "SimdDispatch.hpp"
 
 #include <cstddef>
 
@@ -46,6 +49,26 @@ inline int get_last_bit_index(int mask)
 	_BitScanReverse(&index, mask);
 	return static_cast<int>(index);
 }
+
+inline int get_first_bit_index64(std::uint64_t mask)
+{
+	if (mask == 0)
+		return -1;
+
+	unsigned long index;
+	_BitScanForward64(&index, mask);
+	return static_cast<int>(index);
+}
+
+inline int get_last_bit_index64(std::uint64_t mask)
+{
+	if (mask == 0)
+		return -1;
+
+	unsigned long index;
+	_BitScanReverse64(&index, mask);
+	return static_cast<int>(index);
+}
 #else
 inline int get_first_bit_index(int mask)
 {
@@ -61,10 +84,74 @@ inline int get_last_bit_index(int mask)
 		return -1;
 	return 31 - __builtin_clz(mask);
 }
+
+inline int get_first_bit_index64(std::uint64_t mask)
+{
+	if (mask == 0)
+		return -1;
+
+	return __builtin_ctzll(mask);
+}
+
+inline int get_last_bit_index64(std::uint64_t mask)
+{
+	if (mask == 0)
+		return -1;
+	return 63 - __builtin_clzll(mask);
+}
 #endif
 
-#ifdef __ARM_NEON
-inline bool calculateBoundingBoxNEON256x144(BoundingBox *boundingBox, const std::uint8_t *data, std::uint8_t threshold)
+inline bool calculateBoundingBox(BoundingBox *boundingBox, const std::uint8_t *data, std::uint32_t width,
+				 std::uint32_t height, std::uint8_t threshold)
+{
+	std::int32_t min_x = static_cast<std::int32_t>(width);
+	std::int32_t max_x = -1;
+	std::int32_t min_y = static_cast<std::int32_t>(height);
+	std::int32_t max_y = -1;
+
+	for (std::uint32_t y = 0; y < height; ++y) {
+		const std::uint8_t *row_ptr = data + (y * width);
+
+		for (std::uint32_t x = 0; x < width; ++x) {
+			std::uint8_t pixel = row_ptr[x];
+
+			if (pixel > threshold) {
+				if (static_cast<std::int32_t>(x) < min_x)
+					min_x = x;
+				if (static_cast<std::int32_t>(x) > max_x)
+					max_x = x;
+
+				if (static_cast<std::int32_t>(y) < min_y)
+					min_y = y;
+				if (static_cast<std::int32_t>(y) > max_y)
+					max_y = y;
+			}
+		}
+	}
+
+	if (max_y == -1)
+		return false;
+
+	boundingBox->x = min_x;
+	boundingBox->y = min_y;
+	boundingBox->width = max_x - min_x + 1;
+	boundingBox->height = max_y - min_y + 1;
+
+	return true;
+}
+
+} // anonymous namespace
+
+namespace BoundingBoxKernels {
+
+bool calculateBoundingBoxNaive256x144(BoundingBox *boundingBox, const std::uint8_t *data, std::uint8_t threshold)
+{
+	return calculateBoundingBox(boundingBox, data, 256, 144, threshold);
+}
+
+
+#ifdef SELFIE_SEGMENTER_HAVE_NEON
+bool calculateBoundingBoxNEON256x144(BoundingBox *boundingBox, const std::uint8_t *data, std::uint8_t threshold)
 {
 	constexpr std::uint32_t width = 256;
 	constexpr std::uint32_t height = 144;
@@ -160,54 +247,102 @@ found_max_x:;
 
 	return true;
 }
-#endif // __ARM_NEON
+#endif // SELFIE_SEGMENTER_HAVE_NEON
 
-#ifdef __AVX2__
-/**
- * @brief Checks if the CPU supports AVX2 instructions and if the OS has enabled them.
- * @return true if AVX2 is available, false otherwise.
- */
+#ifdef SELFIE_SEGMENTER_HAVE_X86_64
 #if !defined(_MSC_VER)
-__attribute__((target("xsave")))
+__attribute__((target("sse4.1")))
 #endif
-inline bool
-checkIfAVX2Available()
+bool
+calculateBoundingBoxSSE41256x144(BoundingBox *boundingBox, const std::uint8_t *data, std::uint8_t threshold)
 {
-	int cpuInfo[4];
-	auto cpuid = [&cpuInfo](int leaf, int subleaf = 0) {
-#if defined(_MSC_VER)
-		__cpuidex(cpuInfo, leaf, subleaf);
-#else
-		__cpuid_count(leaf, subleaf, cpuInfo[0], cpuInfo[1], cpuInfo[2], cpuInfo[3]);
-#endif
-	};
+	constexpr std::uint32_t width = 256;
+	constexpr std::uint32_t height = 144;
+	constexpr std::int32_t num_blocks = 16;
 
-	// 1. Check for AVX support
-	// Leaf 1, ECX[28] = AVX, ECX[27] = OSXSAVE
-	cpuid(1, 0);
-	bool osxsave = (cpuInfo[2] & (1 << 27)) != 0;
-	bool avx = (cpuInfo[2] & (1 << 28)) != 0;
+	// SSE has no unsigned byte comparison, so both sides are shifted into the signed range
+	const __m128i v_offset = _mm_set1_epi8(-128);
+	const __m128i v_threshold = _mm_set1_epi8(static_cast<std::int8_t>(threshold - 128));
 
-	if (!avx || !osxsave)
+	__m128i col_acc[num_blocks];
+	for (int i = 0; i < num_blocks; ++i) {
+		col_acc[i] = _mm_setzero_si128();
+	}
+
+	int row_flags[height];
+
+	for (std::uint32_t y = 0; y < height; ++y) {
+		const std::uint8_t *row_ptr = data + y * width;
+		__m128i row_any = _mm_setzero_si128();
+
+		for (std::int32_t b = 0; b < num_blocks; ++b) {
+			__m128i v_data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row_ptr + b * 16));
+			v_data = _mm_add_epi8(v_data, v_offset);
+			__m128i v_cmp = _mm_cmpgt_epi8(v_data, v_threshold);
+
+			col_acc[b] = _mm_or_si128(col_acc[b], v_cmp);
+			row_any = _mm_or_si128(row_any, v_cmp);
+		}
+
+		row_flags[y] = _mm_movemask_epi8(row_any);
+	}
+
+	std::int32_t min_y = -1;
+	std::int32_t max_y = -1;
+
+	for (std::uint32_t y = 0; y < height; ++y) {
+		if (row_flags[y] != 0) {
+			min_y = static_cast<std::int32_t>(y);
+			break;
+		}
+	}
+
+	if (min_y == -1)
 		return false;
 
-	// 2. Check if OS saves YMM registers (XCR0)
-	// _xgetbv(0) returns the XCR0 register
-	// Bit 1 = SSE state, Bit 2 = AVX state. Both must be 1.
-	unsigned long long xcr_val = _xgetbv(0);
-	if ((xcr_val & 0x6) != 0x6)
+	for (std::int32_t y = static_cast<std::int32_t>(height) - 1; y >= min_y; --y) {
+		if (row_flags[y] != 0) {
+			max_y = y;
+			break;
+		}
+	}
+
+	std::int32_t min_x = width;
+	std::int32_t max_x = -1;
+
+	for (std::int32_t b = 0; b < num_blocks; ++b) {
+		int mask = _mm_movemask_epi8(col_acc[b]);
+
+		if (mask != 0) {
+			min_x = (b * 16) + get_first_bit_index(mask);
+			break;
+		}
+	}
+
+	for (std::int32_t b = num_blocks - 1; b >= 0; --b) {
+		int mask = _mm_movemask_epi8(col_acc[b]);
+
+		if (mask != 0) {
+			max_x = (b * 16) + get_last_bit_index(mask);
+			break;
+		}
+	}
+
+	if (max_x < min_x)
 		return false;
 
-	// 3. Check for AVX2 support
-	// Leaf 7, Subleaf 0, EBX[5] = AVX2
-	cpuid(7, 0);
-	return (cpuInfo[1] & (1 << 5)) != 0;
+	boundingBox->x = min_x;
+	boundingBox->y = min_y;
+	boundingBox->width = max_x - min_x + 1;
+	boundingBox->height = max_y - min_y + 1;
+
+	return true;
 }
 
 #if !defined(_MSC_VER)
 __attribute__((target("avx2")))
 #endif
-inline bool
+bool
 calculateBoundingBoxAVX2256x144(BoundingBox *boundingBox, const std::uint8_t *data, std::uint8_t threshold)
 {
 	constexpr std::uint32_t width = 256;
@@ -291,37 +426,65 @@ calculateBoundingBoxAVX2256x144(BoundingBox *boundingBox, const std::uint8_t *da
 
 	return true;
 }
-#endif // __AVX2__
 
-inline bool calculateBoundingBox(BoundingBox *boundingBox, const std::uint8_t *data, std::uint32_t width,
-				 std::uint32_t height, std::uint8_t threshold)
+#if !defined(_MSC_VER)
+__attribute__((target("avx512f,avx512bw")))
+#endif
+bool
+calculateBoundingBoxAVX512BW256x144(BoundingBox *boundingBox, const std::uint8_t *data, std::uint8_t threshold)
 {
-	std::int32_t min_x = static_cast<std::int32_t>(width);
-	std::int32_t max_x = -1;
-	std::int32_t min_y = static_cast<std::int32_t>(height);
+	constexpr std::uint32_t width = 256;
+	constexpr std::uint32_t height = 144;
+	constexpr std::int32_t num_blocks = 4;
+
+	// AVX-512BW compares unsigned bytes directly into a 64-bit mask, so no offset or movemask is needed
+	const __m512i v_threshold = _mm512_set1_epi8(static_cast<char>(threshold));
+
+	std::uint64_t col_acc[num_blocks] = {};
+
+	std::int32_t min_y = -1;
 	std::int32_t max_y = -1;
 
 	for (std::uint32_t y = 0; y < height; ++y) {
-		const std::uint8_t *row_ptr = data + (y * width);
+		const std::uint8_t *row_ptr = data + y * width;
+		std::uint64_t row_any = 0;
 
-		for (std::uint32_t x = 0; x < width; ++x) {
-			std::uint8_t pixel = row_ptr[x];
+		for (std::int32_t b = 0; b < num_blocks; ++b) {
+			__m512i v_data = _mm512_loadu_si512(row_ptr + b * 64);
+			std::uint64_t v_cmp = _mm512_cmpgt_epu8_mask(v_data, v_threshold);
 
-			if (pixel > threshold) {
-				if (static_cast<std::int32_t>(x) < min_x)
-					min_x = x;
-				if (static_cast<std::int32_t>(x) > max_x)
-					max_x = x;
+			col_acc[b] |= v_cmp;
+			row_any |= v_cmp;
+		}
 
-				if (static_cast<std::int32_t>(y) < min_y)
-					min_y = y;
-				if (static_cast<std::int32_t>(y) > max_y)
-					max_y = y;
-			}
+		if (row_any != 0) {
+			if (min_y == -1)
+				min_y = static_cast<std::int32_t>(y);
+			max_y = static_cast<std::int32_t>(y);
 		}
 	}
 
-	if (max_y == -1)
+	if (min_y == -1)
+		return false;
+
+	std::int32_t min_x = width;
+	std::int32_t max_x = -1;
+
+	for (std::int32_t b = 0; b < num_blocks; ++b) {
+		if (col_acc[b] != 0) {
+			min_x = (b * 64) + get_first_bit_index64(col_acc[b]);
+			break;
+		}
+	}
+
+	for (std::int32_t b = num_blocks - 1; b >= 0; --b) {
+		if (col_acc[b] != 0) {
+			max_x = (b * 64) + get_last_bit_index64(col_acc[b]);
+			break;
+		}
+	}
+
+	if (max_x < min_x)
 		return false;
 
 	boundingBox->x = min_x;
@@ -331,23 +494,13 @@ inline bool calculateBoundingBox(BoundingBox *boundingBox, const std::uint8_t *d
 
 	return true;
 }
+#endif // SELFIE_SEGMENTER_HAVE_X86_64
 
-} // anonymous namespace
+} // namespace BoundingBoxKernels
 
 bool BoundingBox::calculateBoundingBoxFrom256x144(const std::uint8_t *data, std::uint8_t threshold)
 {
-#if defined(__ARM_NEON)
-	return calculateBoundingBoxNEON256x144(this, data, threshold);
-#elif defined(__AVX2__)
-	const static bool isAVX2Available = checkIfAVX2Available();
-	if (isAVX2Available) {
-		return calculateBoundingBoxAVX2256x144(this, data, threshold);
-	} else {
-		return calculateBoundingBox(this, data, 256, 144, threshold);
-	}
-#else
-	return calculateBoundingBox(this, data, 256, 144, threshold);
-#endif
+	return getSimdKernels().calculateBoundingBox256x144(this, data, threshold);
 }
 
 } // namespace KaitoTokyo::SelfieSegmenter
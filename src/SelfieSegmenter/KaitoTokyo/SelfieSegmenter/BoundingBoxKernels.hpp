@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+
+#include "BoundingBox.hpp"
+
+/**
+ * @file BoundingBoxKernels.hpp
+ * @brief The individual implementations behind BoundingBox::calculateBoundingBoxFrom256x144.
+ *
+ * Like ShapeConverterKernels.hpp, these are exposed for testing and benchmarking. Each variant leaves the box
+ * untouched and returns false when no pixel exceeds the threshold. The caller is responsible for only calling a
+ * variant that the CPU supports.
+ */
+
+namespace KaitoTokyo::SelfieSegmenter::BoundingBoxKernels {
+
+bool calculateBoundingBoxNaive256x144(BoundingBox *boundingBox, const std::uint8_t *data, std::uint8_t threshold);
+
+#if (defined(_M_ARM64) || defined(__aarch64__)) && defined(__ARM_NEON)
+
+bool calculateBoundingBoxNEON256x144(BoundingBox *boundingBox, const std::uint8_t *data, std::uint8_t threshold);
+
+#endif // (defined(_M_ARM64) || defined(__aarch64__)) && defined(__ARM_NEON)
+
+#if defined(_M_X64) || defined(__x86_64__)
+
+bool calculateBoundingBoxSSE41256x144(BoundingBox *boundingBox, const std::uint8_t *data, std::uint8_t threshold);
+
+bool calculateBoundingBoxAVX2256x144(BoundingBox *boundingBox, const std::uint8_t *data, std::uint8_t threshold);
+
+bool calculateBoundingBoxAVX512BW256x144(BoundingBox *boundingBox, const std::uint8_t *data, std::uint8_t threshold);
+
+#endif // defined(_M_X64) || defined(__x86_64__)
+
+} // namespace KaitoTokyo::SelfieSegmenter::BoundingBoxKernels
@@ -28,6 +28,18 @@ public:
 
 	virtual const std::uint8_t *getMask() const = 0;
 
+	/**
+	 * @brief Returns how many masks process has published so far. Safe to call from any thread.
+	 */
+	virtual std::uint64_t getPublishedMaskGeneration() const noexcept = 0;
+
+	/**
+	 * @brief Returns the generation of the mask the last getMask call returned, or 0 for the initial empty mask.
+	 *
+	 * Like getMask, this is only for the single consumer of the masks.
+	 */
+	virtual std::uint64_t getMaskGeneration() const noexcept = 0;
+
 	ISelfieSegmenter(const ISelfieSegmenter &) = delete;
 	ISelfieSegmenter &operator=(const ISelfieSegmenter &) = delete;
 	ISelfieSegmenter(ISelfieSegmenter &&) = delete;
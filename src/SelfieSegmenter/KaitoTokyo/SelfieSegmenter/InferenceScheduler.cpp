@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "InferenceScheduler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+InferenceScheduler::InferenceScheduler(std::shared_ptr<const Logger::ILogger> logger,
+				       std::chrono::microseconds gatherWindow)
+	: logger_(logger ? std::move(logger)
+			 : throw std::invalid_argument("LoggerIsNullError(InferenceScheduler::InferenceScheduler)")),
+	  gatherWindow_(gatherWindow),
+	  worker_(&InferenceScheduler::workerLoop, this)
+{
+}
+
+InferenceScheduler::~InferenceScheduler() noexcept
+{
+	shutdown();
+}
+
+std::shared_ptr<InferenceScheduler::Client>
+InferenceScheduler::registerClient(std::shared_ptr<ISelfieSegmenter> segmenter, std::string name)
+{
+	if (!segmenter) {
+		throw std::invalid_argument("SegmenterIsNullError(InferenceScheduler::registerClient)");
+	}
+
+	auto client = std::make_shared<Client>(Client::PrivateTag{}, *this, std::move(segmenter), std::move(name));
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	clients_.push_back(client.get());
+	logger_->info("InferenceClientRegistered",
+		      {{"name", client->getName()}, {"clientCount", std::to_string(clients_.size())}});
+
+	return client;
+}
+
+void InferenceScheduler::shutdown() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (stopped_) {
+			return;
+		}
+		stopped_ = true;
+	}
+	cond_.notify_all();
+
+	if (worker_.joinable()) {
+		worker_.join();
+	}
+}
+
+void InferenceScheduler::submit(Client &client, Memory::MemoryBlockPool::MemoryBlockSharedPtr input,
+				CompletionCallback onComplete)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		client.stats_.submittedCount++;
+		client.lastSubmittedRound_ = roundCount_;
+
+		if (stopped_) {
+			client.stats_.droppedCount++;
+			return;
+		}
+
+		if (client.pending_) {
+			client.stats_.droppedCount++;
+		}
+		client.pending_ = PendingInput{std::move(input), std::move(onComplete), std::chrono::steady_clock::now()};
+	}
+	cond_.notify_one();
+}
+
+void InferenceScheduler::unregister(Client &client) noexcept
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	client.pending_.reset();
+	clients_.erase(std::remove(clients_.begin(), clients_.end(), &client), clients_.end());
+}
+
+InferenceScheduler::ClientStats InferenceScheduler::getStats(const Client &client) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	ClientStats stats = client.stats_;
+	stats.meanLatency = stats.processedCount > 0
+				    ? client.totalLatency_ / static_cast<std::int64_t>(stats.processedCount)
+				    : std::chrono::microseconds(0);
+	return stats;
+}
+
+void InferenceScheduler::workerLoop()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		cond_.wait(lock, [this] { return stopped_ || hasPendingLocked(); });
+		if (stopped_) {
+			break;
+		}
+
+		// Let the other active clients catch up so that their inputs join this round. There is nobody to wait for
+		// when every active client already has an input pending, which is always the case with a single client.
+		cond_.wait_for(lock, gatherWindow_, [this] { return stopped_ || allActivePendingLocked(); });
+		if (stopped_) {
+			break;
+		}
+
+		std::vector<Job> round = takeRoundLocked();
+		roundCount_++;
+
+		lock.unlock();
+		for (Job &job : round) {
+			runJob(job);
+		}
+		// Releasing clients and blocks may re-enter the scheduler, so do it unlocked
+		round.clear();
+		lock.lock();
+	}
+}
+
+bool InferenceScheduler::hasPendingLocked() const noexcept
+{
+	return std::any_of(clients_.begin(), clients_.end(),
+			   [](const Client *client) { return client->pending_.has_value(); });
+}
+
+bool InferenceScheduler::allActivePendingLocked() const noexcept
+{
+	// Waiting for a client that has stopped submitting would delay every other client for nothing
+	return std::all_of(clients_.begin(), clients_.end(), [this](const Client *client) {
+		const bool isActive = client->lastSubmittedRound_ &&
+				      roundCount_ - *client->lastSubmittedRound_ <= kActiveRoundCount;
+		return client->pending_.has_value() || !isActive;
+	});
+}
+
+std::vector<InferenceScheduler::Job> InferenceScheduler::takeRoundLocked()
+{
+	std::vector<Job> round;
+	round.reserve(clients_.size());
+
+	for (Client *rawClient : clients_) {
+		if (!rawClient->pending_) {
+			continue;
+		}
+
+		// A client whose destructor is waiting for mutex_ can no longer be locked
+		if (auto client = rawClient->weak_from_this().lock()) {
+			round.push_back(Job{std::move(client), std::move(*rawClient->pending_)});
+			rawClient->pending_.reset();
+		}
+	}
+
+	// Oldest first, so a client that submitted early is never pushed behind later arrivals
+	std::sort(round.begin(), round.end(),
+		  [](const Job &a, const Job &b) { return a.pending.submittedAt < b.pending.submittedAt; });
+
+	return round;
+}
+
+void InferenceScheduler::runJob(Job &job)
+{
+	try {
+		{
+			Profiling::ScopedLatencyTimer inferenceTimer(job.client->inferenceDurations_);
+			job.client->segmenter_->process(job.pending.input->data());
+		}
+		if (job.pending.onComplete) {
+			job.pending.onComplete();
+		}
+	} catch (const std::exception &e) {
+		logger_->error("InferenceExceptionError", {{"name", job.client->getName()}, {"message", e.what()}});
+		std::lock_guard<std::mutex> lock(mutex_);
+		job.client->stats_.failedCount++;
+		return;
+	} catch (...) {
+		logger_->error("InferenceUnknownExceptionError", {{"name", job.client->getName()}});
+		std::lock_guard<std::mutex> lock(mutex_);
+		job.client->stats_.failedCount++;
+		return;
+	}
+
+	const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+										    job.pending.submittedAt);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	ClientStats &stats = job.client->stats_;
+	stats.processedCount++;
+	stats.lastLatency = latency;
+	stats.maxLatency = std::max(stats.maxLatency, latency);
+	job.client->totalLatency_ += latency;
+}
+
+InferenceScheduler::Client::Client(PrivateTag, InferenceScheduler &scheduler,
+				   std::shared_ptr<ISelfieSegmenter> segmenter, std::string name)
+	: scheduler_(scheduler),
+	  segmenter_(std::move(segmenter)),
+	  name_(std::move(name))
+{
+}
+
+InferenceScheduler::Client::~Client() noexcept
+{
+	scheduler_.unregister(*this);
+}
+
+void InferenceScheduler::Client::submit(Memory::MemoryBlockPool::MemoryBlockSharedPtr input,
+					CompletionCallback onComplete)
+{
+	scheduler_.submit(*this, std::move(input), std::move(onComplete));
+}
+
+InferenceScheduler::ClientStats InferenceScheduler::Client::getStats() const
+{
+	return scheduler_.getStats(*this);
+}
+
+} // namespace KaitoTokyo::SelfieSegmenter
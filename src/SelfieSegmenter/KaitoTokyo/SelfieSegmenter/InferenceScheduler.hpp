@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <KaitoTokyo/Logger/ILogger.hpp>
+#include <KaitoTokyo/Memory/MemoryBlockPool.hpp>
+#include <KaitoTokyo/Profiling/LatencyHistogram.hpp>
+
+#include "ISelfieSegmenter.hpp"
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+/**
+ * @brief Runs the inference of every registered segmenter on one shared worker.
+ *
+ * Each client holds at most one pending input; a newer submission replaces an older one that
+ * has not started yet. The worker waits for a short gather window after the first pending
+ * input so that inputs from other active clients can join the same round. A client counts as
+ * active while it has submitted into one of the last kActiveRoundCount rounds, so a hidden
+ * source or a static scene that stopped submitting does not hold up the others, and a lone
+ * client never waits. It then runs the round
+ * back-to-back in submission order (oldest first) so that no client is starved. Running
+ * inferences serially keeps the ncnn thread pool from being oversubscribed by several
+ * instances competing for the same cores.
+ */
+class InferenceScheduler {
+public:
+	using CompletionCallback = std::function<void()>;
+
+	/**
+	 * @brief The number of recent rounds a client must have submitted into to be waited for.
+	 */
+	static constexpr std::uint64_t kActiveRoundCount = 2;
+
+	/**
+	 * @brief Per-client counters. Latencies are measured from submission to completion.
+	 */
+	struct ClientStats {
+		std::uint64_t submittedCount;
+		std::uint64_t processedCount;
+		std::uint64_t droppedCount;
+		std::uint64_t failedCount;
+		std::chrono::microseconds lastLatency;
+		std::chrono::microseconds meanLatency;
+		std::chrono::microseconds maxLatency;
+	};
+
+	class Client;
+
+	/**
+	 * @param logger The logger to use for internal messages.
+	 * @param gatherWindow How long to wait for the other active clients after the first pending input. Not
+	 * waited when every active client already has an input pending.
+	 */
+	InferenceScheduler(std::shared_ptr<const Logger::ILogger> logger,
+			   std::chrono::microseconds gatherWindow = std::chrono::microseconds(2000));
+	~InferenceScheduler() noexcept;
+
+	InferenceScheduler(const InferenceScheduler &) = delete;
+	InferenceScheduler &operator=(const InferenceScheduler &) = delete;
+	InferenceScheduler(InferenceScheduler &&) = delete;
+	InferenceScheduler &operator=(InferenceScheduler &&) = delete;
+
+	/**
+	 * @brief Registers a segmenter. The registration lasts until the returned client is destroyed.
+	 */
+	std::shared_ptr<Client> registerClient(std::shared_ptr<ISelfieSegmenter> segmenter, std::string name);
+
+	/**
+	 * @brief Stops the worker. Pending inputs are discarded.
+	 */
+	void shutdown() noexcept;
+
+private:
+	struct PendingInput {
+		Memory::MemoryBlockPool::MemoryBlockSharedPtr input;
+		CompletionCallback onComplete;
+		std::chrono::steady_clock::time_point submittedAt;
+	};
+
+	struct Job {
+		std::shared_ptr<Client> client;
+		PendingInput pending;
+	};
+
+	void submit(Client &client, Memory::MemoryBlockPool::MemoryBlockSharedPtr input, CompletionCallback onComplete);
+	void unregister(Client &client) noexcept;
+	ClientStats getStats(const Client &client) const;
+
+	void workerLoop();
+	bool hasPendingLocked() const noexcept;
+	bool allActivePendingLocked() const noexcept;
+	std::vector<Job> takeRoundLocked();
+	void runJob(Job &job);
+
+	const std::shared_ptr<const Logger::ILogger> logger_;
+	const std::chrono::microseconds gatherWindow_;
+
+	mutable std::mutex mutex_;
+	std::condition_variable cond_;
+	// Clients remove themselves under mutex_ before they are destroyed
+	std::vector<Client *> clients_;
+	std::uint64_t roundCount_ = 0;
+	bool stopped_ = false;
+	std::thread worker_;
+};
+
+/**
+ * @brief A registration of one segmenter with an InferenceScheduler.
+ *
+ * The scheduler must outlive all of its clients.
+ */
+class InferenceScheduler::Client : public std::enable_shared_from_this<Client> {
+	friend class InferenceScheduler;
+
+	struct PrivateTag {};
+
+public:
+	Client(PrivateTag, InferenceScheduler &scheduler, std::shared_ptr<ISelfieSegmenter> segmenter,
+	       std::string name);
+	~Client() noexcept;
+
+	Client(const Client &) = delete;
+	Client &operator=(const Client &) = delete;
+	Client(Client &&) = delete;
+	Client &operator=(Client &&) = delete;
+
+	/**
+	 * @brief Queues an input for inference, replacing this client's pending input if any.
+	 *
+	 * @param input A block of 4 * pixelCount BGRA bytes. It is kept alive until the inference finishes.
+	 * @param onComplete Called on the scheduler's worker after the mask has been written to the segmenter.
+	 */
+	void submit(Memory::MemoryBlockPool::MemoryBlockSharedPtr input, CompletionCallback onComplete);
+
+	ClientStats getStats() const;
+
+	/**
+	 * @brief Returns the time spent in the segmenter itself for each input, excluding any wait in the queue.
+	 */
+	const Profiling::LatencyHistogram &getInferenceDurations() const noexcept { return inferenceDurations_; }
+
+	const std::string &getName() const noexcept { return name_; }
+
+private:
+	InferenceScheduler &scheduler_;
+	const std::shared_ptr<ISelfieSegmenter> segmenter_;
+	const std::string name_;
+
+	// Guarded by scheduler_.mutex_
+	std::optional<PendingInput> pending_;
+	// The value of scheduler_.roundCount_ at the latest submission, empty until the first one
+	std::optional<std::uint64_t> lastSubmittedRound_;
+	ClientStats stats_{};
+	std::chrono::microseconds totalLatency_{0};
+
+	Profiling::LatencyHistogram inferenceDurations_;
+};
+
+} // namespace KaitoTokyo::SelfieSegmenter
@@ -4,62 +4,253 @@
 
 #pragma once
 
-#include <array>
 #include <atomic>
 #include <cstddef>
-#include <functional>
-#include <mutex>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include <KaitoTokyo/Memory/AlignedAllocator.hpp>
 
 namespace KaitoTokyo::SelfieSegmenter {
 
+/**
+ * @brief Hands the latest mask from one writer to any number of readers without locks or allocations.
+ *
+ * The buffer holds maxReaderCount + 2 slots. Each reader pins the slot it last read, the latest published slot
+ * is never written, and the writer fills a slot that is neither. With at most one pin per reader such a slot
+ * always exists, so the writer never waits. A reader only retries when a publication lands between loading the
+ * latest slot and pinning it, which at inference rates practically never happens twice in a row.
+ *
+ * Every publication increments a generation counter. Readers use it to tell whether their mask is stale and how
+ * many masks they never saw.
+ *
+ * write must only be called from one thread at a time. Each Reader must only be used from one thread at a time.
+ */
 class MaskBuffer {
 	using BlockType = std::vector<std::uint8_t, Memory::AlignedAllocator<std::uint8_t>>;
 
 public:
 	constexpr static std::size_t kAlignment = 32;
+	constexpr static std::size_t kDefaultMaxReaderCount = 2;
+	constexpr static std::size_t kMaxSlotCount = 255;
 
-	explicit MaskBuffer(std::size_t size)
-		: buffers_{BlockType(size, 0, Memory::AlignedAllocator<std::uint8_t>(kAlignment)),
-			   BlockType(size, 0, Memory::AlignedAllocator<std::uint8_t>(kAlignment)),
-			   BlockType(size, 0, Memory::AlignedAllocator<std::uint8_t>(kAlignment))}
+	/**
+	 * @brief A registered reader holding a pin on the slot it last read.
+	 */
+	class Reader {
+	public:
+		Reader(Reader &&other) noexcept
+			: maskBuffer_(std::exchange(other.maskBuffer_, nullptr)),
+			  held_(other.held_),
+			  skippedCount_(other.skippedCount_)
+		{
+		}
+
+		Reader &operator=(Reader &&other) noexcept
+		{
+			if (this != &other) {
+				release();
+				maskBuffer_ = std::exchange(other.maskBuffer_, nullptr);
+				held_ = other.held_;
+				skippedCount_ = other.skippedCount_;
+			}
+			return *this;
+		}
+
+		~Reader() noexcept { release(); }
+
+		Reader(const Reader &) = delete;
+		Reader &operator=(const Reader &) = delete;
+
+		/**
+		 * @brief Returns the latest mask. The pointer stays valid until the next read or the reader's destruction.
+		 */
+		const std::uint8_t *read() noexcept
+		{
+			const std::uint64_t latest = maskBuffer_->latest_.load(std::memory_order_seq_cst);
+			if (latest != held_) {
+				maskBuffer_->unpin(getSlot(held_));
+				const std::uint64_t pinned = maskBuffer_->pinLatest();
+				const std::uint64_t generationGap =
+					MaskBuffer::getGeneration(pinned) - MaskBuffer::getGeneration(held_);
+				skippedCount_ += generationGap > 0 ? generationGap - 1 : 0;
+				held_ = pinned;
+			}
+			return maskBuffer_->slots_[getSlot(held_)].data();
+		}
+
+		/**
+		 * @brief Returns the generation of the mask returned by the last read. The initial empty mask is 0.
+		 */
+		std::uint64_t getGeneration() const noexcept { return MaskBuffer::getGeneration(held_); }
+
+		/**
+		 * @brief Returns whether a mask newer than the one returned by the last read has been published.
+		 */
+		bool isStale() const noexcept
+		{
+			return MaskBuffer::getGeneration(maskBuffer_->latest_.load(std::memory_order_acquire)) !=
+			       getGeneration();
+		}
+
+		/**
+		 * @brief Returns how many published masks this reader has never returned.
+		 */
+		std::uint64_t getSkippedCount() const noexcept { return skippedCount_; }
+
+	private:
+		friend class MaskBuffer;
+
+		explicit Reader(MaskBuffer &maskBuffer) noexcept
+			: maskBuffer_(&maskBuffer),
+			  held_(maskBuffer.pinLatest())
+		{
+		}
+
+		void release() noexcept
+		{
+			if (maskBuffer_) {
+				maskBuffer_->unpin(getSlot(held_));
+				maskBuffer_->readerCount_.fetch_sub(1, std::memory_order_relaxed);
+				maskBuffer_ = nullptr;
+			}
+		}
+
+		MaskBuffer *maskBuffer_;
+		std::uint64_t held_;
+		std::uint64_t skippedCount_ = 0;
+	};
+
+	/**
+	 * @param size The size of one mask in bytes.
+	 * @param maxReaderCount The number of readers that may exist at once, including the one behind read().
+	 */
+	explicit MaskBuffer(std::size_t size, std::size_t maxReaderCount = kDefaultMaxReaderCount)
+		: maxReaderCount_(maxReaderCount > 0 && maxReaderCount + 2 <= kMaxSlotCount
+					  ? maxReaderCount
+					  : throw std::invalid_argument("MaxReaderCountOutOfRangeError(MaskBuffer::MaskBuffer)")),
+		  slots_(maxReaderCount + 2, BlockType(size, 0, Memory::AlignedAllocator<std::uint8_t>(kAlignment))),
+		  pins_(std::make_unique<PinCount[]>(maxReaderCount + 2)),
+		  defaultReader_(makeReader())
 	{
 	}
 
 	~MaskBuffer() noexcept = default;
 
-	void write(std::function<void(std::uint8_t *)> writeFunc)
+	MaskBuffer(const MaskBuffer &) = delete;
+	MaskBuffer &operator=(const MaskBuffer &) = delete;
+	MaskBuffer(MaskBuffer &&) = delete;
+	MaskBuffer &operator=(MaskBuffer &&) = delete;
+
+	/**
+	 * @brief Fills a free slot with @p writeFunc and publishes it as the latest mask.
+	 *
+	 * @param writeFunc Called with a pointer to size bytes. It is invoked directly, without type erasure.
+	 */
+	template<typename WriteFunc> void write(WriteFunc &&writeFunc)
 	{
-		std::lock_guard<std::mutex> lock(bufferMutex_);
-		auto &buffer = buffers_[writerIndex_];
-		writeFunc(buffer.data());
-		writerIndex_ = freshIndex_.exchange(writerIndex_);
-		hasNewFrame_.store(true, std::memory_order_release);
+		// Only this thread stores to latest_, so the relaxed load sees its own last publication
+		const std::uint64_t latest = latest_.load(std::memory_order_relaxed);
+		const std::size_t slot = findFreeSlot(getSlot(latest));
+
+		std::forward<WriteFunc>(writeFunc)(slots_[slot].data());
+
+		latest_.store(makeTicket(getGeneration(latest) + 1, slot), std::memory_order_seq_cst);
 	}
 
-	const std::uint8_t *read() const
+	/**
+	 * @brief Registers a new reader.
+	 *
+	 * @throw std::runtime_error If maxReaderCount readers already exist.
+	 */
+	Reader makeReader()
 	{
-		if (hasNewFrame_.exchange(false, std::memory_order_acq_rel)) {
-			readerIndex_ = freshIndex_.exchange(readerIndex_, std::memory_order_acq_rel);
-		}
+		std::size_t count = readerCount_.load(std::memory_order_relaxed);
+		do {
+			if (count >= maxReaderCount_) {
+				throw std::runtime_error("TooManyReadersError(MaskBuffer::makeReader)");
+			}
+		} while (!readerCount_.compare_exchange_weak(count, count + 1, std::memory_order_relaxed));
 
-		return buffers_[readerIndex_].data();
+		return Reader(*this);
 	}
 
-	MaskBuffer(const MaskBuffer &) = delete;
-	MaskBuffer &operator=(const MaskBuffer &) = delete;
-	MaskBuffer(MaskBuffer &&) = delete;
-	MaskBuffer &operator=(MaskBuffer &&) = delete;
+	/**
+	 * @brief Returns the latest mask through the buffer's own reader, for the single consumer of ISelfieSegmenter.
+	 */
+	const std::uint8_t *read() const noexcept { return defaultReader_.read(); }
+
+	/**
+	 * @brief Returns the generation of the mask the last read() returned. The initial empty mask is 0.
+	 */
+	std::uint64_t getReadGeneration() const noexcept { return defaultReader_.getGeneration(); }
+
+	/**
+	 * @brief Returns the generation of the latest published mask.
+	 */
+	std::uint64_t getGeneration() const noexcept { return getGeneration(latest_.load(std::memory_order_acquire)); }
+
+	std::size_t getSize() const noexcept { return slots_[0].size(); }
 
 private:
-	std::array<BlockType, 3> buffers_;
-	mutable std::size_t readerIndex_ = 0;
-	std::size_t writerIndex_ = 1;
-	mutable std::atomic<std::size_t> freshIndex_ = 2;
-	mutable std::atomic<bool> hasNewFrame_ = false;
-	mutable std::mutex bufferMutex_;
+	// A ticket packs the generation above the slot index so that a reader can validate both with one load
+	constexpr static int kSlotBits = 8;
+	constexpr static std::uint64_t kSlotMask = (std::uint64_t{1} << kSlotBits) - 1;
+
+	struct alignas(64) PinCount {
+		std::atomic<std::uint32_t> count{0};
+	};
+
+	constexpr static std::uint64_t makeTicket(std::uint64_t generation, std::size_t slot) noexcept
+	{
+		return (generation << kSlotBits) | static_cast<std::uint64_t>(slot);
+	}
+
+	constexpr static std::uint64_t getGeneration(std::uint64_t ticket) noexcept { return ticket >> kSlotBits; }
+
+	constexpr static std::size_t getSlot(std::uint64_t ticket) noexcept
+	{
+		return static_cast<std::size_t>(ticket & kSlotMask);
+	}
+
+	std::uint64_t pinLatest() noexcept
+	{
+		// The writer only reuses a slot that is no longer latest, so a pin that still matches latest is safe
+		for (;;) {
+			const std::uint64_t latest = latest_.load(std::memory_order_seq_cst);
+			std::atomic<std::uint32_t> &count = pins_[getSlot(latest)].count;
+			count.fetch_add(1, std::memory_order_seq_cst);
+			if (latest_.load(std::memory_order_seq_cst) == latest) {
+				return latest;
+			}
+			count.fetch_sub(1, std::memory_order_release);
+		}
+	}
+
+	void unpin(std::size_t slot) noexcept { pins_[slot].count.fetch_sub(1, std::memory_order_release); }
+
+	std::size_t findFreeSlot(std::size_t latestSlot) const
+	{
+		for (std::size_t i = 1; i <= slots_.size(); ++i) {
+			const std::size_t slot = (latestSlot + i) % slots_.size();
+			if (slot != latestSlot && pins_[slot].count.load(std::memory_order_seq_cst) == 0) {
+				return slot;
+			}
+		}
+
+		// Unreachable while every reader pins at most one slot
+		throw std::logic_error("NoFreeSlotError(MaskBuffer::findFreeSlot)");
+	}
+
+	const std::size_t maxReaderCount_;
+	std::vector<BlockType> slots_;
+	std::unique_ptr<PinCount[]> pins_;
+	std::atomic<std::uint64_t> latest_{makeTicket(0, 0)};
+	std::atomic<std::size_t> readerCount_{0};
+	mutable Reader defaultReader_;
 };
 
 } // namespace KaitoTokyo::SelfieSegmenter
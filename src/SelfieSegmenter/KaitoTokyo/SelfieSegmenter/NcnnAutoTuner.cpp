@@ -0,0 +1,255 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "NcnnAutoTuner.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "NcnnModelRegistry.hpp"
+#include "NcnnSelfieSegmenter.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define SELFIE_SEGMENTER_HAVE_X86_64
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif // defined(_MSC_VER)
+#endif // defined(_M_X64) || defined(__x86_64__)
+
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#endif
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+namespace {
+
+// A change is kept only if it beats the best so far by this ratio, so that noise does not drift the result
+constexpr double kMinImprovementRatio = 0.97;
+
+// The thread count, packing layout, fp16 mode, winograd, sgemm and OpenMP blocktime
+constexpr int kAxisCount = 6;
+
+/**
+ * @brief Returns the options that differ from @p base in the setting @p axis only.
+ */
+std::vector<NcnnInferenceOptions> makeVariants(const NcnnInferenceOptions &base, int axis, int maxNumThreads)
+{
+	std::vector<NcnnInferenceOptions> variants;
+	const auto addVariant = [&base, &variants](auto &&modify) {
+		NcnnInferenceOptions variant = base;
+		modify(variant);
+		if (variant != base) {
+			variants.push_back(variant);
+		}
+	};
+
+	switch (axis) {
+	case 0:
+		for (int numThreads = 1; numThreads < maxNumThreads; numThreads *= 2) {
+			addVariant([numThreads](NcnnInferenceOptions &o) { o.numThreads = numThreads; });
+		}
+		addVariant([maxNumThreads](NcnnInferenceOptions &o) { o.numThreads = maxNumThreads; });
+		break;
+	case 1:
+		addVariant([](NcnnInferenceOptions &o) { o.usePackingLayout = !o.usePackingLayout; });
+		break;
+	case 2:
+		addVariant([](NcnnInferenceOptions &o) { o.useFp16Storage = o.useFp16Arithmetic = true; });
+		addVariant([](NcnnInferenceOptions &o) {
+			o.useFp16Storage = true;
+			o.useFp16Arithmetic = false;
+		});
+		addVariant([](NcnnInferenceOptions &o) { o.useFp16Storage = o.useFp16Arithmetic = false; });
+		break;
+	case 3:
+		addVariant([](NcnnInferenceOptions &o) { o.useWinogradConvolution = !o.useWinogradConvolution; });
+		break;
+	case 4:
+		addVariant([](NcnnInferenceOptions &o) { o.useSgemmConvolution = !o.useSgemmConvolution; });
+		break;
+	case 5:
+		for (const int openmpBlocktime : {0, 1, 20}) {
+			addVariant([openmpBlocktime](NcnnInferenceOptions &o) { o.openmpBlocktime = openmpBlocktime; });
+		}
+		break;
+	default:
+		break;
+	}
+
+	return variants;
+}
+
+std::string trim(std::string text)
+{
+	const std::size_t first = text.find_first_not_of(" \t");
+	if (first == std::string::npos) {
+		return {};
+	}
+	const std::size_t last = text.find_last_not_of(" \t");
+	return text.substr(first, last - first + 1);
+}
+
+} // anonymous namespace
+
+NcnnAutoTuner::NcnnAutoTuner(std::shared_ptr<const Logger::ILogger> logger, int maxNumThreads)
+	: logger_(logger ? std::move(logger)
+			 : throw std::invalid_argument("LoggerIsNullError(NcnnAutoTuner::NcnnAutoTuner)")),
+	  maxNumThreads_(maxNumThreads >= 1 ? maxNumThreads
+					    : throw std::invalid_argument(
+						      "MaxNumThreadsOutOfRangeError(NcnnAutoTuner::NcnnAutoTuner)"))
+{
+}
+
+NcnnAutoTuner::Result NcnnAutoTuner::search(const MeasureFunction &measure, const std::atomic<bool> *cancelled) const
+{
+	const auto isCancelled = [cancelled] { return cancelled && cancelled->load(); };
+	const auto runTrial = [this, &measure](Result &result, const NcnnInferenceOptions &options) {
+		const double elapsedMs = measure(options);
+		result.trials.push_back(Trial{options, elapsedMs});
+		logger_->debug("NcnnTuningTrial", {{"options", options.serialize()},
+						   {"elapsedMs", std::to_string(elapsedMs)}});
+		return elapsedMs;
+	};
+
+	Result result{NcnnInferenceOptions{}, 0.0, {}};
+	result.bestElapsedMs = runTrial(result, result.bestOptions);
+
+	for (int axis = 0; axis < kAxisCount; ++axis) {
+		const std::vector<NcnnInferenceOptions> variants =
+			makeVariants(result.bestOptions, axis, maxNumThreads_);
+
+		// Every variant of an axis is compared against the best before the axis, not against each other's noise
+		const double axisBaselineMs = result.bestElapsedMs;
+		for (const NcnnInferenceOptions &variant : variants) {
+			if (isCancelled()) {
+				logger_->info("NcnnTuningCancelled");
+				return result;
+			}
+
+			const double elapsedMs = runTrial(result, variant);
+			if (elapsedMs < axisBaselineMs * kMinImprovementRatio && elapsedMs < result.bestElapsedMs) {
+				result.bestOptions = variant;
+				result.bestElapsedMs = elapsedMs;
+			}
+		}
+	}
+
+	return result;
+}
+
+NcnnAutoTuner::Result NcnnAutoTuner::tune(const char *paramText, int binSize, const unsigned char *binData,
+					  int warmupCount, int iterationCount, const std::atomic<bool> *cancelled) const
+{
+	if (iterationCount < 1) {
+		throw std::invalid_argument("IterationCountOutOfRangeError(NcnnAutoTuner::tune)");
+	}
+
+	std::vector<std::uint8_t> frame;
+	const auto measure = [&](const NcnnInferenceOptions &options) {
+		NcnnSelfieSegmenter segmenter(NcnnModelRegistry::loadNet(paramText, binSize, binData, options),
+					      options.numThreads);
+
+		// A smooth gradient keeps the network busy the same way a real frame does, unlike a constant color
+		if (frame.empty()) {
+			frame.resize(segmenter.getPixelCount() * 4);
+			for (std::size_t y = 0; y < segmenter.getHeight(); ++y) {
+				for (std::size_t x = 0; x < segmenter.getWidth(); ++x) {
+					std::uint8_t *pixel = &frame[(y * segmenter.getWidth() + x) * 4];
+					pixel[0] = static_cast<std::uint8_t>(x);
+					pixel[1] = static_cast<std::uint8_t>(y);
+					pixel[2] = static_cast<std::uint8_t>(x + y);
+					pixel[3] = 255;
+				}
+			}
+		}
+
+		for (int i = 0; i < warmupCount; ++i) {
+			segmenter.process(frame.data());
+		}
+
+		std::vector<double> elapsedMs(static_cast<std::size_t>(iterationCount));
+		for (double &sample : elapsedMs) {
+			const auto startTime = std::chrono::steady_clock::now();
+			segmenter.process(frame.data());
+			sample = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime)
+					 .count();
+		}
+
+		const auto median = elapsedMs.begin() + static_cast<std::ptrdiff_t>(elapsedMs.size() / 2);
+		std::nth_element(elapsedMs.begin(), median, elapsedMs.end());
+		return *median;
+	};
+
+	Result result = search(measure, cancelled);
+	logger_->info("NcnnTuningFinished", {{"bestOptions", result.bestOptions.serialize()},
+					     {"bestElapsedMs", std::to_string(result.bestElapsedMs)},
+					     {"defaultElapsedMs", std::to_string(result.trials.front().elapsedMs)},
+					     {"trialCount", std::to_string(result.trials.size())}});
+	return result;
+}
+
+std::optional<std::string> NcnnAutoTuner::getCpuModelName()
+{
+#if defined(SELFIE_SEGMENTER_HAVE_X86_64)
+	int cpuInfo[4];
+	auto cpuid = [&cpuInfo](unsigned int leaf) {
+#if defined(_MSC_VER)
+		__cpuid(cpuInfo, static_cast<int>(leaf));
+#else
+		__cpuid(leaf, cpuInfo[0], cpuInfo[1], cpuInfo[2], cpuInfo[3]);
+#endif
+	};
+
+	// Leaves 0x80000002 to 0x80000004 hold the 48-byte brand string
+	cpuid(0x80000000u);
+	if (static_cast<unsigned int>(cpuInfo[0]) < 0x80000004u) {
+		return std::nullopt;
+	}
+
+	char brand[49] = {};
+	for (unsigned int i = 0; i < 3; ++i) {
+		cpuid(0x80000002u + i);
+		std::memcpy(brand + i * 16, cpuInfo, 16);
+	}
+	std::string name = trim(brand);
+	return name.empty() ? std::nullopt : std::optional<std::string>(std::move(name));
+#elif defined(__APPLE__)
+	char brand[256] = {};
+	std::size_t size = sizeof(brand) - 1;
+	if (sysctlbyname("machdep.cpu.brand_string", brand, &size, nullptr, 0) != 0) {
+		return std::nullopt;
+	}
+	std::string name = trim(brand);
+	return name.empty() ? std::nullopt : std::optional<std::string>(std::move(name));
+#elif defined(__linux__)
+	std::ifstream cpuinfo("/proc/cpuinfo");
+	std::string line;
+	while (std::getline(cpuinfo, line)) {
+		if (line.rfind("model name", 0) == 0 || line.rfind("Model", 0) == 0) {
+			const std::size_t separator = line.find(':');
+			if (separator != std::string::npos) {
+				std::string name = trim(line.substr(separator + 1));
+				if (!name.empty()) {
+					return name;
+				}
+			}
+		}
+	}
+	return std::nullopt;
+#else
+	return std::nullopt;
+#endif
+}
+
+} // namespace KaitoTokyo::SelfieSegmenter
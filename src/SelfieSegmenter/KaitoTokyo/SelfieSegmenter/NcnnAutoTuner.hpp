@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <KaitoTokyo/Logger/ILogger.hpp>
+
+#include "NcnnInferenceOptions.hpp"
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+/**
+ * @brief Finds the fastest NcnnInferenceOptions for a network on the running machine.
+ *
+ * Trying every combination would take minutes, so the search is greedy: starting from the defaults, each setting
+ * in turn is tried at its other values while the rest stay at the best found so far, and a change is kept only if
+ * it is faster. Settings rarely interact strongly enough for this to miss the optimum by much.
+ */
+class NcnnAutoTuner {
+public:
+	/**
+	 * @brief Returns the time in milliseconds one inference takes with the given options.
+	 */
+	using MeasureFunction = std::function<double(const NcnnInferenceOptions &options)>;
+
+	struct Trial {
+		NcnnInferenceOptions options;
+		double elapsedMs;
+	};
+
+	struct Result {
+		NcnnInferenceOptions bestOptions;
+		double bestElapsedMs;
+		/// Every measurement in the order it was made, the defaults first.
+		std::vector<Trial> trials;
+	};
+
+	/**
+	 * @param logger The logger each trial is reported to.
+	 * @param maxNumThreads The largest thread count tried, usually the number of physical cores.
+	 * @throw std::invalid_argument If logger is null or maxNumThreads is less than 1.
+	 */
+	NcnnAutoTuner(std::shared_ptr<const Logger::ILogger> logger, int maxNumThreads);
+
+	/**
+	 * @brief Runs the greedy search with @p measure.
+	 *
+	 * @param cancelled Checked before each trial; once it is set, the search stops with the best result so far.
+	 */
+	Result search(const MeasureFunction &measure, const std::atomic<bool> *cancelled = nullptr) const;
+
+	/**
+	 * @brief Searches with real inferences of the given network on a synthetic frame.
+	 *
+	 * Each trial loads the network with its options, runs @p warmupCount inferences and reports the median of the
+	 * next @p iterationCount.
+	 *
+	 * @throw std::runtime_error If the model cannot be loaded.
+	 */
+	Result tune(const char *paramText, int binSize, const unsigned char *binData, int warmupCount,
+		    int iterationCount, const std::atomic<bool> *cancelled = nullptr) const;
+
+	/**
+	 * @brief Returns the marketing name of the CPU, such as "AMD Ryzen 7 5800X 8-Core Processor".
+	 *
+	 * Tuned options are only valid on the CPU they were measured on, so this names where they came from.
+	 *
+	 * @return std::nullopt if the name cannot be determined on this platform.
+	 */
+	static std::optional<std::string> getCpuModelName();
+
+private:
+	const std::shared_ptr<const Logger::ILogger> logger_;
+	const int maxNumThreads_;
+};
+
+} // namespace KaitoTokyo::SelfieSegmenter
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "NcnnInferenceOptions.hpp"
+
+#include <charconv>
+#include <cstddef>
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+namespace {
+
+constexpr int kMaxNumThreads = 256;
+constexpr int kMaxOpenmpBlocktime = 1000;
+
+std::optional<int> parseInt(std::string_view value, int minValue, int maxValue)
+{
+	int result = 0;
+	const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+	if (ec != std::errc() || end != value.data() + value.size() || result < minValue || result > maxValue) {
+		return std::nullopt;
+	}
+	return result;
+}
+
+std::optional<bool> parseBool(std::string_view value)
+{
+	if (value == "1") {
+		return true;
+	} else if (value == "0") {
+		return false;
+	}
+	return std::nullopt;
+}
+
+} // anonymous namespace
+
+void NcnnInferenceOptions::applyTo(ncnn::Option &option) const noexcept
+{
+	option.use_local_pool_allocator = true;
+	option.use_packing_layout = usePackingLayout;
+	option.use_fp16_storage = useFp16Storage;
+	option.use_fp16_arithmetic = useFp16Storage && useFp16Arithmetic;
+	option.use_winograd_convolution = useWinogradConvolution;
+	option.use_sgemm_convolution = useSgemmConvolution;
+	option.openmp_blocktime = openmpBlocktime;
+}
+
+std::string NcnnInferenceOptions::getNetKey() const
+{
+	NcnnInferenceOptions netOptions = *this;
+	// The thread count is an extractor setting, so every value shares one network
+	netOptions.numThreads = NcnnInferenceOptions{}.numThreads;
+	return netOptions.serialize();
+}
+
+std::string NcnnInferenceOptions::serialize() const
+{
+	std::string text;
+	text += "numThreads=" + std::to_string(numThreads) + "\n";
+	text += "usePackingLayout=" + std::to_string(usePackingLayout ? 1 : 0) + "\n";
+	text += "useFp16Storage=" + std::to_string(useFp16Storage ? 1 : 0) + "\n";
+	text += "useFp16Arithmetic=" + std::to_string(useFp16Arithmetic ? 1 : 0) + "\n";
+	text += "useWinogradConvolution=" + std::to_string(useWinogradConvolution ? 1 : 0) + "\n";
+	text += "useSgemmConvolution=" + std::to_string(useSgemmConvolution ? 1 : 0) + "\n";
+	text += "openmpBlocktime=" + std::to_string(openmpBlocktime) + "\n";
+	return text;
+}
+
+std::optional<NcnnInferenceOptions> NcnnInferenceOptions::parse(std::string_view text)
+{
+	NcnnInferenceOptions options;
+
+	while (!text.empty()) {
+		const std::size_t lineEnd = text.find('\n');
+		std::string_view line = text.substr(0, lineEnd);
+		text = lineEnd == std::string_view::npos ? std::string_view() : text.substr(lineEnd + 1);
+
+		if (!line.empty() && line.back() == '\r') {
+			line.remove_suffix(1);
+		}
+		if (line.empty()) {
+			continue;
+		}
+
+		const std::size_t separator = line.find('=');
+		if (separator == std::string_view::npos) {
+			return std::nullopt;
+		}
+		const std::string_view key = line.substr(0, separator);
+		const std::string_view value = line.substr(separator + 1);
+
+		if (key == "numThreads" || key == "openmpBlocktime") {
+			const bool isNumThreads = key == "numThreads";
+			const std::optional<int> intValue = isNumThreads ? parseInt(value, 1, kMaxNumThreads)
+									 : parseInt(value, 0, kMaxOpenmpBlocktime);
+			if (!intValue) {
+				return std::nullopt;
+			}
+			(isNumThreads ? options.numThreads : options.openmpBlocktime) = *intValue;
+			continue;
+		}
+
+		bool *flag = nullptr;
+		if (key == "usePackingLayout") {
+			flag = &options.usePackingLayout;
+		} else if (key == "useFp16Storage") {
+			flag = &options.useFp16Storage;
+		} else if (key == "useFp16Arithmetic") {
+			flag = &options.useFp16Arithmetic;
+		} else if (key == "useWinogradConvolution") {
+			flag = &options.useWinogradConvolution;
+		} else if (key == "useSgemmConvolution") {
+			flag = &options.useSgemmConvolution;
+		} else {
+			return std::nullopt;
+		}
+
+		const std::optional<bool> boolValue = parseBool(value);
+		if (!boolValue) {
+			return std::nullopt;
+		}
+		*flag = *boolValue;
+	}
+
+	return options;
+}
+
+} // namespace KaitoTokyo::SelfieSegmenter
@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#ifdef PREFIXED_NCNN_HEADERS
+#include <ncnn/option.h>
+#else
+#include <option.h>
+#endif
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+/**
+ * @brief The ncnn settings that trade speed between machines without changing what the network computes.
+ *
+ * The defaults are the settings used before tuning existed. Everything but numThreads is fixed when a network is
+ * loaded, so networks loaded with different options are not interchangeable.
+ */
+struct NcnnInferenceOptions {
+	/// The number of threads each extractor runs the network on.
+	int numThreads = 1;
+	bool usePackingLayout = true;
+	bool useFp16Storage = true;
+	/// Only takes effect together with useFp16Storage.
+	bool useFp16Arithmetic = true;
+	bool useWinogradConvolution = true;
+	bool useSgemmConvolution = true;
+	/// How long in milliseconds OpenMP workers spin after a layer before they sleep.
+	int openmpBlocktime = 1;
+
+	bool operator==(const NcnnInferenceOptions &) const noexcept = default;
+
+	/**
+	 * @brief Copies the load-time settings into @p option.
+	 */
+	void applyTo(ncnn::Option &option) const noexcept;
+
+	/**
+	 * @brief Returns a string that is equal for two options exactly when their loaded networks are interchangeable.
+	 */
+	std::string getNetKey() const;
+
+	/**
+	 * @brief Writes the options as "key=value" lines.
+	 */
+	std::string serialize() const;
+
+	/**
+	 * @brief Reads options written by serialize().
+	 *
+	 * Keys missing from @p text keep their defaults so that files written by older versions still load.
+	 *
+	 * @return std::nullopt if a line is malformed or a value is out of range.
+	 */
+	static std::optional<NcnnInferenceOptions> parse(std::string_view text);
+};
+
+} // namespace KaitoTokyo::SelfieSegmenter
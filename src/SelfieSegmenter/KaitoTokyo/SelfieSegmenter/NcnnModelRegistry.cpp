@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "NcnnModelRegistry.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+NcnnModelRegistry::NcnnModelRegistry(std::shared_ptr<const Logger::ILogger> logger)
+	: logger_(logger ? std::move(logger)
+			 : throw std::invalid_argument("LoggerIsNullError(NcnnModelRegistry::NcnnModelRegistry)"))
+{
+}
+
+NcnnModelRegistry::~NcnnModelRegistry() noexcept {}
+
+std::shared_ptr<const ncnn::Net> NcnnModelRegistry::acquire(const std::string &key, const char *paramText,
+							    int binSize, const unsigned char *binData,
+							    const NcnnInferenceOptions &options)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const std::string entryKey = key + "\n" + options.getNetKey();
+	if (auto it = entries_.find(entryKey); it != entries_.end()) {
+		if (std::shared_ptr<const ncnn::Net> net = it->second.net.lock()) {
+			markLatestLocked(entryKey, net);
+			Stats stats = getStatsLocked();
+			logger_->info("NcnnModelShared", {{"key", key},
+							  {"activeUserCount", std::to_string(stats.activeUserCount)},
+							  {"savedBytes", std::to_string(stats.savedBytes)}});
+			return net;
+		}
+	}
+
+	// Forget the networks that were unloaded since, so that superseded options do not pile up
+	std::erase_if(entries_, [](const auto &item) { return item.second.net.expired(); });
+
+	const auto startTime = std::chrono::steady_clock::now();
+	std::shared_ptr<const ncnn::Net> net = loadNet(paramText, binSize, binData, options);
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+										    startTime);
+
+	entries_.insert_or_assign(entryKey, Entry{key, net, nullptr, static_cast<std::size_t>(binSize)});
+	markLatestLocked(entryKey, net);
+	logger_->info("NcnnModelLoaded", {{"key", key},
+					  {"binSize", std::to_string(binSize)},
+					  {"elapsedMs", std::to_string(elapsed.count())}});
+
+	return net;
+}
+
+NcnnModelRegistry::Stats NcnnModelRegistry::getStats() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return getStatsLocked();
+}
+
+void NcnnModelRegistry::markLatestLocked(const std::string &entryKey, const std::shared_ptr<const ncnn::Net> &net)
+{
+	Entry &latest = entries_.at(entryKey);
+	// Releasing the previous network of the same model unloads it once its own users are gone
+	for (auto &[key, entry] : entries_) {
+		if (entry.modelKey == latest.modelKey && &entry != &latest) {
+			entry.latestNet.reset();
+		}
+	}
+	latest.latestNet = net;
+}
+
+NcnnModelRegistry::Stats NcnnModelRegistry::getStatsLocked() const
+{
+	Stats stats{0, 0, 0};
+	for (const auto &[key, entry] : entries_) {
+		const auto references = static_cast<std::size_t>(entry.net.use_count());
+		if (references == 0) {
+			continue;
+		}
+		const std::size_t users = references - (entry.latestNet ? 1 : 0);
+		stats.loadedModelCount++;
+		stats.activeUserCount += users;
+		if (users > 1) {
+			stats.savedBytes += (users - 1) * entry.binSize;
+		}
+	}
+	return stats;
+}
+
+std::shared_ptr<ncnn::Net> NcnnModelRegistry::loadNet(const char *paramText, int binSize,
+						      const unsigned char *binData, const NcnnInferenceOptions &options)
+{
+	auto net = std::make_shared<ncnn::Net>();
+	options.applyTo(net->opt);
+
+	if (net->load_param_mem(paramText) != 0) {
+		throw std::runtime_error("ParamLoadError(NcnnModelRegistry::loadNet)");
+	}
+
+	if (net->load_model(binData) != binSize) {
+		throw std::runtime_error("ModelLoadError(NcnnModelRegistry::loadNet)");
+	}
+
+	return net;
+}
+
+} // namespace KaitoTokyo::SelfieSegmenter
@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#ifdef PREFIXED_NCNN_HEADERS
+#include <ncnn/net.h>
+#else
+#include <net.h>
+#endif
+
+#include <KaitoTokyo/Logger/ILogger.hpp>
+
+#include "NcnnInferenceOptions.hpp"
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+/**
+ * @brief A process-wide cache of loaded ncnn networks.
+ *
+ * Each model is parsed, loaded and packed once for as long as anyone uses it. Consumers
+ * receive a shared, immutable ncnn::Net and create their own lightweight ncnn::Extractor per
+ * inference, which ncnn supports concurrently from multiple threads. The registry keeps the
+ * network most recently acquired for each model loaded even without users, so that a filter
+ * rebuilding its context does not reload it. Networks loaded with other options are held
+ * weakly and unloaded once their last user releases them, such as those superseded by a retune.
+ */
+class NcnnModelRegistry {
+public:
+	/**
+	 * @brief Snapshot of registry usage. The registry's own references are not counted as users.
+	 */
+	struct Stats {
+		std::size_t loadedModelCount;
+		std::size_t activeUserCount;
+		std::size_t savedBytes;
+	};
+
+	explicit NcnnModelRegistry(std::shared_ptr<const Logger::ILogger> logger);
+	~NcnnModelRegistry() noexcept;
+
+	NcnnModelRegistry(const NcnnModelRegistry &) = delete;
+	NcnnModelRegistry &operator=(const NcnnModelRegistry &) = delete;
+	NcnnModelRegistry(NcnnModelRegistry &&) = delete;
+	NcnnModelRegistry &operator=(NcnnModelRegistry &&) = delete;
+
+	/**
+	 * @brief Returns the network registered under key, loading it from memory if no one holds it.
+	 *
+	 * @param key A name unique to the model data.
+	 * @param paramText The ncnn param text of the model.
+	 * @param binSize The size of binData in bytes.
+	 * @param binData The ncnn weight data. It must outlive the registry because ncnn references it in place.
+	 * @param options The load-time settings. Each distinct NcnnInferenceOptions::getNetKey() loads its own copy.
+	 * @throw std::runtime_error If the model cannot be loaded.
+	 */
+	std::shared_ptr<const ncnn::Net> acquire(const std::string &key, const char *paramText, int binSize,
+						 const unsigned char *binData,
+						 const NcnnInferenceOptions &options = NcnnInferenceOptions{});
+
+	/**
+	 * @brief Returns the current usage statistics.
+	 *
+	 * savedBytes estimates the weight memory that would have been resident if every
+	 * active user had loaded its own copy of the model.
+	 */
+	Stats getStats() const;
+
+	/**
+	 * @brief Loads a network from memory with the load-time settings of @p options.
+	 */
+	static std::shared_ptr<ncnn::Net> loadNet(const char *paramText, int binSize, const unsigned char *binData,
+						  const NcnnInferenceOptions &options = NcnnInferenceOptions{});
+
+private:
+	struct Entry {
+		std::string modelKey;
+		std::weak_ptr<const ncnn::Net> net;
+		/// Set only on the entry most recently acquired for modelKey.
+		std::shared_ptr<const ncnn::Net> latestNet;
+		std::size_t binSize;
+	};
+
+	void markLatestLocked(const std::string &entryKey, const std::shared_ptr<const ncnn::Net> &net);
+
+	Stats getStatsLocked() const;
+
+	const std::shared_ptr<const Logger::ILogger> logger_;
+
+	mutable std::mutex mutex_;
+	std::unordered_map<std::string, Entry> entries_;
+};
+
+} // namespace KaitoTokyo::SelfieSegmenter
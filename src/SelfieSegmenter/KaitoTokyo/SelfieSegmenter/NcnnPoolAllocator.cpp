@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "NcnnPoolAllocator.hpp"
+
+#include <cassert>
+
+#include <KaitoTokyo/Memory/AlignedAllocator.hpp>
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+namespace {
+
+// The block header occupies a whole alignment unit so that the returned pointer stays aligned
+constexpr std::size_t kHeaderSize = NcnnPoolAllocator::kAlignment;
+
+// ncnn's own fastMalloc over-allocates by this much because some kernels read past the end of a Mat
+constexpr std::size_t kOverreadSize = 64;
+
+struct BlockHeader {
+	std::size_t sizeClassIndex;
+};
+
+inline std::size_t roundUpToAlignment(std::size_t size)
+{
+	return (size + NcnnPoolAllocator::kAlignment - 1) & ~(NcnnPoolAllocator::kAlignment - 1);
+}
+
+inline std::size_t getBlockBytes(std::size_t size)
+{
+	return kHeaderSize + size + kOverreadSize;
+}
+
+} // anonymous namespace
+
+NcnnPoolAllocator::NcnnPoolAllocator() noexcept = default;
+
+NcnnPoolAllocator::~NcnnPoolAllocator() noexcept
+{
+	Memory::AlignedAllocator<std::uint8_t> allocator(kAlignment);
+	for (SizeClass &sizeClass : sizeClasses_) {
+		assert(sizeClass.freeBlocks.size() == sizeClass.blockCount && "NcnnPoolAllocator destroyed while in use");
+		for (std::uint8_t *block : sizeClass.freeBlocks) {
+			allocator.deallocate(block, getBlockBytes(sizeClass.size));
+		}
+	}
+}
+
+void *NcnnPoolAllocator::fastMalloc(size_t size)
+{
+	const std::size_t roundedSize = roundUpToAlignment(size);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const std::size_t sizeClassIndex = findOrAddSizeClassLocked(roundedSize);
+	SizeClass &sizeClass = sizeClasses_[sizeClassIndex];
+
+	std::uint8_t *block;
+	if (!sizeClass.freeBlocks.empty()) {
+		block = sizeClass.freeBlocks.back();
+		sizeClass.freeBlocks.pop_back();
+		pooledAllocationCount_++;
+	} else {
+		block = Memory::AlignedAllocator<std::uint8_t>(kAlignment).allocate(getBlockBytes(roundedSize));
+		reinterpret_cast<BlockHeader *>(block)->sizeClassIndex = sizeClassIndex;
+
+		// Reserving here means returning a block in fastFree never has to grow the free list
+		sizeClass.blockCount++;
+		sizeClass.freeBlocks.reserve(sizeClass.blockCount);
+
+		systemAllocationCount_++;
+		reservedBytes_ += getBlockBytes(roundedSize);
+	}
+
+	return block + kHeaderSize;
+}
+
+void NcnnPoolAllocator::fastFree(void *ptr)
+{
+	if (!ptr) {
+		return;
+	}
+
+	std::uint8_t *block = static_cast<std::uint8_t *>(ptr) - kHeaderSize;
+	const std::size_t sizeClassIndex = reinterpret_cast<const BlockHeader *>(block)->sizeClassIndex;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	sizeClasses_[sizeClassIndex].freeBlocks.push_back(block);
+}
+
+NcnnPoolAllocator::Stats NcnnPoolAllocator::getStats() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return {systemAllocationCount_, pooledAllocationCount_, reservedBytes_, sizeClasses_.size()};
+}
+
+std::size_t NcnnPoolAllocator::findOrAddSizeClassLocked(std::size_t size)
+{
+	// A network only uses a few dozen distinct sizes, so a linear scan beats hashing here
+	for (std::size_t i = 0; i < sizeClasses_.size(); ++i) {
+		if (sizeClasses_[i].size == size) {
+			return i;
+		}
+	}
+
+	sizeClasses_.push_back({size, 0, {}});
+	return sizeClasses_.size() - 1;
+}
+
+} // namespace KaitoTokyo::SelfieSegmenter
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#ifdef PREFIXED_NCNN_HEADERS
+#include <ncnn/net.h>
+#else
+#include <net.h>
+#endif
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+/**
+ * @brief An ncnn::Allocator that recycles blocks by size so that repeated inferences stop allocating.
+ *
+ * The first inference allocates every blob and workspace buffer it needs through
+ * Memory::AlignedAllocator. When ncnn frees a buffer it is kept on a free list for its size
+ * class, and later requests of the same size are served from that list. Since a network
+ * requests the same sizes on every run, steady-state inferences are served entirely from
+ * the free lists.
+ *
+ * The allocator is thread-safe, as ncnn may allocate from its worker threads.
+ * Every block must be freed before the allocator is destroyed.
+ */
+class NcnnPoolAllocator final : public ncnn::Allocator {
+public:
+	/**
+	 * @brief Snapshot of allocator usage.
+	 */
+	struct Stats {
+		/// The number of requests that had to allocate a new block.
+		std::size_t systemAllocationCount;
+		/// The number of requests served from a free list.
+		std::size_t pooledAllocationCount;
+		/// The total size of all blocks owned by the allocator, in bytes.
+		std::size_t reservedBytes;
+		/// The number of distinct block sizes seen so far.
+		std::size_t sizeClassCount;
+	};
+
+	constexpr static std::size_t kAlignment = 64;
+
+	NcnnPoolAllocator() noexcept;
+	~NcnnPoolAllocator() noexcept override;
+
+	NcnnPoolAllocator(const NcnnPoolAllocator &) = delete;
+	NcnnPoolAllocator &operator=(const NcnnPoolAllocator &) = delete;
+	NcnnPoolAllocator(NcnnPoolAllocator &&) = delete;
+	NcnnPoolAllocator &operator=(NcnnPoolAllocator &&) = delete;
+
+	void *fastMalloc(size_t size) override;
+	void fastFree(void *ptr) override;
+
+	Stats getStats() const;
+
+private:
+	struct SizeClass {
+		std::size_t size;
+		std::size_t blockCount;
+		std::vector<std::uint8_t *> freeBlocks;
+	};
+
+	std::size_t findOrAddSizeClassLocked(std::size_t size);
+
+	std::vector<SizeClass> sizeClasses_;
+	std::size_t systemAllocationCount_ = 0;
+	std::size_t pooledAllocationCount_ = 0;
+	std::size_t reservedBytes_ = 0;
+	mutable std::mutex mutex_;
+};
+
+} // namespace KaitoTokyo::SelfieSegmenter
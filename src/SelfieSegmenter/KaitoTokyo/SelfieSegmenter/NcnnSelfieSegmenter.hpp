@@ -14,6 +14,7 @@
 #include <mutex>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #ifdef PREFIXED_NCNN_HEADERS
@@ -22,46 +23,69 @@
 #include <net.h>
 #endif
 
-#include <KaitoTokyo/Memory/AlignedAllocator.hpp>
-
 #include "ISelfieSegmenter.hpp"
 #include "MaskBuffer.hpp"
+#include "NcnnModelRegistry.hpp"
+#include "NcnnPoolAllocator.hpp"
 #include "ShapeConverter.hpp"
 
 namespace KaitoTokyo::SelfieSegmenter {
 
-namespace {
-
-constexpr auto kMaxFileSize = 10 * 1024 * 1024;
-constexpr auto kAlignment = 32;
-
-} // anonymous namespace
-
+/**
+ * @brief Runs the MediaPipe selfie segmentation model through ncnn.
+ *
+ * InputMode::RawPixels only removes the normalization pass. ncnn::Mat::from_pixels still expands every frame
+ * into a full float CHW mat, so the input tensor is as large as with InputMode::NormalizedFloat and the input
+ * bandwidth is not reduced.
+ */
 class NcnnSelfieSegmenter final : public ISelfieSegmenter {
 public:
-	NcnnSelfieSegmenter(const char *paramText, int binSize, const unsigned char *binData, int numThreads)
-		: maskBuffer_(kPixelCount)
+	/**
+	 * @brief The value range the network expects on its RGB input.
+	 */
+	enum class InputMode {
+		/// Planar RGB normalized to [0, 1], as produced by the standard conversion.
+		NormalizedFloat,
+		/// Planar RGB in [0, 255], for models converted with the normalization folded into the first layer.
+		RawPixels,
+	};
+
+	/**
+	 * @brief Creates a segmenter that runs a network shared with other segmenters.
+	 *
+	 * @param net A loaded network, typically obtained from NcnnModelRegistry.
+	 * @param numThreads The number of threads used by this segmenter's extractor.
+	 * @param inputMode The input range the network was converted for.
+	 */
+	NcnnSelfieSegmenter(std::shared_ptr<const ncnn::Net> net, int numThreads,
+			    InputMode inputMode = InputMode::NormalizedFloat)
+		: maskBuffer_(kPixelCount),
+		  selfieSegmenterNet_(net ? std::move(net)
+					  : throw std::invalid_argument(
+						    "NetIsNullError(NcnnSelfieSegmenter::NcnnSelfieSegmenter)")),
+		  numThreads_(numThreads),
+		  inputMode_(inputMode)
 	{
-		selfieSegmenterNet_.opt.num_threads = numThreads;
-		selfieSegmenterNet_.opt.use_local_pool_allocator = true;
-		selfieSegmenterNet_.opt.openmp_blocktime = 1;
-
-		if (selfieSegmenterNet_.load_param_mem(paramText) != 0) {
-			throw std::runtime_error("ParamLoadError(NcnnSelfieSegmenter::NcnnSelfieSegmenter)");
+		// The raw input is created by from_pixels on every call instead
+		if (inputMode_ == InputMode::NormalizedFloat) {
+			inputMat_.create(static_cast<int>(getWidth()), static_cast<int>(getHeight()), 3);
 		}
-
-		if (selfieSegmenterNet_.load_model(binData) != binSize) {
-			throw std::runtime_error("ModelLoadError(NcnnSelfieSegmenter::NcnnSelfieSegmenter)");
-		}
-
-		inputMat_.create(static_cast<int>(getWidth()), static_cast<int>(getHeight()), 3);
 		outputMat_.create(static_cast<int>(getWidth()), static_cast<int>(getHeight()), 1);
 
-		if (inputMat_.empty() || outputMat_.empty()) {
+		if ((inputMode_ == InputMode::NormalizedFloat && inputMat_.empty()) || outputMat_.empty()) {
 			throw std::runtime_error("Failed to create NcnnSelfieSegmenter internal mats");
 		}
 	}
 
+	/**
+	 * @brief Creates a segmenter that owns its own copy of the network.
+	 */
+	NcnnSelfieSegmenter(const char *paramText, int binSize, const unsigned char *binData, int numThreads,
+			    InputMode inputMode = InputMode::NormalizedFloat)
+		: NcnnSelfieSegmenter(NcnnModelRegistry::loadNet(paramText, binSize, binData), numThreads, inputMode)
+	{
+	}
+
 	~NcnnSelfieSegmenter() noexcept override = default;
 
 	std::size_t getWidth() const noexcept override { return kWidth; }
@@ -76,15 +100,27 @@ public:
 				std::to_string(getPixelCount()) + ") uint8_ts");
 		}
 
-		if (inputMat_.empty() || outputMat_.empty()) {
+		if ((inputMode_ == InputMode::NormalizedFloat && inputMat_.empty()) || outputMat_.empty()) {
 			throw std::runtime_error("NcnnSelfieSegmenter internal mats are not properly initialized");
 		}
 
-		copy_r8_bgra_to_float_chw(inputMat_.channel(0), inputMat_.channel(1), inputMat_.channel(2), bgraData,
-					  getPixelCount());
+		// Raw pixels go through ncnn's own SIMD deinterleave, which needs no normalization pass but still
+		// produces floats
+		if (inputMode_ == InputMode::RawPixels) {
+			rawInputMat_ = ncnn::Mat::from_pixels(bgraData, ncnn::Mat::PIXEL_BGRA2RGB,
+							      static_cast<int>(kWidth), static_cast<int>(kHeight),
+							      &poolAllocator_);
+		} else {
+			copy_r8_bgra_to_float_chw(inputMat_.channel(0), inputMat_.channel(1), inputMat_.channel(2),
+						  bgraData, getPixelCount());
+		}
 
-		ncnn::Extractor ex = selfieSegmenterNet_.create_extractor();
-		ex.input("in0", inputMat_);
+		// Without explicit allocators every extractor would build and tear down its own local pools
+		ncnn::Extractor ex = selfieSegmenterNet_->create_extractor();
+		ex.set_num_threads(numThreads_);
+		ex.set_blob_allocator(&poolAllocator_);
+		ex.set_workspace_allocator(&poolAllocator_);
+		ex.input("in0", getInputMat());
 		ex.extract("out0", outputMat_);
 
 		maskBuffer_.write([this](std::uint8_t *mask) {
@@ -93,6 +129,28 @@ public:
 	}
 
 	const std::uint8_t *getMask() const override { return maskBuffer_.read(); }
+	std::uint64_t getPublishedMaskGeneration() const noexcept override { return maskBuffer_.getGeneration(); }
+	std::uint64_t getMaskGeneration() const noexcept override { return maskBuffer_.getReadGeneration(); }
+
+	/**
+	 * @brief Returns the planar RGB input the last process call fed to the network, in the range of the input mode.
+	 */
+	const ncnn::Mat &getInputMat() const noexcept
+	{
+		return inputMode_ == InputMode::RawPixels ? rawInputMat_ : inputMat_;
+	}
+
+	/**
+	 * @brief Registers an additional reader of the masks, independent of getMask.
+	 *
+	 * @throw std::runtime_error If the mask buffer has no reader left.
+	 */
+	MaskBuffer::Reader makeMaskReader() { return maskBuffer_.makeReader(); }
+
+	/**
+	 * @brief Returns the usage of the allocator that backs the network's blobs and workspace.
+	 */
+	NcnnPoolAllocator::Stats getAllocatorStats() const { return poolAllocator_.getStats(); }
 
 private:
 	constexpr static std::size_t kWidth = 256;
@@ -101,10 +159,13 @@ private:
 
 	MaskBuffer maskBuffer_;
 
-	std::vector<unsigned char, Memory::AlignedAllocator<unsigned char>> binBuffer_{
-		0, Memory::AlignedAllocator<unsigned char>(kAlignment)};
-	ncnn::Net selfieSegmenterNet_;
+	const std::shared_ptr<const ncnn::Net> selfieSegmenterNet_;
+	const int numThreads_;
+	const InputMode inputMode_;
+	// Declared before the mats because outputMat_ keeps referencing a blob from the last inference
+	NcnnPoolAllocator poolAllocator_;
 	ncnn::Mat inputMat_;
+	ncnn::Mat rawInputMat_;
 	ncnn::Mat outputMat_;
 };
 
@@ -22,6 +22,8 @@ public:
 	void process(const std::uint8_t *) override {}
 
 	const std::uint8_t *getMask() const override { return maskBuffer_.read(); }
+	std::uint64_t getPublishedMaskGeneration() const noexcept override { return maskBuffer_.getGeneration(); }
+	std::uint64_t getMaskGeneration() const noexcept override { return maskBuffer_.getReadGeneration(); }
 
 	NullSelfieSegmenter(const NullSelfieSegmenter &) = delete;
 	NullSelfieSegmenter &operator=(const NullSelfieSegmenter &) = delete;
@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "RoiTracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "BoundingBox.hpp"
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+namespace {
+
+// Mask values above this are treated as the subject
+constexpr std::uint8_t kSubjectThreshold = 127;
+
+} // anonymous namespace
+
+SegmenterOutputPlacement getSegmenterOutputPlacement(const SegmenterInputTransform &transform,
+						     std::uint32_t inputWidth, std::uint32_t inputHeight,
+						     double maskScaleX, double maskScaleY) noexcept
+{
+	return {static_cast<std::uint32_t>(std::round(inputWidth * maskScaleX / transform.scale)),
+		static_cast<std::uint32_t>(std::round(inputHeight * maskScaleY / transform.scale)),
+		static_cast<float>(-transform.x * maskScaleX / transform.scale),
+		static_cast<float>(-transform.y * maskScaleY / transform.scale)};
+}
+
+RoiTracker::RoiTracker(double frameWidth, double frameHeight, double aspectRatio, Config config)
+	: frameWidth_(frameWidth > 0.0 ? frameWidth
+				       : throw std::invalid_argument("InvalidFrameWidthError(RoiTracker::RoiTracker)")),
+	  frameHeight_(frameHeight > 0.0
+			       ? frameHeight
+			       : throw std::invalid_argument("InvalidFrameHeightError(RoiTracker::RoiTracker)")),
+	  aspectRatio_(aspectRatio > 0.0
+			       ? aspectRatio
+			       : throw std::invalid_argument("InvalidAspectRatioError(RoiTracker::RoiTracker)")),
+	  config_(config),
+	  roi_{0.0, 0.0, frameWidth_, frameHeight_}
+{
+}
+
+RoiTracker::RoiTracker(double frameWidth, double frameHeight, double aspectRatio)
+	: RoiTracker(frameWidth, frameHeight, aspectRatio, Config{})
+{
+}
+
+const RoiRect &RoiTracker::update(const std::optional<RoiRect> &detectedBox, bool touchesCropEdge) noexcept
+{
+	if (!detectedBox) {
+		if (++missedUpdates_ > config_.maxMissedUpdates) {
+			reset();
+		}
+		return roi_;
+	}
+
+	missedUpdates_ = 0;
+
+	// The subject probably continues past the crop, so give it room to show up in the next mask
+	const double padding = touchesCropEdge ? config_.padding * 2.0 : config_.padding;
+	const double padX = detectedBox->width * padding;
+	const double padY = detectedBox->height * padding;
+	const RoiRect target = fitToFrame({detectedBox->x - padX, detectedBox->y - padY,
+					   detectedBox->width + 2.0 * padX, detectedBox->height + 2.0 * padY});
+
+	const double s = config_.shrinkSmoothing;
+	const double left = target.x < roi_.x ? target.x : roi_.x + (target.x - roi_.x) * s;
+	const double top = target.y < roi_.y ? target.y : roi_.y + (target.y - roi_.y) * s;
+	const double right = target.right() > roi_.right() ? target.right()
+							   : roi_.right() + (target.right() - roi_.right()) * s;
+	const double bottom = target.bottom() > roi_.bottom() ? target.bottom()
+							      : roi_.bottom() + (target.bottom() - roi_.bottom()) * s;
+
+	roi_ = fitToFrame({left, top, right - left, bottom - top});
+	return roi_;
+}
+
+const RoiRect &RoiTracker::updateFromMask(const std::uint8_t *mask, const SegmenterInputTransform &transform,
+					  std::uint32_t inputWidth, std::uint32_t inputHeight)
+{
+	BoundingBox boundingBox;
+	if (!boundingBox.calculateBoundingBoxFrom256x144(mask, kSubjectThreshold)) {
+		return update(std::nullopt);
+	}
+
+	const RoiRect detectedBox{
+		(boundingBox.x - transform.x) / transform.scale,
+		(boundingBox.y - transform.y) / transform.scale,
+		boundingBox.width / transform.scale,
+		boundingBox.height / transform.scale,
+	};
+
+	// The part of the segmenter input actually covered by the frame
+	const double visibleLeft = std::max(0.0, static_cast<double>(transform.x));
+	const double visibleTop = std::max(0.0, static_cast<double>(transform.y));
+	const double visibleRight =
+		std::min(static_cast<double>(inputWidth), static_cast<double>(transform.x) + transform.width);
+	const double visibleBottom =
+		std::min(static_cast<double>(inputHeight), static_cast<double>(transform.y) + transform.height);
+
+	const bool touchesCropEdge = boundingBox.x <= visibleLeft + 1.0 || boundingBox.y <= visibleTop + 1.0 ||
+				     boundingBox.x + boundingBox.width >= visibleRight - 1.0 ||
+				     boundingBox.y + boundingBox.height >= visibleBottom - 1.0;
+
+	return update(detectedBox, touchesCropEdge);
+}
+
+SegmenterInputTransform RoiTracker::getInputTransform(std::uint32_t inputWidth,
+						      std::uint32_t inputHeight) const noexcept
+{
+	const double targetW = static_cast<double>(inputWidth);
+	const double targetH = static_cast<double>(inputHeight);
+
+	const double scale = std::min(targetW / roi_.width, targetH / roi_.height);
+
+	const auto width = static_cast<std::uint32_t>(std::round(frameWidth_ * scale));
+	const auto height = static_cast<std::uint32_t>(std::round(frameHeight_ * scale));
+
+	const double roiCenterX = roi_.x + roi_.width / 2.0;
+	const double roiCenterY = roi_.y + roi_.height / 2.0;
+
+	const auto x = static_cast<float>((targetW / 2.0) - (roiCenterX * scale));
+	const auto y = static_cast<float>((targetH / 2.0) - (roiCenterY * scale));
+
+	return {scale, width, height, x, y};
+}
+
+void RoiTracker::reset() noexcept
+{
+	roi_ = {0.0, 0.0, frameWidth_, frameHeight_};
+	missedUpdates_ = 0;
+}
+
+bool RoiTracker::isFullFrame() const noexcept
+{
+	return roi_.x <= 0.0 && roi_.y <= 0.0 && roi_.width >= frameWidth_ && roi_.height >= frameHeight_;
+}
+
+RoiRect RoiTracker::fitToFrame(RoiRect rect) const noexcept
+{
+	const double centerX = rect.x + rect.width / 2.0;
+	const double centerY = rect.y + rect.height / 2.0;
+
+	double width = std::max(rect.width, frameWidth_ * config_.minSizeRatio);
+	double height = std::max(rect.height, frameHeight_ * config_.minSizeRatio);
+
+	// Only ever grow to the segmenter's aspect ratio so the subject is never cut
+	if (width < height * aspectRatio_) {
+		width = height * aspectRatio_;
+	} else {
+		height = width / aspectRatio_;
+	}
+
+	width = std::min(width, frameWidth_);
+	height = std::min(height, frameHeight_);
+
+	const double x = std::clamp(centerX - width / 2.0, 0.0, frameWidth_ - width);
+	const double y = std::clamp(centerY - height / 2.0, 0.0, frameHeight_ - height);
+
+	return {x, y, width, height};
+}
+
+} // namespace KaitoTokyo::SelfieSegmenter
@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+/**
+ * @brief An axis-aligned rectangle in frame coordinates.
+ */
+struct RoiRect {
+	double x;
+	double y;
+	double width;
+	double height;
+
+	double right() const noexcept { return x + width; }
+	double bottom() const noexcept { return y + height; }
+};
+
+/**
+ * @brief Placement of the frame inside the segmenter input.
+ *
+ * A frame pixel X maps to the segmenter input pixel X * scale + x.
+ */
+struct SegmenterInputTransform {
+	double scale;
+	std::uint32_t width;
+	std::uint32_t height;
+	float x;
+	float y;
+};
+
+/**
+ * @brief Placement of the segmenter output inside a mask that covers the frame.
+ *
+ * Drawing the whole segmenter output at (x, y) with this size undoes a SegmenterInputTransform.
+ */
+struct SegmenterOutputPlacement {
+	std::uint32_t width;
+	std::uint32_t height;
+	float x;
+	float y;
+};
+
+/**
+ * @brief Returns where the segmenter output goes in a mask of the frame.
+ *
+ * @param transform The placement the segmenter input was drawn with.
+ * @param inputWidth The width of the segmenter input and output.
+ * @param inputHeight The height of the segmenter input and output.
+ * @param maskScaleX The mask width divided by the frame width.
+ * @param maskScaleY The mask height divided by the frame height.
+ */
+SegmenterOutputPlacement getSegmenterOutputPlacement(const SegmenterInputTransform &transform,
+						     std::uint32_t inputWidth, std::uint32_t inputHeight,
+						     double maskScaleX, double maskScaleY) noexcept;
+
+/**
+ * @brief Closed-loop region-of-interest tracker for the segmenter input crop.
+ *
+ * The tracker is fed the bounding box of the person detected in each new mask, already
+ * mapped back to frame coordinates. It pads the box, widens it to the segmenter's aspect
+ * ratio and follows it: edges that must move outward to keep the subject in view jump
+ * immediately, while edges that move inward are eased in so the crop does not jitter.
+ * After too many masks without a subject the tracker falls back to the full frame.
+ */
+class RoiTracker {
+public:
+	struct Config {
+		/// Fraction of the remaining distance an inward-moving edge covers per update.
+		double shrinkSmoothing = 0.2;
+		/// Padding added on each side, relative to the detected box size.
+		double padding = 0.25;
+		/// The smallest crop relative to the frame size, to bound the zoom factor.
+		double minSizeRatio = 0.3;
+		/// The number of consecutive updates without a subject before falling back to the full frame.
+		std::uint32_t maxMissedUpdates = 10;
+	};
+
+	/**
+	 * @param frameWidth The width of the frame being cropped.
+	 * @param frameHeight The height of the frame being cropped.
+	 * @param aspectRatio The width-to-height ratio of the segmenter input.
+	 * @param config The tracking parameters.
+	 */
+	RoiTracker(double frameWidth, double frameHeight, double aspectRatio, Config config);
+	RoiTracker(double frameWidth, double frameHeight, double aspectRatio);
+
+	/**
+	 * @brief Advances the tracker with the result of one mask.
+	 *
+	 * @param detectedBox The bounding box of the subject in frame coordinates, or std::nullopt if none was found.
+	 * @param touchesCropEdge Whether the subject reached the edge of the previous crop, in which case it is
+	 * likely to extend beyond it.
+	 * @return The region to crop for the next segmenter input.
+	 */
+	const RoiRect &update(const std::optional<RoiRect> &detectedBox, bool touchesCropEdge = false) noexcept;
+
+	/**
+	 * @brief Advances the tracker with a mask of the segmenter input.
+	 *
+	 * Finds the subject in @p mask, maps it back to frame coordinates and checks whether it reached the part of
+	 * the input that the frame covers.
+	 *
+	 * @param mask A 256x144 mask laid out like the segmenter input.
+	 * @param transform The placement the segmenter input of @p mask was drawn with.
+	 * @return The region to crop for the next segmenter input.
+	 */
+	const RoiRect &updateFromMask(const std::uint8_t *mask, const SegmenterInputTransform &transform,
+				      std::uint32_t inputWidth, std::uint32_t inputHeight);
+
+	/**
+	 * @brief Returns the placement that scales the current region to fit the segmenter input and centers it.
+	 */
+	SegmenterInputTransform getInputTransform(std::uint32_t inputWidth, std::uint32_t inputHeight) const noexcept;
+
+	/**
+	 * @brief Resets the tracker to the full frame.
+	 */
+	void reset() noexcept;
+
+	const RoiRect &getRoi() const noexcept { return roi_; }
+
+	bool isFullFrame() const noexcept;
+
+private:
+	RoiRect fitToFrame(RoiRect rect) const noexcept;
+
+	const double frameWidth_;
+	const double frameHeight_;
+	const double aspectRatio_;
+	const Config config_;
+
+	RoiRect roi_;
+	std::uint32_t missedUpdates_ = 0;
+};
+
+} // namespace KaitoTokyo::SelfieSegmenter
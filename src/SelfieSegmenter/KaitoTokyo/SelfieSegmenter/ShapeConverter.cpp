@@ -3,16 +3,17 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "ShapeConverter.hpp"
+#include "ShapeConverterKernels.hpp"
+#include "SimdDispatch.hpp"
 
 #include <cassert>
 #include <cstring>
 
 #if defined(_M_X64) || defined(__x86_64__)
-#define SELFIE_SEGMENTER_CHECK_AVX2
+#define SELFIE_SEGMENTER_HAVE_X86_64
 #if defined(_MSC_VER)
 #include <intrin.h>
 #else
-#include <cpuid.h>
 #include <x86intrin.h>
 #endif // defined(_MSC_VER)
 #endif // defined(_M_X64) || defined(__x86_64__)
@@ -26,7 +27,7 @@
 
 namespace KaitoTokyo::SelfieSegmenter {
 
-namespace {
+namespace ShapeConverterKernels {
 
 /**
  * @brief Naive C++ implementation for BGRA (uint8_t) to planar float (CHW) conversion.
@@ -36,13 +37,16 @@ namespace {
  * @param bgraData Pointer to the input BGRA data (uint8_t).
  * @param pixelCount Total number of pixels to process.
  */
-inline void copy_r8_bgra_to_float_chw_naive(float *rChannel, float *gChannel, float *bChannel,
+void copy_r8_bgra_to_float_chw_naive(float *rChannel, float *gChannel, float *bChannel,
 					    const std::uint8_t *bgraData, const std::size_t pixelCount)
 {
+	// Multiplying by the reciprocal, as every SIMD variant does, keeps all variants bit-exact with this one
+	constexpr float norm_factor = 1.0f / 255.0f;
+
 	for (std::size_t i = 0; i < pixelCount; i++) {
-		bChannel[i] = (static_cast<float>(bgraData[i * 4 + 0])) / 255.0f;
-		gChannel[i] = (static_cast<float>(bgraData[i * 4 + 1])) / 255.0f;
-		rChannel[i] = (static_cast<float>(bgraData[i * 4 + 2])) / 255.0f;
+		bChannel[i] = static_cast<float>(bgraData[i * 4 + 0]) * norm_factor;
+		gChannel[i] = static_cast<float>(bgraData[i * 4 + 1]) * norm_factor;
+		rChannel[i] = static_cast<float>(bgraData[i * 4 + 2]) * norm_factor;
 	}
 }
 
@@ -53,7 +57,7 @@ inline void copy_r8_bgra_to_float_chw_naive(float *rChannel, float *gChannel, fl
  * @param pixelCount Total number of pixels to process.
  * @note Input values must be in [0, 1]. Behavior for out-of-range values is undefined.
  */
-inline void copy_float32_to_r8_naive(std::uint8_t *dst, const float *src, std::size_t pixelCount)
+void copy_float32_to_r8_naive(std::uint8_t *dst, const float *src, std::size_t pixelCount)
 {
 	for (std::size_t i = 0; i < pixelCount; i++) {
 		dst[i] = static_cast<std::uint8_t>(src[i] * 255.f);
@@ -70,7 +74,7 @@ inline void copy_float32_to_r8_naive(std::uint8_t *dst, const float *src, std::s
  * @param bgraData Pointer to the input BGRA data (uint8_t).
  * @param pixelCount Total number of pixels to process.
  */
-inline void copy_r8_bgra_to_float_chw_neon(float *rChannel, float *gChannel, float *bChannel,
+void copy_r8_bgra_to_float_chw_neon(float *rChannel, float *gChannel, float *bChannel,
 					   const std::uint8_t *bgraData, const std::size_t pixelCount)
 {
 	// Process 16 pixels at a time to maximize ILP
@@ -150,7 +154,7 @@ inline void copy_r8_bgra_to_float_chw_neon(float *rChannel, float *gChannel, flo
  * @param pixelCount Total number of pixels to process.
  * @note Input values must be in [0, 1]. Behavior for out-of-range values is undefined.
  */
-inline void copy_float32_to_r8_neon(std::uint8_t *dst, const float *src, std::size_t pixelCount)
+void copy_float32_to_r8_neon(std::uint8_t *dst, const float *src, std::size_t pixelCount)
 {
 	constexpr std::size_t FLOATS_PER_LOOP = 32;
 
@@ -244,43 +248,7 @@ inline void copy_float32_to_r8_neon(std::uint8_t *dst, const float *src, std::si
 
 #endif // SELFIE_SEGMENTER_HAVE_NEON
 
-#ifdef SELFIE_SEGMENTER_CHECK_AVX2
-
-/**
- * @brief Checks if the CPU supports AVX2 instructions and if the OS has enabled them.
- * @return true if AVX2 is available, false otherwise.
- */
-#if !defined(_MSC_VER)
-__attribute__((target("xsave")))
-#endif
-inline bool
-check_if_avx2_available()
-{
-	int cpuInfo[4];
-	auto cpuid = [&](int leaf, int subleaf = 0) {
-#if defined(_MSC_VER)
-		__cpuidex(cpuInfo, leaf, subleaf);
-#else
-		__cpuid_count(leaf, subleaf, cpuInfo[0], cpuInfo[1], cpuInfo[2], cpuInfo[3]);
-#endif
-	};
-
-	// 1. Check for AVX support
-	cpuid(1);
-	bool avx = (cpuInfo[2] & (1 << 28)) != 0;
-	bool osxsave = (cpuInfo[2] & (1 << 27)) != 0;
-	if (!avx || !osxsave)
-		return false;
-
-	// 2. Check if OS saves YMM registers
-	unsigned long long xcr_val = _xgetbv(0);
-	if ((xcr_val & 0x6) != 0x6) // Check for SSE (bit 1) and AVX (bit 2) state
-		return false;
-
-	// 3. Check for AVX2 support
-	cpuid(7, 0);
-	return (cpuInfo[1] & (1 << 5)) != 0; // Check EBX[5] for AVX2
-}
+#ifdef SELFIE_SEGMENTER_HAVE_X86_64
 
 /**
  * @brief AVX2 optimized implementation for BGRA (uint8_t) to planar float (CHW) conversion.
@@ -294,7 +262,7 @@ check_if_avx2_available()
 #if !defined(_MSC_VER)
 __attribute__((target("avx,avx2")))
 #endif
-inline void
+void
 copy_r8_bgra_to_float_chw_avx2(float *rChannel, float *gChannel, float *bChannel, const std::uint8_t *bgraData,
 			       const std::size_t pixelCount)
 {
@@ -365,7 +333,7 @@ copy_r8_bgra_to_float_chw_avx2(float *rChannel, float *gChannel, float *bChannel
 #if !defined(_MSC_VER)
 __attribute__((target("avx,avx2")))
 #endif
-inline void
+void
 copy_r8_bgra_to_float_chw_avx2_unaligned(float *rChannel, float *gChannel, float *bChannel,
 					 const std::uint8_t *bgraData, const std::size_t pixelCount)
 {
@@ -429,7 +397,7 @@ copy_r8_bgra_to_float_chw_avx2_unaligned(float *rChannel, float *gChannel, float
 #if !defined(_MSC_VER)
 __attribute__((target("avx,avx2")))
 #endif
-inline void
+void
 convert_float_to_uint8_avx2(std::uint8_t *dst, const float *src, std::size_t pixelCount)
 {
 	// --- 0. Pre-condition checks (32-byte alignment) ---
@@ -494,7 +462,7 @@ convert_float_to_uint8_avx2(std::uint8_t *dst, const float *src, std::size_t pix
 #if !defined(_MSC_VER)
 __attribute__((target("avx,avx2")))
 #endif
-inline void
+void
 convert_float_to_uint8_avx2_unaligned(std::uint8_t *dst, const float *src, std::size_t pixelCount)
 {
 	// --- 0. (No pre-condition checks for alignment) ---
@@ -546,25 +514,189 @@ convert_float_to_uint8_avx2_unaligned(std::uint8_t *dst, const float *src, std::
 }
 
 /**
- * @brief Checks if a pointer is aligned to the specified boundary.
- * @param ptr The pointer to check.
- * @param alignment The alignment boundary (default is 32 bytes).
- * @return true if the pointer is aligned, false otherwise.
+ * @brief SSE4.1 optimized implementation for BGRA (uint8_t) to planar float (CHW) conversion.
+ * @param rChannel Pointer to the R channel output (float).
+ * @param gChannel Pointer to the G channel output (float).
+ * @param bChannel Pointer to the B channel output (float).
+ * @param bgraData Pointer to the input BGRA data (uint8_t).
+ * @param pixelCount Total number of pixels to process.
  */
-inline bool check_ptr_aligned(const void *ptr, std::size_t alignment = 32)
+#if !defined(_MSC_VER)
+__attribute__((target("sse4.1")))
+#endif
+void
+copy_r8_bgra_to_float_chw_sse41(float *rChannel, float *gChannel, float *bChannel, const std::uint8_t *bgraData,
+				const std::size_t pixelCount)
 {
-	return (reinterpret_cast<std::uintptr_t>(ptr) % alignment) == 0;
+	constexpr std::size_t PIXELS_PER_LOOP = 4;
+
+	const std::size_t sse_limit = (pixelCount / PIXELS_PER_LOOP) * PIXELS_PER_LOOP;
+
+	constexpr float norm_factor = 1.0f / 255.0f;
+	const __m128 v_inv_255 = _mm_set1_ps(norm_factor);
+	const __m128i mask_u8 = _mm_set1_epi32(0x000000FF);
+
+	std::size_t i = 0;
+	for (; i < sse_limit; i += PIXELS_PER_LOOP) {
+		// Load 4 pixels (16 bytes) and separate the channels
+		__m128i bgra_u32 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bgraData + i * 4));
+
+		__m128i b_u32 = _mm_and_si128(bgra_u32, mask_u8);
+		__m128i g_u32 = _mm_and_si128(_mm_srli_epi32(bgra_u32, 8), mask_u8);
+		__m128i r_u32 = _mm_and_si128(_mm_srli_epi32(bgra_u32, 16), mask_u8);
+
+		_mm_storeu_ps(bChannel + i, _mm_mul_ps(_mm_cvtepi32_ps(b_u32), v_inv_255));
+		_mm_storeu_ps(gChannel + i, _mm_mul_ps(_mm_cvtepi32_ps(g_u32), v_inv_255));
+		_mm_storeu_ps(rChannel + i, _mm_mul_ps(_mm_cvtepi32_ps(r_u32), v_inv_255));
+	}
+
+	for (; i < pixelCount; ++i) {
+		const std::uint8_t *pixelPtr = bgraData + i * 4;
+		bChannel[i] = static_cast<float>(pixelPtr[0]) * norm_factor;
+		gChannel[i] = static_cast<float>(pixelPtr[1]) * norm_factor;
+		rChannel[i] = static_cast<float>(pixelPtr[2]) * norm_factor;
+	}
 }
 
-#endif // SELFIE_SEGMENTER_CHECK_AVX2
+/**
+ * @brief SSE4.1 optimized implementation for float (0.0f-1.0f) to uint8_t (0-255) conversion.
+ * @param dst Pointer to the output uint8_t buffer.
+ * @param src Pointer to the input float buffer.
+ * @param pixelCount Total number of pixels to process.
+ * @note Input values must be in [0, 1]. Behavior for out-of-range values is undefined.
+ */
+#if !defined(_MSC_VER)
+__attribute__((target("sse4.1")))
+#endif
+void
+copy_float32_to_r8_sse41(std::uint8_t *dst, const float *src, std::size_t pixelCount)
+{
+	constexpr std::size_t FLOATS_PER_LOOP = 16;
+
+	const __m128 v_255 = _mm_set1_ps(255.0f);
 
-} // namespace
+	std::size_t i = 0;
+
+	const std::size_t sse_limit = (pixelCount / FLOATS_PER_LOOP) * FLOATS_PER_LOOP;
+	for (; i < sse_limit; i += FLOATS_PER_LOOP) {
+		__m128i v0 = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 0), v_255));
+		__m128i v1 = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 4), v_255));
+		__m128i v2 = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 8), v_255));
+		__m128i v3 = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 12), v_255));
+
+		// Pack (int32 -> uint16 -> uint8); unlike the AVX2 packs, these do not interleave lanes
+		__m128i v01_16 = _mm_packus_epi32(v0, v1);
+		__m128i v23_16 = _mm_packus_epi32(v2, v3);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(v01_16, v23_16));
+	}
+
+	for (; i < pixelCount; ++i) {
+		dst[i] = static_cast<std::uint8_t>(src[i] * 255.f);
+	}
+}
+
+// GCC 12 reports its own AVX-512 intrinsic headers as reading an uninitialized pass-through operand
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+/**
+ * @brief AVX-512BW optimized implementation for BGRA (uint8_t) to planar float (CHW) conversion.
+ * @param rChannel Pointer to the R channel output (float).
+ * @param gChannel Pointer to the G channel output (float).
+ * @param bChannel Pointer to the B channel output (float).
+ * @param bgraData Pointer to the input BGRA data (uint8_t).
+ * @param pixelCount Total number of pixels to process.
+ */
+#if !defined(_MSC_VER)
+__attribute__((target("avx512f,avx512bw")))
+#endif
+void
+copy_r8_bgra_to_float_chw_avx512bw(float *rChannel, float *gChannel, float *bChannel, const std::uint8_t *bgraData,
+				   const std::size_t pixelCount)
+{
+	constexpr std::size_t PIXELS_PER_LOOP = 16;
+
+	const std::size_t avx_limit = (pixelCount / PIXELS_PER_LOOP) * PIXELS_PER_LOOP;
+
+	constexpr float norm_factor = 1.0f / 255.0f;
+	const __m512 v_inv_255 = _mm512_set1_ps(norm_factor);
+	const __m512i mask_u8 = _mm512_set1_epi32(0x000000FF);
+
+	std::size_t i = 0;
+	for (; i < avx_limit; i += PIXELS_PER_LOOP) {
+		// Load 16 pixels (64 bytes) and separate the channels
+		__m512i bgra_u32 = _mm512_loadu_si512(bgraData + i * 4);
+
+		__m512i b_u32 = _mm512_and_si512(bgra_u32, mask_u8);
+		__m512i g_u32 = _mm512_and_si512(_mm512_srli_epi32(bgra_u32, 8), mask_u8);
+		__m512i r_u32 = _mm512_and_si512(_mm512_srli_epi32(bgra_u32, 16), mask_u8);
+
+		_mm512_storeu_ps(bChannel + i, _mm512_mul_ps(_mm512_cvtepi32_ps(b_u32), v_inv_255));
+		_mm512_storeu_ps(gChannel + i, _mm512_mul_ps(_mm512_cvtepi32_ps(g_u32), v_inv_255));
+		_mm512_storeu_ps(rChannel + i, _mm512_mul_ps(_mm512_cvtepi32_ps(r_u32), v_inv_255));
+	}
+
+	for (; i < pixelCount; ++i) {
+		const std::uint8_t *pixelPtr = bgraData + i * 4;
+		bChannel[i] = static_cast<float>(pixelPtr[0]) * norm_factor;
+		gChannel[i] = static_cast<float>(pixelPtr[1]) * norm_factor;
+		rChannel[i] = static_cast<float>(pixelPtr[2]) * norm_factor;
+	}
+}
+
+/**
+ * @brief AVX-512BW optimized implementation for float (0.0f-1.0f) to uint8_t (0-255) conversion.
+ * @param dst Pointer to the output uint8_t buffer.
+ * @param src Pointer to the input float buffer.
+ * @param pixelCount Total number of pixels to process.
+ * @note Input values must be in [0, 1]. Behavior for out-of-range values is undefined.
+ */
+#if !defined(_MSC_VER)
+__attribute__((target("avx512f,avx512bw")))
+#endif
+void
+copy_float32_to_r8_avx512bw(std::uint8_t *dst, const float *src, std::size_t pixelCount)
+{
+	constexpr std::size_t FLOATS_PER_LOOP = 64;
+
+	const __m512 v_255 = _mm512_set1_ps(255.0f);
+
+	std::size_t i = 0;
+
+	const std::size_t avx_limit = (pixelCount / FLOATS_PER_LOOP) * FLOATS_PER_LOOP;
+	for (; i < avx_limit; i += FLOATS_PER_LOOP) {
+		__m512i v0 = _mm512_cvttps_epi32(_mm512_mul_ps(_mm512_loadu_ps(src + i + 0), v_255));
+		__m512i v1 = _mm512_cvttps_epi32(_mm512_mul_ps(_mm512_loadu_ps(src + i + 16), v_255));
+		__m512i v2 = _mm512_cvttps_epi32(_mm512_mul_ps(_mm512_loadu_ps(src + i + 32), v_255));
+		__m512i v3 = _mm512_cvttps_epi32(_mm512_mul_ps(_mm512_loadu_ps(src + i + 48), v_255));
+
+		// Narrow (int32 -> uint8) with unsigned saturation, keeping the element order
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 0), _mm512_cvtusepi32_epi8(v0));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 16), _mm512_cvtusepi32_epi8(v1));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 32), _mm512_cvtusepi32_epi8(v2));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 48), _mm512_cvtusepi32_epi8(v3));
+	}
+
+	for (; i < pixelCount; ++i) {
+		dst[i] = static_cast<std::uint8_t>(src[i] * 255.f);
+	}
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // SELFIE_SEGMENTER_HAVE_X86_64
+
+} // namespace ShapeConverterKernels
 
 /**
  * @brief Converts BGRA (uint8_t) image data to planar float (CHW) format.
  *
- * This function dispatches to the best available implementation (AVX2, NEON, or naive)
- * at runtime.
+ * This function calls the variant selected once for the running CPU by getSimdKernels().
  *
  * @param rChannel Pointer to the R channel output (float).
  * @param gChannel Pointer to the G channel output (float).
@@ -575,31 +707,13 @@ inline bool check_ptr_aligned(const void *ptr, std::size_t alignment = 32)
 void copy_r8_bgra_to_float_chw(float *rChannel, float *gChannel, float *bChannel, const std::uint8_t *bgraData,
 			       const std::size_t pixelCount)
 {
-#if defined(SELFIE_SEGMENTER_HAVE_NEON)
-	copy_r8_bgra_to_float_chw_neon(rChannel, gChannel, bChannel, bgraData, pixelCount);
-#elif defined(SELFIE_SEGMENTER_CHECK_AVX2)
-	const static bool is_avx2_available = check_if_avx2_available();
-	if (is_avx2_available) {
-		// Check if all pointers are 32-byte aligned
-		if (check_ptr_aligned(rChannel) && check_ptr_aligned(gChannel) && check_ptr_aligned(bChannel) &&
-		    check_ptr_aligned(bgraData)) {
-			copy_r8_bgra_to_float_chw_avx2(rChannel, gChannel, bChannel, bgraData, pixelCount);
-		} else {
-			copy_r8_bgra_to_float_chw_avx2_unaligned(rChannel, gChannel, bChannel, bgraData, pixelCount);
-		}
-	} else {
-		copy_r8_bgra_to_float_chw_naive(rChannel, gChannel, bChannel, bgraData, pixelCount);
-	}
-#else
-	copy_r8_bgra_to_float_chw_naive(rChannel, gChannel, bChannel, bgraData, pixelCount);
-#endif
+	getSimdKernels().copyR8BgraToFloatChw(rChannel, gChannel, bChannel, bgraData, pixelCount);
 }
 
 /**
  * @brief Converts a float (0.0f-1.0f) array to a uint8_t (0-255) array.
  *
- * This function dispatches to the best available implementation (AVX2, NEON, or naive)
- * at runtime.
+ * This function calls the variant selected once for the running CPU by getSimdKernels().
  *
  * @param dst Pointer to the output uint8_t buffer.
  * @param src Pointer to the input float buffer.
@@ -608,24 +722,8 @@ void copy_r8_bgra_to_float_chw(float *rChannel, float *gChannel, float *bChannel
  */
 void copy_float32_to_r8(std::uint8_t *dst, const float *src, std::size_t pixelCount)
 {
-#if defined(SELFIE_SEGMENTER_HAVE_NEON)
-	// NEON (arm64) intrinsics used (vld1q_f32, vst1q_u8) support unaligned access.
-	copy_float32_to_r8_neon(dst, src, pixelCount);
-#elif defined(SELFIE_SEGMENTER_CHECK_AVX2)
-	const static bool is_avx2_available = check_if_avx2_available();
-	if (is_avx2_available) {
-		// Check if both pointers are 32-byte aligned
-		if (check_ptr_aligned(dst) && check_ptr_aligned(src)) {
-			convert_float_to_uint8_avx2(dst, src, pixelCount);
-		} else {
-			convert_float_to_uint8_avx2_unaligned(dst, src, pixelCount);
-		}
-	} else {
-		copy_float32_to_r8_naive(dst, src, pixelCount);
-	}
-#else
-	copy_float32_to_r8_naive(dst, src, pixelCount);
-#endif
+	getSimdKernels().copyFloat32ToR8(dst, src, pixelCount);
 }
 
 } // namespace KaitoTokyo::SelfieSegmenter
+
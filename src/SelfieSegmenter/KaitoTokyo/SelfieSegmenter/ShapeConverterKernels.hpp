@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file ShapeConverterKernels.hpp
+ * @brief The individual implementations behind the ShapeConverter dispatchers.
+ *
+ * These are exposed so that each variant can be benchmarked and tested on its own. Production code should call
+ * the dispatchers in ShapeConverter.hpp, which use the variants that SimdDispatch.hpp selected for the running CPU.
+ * The caller is responsible for only calling a variant that the CPU supports.
+ */
+
+namespace KaitoTokyo::SelfieSegmenter::ShapeConverterKernels {
+
+void copy_r8_bgra_to_float_chw_naive(float *rChannel, float *gChannel, float *bChannel, const std::uint8_t *bgraData,
+				     const std::size_t pixelCount);
+
+void copy_float32_to_r8_naive(std::uint8_t *dst, const float *src, std::size_t pixelCount);
+
+#if (defined(_M_ARM64) || defined(__aarch64__)) && defined(__ARM_NEON)
+
+void copy_r8_bgra_to_float_chw_neon(float *rChannel, float *gChannel, float *bChannel, const std::uint8_t *bgraData,
+				    const std::size_t pixelCount);
+
+void copy_float32_to_r8_neon(std::uint8_t *dst, const float *src, std::size_t pixelCount);
+
+#endif // (defined(_M_ARM64) || defined(__aarch64__)) && defined(__ARM_NEON)
+
+#if defined(_M_X64) || defined(__x86_64__)
+
+void copy_r8_bgra_to_float_chw_sse41(float *rChannel, float *gChannel, float *bChannel, const std::uint8_t *bgraData,
+				     const std::size_t pixelCount);
+
+void copy_float32_to_r8_sse41(std::uint8_t *dst, const float *src, std::size_t pixelCount);
+
+/// @note All pointers must be 32-byte aligned.
+void copy_r8_bgra_to_float_chw_avx2(float *rChannel, float *gChannel, float *bChannel, const std::uint8_t *bgraData,
+				    const std::size_t pixelCount);
+
+void copy_r8_bgra_to_float_chw_avx2_unaligned(float *rChannel, float *gChannel, float *bChannel,
+					      const std::uint8_t *bgraData, const std::size_t pixelCount);
+
+/// @note All pointers must be 32-byte aligned.
+void convert_float_to_uint8_avx2(std::uint8_t *dst, const float *src, std::size_t pixelCount);
+
+void convert_float_to_uint8_avx2_unaligned(std::uint8_t *dst, const float *src, std::size_t pixelCount);
+
+void copy_r8_bgra_to_float_chw_avx512bw(float *rChannel, float *gChannel, float *bChannel,
+					const std::uint8_t *bgraData, const std::size_t pixelCount);
+
+void copy_float32_to_r8_avx512bw(std::uint8_t *dst, const float *src, std::size_t pixelCount);
+
+#endif // defined(_M_X64) || defined(__x86_64__)
+
+} // namespace KaitoTokyo::SelfieSegmenter::ShapeConverterKernels
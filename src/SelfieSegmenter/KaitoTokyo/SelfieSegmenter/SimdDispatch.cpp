@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "SimdDispatch.hpp"
+
+#include <stdexcept>
+
+#include "BoundingBoxKernels.hpp"
+#include "ShapeConverterKernels.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define SELFIE_SEGMENTER_HAVE_X86_64
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif // defined(_MSC_VER)
+#endif // defined(_M_X64) || defined(__x86_64__)
+
+#if (defined(_M_ARM64) || defined(__aarch64__)) && defined(__ARM_NEON)
+#define SELFIE_SEGMENTER_HAVE_NEON
+#endif // (defined(_M_ARM64) || defined(__aarch64__)) && defined(__ARM_NEON)
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+namespace {
+
+#ifdef SELFIE_SEGMENTER_HAVE_X86_64
+
+struct X86Features {
+	bool sse41;
+	bool avx2;
+	bool avx512bw;
+};
+
+/**
+ * @brief Probes the CPU and checks that the OS saves the register state each extension needs.
+ */
+#if !defined(_MSC_VER)
+__attribute__((target("xsave")))
+#endif
+X86Features
+detectX86Features()
+{
+	int cpuInfo[4];
+	auto cpuid = [&cpuInfo](int leaf, int subleaf = 0) {
+#if defined(_MSC_VER)
+		__cpuidex(cpuInfo, leaf, subleaf);
+#else
+		__cpuid_count(leaf, subleaf, cpuInfo[0], cpuInfo[1], cpuInfo[2], cpuInfo[3]);
+#endif
+	};
+
+	X86Features features{false, false, false};
+
+	// Leaf 1, ECX[19] = SSE4.1, ECX[27] = OSXSAVE, ECX[28] = AVX
+	cpuid(1, 0);
+	features.sse41 = (cpuInfo[2] & (1 << 19)) != 0;
+	const bool osxsave = (cpuInfo[2] & (1 << 27)) != 0;
+	const bool avx = (cpuInfo[2] & (1 << 28)) != 0;
+
+	if (!avx || !osxsave)
+		return features;
+
+	// XCR0 bit 1 = SSE state, bit 2 = AVX state, bits 5-7 = opmask and ZMM state
+	const unsigned long long xcr_val = _xgetbv(0);
+	const bool os_saves_ymm = (xcr_val & 0x6) == 0x6;
+	const bool os_saves_zmm = (xcr_val & 0xE6) == 0xE6;
+
+	// Leaf 7, Subleaf 0, EBX[5] = AVX2, EBX[16] = AVX512F, EBX[30] = AVX512BW
+	cpuid(7, 0);
+	features.avx2 = os_saves_ymm && (cpuInfo[1] & (1 << 5)) != 0;
+	features.avx512bw = os_saves_zmm && (cpuInfo[1] & (1 << 16)) != 0 && (cpuInfo[1] & (1 << 30)) != 0;
+
+	return features;
+}
+
+const X86Features &getX86Features()
+{
+	const static X86Features features = detectX86Features();
+	return features;
+}
+
+inline bool check_ptr_aligned(const void *ptr, std::size_t alignment = 32)
+{
+	return (reinterpret_cast<std::uintptr_t>(ptr) % alignment) == 0;
+}
+
+// The AVX2 tier keeps separate aligned and unaligned variants, so its table entries pick one per call
+void copyR8BgraToFloatChwAVX2(float *rChannel, float *gChannel, float *bChannel, const std::uint8_t *bgraData,
+			      std::size_t pixelCount)
+{
+	if (check_ptr_aligned(rChannel) && check_ptr_aligned(gChannel) && check_ptr_aligned(bChannel) &&
+	    check_ptr_aligned(bgraData)) {
+		ShapeConverterKernels::copy_r8_bgra_to_float_chw_avx2(rChannel, gChannel, bChannel, bgraData,
+								      pixelCount);
+	} else {
+		ShapeConverterKernels::copy_r8_bgra_to_float_chw_avx2_unaligned(rChannel, gChannel, bChannel, bgraData,
+										pixelCount);
+	}
+}
+
+void copyFloat32ToR8AVX2(std::uint8_t *dst, const float *src, std::size_t pixelCount)
+{
+	if (check_ptr_aligned(dst) && check_ptr_aligned(src)) {
+		ShapeConverterKernels::convert_float_to_uint8_avx2(dst, src, pixelCount);
+	} else {
+		ShapeConverterKernels::convert_float_to_uint8_avx2_unaligned(dst, src, pixelCount);
+	}
+}
+
+#endif // SELFIE_SEGMENTER_HAVE_X86_64
+
+constexpr SimdKernels kScalarKernels{
+	SimdTier::Scalar,
+	ShapeConverterKernels::copy_r8_bgra_to_float_chw_naive,
+	ShapeConverterKernels::copy_float32_to_r8_naive,
+	BoundingBoxKernels::calculateBoundingBoxNaive256x144,
+};
+
+#ifdef SELFIE_SEGMENTER_HAVE_X86_64
+
+constexpr SimdKernels kSSE41Kernels{
+	SimdTier::SSE41,
+	ShapeConverterKernels::copy_r8_bgra_to_float_chw_sse41,
+	ShapeConverterKernels::copy_float32_to_r8_sse41,
+	BoundingBoxKernels::calculateBoundingBoxSSE41256x144,
+};
+
+constexpr SimdKernels kAVX2Kernels{
+	SimdTier::AVX2,
+	copyR8BgraToFloatChwAVX2,
+	copyFloat32ToR8AVX2,
+	BoundingBoxKernels::calculateBoundingBoxAVX2256x144,
+};
+
+constexpr SimdKernels kAVX512BWKernels{
+	SimdTier::AVX512BW,
+	ShapeConverterKernels::copy_r8_bgra_to_float_chw_avx512bw,
+	ShapeConverterKernels::copy_float32_to_r8_avx512bw,
+	BoundingBoxKernels::calculateBoundingBoxAVX512BW256x144,
+};
+
+#endif // SELFIE_SEGMENTER_HAVE_X86_64
+
+#ifdef SELFIE_SEGMENTER_HAVE_NEON
+
+constexpr SimdKernels kNEONKernels{
+	SimdTier::NEON,
+	ShapeConverterKernels::copy_r8_bgra_to_float_chw_neon,
+	ShapeConverterKernels::copy_float32_to_r8_neon,
+	BoundingBoxKernels::calculateBoundingBoxNEON256x144,
+};
+
+#endif // SELFIE_SEGMENTER_HAVE_NEON
+
+SimdTier detectBestSimdTier() noexcept
+{
+	for (SimdTier tier : {SimdTier::AVX512BW, SimdTier::AVX2, SimdTier::NEON, SimdTier::SSE41}) {
+		if (isSimdTierSupported(tier)) {
+			return tier;
+		}
+	}
+	return SimdTier::Scalar;
+}
+
+} // anonymous namespace
+
+const char *getSimdTierName(SimdTier tier) noexcept
+{
+	switch (tier) {
+	case SimdTier::Scalar:
+		return "Scalar";
+	case SimdTier::SSE41:
+		return "SSE4.1";
+	case SimdTier::AVX2:
+		return "AVX2";
+	case SimdTier::AVX512BW:
+		return "AVX-512BW";
+	case SimdTier::NEON:
+		return "NEON";
+	}
+	return "Unknown";
+}
+
+bool isSimdTierSupported(SimdTier tier) noexcept
+{
+	switch (tier) {
+	case SimdTier::Scalar:
+		return true;
+#ifdef SELFIE_SEGMENTER_HAVE_X86_64
+	case SimdTier::SSE41:
+		return getX86Features().sse41;
+	case SimdTier::AVX2:
+		return getX86Features().avx2;
+	case SimdTier::AVX512BW:
+		return getX86Features().avx512bw;
+#endif // SELFIE_SEGMENTER_HAVE_X86_64
+#ifdef SELFIE_SEGMENTER_HAVE_NEON
+	case SimdTier::NEON:
+		// NEON is mandatory on arm64
+		return true;
+#endif // SELFIE_SEGMENTER_HAVE_NEON
+	default:
+		return false;
+	}
+}
+
+const SimdKernels &getSimdKernelsForTier(SimdTier tier)
+{
+	if (!isSimdTierSupported(tier)) {
+		throw std::invalid_argument("UnsupportedSimdTierError(getSimdKernelsForTier)");
+	}
+
+	switch (tier) {
+#ifdef SELFIE_SEGMENTER_HAVE_X86_64
+	case SimdTier::SSE41:
+		return kSSE41Kernels;
+	case SimdTier::AVX2:
+		return kAVX2Kernels;
+	case SimdTier::AVX512BW:
+		return kAVX512BWKernels;
+#endif // SELFIE_SEGMENTER_HAVE_X86_64
+#ifdef SELFIE_SEGMENTER_HAVE_NEON
+	case SimdTier::NEON:
+		return kNEONKernels;
+#endif // SELFIE_SEGMENTER_HAVE_NEON
+	default:
+		return kScalarKernels;
+	}
+}
+
+const SimdKernels &getSimdKernels() noexcept
+{
+	const static SimdKernels &kernels = getSimdKernelsForTier(detectBestSimdTier());
+	return kernels;
+}
+
+} // namespace KaitoTokyo::SelfieSegmenter
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+struct BoundingBox;
+
+/**
+ * @brief The instruction set tiers the SIMD kernels are built for.
+ */
+enum class SimdTier {
+	Scalar,
+	SSE41,
+	AVX2,
+	AVX512BW,
+	NEON,
+};
+
+/**
+ * @brief The kernels of one SimdTier.
+ *
+ * Every tier produces output that is bit-exact with the Scalar tier.
+ */
+struct SimdKernels {
+	SimdTier tier;
+	void (*copyR8BgraToFloatChw)(float *rChannel, float *gChannel, float *bChannel, const std::uint8_t *bgraData,
+				     std::size_t pixelCount);
+	void (*copyFloat32ToR8)(std::uint8_t *dst, const float *src, std::size_t pixelCount);
+	bool (*calculateBoundingBox256x144)(BoundingBox *boundingBox, const std::uint8_t *data, std::uint8_t threshold);
+};
+
+/**
+ * @brief Returns a short human-readable name such as "AVX2".
+ */
+const char *getSimdTierName(SimdTier tier) noexcept;
+
+/**
+ * @brief Checks whether this build contains the tier and the running CPU and OS can execute it.
+ */
+bool isSimdTierSupported(SimdTier tier) noexcept;
+
+/**
+ * @brief Returns the kernels of a specific tier, for tests and benchmarks.
+ *
+ * @throws std::invalid_argument if the tier is not supported.
+ */
+const SimdKernels &getSimdKernelsForTier(SimdTier tier);
+
+/**
+ * @brief Returns the kernels of the best supported tier.
+ *
+ * The CPU is probed on the first call only; later calls return the cached table.
+ */
+const SimdKernels &getSimdKernels() noexcept;
+
+} // namespace KaitoTokyo::SelfieSegmenter
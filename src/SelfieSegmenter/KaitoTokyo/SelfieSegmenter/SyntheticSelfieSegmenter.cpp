@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "SyntheticSelfieSegmenter.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+namespace {
+
+SyntheticSelfieSegmenter::Config validateConfig(const SyntheticSelfieSegmenter::Config &config)
+{
+	if (config.latency.count() < 0 || config.jitter.count() < 0) {
+		throw std::invalid_argument("NegativeDurationError(SyntheticSelfieSegmenter::SyntheticSelfieSegmenter)");
+	}
+	if (!(config.failureProbability >= 0.0 && config.failureProbability <= 1.0)) {
+		throw std::invalid_argument(
+			"FailureProbabilityOutOfRangeError(SyntheticSelfieSegmenter::SyntheticSelfieSegmenter)");
+	}
+	return config;
+}
+
+} // anonymous namespace
+
+SyntheticSelfieSegmenter::SyntheticSelfieSegmenter(Config config)
+	: config_(validateConfig(config)),
+	  maskBuffer_(kPixelCount),
+	  randomState_(config_.seed)
+{
+}
+
+SyntheticSelfieSegmenter::SyntheticSelfieSegmenter() : SyntheticSelfieSegmenter(Config{}) {}
+
+void SyntheticSelfieSegmenter::process(const std::uint8_t *)
+{
+	// Both draws happen on every call so that the sequence does not depend on the outcomes
+	const std::uint64_t jitterDraw = nextRandom();
+	const std::uint64_t failureDraw = nextRandom();
+
+	const auto jitterRange = static_cast<std::uint64_t>(config_.jitter.count()) + 1;
+	wait(config_.latency + std::chrono::microseconds(static_cast<std::int64_t>(jitterDraw % jitterRange)));
+
+	// The top 53 bits give a uniform double in [0, 1)
+	const double failureSample = static_cast<double>(failureDraw >> 11) * 0x1.0p-53;
+	if (failureSample < config_.failureProbability) {
+		failedCount_.fetch_add(1, std::memory_order_relaxed);
+		throw std::runtime_error("InjectedFailureError(SyntheticSelfieSegmenter::process)");
+	}
+
+	const std::uint64_t maskIndex = processedCount_.load(std::memory_order_relaxed);
+	maskBuffer_.write([this, maskIndex](std::uint8_t *mask) { drawPattern(mask, maskIndex); });
+	processedCount_.store(maskIndex + 1, std::memory_order_relaxed);
+}
+
+std::uint64_t SyntheticSelfieSegmenter::nextRandom() noexcept
+{
+	// SplitMix64, chosen over the standard distributions because their output differs between libraries
+	std::uint64_t z = (randomState_ += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+void SyntheticSelfieSegmenter::wait(std::chrono::microseconds duration) const
+{
+	if (duration.count() == 0) {
+		return;
+	}
+
+	if (config_.waitMode == WaitMode::Sleep) {
+		std::this_thread::sleep_for(duration);
+		return;
+	}
+
+	const auto deadline = std::chrono::steady_clock::now() + duration;
+	while (std::chrono::steady_clock::now() < deadline) {
+	}
+}
+
+void SyntheticSelfieSegmenter::drawPattern(std::uint8_t *mask, std::uint64_t maskIndex) const noexcept
+{
+	switch (config_.pattern) {
+	case MaskPattern::Empty:
+		std::memset(mask, 0, kPixelCount);
+		return;
+	case MaskPattern::Full:
+		std::memset(mask, 255, kPixelCount);
+		return;
+	case MaskPattern::Checkerboard:
+		for (std::size_t y = 0; y < kHeight; ++y) {
+			for (std::size_t x = 0; x < kWidth; ++x) {
+				mask[y * kWidth + x] = ((x / 16) + (y / 16)) % 2 == 0 ? 255 : 0;
+			}
+		}
+		return;
+	case MaskPattern::Ellipse:
+	case MaskPattern::SweepingEllipse:
+		break;
+	}
+
+	// The ellipse spans half the width and reaches from a head near the top to below the bottom edge
+	constexpr double radiusX = kWidth / 4.0;
+	constexpr double radiusY = kHeight * 0.6;
+	constexpr double centerY = kHeight * 0.75;
+
+	double centerX = kWidth / 2.0;
+	if (config_.pattern == MaskPattern::SweepingEllipse) {
+		// A triangle wave over 128 masks that keeps the ellipse inside the frame
+		constexpr std::uint64_t kPeriod = 128;
+		const std::uint64_t phase = maskIndex % kPeriod;
+		const double position = static_cast<double>(phase < kPeriod / 2 ? phase : kPeriod - phase) /
+					static_cast<double>(kPeriod / 2);
+		centerX = radiusX + position * (kWidth - 2.0 * radiusX);
+	}
+
+	for (std::size_t y = 0; y < kHeight; ++y) {
+		const double dy = (static_cast<double>(y) + 0.5 - centerY) / radiusY;
+		for (std::size_t x = 0; x < kWidth; ++x) {
+			const double dx = (static_cast<double>(x) + 0.5 - centerX) / radiusX;
+			mask[y * kWidth + x] = dx * dx + dy * dy <= 1.0 ? 255 : 0;
+		}
+	}
+}
+
+} // namespace KaitoTokyo::SelfieSegmenter
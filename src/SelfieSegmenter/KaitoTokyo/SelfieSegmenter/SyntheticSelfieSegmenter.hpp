@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "ISelfieSegmenter.hpp"
+#include "MaskBuffer.hpp"
+
+namespace KaitoTokyo::SelfieSegmenter {
+
+/**
+ * @brief A segmenter that produces deterministic masks with a configurable cost, for scaling tests.
+ *
+ * The input is ignored. Each call to process spends the configured latency plus a jitter, then either fails
+ * or publishes the next mask of the configured pattern. Jitter and failures are drawn from a generator seeded
+ * by Config::seed, so two segmenters with the same configuration behave identically call by call.
+ */
+class SyntheticSelfieSegmenter final : public ISelfieSegmenter {
+public:
+	enum class MaskPattern {
+		/// Every pixel is background.
+		Empty,
+		/// Every pixel is foreground.
+		Full,
+		/// A centered upright ellipse, roughly where a seated person would be.
+		Ellipse,
+		/// The same ellipse sweeping from side to side, one step per mask, so that trackers see motion.
+		SweepingEllipse,
+		/// A 16-pixel checkerboard, the worst case for the edge-aware filters.
+		Checkerboard,
+	};
+
+	enum class WaitMode {
+		/// Sleep through the latency, like an inference that waits for another device.
+		Sleep,
+		/// Spin through the latency, like an inference that keeps a core busy.
+		Spin,
+	};
+
+	struct Config {
+		/// The time every call to process takes at least.
+		std::chrono::microseconds latency{0};
+		/// The upper bound of a uniformly distributed extra time added to each call.
+		std::chrono::microseconds jitter{0};
+		MaskPattern pattern = MaskPattern::Ellipse;
+		WaitMode waitMode = WaitMode::Sleep;
+		/// The probability in [0, 1] that a call throws after spending its latency.
+		double failureProbability = 0.0;
+		std::uint64_t seed = 0;
+	};
+
+	/**
+	 * @throw std::invalid_argument If a duration is negative or failureProbability is outside [0, 1].
+	 */
+	explicit SyntheticSelfieSegmenter(Config config);
+	SyntheticSelfieSegmenter();
+
+	~SyntheticSelfieSegmenter() noexcept override = default;
+
+	std::size_t getWidth() const noexcept override { return kWidth; }
+	std::size_t getHeight() const noexcept override { return kHeight; }
+	std::size_t getPixelCount() const noexcept override { return kPixelCount; }
+
+	/**
+	 * @throw std::runtime_error When a failure is injected. The previous mask stays current.
+	 */
+	void process(const std::uint8_t *bgraData) override;
+
+	const std::uint8_t *getMask() const override { return maskBuffer_.read(); }
+	std::uint64_t getPublishedMaskGeneration() const noexcept override { return maskBuffer_.getGeneration(); }
+	std::uint64_t getMaskGeneration() const noexcept override { return maskBuffer_.getReadGeneration(); }
+
+	/**
+	 * @brief Returns how many calls to process have published a mask.
+	 */
+	std::uint64_t getProcessedCount() const noexcept { return processedCount_.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Returns how many calls to process have thrown an injected failure.
+	 */
+	std::uint64_t getFailedCount() const noexcept { return failedCount_.load(std::memory_order_relaxed); }
+
+	SyntheticSelfieSegmenter(const SyntheticSelfieSegmenter &) = delete;
+	SyntheticSelfieSegmenter &operator=(const SyntheticSelfieSegmenter &) = delete;
+	SyntheticSelfieSegmenter(SyntheticSelfieSegmenter &&) = delete;
+	SyntheticSelfieSegmenter &operator=(SyntheticSelfieSegmenter &&) = delete;
+
+private:
+	constexpr static std::size_t kWidth = 256;
+	constexpr static std::size_t kHeight = 144;
+	constexpr static std::size_t kPixelCount = kWidth * kHeight;
+
+	std::uint64_t nextRandom() noexcept;
+	void wait(std::chrono::microseconds duration) const;
+	void drawPattern(std::uint8_t *mask, std::uint64_t maskIndex) const noexcept;
+
+	const Config config_;
+	MaskBuffer maskBuffer_;
+
+	// Only touched by the thread calling process
+	std::uint64_t randomState_;
+
+	std::atomic<std::uint64_t> processedCount_{0};
+	std::atomic<std::uint64_t> failedCount_{0};
+};
+
+} // namespace KaitoTokyo::SelfieSegmenter
@@ -0,0 +1,346 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "SharedWorkerPool.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace KaitoTokyo::TaskQueue {
+
+namespace {
+
+// Set by the destructor when it runs on one of the pool's own workers, which must then leave without touching it
+thread_local bool isCurrentWorkerOrphaned = false;
+
+} // anonymous namespace
+
+SharedWorkerPool::Queue::Queue(std::shared_ptr<SharedWorkerPool> pool, std::shared_ptr<QueueState> state)
+	: pool_(std::move(pool)),
+	  state_(std::move(state))
+{
+}
+
+SharedWorkerPool::CancellationToken SharedWorkerPool::Queue::push(CancellableTask task, Priority priority)
+{
+	return pushImpl(std::nullopt, std::move(task), priority);
+}
+
+SharedWorkerPool::CancellationToken SharedWorkerPool::Queue::push(std::string key, CancellableTask task,
+								  Priority priority)
+{
+	return pushImpl(std::move(key), std::move(task), priority);
+}
+
+SharedWorkerPool::CancellationToken SharedWorkerPool::Queue::pushImpl(std::optional<std::string> key,
+								      CancellableTask task, Priority priority)
+{
+	auto token = std::make_shared<std::atomic<bool>>(false);
+	QueuedTask queuedTask{key, [task = std::move(task), token] { task(token); }, token,
+			      std::chrono::steady_clock::now()};
+	std::deque<QueuedTask> &target = state_->tasks[static_cast<std::size_t>(priority)];
+	// Cancelled tasks are destroyed after the lock is released, as their captures may take it again
+	std::vector<QueuedTask> cancelledTasks;
+
+	{
+		std::lock_guard<std::mutex> lock(pool_->mutex_);
+		if (pool_->stopped_ || state_->stopped) {
+			throw std::runtime_error("QueueStoppedError(SharedWorkerPool::Queue::push)");
+		}
+
+		++state_->stats.pushedCount;
+
+		if (key) {
+			const auto it = std::find_if(target.begin(), target.end(),
+						     [&key](const QueuedTask &queued) { return queued.key == key; });
+			if (it != target.end()) {
+				// Same class: replace in place and keep the turn
+				it->token->store(true);
+				cancelledTasks.push_back(std::exchange(*it, std::move(queuedTask)));
+				++state_->stats.coalescedCount;
+				return token;
+			}
+
+			for (std::deque<QueuedTask> &tasks : state_->tasks) {
+				const auto it = std::find_if(tasks.begin(), tasks.end(),
+							     [&key](const QueuedTask &queued) { return queued.key == key; });
+				if (it != tasks.end()) {
+					it->token->store(true);
+					cancelledTasks.push_back(std::move(*it));
+					tasks.erase(it);
+					++state_->stats.coalescedCount;
+					break;
+				}
+			}
+		}
+
+		while (queuedTaskCountLocked(*state_) >= state_->maxQueueSize) {
+			const auto victims = std::find_if(state_->tasks.begin(), state_->tasks.end(),
+							  [](const std::deque<QueuedTask> &tasks) { return !tasks.empty(); });
+			++state_->stats.droppedCount;
+			if (victims > state_->tasks.begin() + static_cast<std::ptrdiff_t>(priority)) {
+				// Every queued task outranks the new one, which is refused rather than evicting them
+				token->store(true);
+				return token;
+			}
+			victims->front().token->store(true);
+			cancelledTasks.push_back(std::move(victims->front()));
+			victims->pop_front();
+		}
+
+		target.push_back(std::move(queuedTask));
+		pool_->scheduleLocked(state_);
+	}
+
+	pool_->workAvailable_.notify_one();
+	return token;
+}
+
+void SharedWorkerPool::Queue::shutdown() noexcept
+{
+	std::array<std::deque<QueuedTask>, kPriorityCount> cancelledTasks;
+
+	std::unique_lock<std::mutex> lock(pool_->mutex_);
+	state_->stopped = true;
+	cancelledTasks = cancelQueuedTasksLocked(*state_);
+
+	if (state_->running) {
+		state_->runningToken->store(true);
+		if (state_->runningThreadId != std::this_thread::get_id()) {
+			pool_->queueIdle_.wait(lock, [this] { return !state_->running; });
+		}
+	}
+	lock.unlock();
+}
+
+SharedWorkerPool::QueueStats SharedWorkerPool::Queue::getStats() const
+{
+	std::lock_guard<std::mutex> lock(pool_->mutex_);
+	return state_->stats;
+}
+
+const std::string &SharedWorkerPool::Queue::getName() const noexcept
+{
+	return state_->name;
+}
+
+SharedWorkerPool::SharedWorkerPool(std::shared_ptr<const Logger::ILogger> logger, std::size_t workerCount,
+				   std::vector<int> cpuAffinity)
+	: logger_(logger ? std::move(logger)
+			 : throw std::invalid_argument("LoggerIsNullError(SharedWorkerPool::SharedWorkerPool)")),
+	  cpuAffinity_(std::move(cpuAffinity))
+{
+	if (workerCount == 0) {
+		throw std::invalid_argument("WorkerCountIsZeroError(SharedWorkerPool::SharedWorkerPool)");
+	}
+
+	workers_.reserve(workerCount);
+	for (std::size_t i = 0; i < workerCount; ++i) {
+		workers_.emplace_back(&SharedWorkerPool::workerLoop, this, i);
+	}
+}
+
+SharedWorkerPool::~SharedWorkerPool() noexcept
+{
+	shutdown();
+
+	for (std::thread &worker : workers_) {
+		if (worker.get_id() == std::this_thread::get_id()) {
+			// The last reference was dropped by a task, which cannot join its own thread
+			worker.detach();
+			isCurrentWorkerOrphaned = true;
+		} else if (worker.joinable()) {
+			worker.join();
+		}
+	}
+}
+
+std::shared_ptr<SharedWorkerPool::Queue> SharedWorkerPool::createQueue(std::string name, std::size_t maxQueueSize)
+{
+	if (maxQueueSize == 0) {
+		throw std::invalid_argument("MaxQueueSizeIsZeroError(SharedWorkerPool::createQueue)");
+	}
+
+	auto state = std::make_shared<QueueState>();
+	state->name = std::move(name);
+	state->maxQueueSize = maxQueueSize;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		std::erase_if(queues_, [](const std::weak_ptr<QueueState> &queue) { return queue.expired(); });
+		queues_.push_back(state);
+	}
+
+	return std::shared_ptr<Queue>(new Queue(shared_from_this(), std::move(state)));
+}
+
+void SharedWorkerPool::shutdown() noexcept
+{
+	std::vector<std::array<std::deque<QueuedTask>, kPriorityCount>> cancelledTasks;
+	std::vector<std::shared_ptr<QueueState>> queues;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (stopped_) {
+			return;
+		}
+		stopped_ = true;
+
+		for (const std::weak_ptr<QueueState> &weakQueue : queues_) {
+			if (std::shared_ptr<QueueState> queue = weakQueue.lock()) {
+				cancelledTasks.push_back(cancelQueuedTasksLocked(*queue));
+				if (queue->running) {
+					queue->runningToken->store(true);
+				}
+				queues.push_back(std::move(queue));
+			}
+		}
+		readyQueues_.clear();
+	}
+	workAvailable_.notify_all();
+}
+
+void SharedWorkerPool::workerLoop(std::size_t workerIndex)
+{
+	if (!cpuAffinity_.empty()) {
+		const int cpu = cpuAffinity_[workerIndex % cpuAffinity_.size()];
+		if (!setCurrentThreadAffinity(cpu)) {
+			logger_->warn("CpuAffinityError", {{"workerIndex", std::to_string(workerIndex)},
+							   {"cpu", std::to_string(cpu)}});
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		workAvailable_.wait(lock, [this] { return stopped_ || !readyQueues_.empty(); });
+		if (stopped_) {
+			return;
+		}
+
+		std::shared_ptr<QueueState> queue = std::move(readyQueues_.front());
+		readyQueues_.pop_front();
+		queue->scheduled = false;
+		// Scan from the highest class down
+		const auto source = std::find_if(queue->tasks.rbegin(), queue->tasks.rend(),
+						 [](const std::deque<QueuedTask> &tasks) { return !tasks.empty(); });
+		if (source == queue->tasks.rend()) {
+			// Coalescing or a shutdown emptied the queue after it was scheduled
+			continue;
+		}
+
+		QueuedTask task = std::move(source->front());
+		source->pop_front();
+		queue->running = true;
+		queue->runningThreadId = std::this_thread::get_id();
+		queue->runningToken = task.token;
+		// Keeps the pool alive while the task is torn down, as it may hold the last reference. Empty only while
+		// the destructor runs on another thread, which then joins this one.
+		std::shared_ptr<SharedWorkerPool> self = weak_from_this().lock();
+		lock.unlock();
+
+		const auto startTime = std::chrono::steady_clock::now();
+		bool failed = false;
+		if (!task.token->load()) {
+			try {
+				task.run();
+			} catch (const std::exception &e) {
+				failed = true;
+				logger_->error("TaskExceptionError", {{"queue", queue->name}, {"message", e.what()}});
+			} catch (...) {
+				failed = true;
+				logger_->error("TaskUnknownExceptionError", {{"queue", queue->name}});
+			}
+		}
+		const auto endTime = std::chrono::steady_clock::now();
+		// Destroying the task may release captured resources, which must not happen under the lock
+		task.run = nullptr;
+
+		lock.lock();
+		const auto waitTime = std::chrono::duration_cast<std::chrono::nanoseconds>(startTime - task.pushTime);
+		queue->stats.totalWaitTime += waitTime;
+		queue->stats.maxWaitTime = std::max(queue->stats.maxWaitTime, waitTime);
+		queue->stats.totalRunTime += std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+		++(failed ? queue->stats.failedCount : queue->stats.completedCount);
+
+		queue->running = false;
+		queue->runningThreadId = std::thread::id();
+		queue->runningToken.reset();
+		if (!queue->stopped && !stopped_) {
+			scheduleLocked(queue);
+		}
+		queueIdle_.notify_all();
+
+		lock.unlock();
+		self.reset();
+		if (isCurrentWorkerOrphaned) {
+			return;
+		}
+		lock.lock();
+	}
+}
+
+void SharedWorkerPool::scheduleLocked(const std::shared_ptr<QueueState> &state)
+{
+	// A running queue is rescheduled by its worker, which keeps the tasks of one queue in order
+	if (!state->scheduled && !state->running && queuedTaskCountLocked(*state) > 0) {
+		state->scheduled = true;
+		readyQueues_.push_back(state);
+	}
+}
+
+std::size_t SharedWorkerPool::queuedTaskCountLocked(const QueueState &state) noexcept
+{
+	std::size_t count = 0;
+	for (const std::deque<QueuedTask> &tasks : state.tasks) {
+		count += tasks.size();
+	}
+	return count;
+}
+
+std::array<std::deque<SharedWorkerPool::QueuedTask>, SharedWorkerPool::kPriorityCount>
+SharedWorkerPool::cancelQueuedTasksLocked(QueueState &state) noexcept
+{
+	for (std::deque<QueuedTask> &tasks : state.tasks) {
+		for (QueuedTask &task : tasks) {
+			task.token->store(true);
+		}
+	}
+	return std::exchange(state.tasks, {});
+}
+
+bool SharedWorkerPool::setCurrentThreadAffinity(int cpu) noexcept
+{
+#if defined(_WIN32)
+	if (cpu < 0 || cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+		return false;
+	}
+	return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+#elif defined(__linux__)
+	if (cpu < 0 || cpu >= CPU_SETSIZE) {
+		return false;
+	}
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(cpu, &cpuSet);
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+	// macOS offers only affinity hints between threads, not pinning to a CPU
+	(void)cpu;
+	return false;
+#endif
+}
+
+} // namespace KaitoTokyo::TaskQueue
@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <KaitoTokyo/Logger/ILogger.hpp>
+
+namespace KaitoTokyo::TaskQueue {
+
+/**
+ * @brief A fixed set of worker threads that serves any number of logical task queues.
+ *
+ * Each Queue behaves like a ThrottledTaskQueue: its tasks run one at a time, interactive tasks before normal ones
+ * and each class in push order. A full queue cancels and drops the oldest task of its lowest class, but never one
+ * that outranks the new task, which is refused instead. Shutting a queue down cancels what is left and waits for
+ * the running task. Unlike ThrottledTaskQueue, queues do not own a thread. Ready queues are served round-robin, so
+ * a busy queue cannot starve the others, and at most getWorkerCount() tasks run at once across the whole process.
+ *
+ * The pool must be owned by a std::shared_ptr because its queues keep it alive.
+ */
+class SharedWorkerPool : public std::enable_shared_from_this<SharedWorkerPool> {
+	struct QueueState;
+
+public:
+	/**
+	 * @brief Set to true when the task should stop; shared with ThrottledTaskQueue.
+	 */
+	using CancellationToken = std::shared_ptr<std::atomic<bool>>;
+
+	using CancellableTask = std::function<void(const CancellationToken &)>;
+
+	/**
+	 * @brief The priority class of a task, as in ThrottledTaskQueue. Tasks of a higher class run first.
+	 */
+	enum class Priority : std::size_t {
+		Normal = 0,
+		Interactive = 1,
+	};
+
+	/**
+	 * @brief Counters of one queue since it was created.
+	 */
+	struct QueueStats {
+		std::uint64_t pushedCount;
+		/// Tasks cancelled or refused because the queue was full.
+		std::uint64_t droppedCount;
+		/// Tasks cancelled because a newer task with the same key was pushed.
+		std::uint64_t coalescedCount;
+		/// Tasks that ran to completion, including those that observed their cancellation.
+		std::uint64_t completedCount;
+		/// Tasks that threw.
+		std::uint64_t failedCount;
+		/// The time from push until a worker picked the task up, summed over every task that ran.
+		std::chrono::nanoseconds totalWaitTime;
+		std::chrono::nanoseconds maxWaitTime;
+		std::chrono::nanoseconds totalRunTime;
+	};
+
+	/**
+	 * @brief A logical queue served by the pool.
+	 */
+	class Queue {
+	public:
+		~Queue() noexcept { shutdown(); }
+
+		Queue(const Queue &) = delete;
+		Queue &operator=(const Queue &) = delete;
+		Queue(Queue &&) = delete;
+		Queue &operator=(Queue &&) = delete;
+
+		/**
+		 * @brief Pushes a task, cancelling the oldest queued task if the queue is full.
+		 *
+		 * @return A token that cancels the task when set.
+		 * @throws std::runtime_error If the queue or the pool has been shut down.
+		 */
+		CancellationToken push(CancellableTask task, Priority priority = Priority::Normal);
+
+		/**
+		 * @brief Pushes a task that replaces a queued task with the same @p key.
+		 *
+		 * The replaced task is cancelled and the new one takes its place, so a producer that pushes faster than
+		 * the queue runs keeps its turn instead of moving to the back. If the priority differs, the new task
+		 * moves to the back of its own class. A running task with the same key is not affected.
+		 *
+		 * @throws std::runtime_error If the queue or the pool has been shut down.
+		 */
+		CancellationToken push(std::string key, CancellableTask task, Priority priority = Priority::Normal);
+
+		/**
+		 * @brief Cancels every queued task and the running one, then waits for the running one to return.
+		 *
+		 * Called from one of this queue's own tasks, it does not wait.
+		 */
+		void shutdown() noexcept;
+
+		QueueStats getStats() const;
+
+		const std::string &getName() const noexcept;
+
+	private:
+		friend class SharedWorkerPool;
+
+		Queue(std::shared_ptr<SharedWorkerPool> pool, std::shared_ptr<QueueState> state);
+
+		CancellationToken pushImpl(std::optional<std::string> key, CancellableTask task, Priority priority);
+
+		const std::shared_ptr<SharedWorkerPool> pool_;
+		const std::shared_ptr<QueueState> state_;
+	};
+
+	/**
+	 * @param logger The logger task failures are reported to.
+	 * @param workerCount The number of worker threads. Must be at least 1.
+	 * @param cpuAffinity The CPUs the workers are pinned to, worker i to cpuAffinity[i % size]. Empty for no
+	 * pinning. Pinning is best effort and only logged if the platform refuses it.
+	 * @throws std::invalid_argument If logger is null or workerCount is 0.
+	 */
+	SharedWorkerPool(std::shared_ptr<const Logger::ILogger> logger, std::size_t workerCount,
+			 std::vector<int> cpuAffinity = {});
+
+	/**
+	 * @brief Shuts the pool down and joins the workers.
+	 */
+	~SharedWorkerPool() noexcept;
+
+	SharedWorkerPool(const SharedWorkerPool &) = delete;
+	SharedWorkerPool &operator=(const SharedWorkerPool &) = delete;
+	SharedWorkerPool(SharedWorkerPool &&) = delete;
+	SharedWorkerPool &operator=(SharedWorkerPool &&) = delete;
+
+	/**
+	 * @brief Creates a logical queue that holds at most @p maxQueueSize waiting tasks.
+	 *
+	 * @param name A name for statistics and logs.
+	 * @throws std::invalid_argument If maxQueueSize is 0.
+	 */
+	std::shared_ptr<Queue> createQueue(std::string name, std::size_t maxQueueSize);
+
+	/**
+	 * @brief Cancels every task of every queue and stops accepting new ones.
+	 *
+	 * The workers are joined by the destructor.
+	 */
+	void shutdown() noexcept;
+
+	std::size_t getWorkerCount() const noexcept { return workers_.size(); }
+
+private:
+	static constexpr std::size_t kPriorityCount = 2;
+
+	struct QueuedTask {
+		std::optional<std::string> key;
+		std::function<void()> run;
+		CancellationToken token;
+		std::chrono::steady_clock::time_point pushTime;
+	};
+
+	struct QueueState {
+		std::string name;
+		std::size_t maxQueueSize;
+		/// Queued tasks per priority class, indexed by Priority.
+		std::array<std::deque<QueuedTask>, kPriorityCount> tasks;
+		bool stopped = false;
+		/// Whether the queue is in readyQueues_.
+		bool scheduled = false;
+		bool running = false;
+		std::thread::id runningThreadId;
+		CancellationToken runningToken;
+		QueueStats stats{};
+	};
+
+	void workerLoop(std::size_t workerIndex);
+	void scheduleLocked(const std::shared_ptr<QueueState> &state);
+
+	static std::size_t queuedTaskCountLocked(const QueueState &state) noexcept;
+
+	/**
+	 * @brief Cancels and removes the queued tasks of @p state, returning them to be destroyed without the lock.
+	 */
+	static std::array<std::deque<QueuedTask>, kPriorityCount> cancelQueuedTasksLocked(QueueState &state) noexcept;
+	static bool setCurrentThreadAffinity(int cpu) noexcept;
+
+	const std::shared_ptr<const Logger::ILogger> logger_;
+	const std::vector<int> cpuAffinity_;
+
+	mutable std::mutex mutex_;
+	std::condition_variable workAvailable_;
+	std::condition_variable queueIdle_;
+	std::deque<std::shared_ptr<QueueState>> readyQueues_;
+	std::vector<std::weak_ptr<QueueState>> queues_;
+	bool stopped_ = false;
+
+	std::vector<std::thread> workers_;
+};
+
+} // namespace KaitoTokyo::TaskQueue
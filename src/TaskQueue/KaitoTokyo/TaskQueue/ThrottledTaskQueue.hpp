@@ -4,16 +4,21 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cassert>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <queue>
 #include <stdexcept>
+#include <string>
 #include <thread>
+#include <unordered_set>
 #include <utility>
 
 #include <KaitoTokyo/Logger/ILogger.hpp>
@@ -26,6 +31,11 @@ namespace KaitoTokyo::TaskQueue {
  * This class manages a single internal worker thread in an RAII style.
  * The thread is started upon object construction and safely joined upon destruction.
  * If the queue is full when a new task is pushed, the oldest task is cancelled and removed.
+ *
+ * Tasks pushed with a key are coalesced: a newer task replaces the pending task with the same key, so a busy
+ * producer holds at most one slot and cannot push the tasks of other producers out of the queue. Interactive
+ * tasks run before normal ones, and a full queue drops normal tasks first. A task never evicts one of a higher
+ * class; if the full queue holds only such tasks, the new task is cancelled instead.
  */
 class ThrottledTaskQueue {
 public:
@@ -41,8 +51,22 @@ public:
      */
 	using CancellableTask = std::function<void(const CancellationToken &)>;
 
+	/**
+     * @brief The priority class of a task. Tasks of a higher class run first.
+     */
+	enum class Priority : std::size_t {
+		Normal = 0,
+		Interactive = 1,
+	};
+
 private:
-	using QueuedTask = std::pair<std::function<void()>, CancellationToken>;
+	static constexpr std::size_t kPriorityCount = 2;
+
+	struct QueuedTask {
+		std::optional<std::string> key;
+		std::function<void()> run;
+		CancellationToken token;
+	};
 
 public:
 	/**
@@ -87,8 +111,39 @@ public:
      * @throws std::runtime_error if the queue has already been stopped.
      */
 	CancellationToken push(CancellableTask userTask)
+	{
+		return pushImpl(std::nullopt, std::move(userTask), Priority::Normal);
+	}
+
+	/**
+     * @brief Pushes a cancellable task with a priority class.
+     * @throws std::runtime_error if the queue has already been stopped.
+     */
+	CancellationToken push(CancellableTask userTask, Priority priority)
+	{
+		return pushImpl(std::nullopt, std::move(userTask), priority);
+	}
+
+	/**
+     * @brief Pushes a task that replaces the pending task with the same key.
+     *
+     * The replaced task is cancelled and the new one takes its place in the queue, so a producer that pushes
+     * faster than the worker runs keeps its turn instead of moving to the back. If the priority differs, the new
+     * task moves to the back of its own class. A running task with the same key is not affected.
+     *
+     * @throws std::runtime_error if the queue has already been stopped.
+     */
+	CancellationToken push(std::string key, CancellableTask userTask, Priority priority = Priority::Normal)
+	{
+		return pushImpl(std::move(key), std::move(userTask), priority);
+	}
+
+private:
+	CancellationToken pushImpl(std::optional<std::string> key, CancellableTask userTask, Priority priority)
 	{
 		auto token = std::make_shared<std::atomic<bool>>(false);
+		QueuedTask queuedTask{key, [userTask = std::move(userTask), token] { userTask(token); }, token};
+		std::deque<QueuedTask> &target = queues_[static_cast<std::size_t>(priority)];
 
 		{
 			std::lock_guard<std::mutex> lock(mutex_);
@@ -96,20 +151,74 @@ public:
 				throw std::runtime_error("push on stopped ThrottledTaskQueue");
 			}
 
-			// If the queue is full, cancel and remove the oldest task.
-			while (queue_.size() >= maxQueueSize_) {
-				if (queue_.front().second) {
-					queue_.front().second->store(true); // Cancel
+			if (key && !pendingKeys_.insert(*key).second) {
+				auto it = findKey(target, *key);
+				if (it != target.end()) {
+					// Same class: replace in place and keep the turn
+					it->token->store(true);
+					*it = std::move(queuedTask);
+					return token;
+				}
+				eraseKeyLocked(*key);
+				pendingKeys_.insert(*key);
+			}
+
+			// If the queue is full, cancel and remove the oldest task of the lowest class.
+			while (sizeLocked() >= maxQueueSize_) {
+				auto victims = std::find_if(queues_.begin(), queues_.end(),
+							    [](const auto &queue) { return !queue.empty(); });
+				if (victims > queues_.begin() + static_cast<std::ptrdiff_t>(priority)) {
+					// Every queued task outranks the new one, which is refused rather than evicting them
+					cancelLocked(queuedTask);
+					return token;
 				}
-				queue_.pop();
+				cancelLocked(victims->front());
+				victims->pop_front();
 			}
-			queue_.push({[userTask, token] { userTask(token); }, token});
+			target.push_back(std::move(queuedTask));
 		}
 		cond_.notify_one();
 		return token;
 	}
 
-private:
+	static std::deque<QueuedTask>::iterator findKey(std::deque<QueuedTask> &queue, const std::string &key)
+	{
+		return std::find_if(queue.begin(), queue.end(),
+				    [&key](const QueuedTask &pending) { return pending.key == key; });
+	}
+
+	std::size_t sizeLocked() const noexcept
+	{
+		std::size_t size = 0;
+		for (const std::deque<QueuedTask> &queue : queues_) {
+			size += queue.size();
+		}
+		return size;
+	}
+
+	void cancelLocked(QueuedTask &queuedTask) noexcept
+	{
+		queuedTask.token->store(true);
+		if (queuedTask.key) {
+			pendingKeys_.erase(*queuedTask.key);
+		}
+	}
+
+	/**
+     * @brief Cancels and removes the pending task with @p key from whichever class holds it.
+     */
+	void eraseKeyLocked(const std::string &key)
+	{
+		for (std::deque<QueuedTask> &queue : queues_) {
+			auto it = findKey(queue, key);
+			if (it != queue.end()) {
+				cancelLocked(*it);
+				queue.erase(it);
+				return;
+			}
+		}
+	}
+
 	/**
      * @brief The main loop for the worker thread.
      */
@@ -123,7 +232,7 @@ private:
 
 			{
 				std::lock_guard<std::mutex> lock(mutex_);
-				currentTaskToken_ = queuedTaskOpt->second;
+				currentTaskToken_ = queuedTaskOpt->token;
 			}
 
 			if (currentTaskToken_->load()) {
@@ -135,7 +244,7 @@ private:
 			}
 
 			try {
-				queuedTaskOpt->first();
+				queuedTaskOpt->run();
 			} catch (const std::exception &e) {
 				logger_->error("TaskExceptionError", {{"message", e.what()}});
 			} catch (...) {
@@ -156,16 +265,24 @@ private:
 	std::optional<QueuedTask> pop()
 	{
 		std::unique_lock<std::mutex> lock(mutex_);
-		cond_.wait(lock, [this] { return !queue_.empty() || stopped_; });
+		cond_.wait(lock, [this] { return sizeLocked() > 0 || stopped_; });
 
-		if (stopped_ && queue_.empty()) {
+		if (stopped_ && sizeLocked() == 0) {
 			return std::nullopt;
 		}
 
-		auto queuedTask = std::move(queue_.front());
-		queue_.pop();
-
-		return queuedTask;
+		// Scan from the highest class down
+		for (auto it = queues_.rbegin(); it != queues_.rend(); ++it) {
+			if (!it->empty()) {
+				QueuedTask queuedTask = std::move(it->front());
+				it->pop_front();
+				if (queuedTask.key) {
+					pendingKeys_.erase(*queuedTask.key);
+				}
+				return queuedTask;
+			}
+		}
+		return std::nullopt;
 	}
 
 	/**
@@ -182,12 +299,13 @@ private:
 			stopped_ = true;
 
 			// Cancel all pending tasks in the queue before shutting down.
-			while (!queue_.empty()) {
-				if (queue_.front().second) {
-					queue_.front().second->store(true);
+			for (std::deque<QueuedTask> &queue : queues_) {
+				for (QueuedTask &queuedTask : queue) {
+					queuedTask.token->store(true);
 				}
-				queue_.pop();
+				queue.clear();
 			}
+			pendingKeys_.clear();
 
 			if (currentTaskToken_) {
 				currentTaskToken_->store(true);
@@ -200,7 +318,9 @@ private:
 	const std::size_t maxQueueSize_;
 	std::mutex mutex_;
 	std::condition_variable cond_;
-	std::queue<QueuedTask> queue_;
+	/// Pending tasks per priority class, indexed by Priority.
+	std::array<std::deque<QueuedTask>, kPriorityCount> queues_;
+	std::unordered_set<std::string> pendingKeys_;
 	bool stopped_ = false;
 	CancellationToken currentTaskToken_;
 	std::thread worker_;
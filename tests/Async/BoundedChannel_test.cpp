@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <KaitoTokyo/Async/BoundedChannel.hpp>
+#include <KaitoTokyo/Async/Join.hpp>
+#include <KaitoTokyo/Async/Task.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace KaitoTokyo::Async;
+
+namespace {
+
+/**
+ * @brief Receives until the channel is closed and drained.
+ */
+Task<void> receiveAll(BoundedChannel<int> &channel, std::vector<int> &received)
+{
+	while (std::optional<int> value = co_await channel.receive()) {
+		received.push_back(*value);
+	}
+}
+
+Task<void> sendAll(BoundedChannel<int> &channel, int first, int count, std::vector<bool> &results)
+{
+	for (int i = first; i < first + count; ++i) {
+		results.push_back(co_await channel.async_send(i));
+	}
+}
+
+} // namespace
+
+TEST(BoundedRingTest, CapacityIsRoundedUpToAPowerOfTwo)
+{
+	EXPECT_THROW(BoundedRing<int>(0), std::invalid_argument);
+	EXPECT_EQ(BoundedRing<int>(1).capacity(), 2u);
+	EXPECT_EQ(BoundedRing<int>(5).capacity(), 8u);
+}
+
+TEST(BoundedRingTest, PushFailsWhenFullAndLeavesTheValue)
+{
+	BoundedRing<std::vector<int>> ring(2);
+	std::vector<int> first{1};
+	std::vector<int> second{2};
+	std::vector<int> third{3};
+
+	EXPECT_TRUE(ring.try_push(first));
+	EXPECT_TRUE(ring.try_push(second));
+	EXPECT_FALSE(ring.try_push(third));
+	EXPECT_EQ(third, std::vector<int>{3});
+
+	std::optional<std::vector<int>> out;
+	ASSERT_TRUE(ring.try_pop(out));
+	EXPECT_EQ(*out, std::vector<int>{1});
+	EXPECT_TRUE(ring.try_push(third));
+}
+
+TEST(BoundedChannelTest, DeliversInOrderAndDrainsAfterClose)
+{
+	BoundedChannel<int> channel(4);
+	EXPECT_TRUE(channel.send(1));
+	EXPECT_TRUE(channel.send(2));
+	channel.close();
+	EXPECT_FALSE(channel.send(3));
+
+	std::vector<int> received;
+	join(receiveAll(channel, received));
+	EXPECT_EQ(received, (std::vector<int>{1, 2}));
+}
+
+TEST(BoundedChannelTest, DropNewestRefusesTheNewMessage)
+{
+	BoundedChannel<int> channel(2, OverflowPolicy::DropNewest);
+	EXPECT_TRUE(channel.send(1));
+	EXPECT_TRUE(channel.send(2));
+	EXPECT_FALSE(channel.send(3));
+	EXPECT_EQ(channel.dropped_count(), 1u);
+	channel.close();
+
+	std::vector<int> received;
+	join(receiveAll(channel, received));
+	EXPECT_EQ(received, (std::vector<int>{1, 2}));
+}
+
+TEST(BoundedChannelTest, DropOldestDiscardsTheOldestMessage)
+{
+	BoundedChannel<int> channel(2, OverflowPolicy::DropOldest);
+	for (int i = 1; i <= 5; ++i) {
+		EXPECT_TRUE(channel.send(i));
+	}
+	EXPECT_EQ(channel.dropped_count(), 3u);
+	channel.close();
+
+	std::vector<int> received;
+	join(receiveAll(channel, received));
+	EXPECT_EQ(received, (std::vector<int>{4, 5}));
+}
+
+TEST(BoundedChannelTest, AsyncSendSuspendsUntilTheReceiverMakesRoom)
+{
+	BoundedChannel<int> channel(2);
+	std::vector<bool> results;
+
+	// The sender parks at the third message and is resumed from inside receive()
+	Task<void> sender = sendAll(channel, 1, 5, results);
+	sender.start();
+	EXPECT_EQ(results.size(), 2u);
+
+	std::vector<int> received;
+	Task<void> receiver = receiveAll(channel, received);
+	receiver.start();
+	EXPECT_EQ(results, std::vector<bool>(5, true));
+	EXPECT_EQ(received, (std::vector<int>{1, 2, 3, 4, 5}));
+
+	channel.close();
+	EXPECT_EQ(channel.dropped_count(), 0u);
+}
+
+TEST(BoundedChannelTest, CloseFailsParkedSenders)
+{
+	BoundedChannel<int> channel(2);
+	std::vector<bool> results;
+
+	Task<void> sender = sendAll(channel, 1, 4, results);
+	sender.start();
+	EXPECT_EQ(results, (std::vector<bool>{true, true}));
+
+	channel.close();
+	EXPECT_EQ(results, (std::vector<bool>{true, true, false, false}));
+
+	std::vector<int> received;
+	join(receiveAll(channel, received));
+	EXPECT_EQ(received, (std::vector<int>{1, 2}));
+}
+
+TEST(BoundedChannelTest, ManyProducersDeliverEveryMessageInPerProducerOrder)
+{
+	constexpr int kProducerCount = 4;
+	constexpr int kMessageCount = 20000;
+	BoundedChannel<int> channel(8);
+
+	std::vector<int> received;
+	std::thread consumer([&channel, &received] { join(receiveAll(channel, received)); });
+
+	std::vector<std::thread> producers;
+	std::vector<std::vector<bool>> results(kProducerCount);
+	for (int p = 0; p < kProducerCount; ++p) {
+		producers.emplace_back([&channel, &results, p] {
+			join(sendAll(channel, p * kMessageCount, kMessageCount, results[p]));
+		});
+	}
+	for (std::thread &producer : producers) {
+		producer.join();
+	}
+	channel.close();
+	consumer.join();
+
+	ASSERT_EQ(received.size(), static_cast<std::size_t>(kProducerCount * kMessageCount));
+	std::vector<int> next(kProducerCount);
+	for (int p = 0; p < kProducerCount; ++p) {
+		next[p] = p * kMessageCount;
+	}
+	for (const int value : received) {
+		const int p = value / kMessageCount;
+		EXPECT_EQ(value, next[p]);
+		next[p] = value + 1;
+	}
+}
@@ -0,0 +1,204 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <KaitoTokyo/Async/Join.hpp>
+#include <KaitoTokyo/Async/Task.hpp>
+#include <KaitoTokyo/Async/ThreadPool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace KaitoTokyo::Async;
+
+namespace {
+
+Task<std::thread::id> currentThreadOn(ThreadPool &pool)
+{
+	co_await schedule_on(pool);
+	co_return std::this_thread::get_id();
+}
+
+Task<int> squareOn(ThreadPool &pool, int value, std::chrono::milliseconds delay)
+{
+	co_await pool.schedule_after(delay);
+	co_return value * value;
+}
+
+} // namespace
+
+TEST(ThreadPoolTest, ConstructorRejectsZeroThreads)
+{
+	EXPECT_THROW(ThreadPool(0), std::invalid_argument);
+}
+
+TEST(ThreadPoolTest, ScheduleOnResumesOnAWorker)
+{
+	ThreadPool pool(2);
+	std::thread::id workerId;
+
+	join([](ThreadPool &pool, std::thread::id &workerId) -> Task<void> {
+		workerId = co_await currentThreadOn(pool);
+	}(pool, workerId));
+
+	EXPECT_NE(workerId, std::thread::id());
+	EXPECT_NE(workerId, std::this_thread::get_id());
+}
+
+TEST(ThreadPoolTest, ScheduleAfterWaitsForTheDelay)
+{
+	ThreadPool pool(1);
+	const auto startTime = ThreadPool::Clock::now();
+
+	join([](ThreadPool &pool) -> Task<void> {
+		co_await pool.schedule_after(std::chrono::milliseconds(20));
+		co_return;
+	}(pool));
+
+	EXPECT_GE(ThreadPool::Clock::now() - startTime, std::chrono::milliseconds(20));
+}
+
+TEST(ThreadPoolTest, TimersFireInDeadlineOrder)
+{
+	ThreadPool pool(1);
+	std::mutex mutex;
+	std::vector<int> order;
+
+	const auto record = [](ThreadPool &pool, std::mutex &mutex, std::vector<int> &order, int value) -> Task<void> {
+		co_await pool.schedule_after(std::chrono::milliseconds(value));
+		std::scoped_lock lock(mutex);
+		order.push_back(value);
+		co_return;
+	};
+
+	std::vector<Task<void>> tasks;
+	tasks.push_back(record(pool, mutex, order, 30));
+	tasks.push_back(record(pool, mutex, order, 10));
+	tasks.push_back(record(pool, mutex, order, 20));
+	join(when_all(std::move(tasks)));
+
+	EXPECT_EQ(order, (std::vector<int>{10, 20, 30}));
+}
+
+TEST(ThreadPoolTest, IdleWorkersStealFromABusyWorker)
+{
+	ThreadPool pool(4);
+	std::mutex mutex;
+	std::set<std::thread::id> threadIds;
+
+	// Scheduled from a worker, every child goes to that worker's own queue first
+	const auto child = [](ThreadPool &pool, std::mutex &mutex, std::set<std::thread::id> &threadIds) -> Task<void> {
+		co_await schedule_on(pool);
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		std::scoped_lock lock(mutex);
+		threadIds.insert(std::this_thread::get_id());
+	};
+
+	join([](ThreadPool &pool, auto child, std::mutex &mutex, std::set<std::thread::id> &threadIds) -> Task<void> {
+		co_await schedule_on(pool);
+		std::vector<Task<void>> children;
+		for (int i = 0; i < 32; ++i) {
+			children.push_back(child(pool, mutex, threadIds));
+		}
+		co_await when_all(std::move(children));
+	}(pool, child, mutex, threadIds));
+
+	EXPECT_GT(threadIds.size(), 1u);
+}
+
+TEST(WhenAllTest, ReturnsResultsInTaskOrder)
+{
+	ThreadPool pool(4);
+	std::vector<int> results;
+
+	join([](ThreadPool &pool, std::vector<int> &results) -> Task<void> {
+		std::vector<Task<int>> tasks;
+		tasks.push_back(squareOn(pool, 1, std::chrono::milliseconds(15)));
+		tasks.push_back(squareOn(pool, 2, std::chrono::milliseconds(0)));
+		tasks.push_back(squareOn(pool, 3, std::chrono::milliseconds(5)));
+		results = co_await when_all(std::move(tasks));
+	}(pool, results));
+
+	EXPECT_EQ(results, (std::vector<int>{1, 4, 9}));
+}
+
+TEST(WhenAllTest, EmptyGroupCompletesImmediately)
+{
+	std::vector<int> results{1};
+
+	join([](std::vector<int> &results) -> Task<void> {
+		results = co_await when_all(std::vector<Task<int>>{});
+	}(results));
+
+	EXPECT_TRUE(results.empty());
+}
+
+TEST(WhenAllTest, RethrowsAfterEveryTaskFinished)
+{
+	ThreadPool pool(2);
+	std::atomic<int> finishedCount = 0;
+
+	const auto failing = [](ThreadPool &pool) -> Task<void> {
+		co_await schedule_on(pool);
+		throw std::runtime_error("failure");
+	};
+	const auto slow = [](ThreadPool &pool, std::atomic<int> &finishedCount) -> Task<void> {
+		co_await pool.schedule_after(std::chrono::milliseconds(10));
+		finishedCount++;
+		co_return;
+	};
+
+	std::vector<Task<void>> tasks;
+	tasks.push_back(failing(pool));
+	tasks.push_back(slow(pool, finishedCount));
+	EXPECT_THROW(join(when_all(std::move(tasks))), std::runtime_error);
+	EXPECT_EQ(finishedCount.load(), 1);
+}
+
+TEST(WhenAnyTest, ReturnsTheFirstTaskToFinish)
+{
+	ThreadPool pool(2);
+	std::pair<std::size_t, int> first;
+	std::atomic<int> finishedCount = 0;
+
+	const auto counted = [](Task<int> task, std::atomic<int> &finishedCount) -> Task<int> {
+		const int value = co_await task;
+		finishedCount++;
+		co_return value;
+	};
+
+	join([](ThreadPool &pool, auto counted, std::atomic<int> &finishedCount,
+		std::pair<std::size_t, int> &first) -> Task<void> {
+		std::vector<Task<int>> tasks;
+		tasks.push_back(counted(squareOn(pool, 2, std::chrono::milliseconds(50)), finishedCount));
+		tasks.push_back(counted(squareOn(pool, 3, std::chrono::milliseconds(0)), finishedCount));
+		first = co_await when_any(std::move(tasks));
+	}(pool, counted, finishedCount, first));
+
+	EXPECT_EQ(first.first, 1u);
+	EXPECT_EQ(first.second, 9);
+
+	// The loser keeps running on the pool, which must outlive it
+	while (finishedCount.load() < 2) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+TEST(WhenAnyTest, RejectsAnEmptyGroup)
+{
+	const auto awaitEmptyGroup = []() -> Task<void> {
+		co_await when_any(std::vector<Task<void>>{});
+		co_return;
+	};
+
+	EXPECT_THROW(join(awaitEmptyGroup()), std::invalid_argument);
+}
@@ -0,0 +1,464 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <KaitoTokyo/Logger/NullLogger.hpp>
+#include <KaitoTokyo/ObsBridgeUtils/GsTexturePool.hpp>
+#include <KaitoTokyo/ObsBridgeUtils/GsUnique.hpp>
+#include <KaitoTokyo/SelfieSegmenter/InferenceScheduler.hpp>
+#include <KaitoTokyo/SelfieSegmenter/SyntheticSelfieSegmenter.hpp>
+
+#include <ObsGraphicsMock.hpp>
+#include <ReferenceMainEffect.hpp>
+
+#include "MainEffect.hpp"
+#include "RenderingContext.hpp"
+
+using namespace KaitoTokyo;
+using namespace KaitoTokyo::LiveBackgroundRemovalLite::MainFilter;
+using KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect::ReferenceMainEffect;
+using KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect::Texture;
+using KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect::TextureFormat;
+using KaitoTokyo::ObsBridgeUtils::GraphicsContextGuard;
+using KaitoTokyo::SelfieSegmenter::InferenceScheduler;
+using KaitoTokyo::SelfieSegmenter::SyntheticSelfieSegmenter;
+
+namespace {
+
+constexpr std::uint32_t kWidth = 320;
+constexpr std::uint32_t kHeight = 180;
+constexpr std::uint32_t kSubsamplingRate = 4;
+constexpr int kBlurSize = 2;
+
+float getCenterTexel(const Texture &texture, std::uint32_t channel = 0)
+{
+	return texture.getRow(texture.getHeight() / 2)[(texture.getWidth() / 2) * texture.getChannelCount() + channel];
+}
+
+} // namespace
+
+class RenderingContextTest : public ::testing::Test {
+protected:
+	void SetUp() override
+	{
+		ObsGraphicsMock::reset();
+		ObsGraphicsMock::installReferenceHandlers(referenceEffect_);
+
+		frameSource_ = ObsGraphicsMock::createSource("Frame", kWidth, kHeight);
+		filterSource_ = ObsGraphicsMock::createSource("Filter", kWidth, kHeight);
+		ObsGraphicsMock::setFilterTarget(filterSource_, frameSource_);
+		setSolidFrame(0, 0, 0);
+
+		SyntheticSelfieSegmenter::Config config;
+		config.pattern = SyntheticSelfieSegmenter::MaskPattern::Full;
+		segmenter_ = std::make_shared<SyntheticSelfieSegmenter>(config);
+
+		GraphicsContextGuard graphicsContextGuard;
+		mainEffect_ = std::make_unique<MainEffect>(
+			logger_, ObsBridgeUtils::unique_bfree_char_t(bstrdup(DATA_DIR "/effects/main.effect")));
+		renderingContext_ = makeRenderingContext(nullptr);
+		renderingContext_->applyPluginProperty(PluginProperty{});
+		ObsGraphicsMock::resetCounters();
+	}
+
+	void TearDown() override
+	{
+		GraphicsContextGuard graphicsContextGuard;
+		renderingContext_.reset();
+		mainEffect_.reset();
+		ObsBridgeUtils::GsUnique::drain();
+	}
+
+	std::shared_ptr<RenderingContext>
+	makeRenderingContext(std::shared_ptr<ObsBridgeUtils::GsTexturePool> texturePool)
+	{
+		return std::make_shared<RenderingContext>(filterSource_, logger_, *mainEffect_, scheduler_, nullptr,
+							  std::move(texturePool), segmenter_, kSubsamplingRate, kWidth,
+							  kHeight, 1, kBlurSize);
+	}
+
+	void setSolidFrame(std::uint8_t b, std::uint8_t g, std::uint8_t r)
+	{
+		std::vector<std::uint8_t> bgra(static_cast<std::size_t>(kWidth) * kHeight * 4);
+		for (std::size_t i = 0; i < bgra.size(); i += 4) {
+			bgra[i + 0] = b;
+			bgra[i + 1] = g;
+			bgra[i + 2] = r;
+			bgra[i + 3] = 255;
+		}
+		ObsGraphicsMock::setSourceFrame(frameSource_, bgra.data(), kWidth * 4);
+	}
+
+	void renderFrame(bool ticks)
+	{
+		GraphicsContextGuard graphicsContextGuard;
+		if (ticks) {
+			renderingContext_->videoTick(1.0f / 60.0f);
+		}
+		renderingContext_->videoRender();
+	}
+
+	bool waitForProcessedCount(std::uint64_t count) const
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (renderingContext_->getInferenceStats().processedCount < count) {
+			if (std::chrono::steady_clock::now() > deadline) {
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	const std::shared_ptr<const Logger::ILogger> logger_ = std::make_shared<Logger::NullLogger>();
+	const ReferenceMainEffect referenceEffect_{};
+	InferenceScheduler scheduler_{logger_, std::chrono::microseconds(0)};
+	obs_source_t *frameSource_ = nullptr;
+	obs_source_t *filterSource_ = nullptr;
+	std::shared_ptr<SyntheticSelfieSegmenter> segmenter_;
+	std::unique_ptr<MainEffect> mainEffect_;
+	std::shared_ptr<RenderingContext> renderingContext_;
+};
+
+TEST_F(RenderingContextTest, ConstructorRejectsNullSegmenter)
+{
+	GraphicsContextGuard graphicsContextGuard;
+	const std::shared_ptr<KaitoTokyo::SelfieSegmenter::ISelfieSegmenter> nullSegmenter;
+	EXPECT_THROW(RenderingContext(filterSource_, logger_, *mainEffect_, scheduler_, nullptr, nullptr, nullSegmenter,
+				      kSubsamplingRate, kWidth, kHeight, 1, kBlurSize),
+		     std::invalid_argument);
+}
+
+TEST_F(RenderingContextTest, PyramidsHalveDownToTheirLastLevel)
+{
+	const auto &reductionPyramid = renderingContext_->r32fMeanSquaredMotionReductionPyramid_;
+	ASSERT_FALSE(reductionPyramid.empty());
+	EXPECT_EQ(gs_texture_get_width(reductionPyramid.back().get()), 1u);
+	EXPECT_EQ(gs_texture_get_height(reductionPyramid.back().get()), 1u);
+
+	std::uint32_t width = gs_texture_get_width(renderingContext_->r32fSubPaddedSquaredMotion_.get());
+	std::uint32_t height = gs_texture_get_height(renderingContext_->r32fSubPaddedSquaredMotion_.get());
+	for (const auto &level : reductionPyramid) {
+		width = std::max(1u, (width + 1) / 2);
+		height = std::max(1u, (height + 1) / 2);
+		EXPECT_EQ(gs_texture_get_width(level.get()), width);
+		EXPECT_EQ(gs_texture_get_height(level.get()), height);
+	}
+
+	const auto &blurPyramid = renderingContext_->bgrxDualKawaseBlurReductionPyramid_;
+	ASSERT_EQ(blurPyramid.size(), static_cast<std::size_t>(kBlurSize) + 1);
+	EXPECT_EQ(gs_texture_get_width(blurPyramid[0].get()), kWidth);
+	EXPECT_EQ(gs_texture_get_height(blurPyramid[0].get()), kHeight);
+	EXPECT_EQ(gs_texture_get_width(blurPyramid[kBlurSize].get()), kWidth / 4);
+	EXPECT_EQ(gs_texture_get_height(blurPyramid[kBlurSize].get()), (kHeight + 3) / 4);
+
+	// Two double-buffered readers: the segmenter input and the reduced motion
+	EXPECT_EQ(ObsGraphicsMock::getLiveStagesurfCount(), 4u);
+}
+
+TEST_F(RenderingContextTest, FirstFrameIsProcessedAndSubmitted)
+{
+	renderFrame(false);
+
+	const ObsGraphicsMock::Counters counters = ObsGraphicsMock::getCounters();
+	EXPECT_EQ(counters.sourceRenderCount, 1u);
+	EXPECT_EQ(counters.stageCount, 2u);
+	EXPECT_EQ(counters.textureCopyCount, 1u);
+	EXPECT_EQ(counters.textureCreateCount, 0u);
+	EXPECT_EQ(counters.drawCountByTechnique.at("Reduce"),
+		  renderingContext_->r32fMeanSquaredMotionReductionPyramid_.size());
+	EXPECT_EQ(renderingContext_->getInferenceStats().submittedCount, 1u);
+}
+
+TEST_F(RenderingContextTest, GuidedFilterMeansTakeOnePassPair)
+{
+	renderFrame(false);
+
+	const ObsGraphicsMock::Counters counters = ObsGraphicsMock::getCounters();
+	EXPECT_EQ(counters.drawCountByTechnique.at("HorizontalBoxFilterGuidedFilterMeans"), 1u);
+	EXPECT_EQ(counters.drawCountByTechnique.at("VerticalBoxFilterRGBA32F"), 1u);
+	EXPECT_EQ(counters.drawCountByTechnique.at("CalculateGuidedFilterAFromMeans"), 1u);
+	EXPECT_EQ(counters.drawCountByTechnique.at("CalculateGuidedFilterBFromMeans"), 1u);
+}
+
+TEST_F(RenderingContextTest, GuidedFilterBoxRadiusFollowsThePluginProperty)
+{
+	std::vector<float> kernelSizes;
+	ObsGraphicsMock::setDrawHandler("VerticalBoxFilterRGBA32F", [&](const ObsGraphicsMock::DrawCall &call) {
+		kernelSizes.push_back(call.getFloat("kernelSize"));
+	});
+
+	renderFrame(true);
+
+	PluginProperty pluginProperty;
+	pluginProperty.guidedFilterBoxRadiusAuto = false;
+	pluginProperty.guidedFilterBoxRadius = 12;
+	renderingContext_->applyPluginProperty(pluginProperty);
+	renderFrame(true);
+
+	pluginProperty.guidedFilterBoxRadius = 100;
+	renderingContext_->applyPluginProperty(pluginProperty);
+	renderFrame(true);
+
+	pluginProperty.guidedFilterBoxRadius = 1;
+	renderingContext_->applyPluginProperty(pluginProperty);
+	renderFrame(true);
+
+	// The auto checkbox wins over whatever radius is stored
+	pluginProperty.guidedFilterBoxRadiusAuto = true;
+	renderingContext_->applyPluginProperty(pluginProperty);
+	renderFrame(true);
+
+	const auto autoRadius = static_cast<float>(getAutoGuidedFilterBoxRadius(renderingContext_->subRegion_.height));
+	EXPECT_EQ(kernelSizes, (std::vector<float>{2.0f * autoRadius + 1.0f, 25.0f,
+						   2.0f * kMaxGuidedFilterBoxRadius + 1.0f,
+						   2.0f * kMinGuidedFilterBoxRadius + 1.0f, 2.0f * autoRadius + 1.0f}));
+}
+
+TEST_F(RenderingContextTest, FrameWithoutTickOnlyUploadsTheNewMaskAndDraws)
+{
+	renderFrame(false);
+	ASSERT_TRUE(waitForProcessedCount(1));
+	ObsGraphicsMock::resetCounters();
+
+	renderFrame(false);
+	ObsGraphicsMock::Counters counters = ObsGraphicsMock::getCounters();
+	EXPECT_EQ(counters.sourceRenderCount, 0u);
+	EXPECT_EQ(counters.stageCount, 0u);
+	EXPECT_EQ(counters.textureUploadCount, 1u);
+	EXPECT_EQ(counters.textureCreateCount, 0u);
+	// Mapping the mask onto the frame, then the final composite
+	EXPECT_EQ(counters.drawCount, 2u);
+	EXPECT_EQ(renderingContext_->getSegmentationMaskAge(), 0u);
+
+	ObsGraphicsMock::resetCounters();
+	renderFrame(false);
+	counters = ObsGraphicsMock::getCounters();
+	EXPECT_EQ(counters.textureUploadCount, 0u);
+	EXPECT_EQ(counters.drawCount, 1u);
+}
+
+TEST_F(RenderingContextTest, FramesPassThroughUntilTheFirstMaskArrives)
+{
+	renderFrame(true);
+	ObsGraphicsMock::Counters counters = ObsGraphicsMock::getCounters();
+	// Cropping the segmenter input, then the passthrough draw
+	EXPECT_EQ(counters.drawCountByTechnique.at("Draw"), 2u);
+	EXPECT_EQ(counters.drawCountByTechnique.count("DrawWithRefinedBlurredBackground"), 0u);
+
+	ASSERT_TRUE(waitForProcessedCount(1));
+	ObsGraphicsMock::resetCounters();
+
+	renderFrame(false);
+	counters = ObsGraphicsMock::getCounters();
+	// Only the mask mapping remains on the Draw technique once the composite takes over
+	EXPECT_EQ(counters.drawCountByTechnique.at("Draw"), 1u);
+	EXPECT_EQ(counters.drawCountByTechnique.at("DrawWithRefinedBlurredBackground"), 1u);
+}
+
+TEST_F(RenderingContextTest, RebuildAtTheSameSizeKeepsMaskingWithThePredecessorMask)
+{
+	renderFrame(true);
+	ASSERT_TRUE(waitForProcessedCount(1));
+	renderFrame(false);
+
+	std::shared_ptr<RenderingContext> successor;
+	{
+		GraphicsContextGuard graphicsContextGuard;
+		successor = makeRenderingContext(nullptr);
+	}
+	successor->applyPluginProperty(PluginProperty{});
+	successor->inheritSegmentationMask(renderingContext_);
+	renderingContext_ = successor;
+	ObsGraphicsMock::resetCounters();
+
+	renderFrame(true);
+	const ObsGraphicsMock::Counters counters = ObsGraphicsMock::getCounters();
+	// Only the segmenter input crop uses the Draw technique, as there is no passthrough draw
+	EXPECT_EQ(counters.drawCountByTechnique.at("Draw"), 1u);
+	EXPECT_EQ(counters.drawCountByTechnique.at("DrawWithRefinedBlurredBackground"), 1u);
+	EXPECT_EQ(getCenterTexel(ObsGraphicsMock::getTexture(successor->r8SegmentationMask_.get())), 1.0f);
+}
+
+TEST_F(RenderingContextTest, MaskPublishedAheadOfItsRecordIsNotMappedWithAnOlderTransform)
+{
+	renderFrame(true);
+	ASSERT_TRUE(waitForProcessedCount(1));
+	renderFrame(false);
+
+	renderingContext_->show();
+	renderFrame(true);
+	ASSERT_TRUE(waitForProcessedCount(2));
+	// A mask that no completion has described yet, as when the worker publishes before it records the transform
+	segmenter_->process(nullptr);
+	ObsGraphicsMock::resetCounters();
+
+	renderFrame(false);
+	EXPECT_EQ(ObsGraphicsMock::getCounters().textureUploadCount, 0u);
+
+	renderingContext_->show();
+	renderFrame(true);
+	ASSERT_TRUE(waitForProcessedCount(3));
+	ObsGraphicsMock::resetCounters();
+	renderFrame(false);
+	EXPECT_EQ(ObsGraphicsMock::getCounters().textureUploadCount, 1u);
+}
+
+TEST_F(RenderingContextTest, DoubleBuffersFlipOnlyOnProcessedFrames)
+{
+	EXPECT_EQ(renderingContext_->currentSubLumaIndex_, 0u);
+	EXPECT_EQ(renderingContext_->currentTimeAveragedMaskIndex_, 0u);
+
+	renderFrame(true);
+	EXPECT_EQ(renderingContext_->currentSubLumaIndex_, 1u);
+	EXPECT_EQ(renderingContext_->currentTimeAveragedMaskIndex_, 1u);
+
+	renderFrame(false);
+	EXPECT_EQ(renderingContext_->currentSubLumaIndex_, 1u);
+	EXPECT_EQ(renderingContext_->currentTimeAveragedMaskIndex_, 1u);
+
+	renderFrame(true);
+	EXPECT_EQ(renderingContext_->currentSubLumaIndex_, 0u);
+	EXPECT_EQ(renderingContext_->currentTimeAveragedMaskIndex_, 0u);
+}
+
+TEST_F(RenderingContextTest, StillFramesAreNotResubmitted)
+{
+	renderFrame(false);
+	ASSERT_TRUE(waitForProcessedCount(1));
+
+	renderFrame(true);
+	renderFrame(true);
+	EXPECT_EQ(renderingContext_->getInferenceStats().submittedCount, 1u);
+
+	setSolidFrame(128, 128, 128);
+	renderFrame(true);
+	EXPECT_EQ(renderingContext_->getInferenceStats().submittedCount, 2u);
+}
+
+TEST_F(RenderingContextTest, ShowForcesASubmission)
+{
+	renderFrame(false);
+	ASSERT_TRUE(waitForProcessedCount(1));
+
+	renderingContext_->show();
+	renderFrame(true);
+	EXPECT_EQ(renderingContext_->getInferenceStats().submittedCount, 2u);
+}
+
+TEST_F(RenderingContextTest, SegmentationLevelSubmitsEveryProcessedFrame)
+{
+	PluginProperty pluginProperty;
+	pluginProperty.filterLevel = FilterLevel::Segmentation;
+	renderingContext_->applyPluginProperty(pluginProperty);
+
+	renderFrame(true);
+	renderFrame(true);
+	renderFrame(false);
+	renderFrame(true);
+	EXPECT_EQ(renderingContext_->getInferenceStats().submittedCount, 3u);
+}
+
+TEST_F(RenderingContextTest, SegmenterInputAndLumaFollowTheFrame)
+{
+	setSolidFrame(30, 60, 90);
+	renderFrame(false);
+
+	const Texture &segmenterInput = ObsGraphicsMock::getTexture(renderingContext_->bgrxSegmenterInput_.get());
+	EXPECT_FLOAT_EQ(getCenterTexel(segmenterInput, 0), 30.0f / 255.0f);
+	EXPECT_FLOAT_EQ(getCenterTexel(segmenterInput, 1), 60.0f / 255.0f);
+	EXPECT_FLOAT_EQ(getCenterTexel(segmenterInput, 2), 90.0f / 255.0f);
+
+	const Texture &source = ObsGraphicsMock::getTexture(renderingContext_->bgrxSource_.get());
+	Texture expectedLuma(kWidth, kHeight, TextureFormat::R32F);
+	referenceEffect_.convertToLuma(expectedLuma, source);
+	const Texture &luma = ObsGraphicsMock::getTexture(renderingContext_->r32fLuma_.get());
+	EXPECT_FLOAT_EQ(getCenterTexel(luma), getCenterTexel(expectedLuma));
+}
+
+TEST_F(RenderingContextTest, CompletedMaskIsMappedOntoTheFrame)
+{
+	const Texture &mask = ObsGraphicsMock::getTexture(renderingContext_->r8SegmentationMask_.get());
+
+	renderFrame(false);
+	EXPECT_FLOAT_EQ(getCenterTexel(mask), 0.0f);
+
+	ASSERT_TRUE(waitForProcessedCount(1));
+	renderFrame(false);
+	EXPECT_FLOAT_EQ(getCenterTexel(mask), 1.0f);
+}
+
+TEST_F(RenderingContextTest, RenderingKeepsTheGraphicsStateBalanced)
+{
+	renderFrame(false);
+	ASSERT_TRUE(waitForProcessedCount(1));
+	for (int i = 0; i < 4; ++i) {
+		setSolidFrame(static_cast<std::uint8_t>(i * 60), 0, 0);
+		renderFrame(i % 2 == 0);
+	}
+
+	const ObsGraphicsMock::Counters counters = ObsGraphicsMock::getCounters();
+	EXPECT_EQ(counters.callOutsideGraphicsContextCount, 0u);
+	EXPECT_EQ(counters.unbalancedStatePopCount, 0u);
+	EXPECT_EQ(ObsGraphicsMock::getStateStackDepth(), 0u);
+
+	GraphicsContextGuard graphicsContextGuard;
+	EXPECT_EQ(gs_get_render_target(), nullptr);
+}
+
+TEST_F(RenderingContextTest, TexturesAreReleasedOnlyWhenTheQueueIsDrained)
+{
+	const std::size_t liveTextureCount = ObsGraphicsMock::getLiveTextureCount();
+	ASSERT_GT(liveTextureCount, 0u);
+
+	GraphicsContextGuard graphicsContextGuard;
+	renderingContext_.reset();
+	EXPECT_EQ(ObsGraphicsMock::getLiveTextureCount(), liveTextureCount);
+
+	ObsBridgeUtils::GsUnique::drain();
+	EXPECT_EQ(ObsGraphicsMock::getLiveTextureCount(), 0u);
+	EXPECT_EQ(ObsGraphicsMock::getLiveStagesurfCount(), 0u);
+}
+
+TEST_F(RenderingContextTest, RebuildReusesPooledTextures)
+{
+	const auto texturePool = std::make_shared<ObsBridgeUtils::GsTexturePool>(256 * 1024 * 1024);
+	ObsBridgeUtils::GsTexturePool::install(texturePool);
+	{
+		GraphicsContextGuard graphicsContextGuard;
+		renderingContext_.reset();
+		ObsBridgeUtils::GsUnique::drain();
+		renderingContext_ = makeRenderingContext(texturePool);
+	}
+	const std::uint64_t textureCount = texturePool->getStats().missCount;
+	ASSERT_GT(textureCount, 0u);
+
+	setSolidFrame(255, 255, 255);
+	renderFrame(true);
+
+	GraphicsContextGuard graphicsContextGuard;
+	renderingContext_.reset();
+	ObsBridgeUtils::GsUnique::drain();
+	EXPECT_EQ(texturePool->getStats().idleCount, textureCount);
+
+	ObsGraphicsMock::resetCounters();
+	renderingContext_ = makeRenderingContext(texturePool);
+	EXPECT_EQ(ObsGraphicsMock::getCounters().textureCreateCount, 0u);
+	EXPECT_EQ(texturePool->getStats().hitCount, textureCount);
+
+	// Reused render targets are cleared like new ones
+	const Texture &luma = ObsGraphicsMock::getTexture(renderingContext_->r32fLuma_.get());
+	EXPECT_FLOAT_EQ(getCenterTexel(luma), 0.0f);
+
+	ObsBridgeUtils::GsUnique::setTextureRecycler(nullptr);
+}
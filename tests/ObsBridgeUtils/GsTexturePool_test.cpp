@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+
+#include <KaitoTokyo/ObsBridgeUtils/GsTexturePool.hpp>
+#include <KaitoTokyo/ObsBridgeUtils/GsUnique.hpp>
+
+#include <ObsGraphicsMock.hpp>
+
+using namespace KaitoTokyo;
+using KaitoTokyo::ObsBridgeUtils::GraphicsContextGuard;
+using KaitoTokyo::ObsBridgeUtils::GsTexturePool;
+using KaitoTokyo::ObsBridgeUtils::unique_gs_texture_t;
+
+namespace {
+
+// A 16x16 R32F texture
+constexpr std::size_t kTextureBytes = 16 * 16 * 4;
+
+} // namespace
+
+class GsTexturePoolTest : public ::testing::Test {
+protected:
+	void SetUp() override { ObsGraphicsMock::reset(); }
+
+	void TearDown() override
+	{
+		ObsBridgeUtils::GsUnique::setTextureRecycler(nullptr);
+		texturePool_.reset();
+		GraphicsContextGuard graphicsContextGuard;
+		ObsBridgeUtils::GsUnique::drain();
+		EXPECT_EQ(ObsGraphicsMock::getLiveTextureCount(), 0u);
+	}
+
+	void installPool(std::size_t budgetBytes)
+	{
+		texturePool_ = std::make_shared<GsTexturePool>(budgetBytes);
+		GsTexturePool::install(texturePool_);
+	}
+
+	std::shared_ptr<GsTexturePool> texturePool_;
+};
+
+TEST_F(GsTexturePoolTest, ReleasedTextureIsReusedForTheSameKey)
+{
+	installPool(kTextureBytes * 4);
+	GraphicsContextGuard graphicsContextGuard;
+
+	unique_gs_texture_t texture = texturePool_->acquire(16, 16, GS_R32F, GS_RENDER_TARGET);
+	gs_texture_t *const rawTexture = texture.get();
+	texture.reset();
+	ObsBridgeUtils::GsUnique::drain();
+	EXPECT_EQ(ObsGraphicsMock::getLiveTextureCount(), 1u);
+
+	texture = texturePool_->acquire(16, 16, GS_R32F, GS_RENDER_TARGET);
+	EXPECT_EQ(texture.get(), rawTexture);
+
+	const GsTexturePool::Stats stats = texturePool_->getStats();
+	EXPECT_EQ(stats.hitCount, 1u);
+	EXPECT_EQ(stats.missCount, 1u);
+	EXPECT_EQ(stats.recycledCount, 1u);
+	EXPECT_EQ(stats.idleCount, 0u);
+	EXPECT_EQ(stats.outstandingCount, 1u);
+}
+
+TEST_F(GsTexturePoolTest, DifferentFormatOrFlagsDoNotMatch)
+{
+	installPool(kTextureBytes * 16);
+	GraphicsContextGuard graphicsContextGuard;
+
+	texturePool_->acquire(16, 16, GS_R32F, GS_RENDER_TARGET).reset();
+	ObsBridgeUtils::GsUnique::drain();
+
+	const unique_gs_texture_t r8Texture = texturePool_->acquire(16, 16, GS_R8, GS_RENDER_TARGET);
+	const unique_gs_texture_t dynamicTexture = texturePool_->acquire(16, 16, GS_R32F, GS_DYNAMIC);
+	const unique_gs_texture_t largerTexture = texturePool_->acquire(32, 16, GS_R32F, GS_RENDER_TARGET);
+
+	const GsTexturePool::Stats stats = texturePool_->getStats();
+	EXPECT_EQ(stats.hitCount, 0u);
+	EXPECT_EQ(stats.missCount, 4u);
+	EXPECT_EQ(stats.idleCount, 1u);
+	EXPECT_EQ(stats.idleBytes, kTextureBytes);
+}
+
+TEST_F(GsTexturePoolTest, LeastRecentlyReleasedTexturesAreEvictedOverBudget)
+{
+	installPool(kTextureBytes * 2);
+	GraphicsContextGuard graphicsContextGuard;
+
+	unique_gs_texture_t first = texturePool_->acquire(16, 16, GS_R32F, GS_RENDER_TARGET);
+	unique_gs_texture_t second = texturePool_->acquire(16, 16, GS_R32F, GS_RENDER_TARGET);
+	unique_gs_texture_t third = texturePool_->acquire(16, 16, GS_R32F, GS_RENDER_TARGET);
+	gs_texture_t *const rawThird = third.get();
+
+	first.reset();
+	second.reset();
+	third.reset();
+	ObsBridgeUtils::GsUnique::drain();
+
+	GsTexturePool::Stats stats = texturePool_->getStats();
+	EXPECT_EQ(stats.evictedCount, 1u);
+	EXPECT_EQ(stats.idleCount, 2u);
+	EXPECT_EQ(stats.idleBytes, kTextureBytes * 2);
+
+	// Evicted textures go through the deletion queue as well
+	EXPECT_EQ(ObsGraphicsMock::getLiveTextureCount(), 3u);
+	ObsBridgeUtils::GsUnique::drain();
+	EXPECT_EQ(ObsGraphicsMock::getLiveTextureCount(), 2u);
+
+	const unique_gs_texture_t reused = texturePool_->acquire(16, 16, GS_R32F, GS_RENDER_TARGET);
+	EXPECT_EQ(reused.get(), rawThird);
+
+	texturePool_->trim(0);
+	ObsBridgeUtils::GsUnique::drain();
+	stats = texturePool_->getStats();
+	EXPECT_EQ(stats.idleCount, 0u);
+	EXPECT_EQ(ObsGraphicsMock::getLiveTextureCount(), 1u);
+}
+
+TEST_F(GsTexturePoolTest, TexturesFromElsewhereAreDestroyed)
+{
+	installPool(kTextureBytes * 4);
+	GraphicsContextGuard graphicsContextGuard;
+
+	unique_gs_texture_t texture =
+		ObsBridgeUtils::make_unique_gs_texture(16, 16, GS_R32F, 1, nullptr, GS_RENDER_TARGET);
+	texture.reset();
+	ObsBridgeUtils::GsUnique::drain();
+
+	EXPECT_EQ(ObsGraphicsMock::getLiveTextureCount(), 0u);
+	EXPECT_EQ(texturePool_->getStats().recycledCount, 0u);
+}
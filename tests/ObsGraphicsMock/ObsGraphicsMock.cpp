@@ -0,0 +1,981 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ObsGraphicsMock.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <ReferenceMainEffect.hpp>
+
+using KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect::ReferenceMainEffect;
+using KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect::Texture;
+using KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect::TextureFormat;
+
+struct gs_texture {
+	Texture texture;
+	enum gs_color_format format;
+	std::uint32_t flags;
+	std::array<float, 4> clearColor{0.0f, 0.0f, 0.0f, 1.0f};
+};
+
+struct gs_stage_surface {
+	std::uint32_t width;
+	std::uint32_t height;
+	enum gs_color_format format;
+	std::uint32_t linesize;
+	std::vector<std::uint8_t> data;
+	bool isMapped = false;
+};
+
+struct gs_effect_param {
+	std::string name;
+	gs_texture *texture = nullptr;
+	std::optional<float> value;
+};
+
+struct gs_effect_technique {
+	gs_effect *effect;
+	std::string name;
+	std::size_t passCount;
+	std::optional<std::size_t> currentPass;
+};
+
+struct gs_effect {
+	std::map<std::string, std::unique_ptr<gs_effect_param>> params;
+	std::map<std::string, std::unique_ptr<gs_effect_technique>> techniques;
+	gs_effect_technique *loopTechnique = nullptr;
+	std::size_t loopPass = 0;
+};
+
+struct gs_timer {};
+
+struct gs_timer_range {};
+
+struct obs_source {
+	std::string name;
+	std::uint32_t width;
+	std::uint32_t height;
+	obs_source *filterTarget = nullptr;
+	std::optional<Texture> frame;
+};
+
+namespace KaitoTokyo::ObsGraphicsMock {
+
+namespace {
+
+struct State {
+	std::recursive_mutex mutex;
+	Counters counters;
+
+	std::unordered_set<gs_texture *> liveTextures;
+	std::unordered_set<gs_effect *> liveEffects;
+	std::size_t liveStagesurfCount = 0;
+
+	std::vector<std::unique_ptr<obs_source>> sources;
+	std::map<std::string, DrawHandler> drawHandlers;
+
+	gs_texture *renderTarget = nullptr;
+	gs_zstencil_t *zstencilTarget = nullptr;
+	enum gs_color_space colorSpace = GS_CS_SRGB;
+	gs_effect_technique *activeTechnique = nullptr;
+
+	std::size_t viewportDepth = 0;
+	std::size_t projectionDepth = 0;
+	std::size_t blendDepth = 0;
+	std::array<float, 2> translate{0.0f, 0.0f};
+	std::vector<std::array<float, 2>> matrixStack;
+};
+
+State &getState()
+{
+	static State state;
+	return state;
+}
+
+std::recursive_mutex &getGraphicsMutex()
+{
+	static std::recursive_mutex mutex;
+	return mutex;
+}
+
+thread_local int graphicsDepth = 0;
+
+/**
+ * @brief Locks the mock state for one gs_ call and records whether the caller holds the graphics context.
+ */
+std::unique_lock<std::recursive_mutex> enterCall()
+{
+	State &state = getState();
+	std::unique_lock lock(state.mutex);
+	if (graphicsDepth == 0) {
+		++state.counters.callOutsideGraphicsContextCount;
+	}
+	return lock;
+}
+
+void popStateStack(std::size_t &depth)
+{
+	if (depth == 0) {
+		++getState().counters.unbalancedStatePopCount;
+	} else {
+		--depth;
+	}
+}
+
+std::optional<TextureFormat> toTextureFormat(enum gs_color_format format) noexcept
+{
+	switch (format) {
+	case GS_BGRA:
+		return TextureFormat::BGRA;
+	case GS_BGRX:
+		return TextureFormat::BGRX;
+	case GS_R8:
+		return TextureFormat::R8;
+	case GS_R32F:
+		return TextureFormat::R32F;
+	case GS_RGBA32F:
+		return TextureFormat::RGBA32F;
+	default:
+		return std::nullopt;
+	}
+}
+
+std::uint32_t getBytesPerPixel(enum gs_color_format format) noexcept
+{
+	switch (format) {
+	case GS_R8:
+		return 1;
+	case GS_RGBA32F:
+		return 16;
+	default:
+		return 4;
+	}
+}
+
+bool isIdentifierChar(char c) noexcept
+{
+	return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+std::vector<std::string> tokenize(const std::string &text)
+{
+	std::vector<std::string> tokens;
+	std::size_t i = 0;
+	while (i < text.size()) {
+		if (text.compare(i, 2, "//") == 0) {
+			i = text.find('\n', i);
+		} else if (text.compare(i, 2, "/*") == 0) {
+			i = text.find("*/", i + 2);
+			i = i == std::string::npos ? i : i + 2;
+		} else if (isIdentifierChar(text[i])) {
+			std::size_t end = i;
+			while (end < text.size() && isIdentifierChar(text[end])) {
+				++end;
+			}
+			tokens.push_back(text.substr(i, end - i));
+			i = end;
+		} else {
+			if (!std::isspace(static_cast<unsigned char>(text[i]))) {
+				tokens.emplace_back(1, text[i]);
+			}
+			++i;
+		}
+	}
+	return tokens;
+}
+
+/**
+ * @brief Collects the uniforms and the passes of each technique, which is all the mock needs from an effect.
+ */
+std::unique_ptr<gs_effect> parseEffect(const std::string &text)
+{
+	const std::vector<std::string> tokens = tokenize(text);
+	auto effect = std::make_unique<gs_effect>();
+
+	for (std::size_t i = 0; i < tokens.size(); ++i) {
+		if (tokens[i] == "uniform" && i + 2 < tokens.size()) {
+			const std::string &name = tokens[i + 2];
+			auto param = std::make_unique<gs_effect_param>(gs_effect_param{name, nullptr, std::nullopt});
+			effect->params.emplace(name, std::move(param));
+			i += 2;
+		} else if (tokens[i] == "technique" && i + 1 < tokens.size()) {
+			const std::string &name = tokens[i + 1];
+			std::size_t passCount = 0;
+			int depth = 0;
+			std::size_t j = i + 2;
+			for (; j < tokens.size(); ++j) {
+				if (tokens[j] == "{") {
+					++depth;
+				} else if (tokens[j] == "}") {
+					if (--depth == 0) {
+						break;
+					}
+				} else if (depth == 1 && tokens[j] == "pass") {
+					++passCount;
+				}
+			}
+			auto technique = std::make_unique<gs_effect_technique>(
+				gs_effect_technique{effect.get(), name, passCount, std::nullopt});
+			effect->techniques.emplace(name, std::move(technique));
+			i = j;
+		}
+	}
+
+	return effect;
+}
+
+char *duplicateString(const std::string &text)
+{
+	return static_cast<char *>(bmemdup(text.c_str(), text.size() + 1));
+}
+
+} // anonymous namespace
+
+const Texture &DrawCall::getTexture(const std::string &name) const
+{
+	const auto it = textures.find(name);
+	if (it == textures.end()) {
+		throw std::out_of_range("TextureNotBoundError(DrawCall::getTexture): " + name);
+	}
+	return *it->second;
+}
+
+void reset()
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	state.counters = Counters{};
+	state.sources.clear();
+	state.drawHandlers.clear();
+	state.renderTarget = nullptr;
+	state.zstencilTarget = nullptr;
+	state.colorSpace = GS_CS_SRGB;
+	state.activeTechnique = nullptr;
+	state.viewportDepth = 0;
+	state.projectionDepth = 0;
+	state.blendDepth = 0;
+	state.translate = {0.0f, 0.0f};
+	state.matrixStack.clear();
+}
+
+Counters getCounters()
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	return state.counters;
+}
+
+void resetCounters()
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	state.counters = Counters{};
+}
+
+std::size_t getLiveTextureCount()
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	return state.liveTextures.size();
+}
+
+std::size_t getLiveStagesurfCount()
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	return state.liveStagesurfCount;
+}
+
+std::size_t getStateStackDepth()
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	return state.viewportDepth + state.projectionDepth + state.matrixStack.size() + state.blendDepth;
+}
+
+Texture &getTexture(gs_texture_t *texture)
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	if (!texture || !state.liveTextures.contains(texture)) {
+		throw std::invalid_argument("TextureIsNotAliveError(ObsGraphicsMock::getTexture)");
+	}
+	return texture->texture;
+}
+
+obs_source_t *createSource(const std::string &name, std::uint32_t width, std::uint32_t height)
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	state.sources.push_back(std::make_unique<obs_source>(obs_source{name, width, height, nullptr, std::nullopt}));
+	return state.sources.back().get();
+}
+
+void setFilterTarget(obs_source_t *filter, obs_source_t *target)
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	filter->filterTarget = target;
+}
+
+void setSourceFrame(obs_source_t *source, const std::uint8_t *bgra, std::uint32_t linesize)
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	source->frame.emplace(source->width, source->height, TextureFormat::BGRA);
+	source->frame->setImage(bgra, linesize);
+}
+
+void setDrawHandler(const std::string &technique, DrawHandler handler)
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	state.drawHandlers[technique] = std::move(handler);
+}
+
+void installReferenceHandlers(const ReferenceMainEffect &referenceEffect)
+{
+	const ReferenceMainEffect *reference = &referenceEffect;
+
+	// Draws to the output of the filter have no target to write to
+	setDrawHandler("Draw", [reference](const DrawCall &call) {
+		if (call.target) {
+			reference->drawRoi(*call.target, call.getTexture("image"), call.targetClearColor, call.width,
+					   call.height, call.translateX, call.translateY);
+		}
+	});
+	setDrawHandler("ConvertToGrayscale", [reference](const DrawCall &call) {
+		reference->convertToLuma(*call.target, call.getTexture("image"));
+	});
+	setDrawHandler("ResampleByNearestR8", [reference](const DrawCall &call) {
+		reference->resampleByNearestR8(*call.target, call.getTexture("image"));
+	});
+	setDrawHandler("CalculateSquaredMotion", [reference](const DrawCall &call) {
+		reference->calculateSquaredMotion(*call.target, call.getTexture("image"), call.getTexture("image1"));
+	});
+	setDrawHandler("Reduce", [reference](const DrawCall &call) {
+		std::vector<Texture> level;
+		level.emplace_back(call.target->getWidth(), call.target->getHeight(), call.target->getFormat());
+		reference->reduce(level, call.getTexture("image"));
+		*call.target = std::move(level.front());
+	});
+	setDrawHandler("FinalizeGuidedFilter", [reference](const DrawCall &call) {
+		reference->finalizeGuidedFilter(*call.target, call.getTexture("image"), call.getTexture("image1"),
+						call.getTexture("image2"));
+	});
+	setDrawHandler("TimeAveragedFilter", [reference](const DrawCall &call) {
+		reference->timeAveragedFiltering(*call.target, call.getTexture("image1"), call.getTexture("image"),
+						 call.getFloat("alpha"));
+	});
+}
+
+} // namespace KaitoTokyo::ObsGraphicsMock
+
+using namespace KaitoTokyo::ObsGraphicsMock;
+
+extern "C" {
+
+void *bmalloc(size_t size)
+{
+	return std::malloc(size > 0 ? size : 1);
+}
+
+void bfree(void *ptr)
+{
+	std::free(ptr);
+}
+
+void *bmemdup(const void *ptr, size_t size)
+{
+	void *out = bmalloc(size);
+	if (size > 0) {
+		std::memcpy(out, ptr, size);
+	}
+	return out;
+}
+
+void obs_enter_graphics(void)
+{
+	getGraphicsMutex().lock();
+	++graphicsDepth;
+}
+
+void obs_leave_graphics(void)
+{
+	--graphicsDepth;
+	getGraphicsMutex().unlock();
+}
+
+gs_effect_t *gs_effect_create_from_file(const char *file, char **error_string)
+{
+	const auto lock = enterCall();
+
+	std::ifstream stream(file ? file : "", std::ios::binary);
+	if (!stream) {
+		if (error_string) {
+			*error_string = duplicateString(std::string("Could not open ") + (file ? file : "(null)"));
+		}
+		return nullptr;
+	}
+
+	const std::string text((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	gs_effect *effect = parseEffect(text).release();
+	getState().liveEffects.insert(effect);
+	++getState().counters.effectCreateCount;
+	return effect;
+}
+
+void gs_effect_destroy(gs_effect_t *effect)
+{
+	const auto lock = enterCall();
+	if (effect) {
+		getState().liveEffects.erase(effect);
+		delete effect;
+	}
+}
+
+gs_eparam_t *gs_effect_get_param_by_name(const gs_effect_t *effect, const char *name)
+{
+	const auto lock = enterCall();
+	if (!effect || !name) {
+		return nullptr;
+	}
+	const auto it = effect->params.find(name);
+	return it != effect->params.end() ? it->second.get() : nullptr;
+}
+
+gs_technique_t *gs_effect_get_technique(const gs_effect_t *effect, const char *name)
+{
+	const auto lock = enterCall();
+	if (!effect || !name) {
+		return nullptr;
+	}
+	const auto it = effect->techniques.find(name);
+	return it != effect->techniques.end() ? it->second.get() : nullptr;
+}
+
+size_t gs_technique_begin(gs_technique_t *technique)
+{
+	const auto lock = enterCall();
+	if (!technique) {
+		return 0;
+	}
+	getState().activeTechnique = technique;
+	technique->currentPass.reset();
+	return technique->passCount;
+}
+
+void gs_technique_end(gs_technique_t *technique)
+{
+	const auto lock = enterCall();
+	if (getState().activeTechnique == technique) {
+		getState().activeTechnique = nullptr;
+	}
+}
+
+bool gs_technique_begin_pass(gs_technique_t *technique, size_t pass)
+{
+	const auto lock = enterCall();
+	if (!technique || pass >= technique->passCount) {
+		return false;
+	}
+	technique->currentPass = pass;
+	return true;
+}
+
+void gs_technique_end_pass(gs_technique_t *technique)
+{
+	const auto lock = enterCall();
+	if (technique) {
+		technique->currentPass.reset();
+	}
+}
+
+bool gs_effect_loop(gs_effect_t *effect, const char *name)
+{
+	const auto lock = enterCall();
+	if (!effect) {
+		return false;
+	}
+
+	// Same protocol as libobs: begin the technique on the first call, then advance one pass per call
+	if (!effect->loopTechnique) {
+		gs_technique_t *technique = gs_effect_get_technique(effect, name);
+		if (!technique) {
+			return false;
+		}
+		gs_technique_begin(technique);
+		effect->loopTechnique = technique;
+		effect->loopPass = 0;
+	} else {
+		gs_technique_end_pass(effect->loopTechnique);
+	}
+
+	if (!gs_technique_begin_pass(effect->loopTechnique, effect->loopPass++)) {
+		gs_technique_end(effect->loopTechnique);
+		effect->loopTechnique = nullptr;
+		effect->loopPass = 0;
+		return false;
+	}
+	return true;
+}
+
+void gs_effect_set_texture(gs_eparam_t *param, gs_texture_t *val)
+{
+	const auto lock = enterCall();
+	if (param) {
+		param->texture = val;
+	}
+}
+
+void gs_effect_set_float(gs_eparam_t *param, float val)
+{
+	const auto lock = enterCall();
+	if (param) {
+		param->value = val;
+	}
+}
+
+void gs_effect_set_int(gs_eparam_t *param, int val)
+{
+	const auto lock = enterCall();
+	if (param) {
+		param->value = static_cast<float>(val);
+	}
+}
+
+gs_texture_t *gs_texture_create(uint32_t width, uint32_t height, enum gs_color_format color_format, uint32_t,
+				const uint8_t **data, uint32_t flags)
+{
+	const auto lock = enterCall();
+	const std::optional<TextureFormat> format = toTextureFormat(color_format);
+	if (!format || width == 0 || height == 0) {
+		return nullptr;
+	}
+
+	auto *texture = new gs_texture{Texture(width, height, *format), color_format, flags};
+	if (data && data[0]) {
+		texture->texture.setImage(data[0], width * getBytesPerPixel(color_format));
+	}
+
+	getState().liveTextures.insert(texture);
+	++getState().counters.textureCreateCount;
+	return texture;
+}
+
+void gs_texture_destroy(gs_texture_t *tex)
+{
+	const auto lock = enterCall();
+	if (!tex) {
+		return;
+	}
+
+	// Unbind it everywhere so that a texture later allocated at the same address is never mistaken for it
+	State &state = getState();
+	for (gs_effect *effect : state.liveEffects) {
+		for (auto &[name, param] : effect->params) {
+			if (param->texture == tex) {
+				param->texture = nullptr;
+			}
+		}
+	}
+	if (state.renderTarget == tex) {
+		state.renderTarget = nullptr;
+	}
+
+	state.liveTextures.erase(tex);
+	delete tex;
+	++state.counters.textureDestroyCount;
+}
+
+uint32_t gs_texture_get_width(const gs_texture_t *tex)
+{
+	const auto lock = enterCall();
+	return tex ? tex->texture.getWidth() : 0;
+}
+
+uint32_t gs_texture_get_height(const gs_texture_t *tex)
+{
+	const auto lock = enterCall();
+	return tex ? tex->texture.getHeight() : 0;
+}
+
+void gs_texture_set_image(gs_texture_t *tex, const uint8_t *data, uint32_t linesize, bool invert)
+{
+	const auto lock = enterCall();
+	if (!tex || !data) {
+		return;
+	}
+
+	if (invert) {
+		const std::uint32_t height = tex->texture.getHeight();
+		std::vector<std::uint8_t> flipped(static_cast<std::size_t>(linesize) * height);
+		for (std::uint32_t y = 0; y < height; ++y) {
+			std::memcpy(flipped.data() + static_cast<std::size_t>(y) * linesize,
+				    data + static_cast<std::size_t>(height - 1 - y) * linesize, linesize);
+		}
+		tex->texture.setImage(flipped.data(), linesize);
+	} else {
+		tex->texture.setImage(data, linesize);
+	}
+	++getState().counters.textureUploadCount;
+}
+
+gs_stagesurf_t *gs_stagesurface_create(uint32_t width, uint32_t height, enum gs_color_format color_format)
+{
+	const auto lock = enterCall();
+	if (!toTextureFormat(color_format) || width == 0 || height == 0) {
+		return nullptr;
+	}
+
+	const std::uint32_t linesize = width * getBytesPerPixel(color_format);
+	auto *stagesurf = new gs_stage_surface{width, height, color_format, linesize,
+					       std::vector<std::uint8_t>(static_cast<std::size_t>(linesize) * height)};
+	++getState().liveStagesurfCount;
+	++getState().counters.stagesurfCreateCount;
+	return stagesurf;
+}
+
+void gs_stagesurface_destroy(gs_stagesurf_t *stagesurf)
+{
+	const auto lock = enterCall();
+	if (stagesurf) {
+		delete stagesurf;
+		--getState().liveStagesurfCount;
+		++getState().counters.stagesurfDestroyCount;
+	}
+}
+
+bool gs_stagesurface_map(gs_stagesurf_t *stagesurf, uint8_t **data, uint32_t *linesize)
+{
+	const auto lock = enterCall();
+	if (!stagesurf || stagesurf->isMapped) {
+		return false;
+	}
+	stagesurf->isMapped = true;
+	*data = stagesurf->data.data();
+	*linesize = stagesurf->linesize;
+	++getState().counters.mapCount;
+	return true;
+}
+
+void gs_stagesurface_unmap(gs_stagesurf_t *stagesurf)
+{
+	const auto lock = enterCall();
+	if (stagesurf) {
+		stagesurf->isMapped = false;
+	}
+}
+
+void gs_stage_texture(gs_stagesurf_t *dst, gs_texture_t *src)
+{
+	const auto lock = enterCall();
+	if (!dst || !src || dst->width != src->texture.getWidth() || dst->height != src->texture.getHeight() ||
+	    dst->format != src->format) {
+		return;
+	}
+	src->texture.getImage(dst->data.data(), dst->linesize);
+	++getState().counters.stageCount;
+}
+
+void gs_copy_texture(gs_texture_t *dst, gs_texture_t *src)
+{
+	const auto lock = enterCall();
+	if (!dst || !src || dst->texture.getWidth() != src->texture.getWidth() ||
+	    dst->texture.getHeight() != src->texture.getHeight() || dst->format != src->format) {
+		return;
+	}
+	dst->texture = src->texture;
+	++getState().counters.textureCopyCount;
+}
+
+void gs_clear(uint32_t clear_flags, const struct vec4 *color, float, uint8_t)
+{
+	const auto lock = enterCall();
+	State &state = getState();
+	++state.counters.clearCount;
+	if ((clear_flags & GS_CLEAR_COLOR) && color && state.renderTarget) {
+		const std::array<float, 4> rgba{color->ptr[0], color->ptr[1], color->ptr[2], color->ptr[3]};
+		state.renderTarget->texture.clear(rgba);
+		state.renderTarget->clearColor = rgba;
+	}
+}
+
+void gs_draw_sprite(gs_texture_t *tex, uint32_t, uint32_t width, uint32_t height)
+{
+	const auto lock = enterCall();
+	State &state = getState();
+
+	gs_effect_technique *const technique = state.activeTechnique;
+	const std::string techniqueName = technique ? technique->name : std::string();
+	++state.counters.drawCount;
+	++state.counters.drawCountByTechnique[techniqueName];
+
+	const auto handler = state.drawHandlers.find(techniqueName);
+	if (handler == state.drawHandlers.end()) {
+		return;
+	}
+
+	DrawCall call{
+		techniqueName,
+		technique ? technique->currentPass.value_or(0) : 0,
+		state.renderTarget ? &state.renderTarget->texture : nullptr,
+		state.renderTarget ? state.renderTarget->clearColor : std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f},
+		width > 0 ? width : (tex ? tex->texture.getWidth() : 0),
+		height > 0 ? height : (tex ? tex->texture.getHeight() : 0),
+		{},
+		{},
+		state.translate[0],
+		state.translate[1],
+	};
+	if (technique) {
+		for (const auto &[name, param] : technique->effect->params) {
+			if (param->texture) {
+				call.textures.emplace(name, &param->texture->texture);
+			}
+			if (param->value) {
+				call.floats.emplace(name, *param->value);
+			}
+		}
+	}
+
+	handler->second(call);
+	if (state.renderTarget) {
+		state.renderTarget->texture.resolve();
+	}
+}
+
+gs_texture_t *gs_get_render_target(void)
+{
+	const auto lock = enterCall();
+	return getState().renderTarget;
+}
+
+gs_zstencil_t *gs_get_zstencil_target(void)
+{
+	const auto lock = enterCall();
+	return getState().zstencilTarget;
+}
+
+enum gs_color_space gs_get_color_space(void)
+{
+	const auto lock = enterCall();
+	return getState().colorSpace;
+}
+
+void gs_set_render_target_with_color_space(gs_texture_t *tex, gs_zstencil_t *zstencil, enum gs_color_space space)
+{
+	const auto lock = enterCall();
+	State &state = getState();
+	state.renderTarget = tex;
+	state.zstencilTarget = zstencil;
+	state.colorSpace = space;
+}
+
+void gs_viewport_push(void)
+{
+	const auto lock = enterCall();
+	++getState().viewportDepth;
+}
+
+void gs_viewport_pop(void)
+{
+	const auto lock = enterCall();
+	popStateStack(getState().viewportDepth);
+}
+
+void gs_projection_push(void)
+{
+	const auto lock = enterCall();
+	++getState().projectionDepth;
+}
+
+void gs_projection_pop(void)
+{
+	const auto lock = enterCall();
+	popStateStack(getState().projectionDepth);
+}
+
+void gs_matrix_push(void)
+{
+	const auto lock = enterCall();
+	State &state = getState();
+	state.matrixStack.push_back(state.translate);
+}
+
+void gs_matrix_pop(void)
+{
+	const auto lock = enterCall();
+	State &state = getState();
+	if (state.matrixStack.empty()) {
+		++state.counters.unbalancedStatePopCount;
+		return;
+	}
+	state.translate = state.matrixStack.back();
+	state.matrixStack.pop_back();
+}
+
+void gs_matrix_identity(void)
+{
+	const auto lock = enterCall();
+	getState().translate = {0.0f, 0.0f};
+}
+
+void gs_matrix_translate3f(float x, float y, float)
+{
+	const auto lock = enterCall();
+	State &state = getState();
+	state.translate[0] += x;
+	state.translate[1] += y;
+}
+
+void gs_set_viewport(int, int, int, int)
+{
+	const auto lock = enterCall();
+}
+
+void gs_ortho(float, float, float, float, float, float)
+{
+	const auto lock = enterCall();
+}
+
+void gs_blend_state_push(void)
+{
+	const auto lock = enterCall();
+	++getState().blendDepth;
+}
+
+void gs_blend_state_pop(void)
+{
+	const auto lock = enterCall();
+	popStateStack(getState().blendDepth);
+}
+
+void gs_blend_function(enum gs_blend_type, enum gs_blend_type)
+{
+	const auto lock = enterCall();
+}
+
+gs_timer_t *gs_timer_create(void)
+{
+	const auto lock = enterCall();
+	++getState().counters.timerCreateCount;
+	return new gs_timer;
+}
+
+void gs_timer_destroy(gs_timer_t *timer)
+{
+	const auto lock = enterCall();
+	delete timer;
+}
+
+void gs_timer_begin(gs_timer_t *)
+{
+	const auto lock = enterCall();
+}
+
+void gs_timer_end(gs_timer_t *)
+{
+	const auto lock = enterCall();
+}
+
+bool gs_timer_get_data(gs_timer_t *timer, uint64_t *ticks)
+{
+	const auto lock = enterCall();
+	if (!timer) {
+		return false;
+	}
+	*ticks = 0;
+	return true;
+}
+
+gs_timer_range_t *gs_timer_range_create(void)
+{
+	const auto lock = enterCall();
+	return new gs_timer_range;
+}
+
+void gs_timer_range_destroy(gs_timer_range_t *range)
+{
+	const auto lock = enterCall();
+	delete range;
+}
+
+void gs_timer_range_begin(gs_timer_range_t *)
+{
+	const auto lock = enterCall();
+}
+
+void gs_timer_range_end(gs_timer_range_t *)
+{
+	const auto lock = enterCall();
+}
+
+bool gs_timer_range_get_data(gs_timer_range_t *range, bool *disjoint, uint64_t *frequency)
+{
+	const auto lock = enterCall();
+	if (!range) {
+		return false;
+	}
+	*disjoint = false;
+	*frequency = 1000000000;
+	return true;
+}
+
+obs_source_t *obs_filter_get_target(const obs_source_t *filter)
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	return filter ? filter->filterTarget : nullptr;
+}
+
+const char *obs_source_get_name(const obs_source_t *source)
+{
+	State &state = getState();
+	std::lock_guard lock(state.mutex);
+	return source ? source->name.c_str() : nullptr;
+}
+
+void obs_source_video_render(obs_source_t *source)
+{
+	const auto lock = enterCall();
+	State &state = getState();
+	++state.counters.sourceRenderCount;
+	if (!source || !source->frame || !state.renderTarget) {
+		return;
+	}
+
+	// Like a source without scaling, the frame lands at the origin and is cropped to the target
+	const Texture &frame = *source->frame;
+	Texture &target = state.renderTarget->texture;
+	const std::uint32_t width = std::min(frame.getWidth(), target.getWidth());
+	const std::uint32_t height = std::min(frame.getHeight(), target.getHeight());
+	const std::uint32_t channelCount = target.getChannelCount();
+	for (std::uint32_t y = 0; y < height; ++y) {
+		const float *src = frame.getRow(y);
+		float *dst = target.getRow(y);
+		for (std::uint32_t x = 0; x < width; ++x) {
+			if (channelCount == 4) {
+				std::copy(src + x * 4, src + x * 4 + 4, dst + x * 4);
+			} else {
+				dst[x] = src[x * 4 + Texture::getRedChannel(TextureFormat::BGRA)];
+			}
+		}
+	}
+	target.resolve();
+}
+
+} // extern "C"
@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+#include <obs.h>
+
+#include <Texture.hpp>
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect {
+class ReferenceMainEffect;
+}
+
+/**
+ * @brief A link-time stand-in for the part of the libobs graphics API the plugin uses, backed by CPU textures.
+ *
+ * Linking this library instead of libobs lets RenderingContext, MainEffect, AsyncTextureReader and GsUnique
+ * run in tests without a GPU. Effect files are parsed for their uniforms and the passes of each technique, so
+ * unknown names fail the same way they do in libobs. Textures are ReferenceEffect::Texture, staging surfaces
+ * copy them out like the GPU would, and obs_source_video_render draws a frame set with setSourceFrame. Draws do
+ * not touch any pixels unless a handler is registered for their technique; installReferenceHandlers wires the
+ * techniques that have a CPU reference per pass.
+ *
+ * Every call is counted so that tests can assert how many textures a frame allocates, uploads, copies and
+ * draws. Like libobs, the state is global and only valid between obs_enter_graphics and obs_leave_graphics.
+ */
+namespace KaitoTokyo::ObsGraphicsMock {
+
+/**
+ * @brief Calls made since the last resetCounters.
+ */
+struct Counters {
+	std::uint64_t textureCreateCount = 0;
+	std::uint64_t textureDestroyCount = 0;
+	std::uint64_t stagesurfCreateCount = 0;
+	std::uint64_t stagesurfDestroyCount = 0;
+	std::uint64_t effectCreateCount = 0;
+	std::uint64_t timerCreateCount = 0;
+	/// gs_texture_set_image calls, which upload from the CPU.
+	std::uint64_t textureUploadCount = 0;
+	/// gs_copy_texture calls.
+	std::uint64_t textureCopyCount = 0;
+	/// gs_stage_texture calls, which copy a texture into a staging surface.
+	std::uint64_t stageCount = 0;
+	std::uint64_t mapCount = 0;
+	std::uint64_t clearCount = 0;
+	std::uint64_t drawCount = 0;
+	std::uint64_t sourceRenderCount = 0;
+	/// Pops of a viewport, projection, matrix or blend state stack that was already empty.
+	std::uint64_t unbalancedStatePopCount = 0;
+	/// gs_ calls made without holding the graphics context, which libobs would reject or crash on.
+	std::uint64_t callOutsideGraphicsContextCount = 0;
+	std::map<std::string, std::uint64_t> drawCountByTechnique;
+};
+
+/**
+ * @brief The state of one gs_draw_sprite call, as seen by a draw handler.
+ */
+struct DrawCall {
+	std::string technique;
+	std::size_t pass;
+	/// The render target, or nullptr when drawing to the output of the filter.
+	LiveBackgroundRemovalLite::ReferenceEffect::Texture *target;
+	/// The color the target was last cleared to, in RGBA order.
+	std::array<float, 4> targetClearColor;
+	/// The sprite size, which defaults to the size of the texture passed to gs_draw_sprite.
+	std::uint32_t width;
+	std::uint32_t height;
+	std::map<std::string, const LiveBackgroundRemovalLite::ReferenceEffect::Texture *> textures;
+	/// The scalar parameters by name, with those set by gs_effect_set_int converted to float.
+	std::map<std::string, float> floats;
+	float translateX;
+	float translateY;
+
+	/**
+	 * @throw std::out_of_range If no texture is bound to @p name.
+	 */
+	const LiveBackgroundRemovalLite::ReferenceEffect::Texture &getTexture(const std::string &name) const;
+
+	/**
+	 * @throw std::out_of_range If @p name has not been set.
+	 */
+	float getFloat(const std::string &name) const { return floats.at(name); }
+};
+
+using DrawHandler = std::function<void(const DrawCall &)>;
+
+/**
+ * @brief Forgets all sources and handlers and zeroes the counters.
+ *
+ * Graphics objects that are still alive stay valid, so reset can run between tests that leak on purpose.
+ */
+void reset();
+
+Counters getCounters();
+void resetCounters();
+
+std::size_t getLiveTextureCount();
+std::size_t getLiveStagesurfCount();
+
+/**
+ * @brief Returns the depth of the viewport, projection, matrix and blend state stacks, which is 0 when balanced.
+ */
+std::size_t getStateStackDepth();
+
+/**
+ * @brief Returns the CPU texture behind @p texture.
+ */
+LiveBackgroundRemovalLite::ReferenceEffect::Texture &getTexture(gs_texture_t *texture);
+
+/**
+ * @brief Creates a source owned by the mock. It stays valid until reset.
+ */
+obs_source_t *createSource(const std::string &name, std::uint32_t width, std::uint32_t height);
+
+/**
+ * @brief Makes @p target what obs_filter_get_target returns for @p filter.
+ */
+void setFilterTarget(obs_source_t *filter, obs_source_t *target);
+
+/**
+ * @brief Sets the frame that obs_source_video_render draws for @p source.
+ *
+ * @param bgra width * height BGRA pixels with rows @p linesize bytes apart.
+ */
+void setSourceFrame(obs_source_t *source, const std::uint8_t *bgra, std::uint32_t linesize);
+
+/**
+ * @brief Runs @p handler on every draw with @p technique, in place of the GPU.
+ */
+void setDrawHandler(const std::string &technique, DrawHandler handler);
+
+/**
+ * @brief Wires the techniques that map one-to-one onto a ReferenceMainEffect method.
+ *
+ * These are Draw into a texture, ConvertToGrayscale, ResampleByNearestR8, CalculateSquaredMotion, Reduce,
+ * FinalizeGuidedFilter and TimeAveragedFilter, which is enough to run motion detection and the segmenter
+ * input for real. The box filters, the guided filter coefficients and the blur only have a reference for the
+ * whole operation and keep drawing nothing. @p referenceEffect must outlive the handlers.
+ */
+void installReferenceHandlers(const LiveBackgroundRemovalLite::ReferenceEffect::ReferenceMainEffect &referenceEffect);
+
+} // namespace KaitoTokyo::ObsGraphicsMock
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <KaitoTokyo/Profiling/LatencyHistogram.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace KaitoTokyo::Profiling;
+using namespace std::chrono_literals;
+
+TEST(LatencyHistogramTest, BucketsAreContiguousAndIncreasing)
+{
+	for (std::size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+		const std::uint64_t lower = LatencyHistogram::getBucketLowerBound(i);
+		const std::uint64_t upper = LatencyHistogram::getBucketLowerBound(i + 1);
+		ASSERT_LT(lower, upper) << "bucket " << i;
+		EXPECT_EQ(LatencyHistogram::getBucketIndex(lower), i);
+		EXPECT_EQ(LatencyHistogram::getBucketIndex(upper - 1), i);
+	}
+}
+
+TEST(LatencyHistogramTest, HugeDurationsLandInTheLastBucket)
+{
+	EXPECT_EQ(LatencyHistogram::getBucketIndex(UINT64_MAX), LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(LatencyHistogramTest, EmptySnapshotReportsZero)
+{
+	LatencyHistogram histogram;
+	const LatencySummary summary = histogram.snapshot().summarize();
+
+	EXPECT_EQ(summary.count, 0u);
+	EXPECT_EQ(summary.p50, 0ns);
+	EXPECT_EQ(summary.p99, 0ns);
+}
+
+TEST(LatencyHistogramTest, PercentilesAreWithinBucketPrecision)
+{
+	LatencyHistogram histogram;
+	for (int i = 1; i <= 1000; ++i) {
+		histogram.record(std::chrono::microseconds(i));
+	}
+
+	const LatencySummary summary = histogram.snapshot().summarize();
+	EXPECT_EQ(summary.count, 1000u);
+	EXPECT_NEAR(static_cast<double>(summary.p50.count()), 500'000.0, 500'000.0 / 16);
+	EXPECT_NEAR(static_cast<double>(summary.p95.count()), 950'000.0, 950'000.0 / 16);
+	EXPECT_NEAR(static_cast<double>(summary.p99.count()), 990'000.0, 990'000.0 / 16);
+}
+
+TEST(LatencyHistogramTest, NegativeDurationsCountAsZero)
+{
+	LatencyHistogram histogram;
+	histogram.record(-5ns);
+
+	const LatencyHistogram::Snapshot snapshot = histogram.snapshot();
+	EXPECT_EQ(snapshot.counts[0], 1u);
+}
+
+TEST(LatencyHistogramTest, SnapshotDifferenceCoversOnlyTheWindow)
+{
+	LatencyHistogram histogram;
+	for (int i = 0; i < 100; ++i) {
+		histogram.record(10ms);
+	}
+	const LatencyHistogram::Snapshot before = histogram.snapshot();
+
+	for (int i = 0; i < 10; ++i) {
+		histogram.record(100us);
+	}
+	const LatencySummary window = (histogram.snapshot() - before).summarize();
+
+	EXPECT_EQ(window.count, 10u);
+	EXPECT_NEAR(static_cast<double>(window.p99.count()), 100'000.0, 100'000.0 / 16);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordsAreAllCounted)
+{
+	constexpr int kThreadCount = 4;
+	constexpr int kRecordsPerThread = 10000;
+
+	LatencyHistogram histogram;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < kThreadCount; ++t) {
+		threads.emplace_back([&histogram, t] {
+			for (int i = 0; i < kRecordsPerThread; ++i) {
+				histogram.record(std::chrono::nanoseconds((t + 1) * (i + 1)));
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_EQ(histogram.snapshot().getCount(), static_cast<std::uint64_t>(kThreadCount * kRecordsPerThread));
+}
+
+TEST(LatencyHistogramTest, ScopedTimerRecordsOnce)
+{
+	LatencyHistogram histogram;
+	{
+		ScopedLatencyTimer timer(histogram);
+		std::this_thread::sleep_for(1ms);
+	}
+
+	const LatencySummary summary = histogram.snapshot().summarize();
+	EXPECT_EQ(summary.count, 1u);
+	EXPECT_GE(summary.p50, 900us);
+}
@@ -0,0 +1,383 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <ReferenceMainEffect.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect;
+
+namespace {
+
+// A deterministic pattern with structure at every scale
+float patternAt(std::uint32_t x, std::uint32_t y)
+{
+	return static_cast<float>((x * 7 + y * 13 + (x * y) % 11) % 256) / 255.0f;
+}
+
+Texture makePatternR32F(std::uint32_t width, std::uint32_t height)
+{
+	Texture texture(width, height, TextureFormat::R32F);
+	for (std::uint32_t y = 0; y < height; ++y) {
+		for (std::uint32_t x = 0; x < width; ++x) {
+			texture.getRow(y)[x] = patternAt(x, y);
+		}
+	}
+	return texture;
+}
+
+Texture makeSolidBgrx(std::uint32_t width, std::uint32_t height, std::uint8_t b, std::uint8_t g, std::uint8_t r)
+{
+	std::vector<std::uint8_t> bgrx(static_cast<std::size_t>(width) * height * 4);
+	for (std::size_t i = 0; i < bgrx.size(); i += 4) {
+		bgrx[i + 0] = b;
+		bgrx[i + 1] = g;
+		bgrx[i + 2] = r;
+		bgrx[i + 3] = 255;
+	}
+	Texture texture(width, height, TextureFormat::BGRX);
+	texture.setImage(bgrx.data(), width * 4);
+	return texture;
+}
+
+} // namespace
+
+TEST(ReferenceMainEffectTest, R8TargetsRoundToUnorm)
+{
+	Texture texture(1, 1, TextureFormat::R8);
+	texture.getRow(0)[0] = 0.5f;
+	texture.resolve();
+
+	std::uint8_t value = 0;
+	texture.getImage(&value, 1);
+	EXPECT_EQ(value, 128);
+	EXPECT_FLOAT_EQ(texture.getRow(0)[0], 128.0f / 255.0f);
+}
+
+TEST(ReferenceMainEffectTest, BoxFilterMatchesClampedMean)
+{
+	constexpr std::uint32_t kWidth = 40;
+	constexpr std::uint32_t kHeight = 30;
+
+	ReferenceMainEffect effect;
+	const Texture source = makePatternR32F(kWidth, kHeight);
+	Texture intermediate(kWidth, kHeight, TextureFormat::R32F);
+	Texture target(kWidth, kHeight, TextureFormat::R32F);
+	effect.applyBoxFilterR8KS17(target, source, intermediate);
+
+	for (std::uint32_t y = 0; y < kHeight; ++y) {
+		for (std::uint32_t x = 0; x < kWidth; ++x) {
+			double sum = 0.0;
+			for (int dy = -8; dy <= 8; ++dy) {
+				for (int dx = -8; dx <= 8; ++dx) {
+					const auto sx = static_cast<std::uint32_t>(
+						std::clamp<int>(static_cast<int>(x) + dx, 0, kWidth - 1));
+					const auto sy = static_cast<std::uint32_t>(
+						std::clamp<int>(static_cast<int>(y) + dy, 0, kHeight - 1));
+					sum += source.getRow(sy)[sx];
+				}
+			}
+			ASSERT_NEAR(target.getRow(y)[x], sum / (17.0 * 17.0), 1e-5) << x << "," << y;
+		}
+	}
+}
+
+TEST(ReferenceMainEffectTest, BoxFilterWithMulAndSqAgree)
+{
+	constexpr std::uint32_t kWidth = 24;
+	constexpr std::uint32_t kHeight = 20;
+
+	ReferenceMainEffect effect;
+	const Texture source = makePatternR32F(kWidth, kHeight);
+	Texture intermediate(kWidth, kHeight, TextureFormat::R32F);
+	Texture withMul(kWidth, kHeight, TextureFormat::R32F);
+	Texture withSq(kWidth, kHeight, TextureFormat::R32F);
+	effect.applyBoxFilterWithMulR8KS17(withMul, source, source, intermediate);
+	effect.applyBoxFilterWithSqR8KS17(withSq, source, intermediate);
+
+	for (std::size_t i = 0; i < withMul.size(); ++i) {
+		ASSERT_FLOAT_EQ(withMul.data()[i], withSq.data()[i]);
+	}
+}
+
+TEST(ReferenceMainEffectTest, ReducePyramidSumsTheWholeImage)
+{
+	constexpr std::uint32_t kSize = 16;
+
+	ReferenceMainEffect effect;
+	const Texture source = makePatternR32F(kSize, kSize);
+	std::vector<Texture> pyramid;
+	for (std::uint32_t size = kSize / 2; size >= 1; size /= 2) {
+		pyramid.emplace_back(size, size, TextureFormat::R32F);
+	}
+	effect.reduce(pyramid, source);
+
+	double expected = 0.0;
+	for (std::size_t i = 0; i < source.size(); ++i) {
+		expected += source.data()[i];
+	}
+	EXPECT_NEAR(pyramid.back().getRow(0)[0], expected, 1e-3);
+}
+
+TEST(ReferenceMainEffectTest, SquaredMotionKeepsThePaddedBorder)
+{
+	ReferenceMainEffect effect;
+	Texture current(3, 2, TextureFormat::R32F);
+	Texture last(3, 2, TextureFormat::R32F);
+	std::fill(current.data(), current.data() + current.size(), 0.75f);
+	std::fill(last.data(), last.data() + last.size(), 0.25f);
+
+	Texture padded(4, 4, TextureFormat::R32F);
+	effect.calculateSquaredMotion(padded, current, last);
+
+	EXPECT_FLOAT_EQ(padded.getRow(1)[2], 0.25f);
+	EXPECT_FLOAT_EQ(padded.getRow(1)[3], 0.0f);
+	EXPECT_FLOAT_EQ(padded.getRow(3)[0], 0.0f);
+}
+
+TEST(ReferenceMainEffectTest, DrawRoiPlacesTheSpriteOverTheClearColor)
+{
+	ReferenceMainEffect effect;
+	const Texture source = makeSolidBgrx(4, 4, 0, 0, 255);
+	Texture target(8, 8, TextureFormat::BGRX);
+	effect.drawRoi(target, source, {0.0f, 0.0f, 1.0f, 1.0f}, 4, 4, 2.0f, 3.0f);
+
+	// Outside the sprite the clear color (blue) remains; inside it the source (red) is drawn
+	EXPECT_FLOAT_EQ(target.getRow(0)[0 * 4 + 0], 1.0f);
+	EXPECT_FLOAT_EQ(target.getRow(0)[0 * 4 + 2], 0.0f);
+	EXPECT_FLOAT_EQ(target.getRow(3)[2 * 4 + 2], 1.0f);
+	EXPECT_FLOAT_EQ(target.getRow(6)[5 * 4 + 2], 1.0f);
+	EXPECT_FLOAT_EQ(target.getRow(7)[5 * 4 + 2], 0.0f);
+	EXPECT_FLOAT_EQ(target.getRow(3)[6 * 4 + 2], 0.0f);
+}
+
+TEST(ReferenceMainEffectTest, ResampleByNearestPicksPixelCenters)
+{
+	ReferenceMainEffect effect;
+	const Texture source = makePatternR32F(8, 8);
+	Texture target(2, 2, TextureFormat::R32F);
+	effect.resampleByNearestR8(target, source);
+
+	EXPECT_FLOAT_EQ(target.getRow(0)[0], source.getRow(2)[2]);
+	EXPECT_FLOAT_EQ(target.getRow(1)[1], source.getRow(6)[6]);
+}
+
+TEST(ReferenceMainEffectTest, GuidedFilterOfConstantMaskIsConstant)
+{
+	constexpr std::uint32_t kWidth = 32;
+	constexpr std::uint32_t kHeight = 18;
+	constexpr std::uint32_t kSubWidth = 8;
+	constexpr std::uint32_t kSubHeight = 4;
+
+	ReferenceMainEffect effect;
+	const Texture guide = makePatternR32F(kWidth, kHeight);
+	Texture subGuide(kSubWidth, kSubHeight, TextureFormat::R32F);
+	effect.resampleByNearestR8(subGuide, guide);
+
+	Texture subSource(kSubWidth, kSubHeight, TextureFormat::R32F);
+	std::fill(subSource.data(), subSource.data() + subSource.size(), 0.6f);
+
+	Texture intermediate(kSubWidth, kSubHeight, TextureFormat::R32F);
+	Texture meanGuide(kSubWidth, kSubHeight, TextureFormat::R32F);
+	Texture meanSource(kSubWidth, kSubHeight, TextureFormat::R32F);
+	Texture meanGuideSource(kSubWidth, kSubHeight, TextureFormat::R32F);
+	Texture meanGuideSq(kSubWidth, kSubHeight, TextureFormat::R32F);
+	effect.applyBoxFilterR8KS17(meanGuide, subGuide, intermediate);
+	effect.applyBoxFilterR8KS17(meanSource, subSource, intermediate);
+	effect.applyBoxFilterWithMulR8KS17(meanGuideSource, subGuide, subSource, intermediate);
+	effect.applyBoxFilterWithSqR8KS17(meanGuideSq, subGuide, intermediate);
+
+	Texture a(kSubWidth, kSubHeight, TextureFormat::R32F);
+	Texture b(kSubWidth, kSubHeight, TextureFormat::R32F);
+	effect.calculateGuidedFilterAAndB(a, b, meanGuideSq, meanGuide, meanGuideSource, meanSource, 1e-3f);
+
+	Texture result(kWidth, kHeight, TextureFormat::R8);
+	effect.finalizeGuidedFilter(result, guide, a, b);
+
+	for (std::size_t i = 0; i < result.size(); ++i) {
+		ASSERT_NEAR(result.data()[i], 0.6f, 1.0f / 255.0f);
+	}
+}
+
+TEST(ReferenceMainEffectTest, FusedGuidedFilterMeansMatchSeparateBoxFilters)
+{
+	constexpr std::uint32_t kWidth = 160;
+	constexpr std::uint32_t kHeight = 90;
+	constexpr std::uint32_t kSubWidth = 40;
+	constexpr std::uint32_t kSubHeight = 22;
+	constexpr float kEps = 1e-4f;
+
+	ReferenceMainEffect effect;
+	const Texture guide = makePatternR32F(kWidth, kHeight);
+	Texture subGuide(kSubWidth, kSubHeight, TextureFormat::R32F);
+	effect.resampleByNearestR8(subGuide, guide);
+
+	// A soft-edged mask so that the covariance term is far from zero
+	Texture subSource(kSubWidth, kSubHeight, TextureFormat::R32F);
+	for (std::uint32_t y = 0; y < kSubHeight; ++y) {
+		for (std::uint32_t x = 0; x < kSubWidth; ++x) {
+			subSource.getRow(y)[x] = std::clamp((static_cast<float>(x) - 12.0f) / 16.0f, 0.0f, 1.0f);
+		}
+	}
+
+	Texture intermediate(kSubWidth, kSubHeight, TextureFormat::R32F);
+	Texture meanGuide(kSubWidth, kSubHeight, TextureFormat::R32F);
+	Texture meanSource(kSubWidth, kSubHeight, TextureFormat::R32F);
+	Texture meanGuideSource(kSubWidth, kSubHeight, TextureFormat::R32F);
+	Texture meanGuideSq(kSubWidth, kSubHeight, TextureFormat::R32F);
+	effect.applyBoxFilterR8KS17(meanGuide, subGuide, intermediate);
+	effect.applyBoxFilterR8KS17(meanSource, subSource, intermediate);
+	effect.applyBoxFilterWithMulR8KS17(meanGuideSource, subGuide, subSource, intermediate);
+	effect.applyBoxFilterWithSqR8KS17(meanGuideSq, subGuide, intermediate);
+
+	Texture separateA(kSubWidth, kSubHeight, TextureFormat::R32F);
+	Texture separateB(kSubWidth, kSubHeight, TextureFormat::R32F);
+	effect.calculateGuidedFilterAAndB(separateA, separateB, meanGuideSq, meanGuide, meanGuideSource, meanSource,
+					  kEps);
+	Texture separateResult(kWidth, kHeight, TextureFormat::R8);
+	effect.finalizeGuidedFilter(separateResult, guide, separateA, separateB);
+
+	Texture fusedIntermediate(kSubWidth, kSubHeight, TextureFormat::RGBA32F);
+	Texture means(kSubWidth, kSubHeight, TextureFormat::RGBA32F);
+	effect.applyGuidedFilterMeans(means, subGuide, subSource, fusedIntermediate, 8);
+
+	for (std::uint32_t y = 0; y < kSubHeight; ++y) {
+		for (std::uint32_t x = 0; x < kSubWidth; ++x) {
+			const float *packed = means.getRow(y) + x * 4;
+			ASSERT_NEAR(packed[0], meanGuide.getRow(y)[x], 1e-6f);
+			ASSERT_NEAR(packed[1], meanSource.getRow(y)[x], 1e-6f);
+			ASSERT_NEAR(packed[2], meanGuideSource.getRow(y)[x], 1e-6f);
+			ASSERT_NEAR(packed[3], meanGuideSq.getRow(y)[x], 1e-6f);
+		}
+	}
+
+	Texture fusedA(kSubWidth, kSubHeight, TextureFormat::R32F);
+	Texture fusedB(kSubWidth, kSubHeight, TextureFormat::R32F);
+	effect.calculateGuidedFilterAAndBFromMeans(fusedA, fusedB, means, kEps);
+	Texture fusedResult(kWidth, kHeight, TextureFormat::R8);
+	effect.finalizeGuidedFilter(fusedResult, guide, fusedA, fusedB);
+
+	for (std::size_t i = 0; i < fusedResult.size(); ++i) {
+		ASSERT_NEAR(fusedResult.data()[i], separateResult.data()[i], 1.0f / 255.0f);
+	}
+}
+
+TEST(ReferenceMainEffectTest, GuidedFilterMeansMatchClampedBoxAtEveryRadius)
+{
+	constexpr std::uint32_t kWidth = 40;
+	constexpr std::uint32_t kHeight = 24;
+
+	ReferenceMainEffect effect;
+	const Texture guide = makePatternR32F(kWidth, kHeight);
+	Texture source(kWidth, kHeight, TextureFormat::R32F);
+	for (std::uint32_t y = 0; y < kHeight; ++y) {
+		for (std::uint32_t x = 0; x < kWidth; ++x) {
+			source.getRow(y)[x] = patternAt(y, x);
+		}
+	}
+
+	// 5 and 8 are summed tap by tap and 9 and 33 with running sums; 33 also spans past both edges
+	for (const std::uint32_t boxRadius : {5u, 8u, 9u, 33u}) {
+		Texture intermediate(kWidth, kHeight, TextureFormat::RGBA32F);
+		Texture means(kWidth, kHeight, TextureFormat::RGBA32F);
+		effect.applyGuidedFilterMeans(means, guide, source, intermediate, boxRadius);
+
+		const auto radius = static_cast<std::int64_t>(boxRadius);
+		const auto boxArea = static_cast<double>((2 * radius + 1) * (2 * radius + 1));
+		for (std::uint32_t y = 0; y < kHeight; ++y) {
+			for (std::uint32_t x = 0; x < kWidth; ++x) {
+				double expected[4] = {};
+				for (std::int64_t dy = -radius; dy <= radius; ++dy) {
+					for (std::int64_t dx = -radius; dx <= radius; ++dx) {
+						const auto tapX = static_cast<std::uint32_t>(
+							std::clamp<std::int64_t>(x + dx, 0, kWidth - 1));
+						const auto tapY = static_cast<std::uint32_t>(
+							std::clamp<std::int64_t>(y + dy, 0, kHeight - 1));
+						const double i = guide.getRow(tapY)[tapX];
+						const double p = source.getRow(tapY)[tapX];
+						expected[0] += i;
+						expected[1] += p;
+						expected[2] += i * p;
+						expected[3] += i * i;
+					}
+				}
+				const float *packed = means.getRow(y) + x * 4;
+				for (std::size_t channel = 0; channel < 4; ++channel) {
+					ASSERT_NEAR(packed[channel], expected[channel] / boxArea, 1e-5)
+						<< "boxRadius=" << boxRadius << " x=" << x << " y=" << y;
+				}
+			}
+		}
+	}
+}
+
+TEST(ReferenceMainEffectTest, GuidedFilterMeansRejectZeroRadius)
+{
+	ReferenceMainEffect effect;
+	const Texture guide = makePatternR32F(4, 4);
+	Texture intermediate(4, 4, TextureFormat::RGBA32F);
+	Texture means(4, 4, TextureFormat::RGBA32F);
+
+	EXPECT_THROW(effect.applyGuidedFilterMeans(means, guide, guide, intermediate, 0), std::invalid_argument);
+}
+
+TEST(ReferenceMainEffectTest, RGBA32FKeepsChannelOrderAndPrecision)
+{
+	Texture texture(1, 1, TextureFormat::RGBA32F);
+	texture.clear({0.1f, 0.2f, 1.5f, -0.25f});
+
+	EXPECT_FLOAT_EQ(texture.getRow(0)[0], 0.1f);
+	EXPECT_FLOAT_EQ(texture.getRow(0)[1], 0.2f);
+	EXPECT_FLOAT_EQ(texture.getRow(0)[2], 1.5f);
+	EXPECT_FLOAT_EQ(texture.getRow(0)[3], -0.25f);
+}
+
+TEST(ReferenceMainEffectTest, DualKawaseBlurKeepsSolidColors)
+{
+	ReferenceMainEffect effect;
+	std::vector<Texture> pyramid;
+	pyramid.push_back(makeSolidBgrx(33, 17, 10, 128, 250));
+	pyramid.emplace_back(17, 9, TextureFormat::BGRX);
+	pyramid.emplace_back(9, 5, TextureFormat::BGRX);
+
+	const Texture original = pyramid[0];
+	effect.dualKawaseBlur(pyramid, 2);
+
+	for (std::size_t i = 0; i < original.size(); ++i) {
+		ASSERT_FLOAT_EQ(pyramid[0].data()[i], original.data()[i]);
+	}
+}
+
+TEST(ReferenceMainEffectTest, RefinedBlurredBackgroundSelectsByMask)
+{
+	ReferenceMainEffect effect;
+	const Texture foreground = makeSolidBgrx(2, 1, 0, 0, 255);
+	const Texture background = makeSolidBgrx(2, 1, 255, 0, 0);
+	Texture mask(2, 1, TextureFormat::R8);
+	mask.getRow(0)[0] = 1.0f;
+	mask.getRow(0)[1] = 0.0f;
+
+	Texture output(2, 1, TextureFormat::BGRA);
+	effect.directDrawWithRefinedBlurredBackground(output, foreground, mask, 2.0, 0.1, 0.1, background);
+
+	EXPECT_FLOAT_EQ(output.getRow(0)[0 * 4 + 2], 1.0f);
+	EXPECT_FLOAT_EQ(output.getRow(0)[0 * 4 + 0], 0.0f);
+	EXPECT_FLOAT_EQ(output.getRow(0)[1 * 4 + 2], 0.0f);
+	EXPECT_FLOAT_EQ(output.getRow(0)[1 * 4 + 0], 1.0f);
+	EXPECT_FLOAT_EQ(output.getRow(0)[1 * 4 + 3], 1.0f);
+}
+
+TEST(ReferenceMainEffectTest, MismatchedSizesThrow)
+{
+	ReferenceMainEffect effect;
+	const Texture source(4, 4, TextureFormat::BGRX);
+	Texture target(2, 2, TextureFormat::R32F);
+
+	EXPECT_THROW(effect.convertToLuma(target, source), std::invalid_argument);
+}
@@ -0,0 +1,291 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <KaitoTokyo/Logger/NullLogger.hpp>
+#include <KaitoTokyo/Memory/MemoryBlockPool.hpp>
+#include <KaitoTokyo/SelfieSegmenter/InferenceScheduler.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NullSelfieSegmenter.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace KaitoTokyo;
+using namespace KaitoTokyo::SelfieSegmenter;
+
+namespace {
+
+class BlockingSelfieSegmenter final : public ISelfieSegmenter {
+public:
+	BlockingSelfieSegmenter(std::shared_future<void> release) : release_(std::move(release)) {}
+
+	std::size_t getWidth() const noexcept override { return 256; }
+	std::size_t getHeight() const noexcept override { return 144; }
+	std::size_t getPixelCount() const noexcept override { return 256 * 144; }
+
+	void process(const std::uint8_t *) override { release_.wait(); }
+
+	const std::uint8_t *getMask() const override { return nullptr; }
+	std::uint64_t getPublishedMaskGeneration() const noexcept override { return 0; }
+	std::uint64_t getMaskGeneration() const noexcept override { return 0; }
+
+private:
+	std::shared_future<void> release_;
+};
+
+/**
+ * @brief Appends its name to a shared list whenever it processes an input.
+ */
+class RecordingSelfieSegmenter final : public ISelfieSegmenter {
+public:
+	RecordingSelfieSegmenter(std::string name, std::mutex &mutex, std::vector<std::string> &names)
+		: name_(std::move(name)),
+		  mutex_(mutex),
+		  names_(names)
+	{
+	}
+
+	std::size_t getWidth() const noexcept override { return 256; }
+	std::size_t getHeight() const noexcept override { return 144; }
+	std::size_t getPixelCount() const noexcept override { return 256 * 144; }
+
+	void process(const std::uint8_t *) override
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		names_.push_back(name_);
+	}
+
+	const std::uint8_t *getMask() const override { return nullptr; }
+	std::uint64_t getPublishedMaskGeneration() const noexcept override { return 0; }
+	std::uint64_t getMaskGeneration() const noexcept override { return 0; }
+
+private:
+	const std::string name_;
+	std::mutex &mutex_;
+	std::vector<std::string> &names_;
+};
+
+class ThrowingSelfieSegmenter final : public ISelfieSegmenter {
+public:
+	std::size_t getWidth() const noexcept override { return 256; }
+	std::size_t getHeight() const noexcept override { return 144; }
+	std::size_t getPixelCount() const noexcept override { return 256 * 144; }
+
+	void process(const std::uint8_t *) override { throw std::runtime_error("failure"); }
+
+	const std::uint8_t *getMask() const override { return nullptr; }
+	std::uint64_t getPublishedMaskGeneration() const noexcept override { return 0; }
+	std::uint64_t getMaskGeneration() const noexcept override { return 0; }
+};
+
+template<typename Predicate> bool waitUntil(Predicate predicate)
+{
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (std::chrono::steady_clock::now() < deadline) {
+		if (predicate()) {
+			return true;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return false;
+}
+
+} // namespace
+
+TEST(InferenceSchedulerTest, ProcessesInputsFromAllClients)
+{
+	auto logger = Logger::NullLogger::instance();
+	auto pool = Memory::MemoryBlockPool::create(logger, 256 * 144 * 4);
+	InferenceScheduler scheduler(logger, std::chrono::microseconds(100));
+
+	std::atomic<int> completedCount = 0;
+	std::vector<std::shared_ptr<InferenceScheduler::Client>> clients;
+	for (int i = 0; i < 4; ++i) {
+		clients.push_back(scheduler.registerClient(std::make_shared<NullSelfieSegmenter>(), "client"));
+	}
+
+	for (auto &client : clients) {
+		client->submit(pool->acquire(), [&completedCount] { completedCount++; });
+	}
+
+	ASSERT_TRUE(waitUntil([&] { return completedCount.load() == 4; }));
+	for (auto &client : clients) {
+		const auto stats = client->getStats();
+		EXPECT_EQ(stats.submittedCount, 1u);
+		EXPECT_EQ(stats.processedCount, 1u);
+		EXPECT_EQ(stats.droppedCount, 0u);
+	}
+}
+
+TEST(InferenceSchedulerTest, NewerInputReplacesPendingInput)
+{
+	auto logger = Logger::NullLogger::instance();
+	auto pool = Memory::MemoryBlockPool::create(logger, 256 * 144 * 4);
+	InferenceScheduler scheduler(logger, std::chrono::microseconds(100));
+
+	std::promise<void> release;
+	auto segmenter = std::make_shared<BlockingSelfieSegmenter>(release.get_future().share());
+	auto client = scheduler.registerClient(segmenter, "client");
+
+	std::vector<int> completedInputs;
+	std::mutex completedInputsMutex;
+	auto submit = [&](int id) {
+		client->submit(pool->acquire(), [&, id] {
+			std::lock_guard<std::mutex> lock(completedInputsMutex);
+			completedInputs.push_back(id);
+		});
+	};
+
+	// The first input occupies the worker, the next two race for the single pending slot
+	submit(0);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	submit(1);
+	submit(2);
+	release.set_value();
+
+	ASSERT_TRUE(waitUntil([&] {
+		std::lock_guard<std::mutex> lock(completedInputsMutex);
+		return completedInputs.size() == 2;
+	}));
+	std::lock_guard<std::mutex> lock(completedInputsMutex);
+	EXPECT_EQ(completedInputs, (std::vector<int>{0, 2}));
+	EXPECT_EQ(client->getStats().droppedCount, 1u);
+}
+
+TEST(InferenceSchedulerTest, ClientCanBeDestroyedWithPendingInput)
+{
+	auto logger = Logger::NullLogger::instance();
+	auto pool = Memory::MemoryBlockPool::create(logger, 256 * 144 * 4);
+	InferenceScheduler scheduler(logger, std::chrono::milliseconds(50));
+
+	// A second client that has just submitted makes the worker wait out the gather window, during which the first
+	// one goes away
+	auto otherClient = scheduler.registerClient(std::make_shared<NullSelfieSegmenter>(), "other");
+	std::atomic<bool> otherCompleted = false;
+	otherClient->submit(pool->acquire(), [&otherCompleted] { otherCompleted = true; });
+	ASSERT_TRUE(waitUntil([&] { return otherCompleted.load(); }));
+
+	std::atomic<bool> completed = false;
+	{
+		auto client = scheduler.registerClient(std::make_shared<NullSelfieSegmenter>(), "client");
+		client->submit(pool->acquire(), [&completed] { completed = true; });
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	EXPECT_FALSE(completed.load());
+}
+
+TEST(InferenceSchedulerTest, RoundRunsInSubmissionOrder)
+{
+	auto logger = Logger::NullLogger::instance();
+	auto pool = Memory::MemoryBlockPool::create(logger, 256 * 144 * 4);
+	InferenceScheduler scheduler(logger, std::chrono::microseconds(100));
+
+	std::promise<void> release;
+	auto blocker = scheduler.registerClient(
+		std::make_shared<BlockingSelfieSegmenter>(release.get_future().share()), "blocker");
+
+	std::mutex namesMutex;
+	std::vector<std::string> names;
+	auto a = scheduler.registerClient(std::make_shared<RecordingSelfieSegmenter>("a", namesMutex, names), "a");
+	auto b = scheduler.registerClient(std::make_shared<RecordingSelfieSegmenter>("b", namesMutex, names), "b");
+	auto c = scheduler.registerClient(std::make_shared<RecordingSelfieSegmenter>("c", namesMutex, names), "c");
+
+	// While the blocker occupies the worker, the others submit against their registration order
+	std::atomic<int> completedCount = 0;
+	blocker->submit(pool->acquire(), nullptr);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	for (const auto &client : {c, a, b}) {
+		client->submit(pool->acquire(), [&completedCount] { completedCount++; });
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	release.set_value();
+
+	ASSERT_TRUE(waitUntil([&] { return completedCount.load() == 3; }));
+	std::lock_guard<std::mutex> lock(namesMutex);
+	EXPECT_EQ(names, (std::vector<std::string>{"c", "a", "b"}));
+}
+
+TEST(InferenceSchedulerTest, StatsTrackLatencyPerClient)
+{
+	auto logger = Logger::NullLogger::instance();
+	auto pool = Memory::MemoryBlockPool::create(logger, 256 * 144 * 4);
+	InferenceScheduler scheduler(logger, std::chrono::microseconds(100));
+
+	std::promise<void> release;
+	auto slow = scheduler.registerClient(
+		std::make_shared<BlockingSelfieSegmenter>(release.get_future().share()), "slow");
+	auto failing = scheduler.registerClient(std::make_shared<ThrowingSelfieSegmenter>(), "failing");
+
+	std::atomic<int> completedCount = 0;
+	slow->submit(pool->acquire(), [&completedCount] { completedCount++; });
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	release.set_value();
+	ASSERT_TRUE(waitUntil([&] { return completedCount.load() == 1; }));
+
+	// The segmenter is released now, so the second input is much faster than the first
+	slow->submit(pool->acquire(), [&completedCount] { completedCount++; });
+	ASSERT_TRUE(waitUntil([&] { return completedCount.load() == 2; }));
+
+	const InferenceScheduler::ClientStats slowStats = slow->getStats();
+	EXPECT_EQ(slowStats.submittedCount, 2u);
+	EXPECT_EQ(slowStats.processedCount, 2u);
+	EXPECT_EQ(slowStats.failedCount, 0u);
+	EXPECT_GE(slowStats.maxLatency, std::chrono::milliseconds(20));
+	EXPECT_LT(slowStats.lastLatency, slowStats.maxLatency);
+	EXPECT_EQ(slowStats.meanLatency, (slowStats.maxLatency + slowStats.lastLatency) / 2);
+	EXPECT_EQ(slow->getInferenceDurations().snapshot().getCount(), 2u);
+
+	failing->submit(pool->acquire(), nullptr);
+	ASSERT_TRUE(waitUntil([&] { return failing->getStats().failedCount == 1; }));
+	const InferenceScheduler::ClientStats failingStats = failing->getStats();
+	EXPECT_EQ(failingStats.processedCount, 0u);
+	EXPECT_EQ(failingStats.meanLatency, std::chrono::microseconds(0));
+}
+
+TEST(InferenceSchedulerTest, SingleClientSkipsTheGatherWindow)
+{
+	auto logger = Logger::NullLogger::instance();
+	auto pool = Memory::MemoryBlockPool::create(logger, 256 * 144 * 4);
+	InferenceScheduler scheduler(logger, std::chrono::seconds(10));
+
+	auto client = scheduler.registerClient(std::make_shared<NullSelfieSegmenter>(), "client");
+	std::atomic<bool> completed = false;
+	client->submit(pool->acquire(), [&completed] { completed = true; });
+
+	ASSERT_TRUE(waitUntil([&] { return completed.load(); }));
+	EXPECT_LT(client->getStats().lastLatency, std::chrono::seconds(1));
+}
+
+TEST(InferenceSchedulerTest, InactiveClientsDoNotHoldUpTheRound)
+{
+	auto logger = Logger::NullLogger::instance();
+	auto pool = Memory::MemoryBlockPool::create(logger, 256 * 144 * 4);
+	InferenceScheduler scheduler(logger, std::chrono::milliseconds(500));
+
+	auto active = scheduler.registerClient(std::make_shared<NullSelfieSegmenter>(), "active");
+	auto quiet = scheduler.registerClient(std::make_shared<NullSelfieSegmenter>(), "quiet");
+	auto neverSubmitting = scheduler.registerClient(std::make_shared<NullSelfieSegmenter>(), "neverSubmitting");
+
+	std::atomic<int> completedCount = 0;
+	quiet->submit(pool->acquire(), [&completedCount] { completedCount++; });
+	ASSERT_TRUE(waitUntil([&] { return completedCount.load() == 1; }));
+
+	// The quiet client is waited for until it has missed kActiveRoundCount rounds
+	for (std::uint64_t i = 0; i <= InferenceScheduler::kActiveRoundCount; ++i) {
+		active->submit(pool->acquire(), [&completedCount] { completedCount++; });
+		ASSERT_TRUE(waitUntil([&] { return completedCount.load() == static_cast<int>(i) + 2; }));
+	}
+
+	EXPECT_GE(active->getStats().maxLatency, std::chrono::milliseconds(500));
+	EXPECT_LT(active->getStats().lastLatency, std::chrono::milliseconds(250));
+}
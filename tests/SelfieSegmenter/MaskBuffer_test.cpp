@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <KaitoTokyo/SelfieSegmenter/MaskBuffer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace KaitoTokyo::SelfieSegmenter;
+
+namespace {
+
+constexpr std::size_t kMaskSize = 256 * 144;
+
+void writeFilled(MaskBuffer &maskBuffer, std::uint8_t value)
+{
+	maskBuffer.write([value](std::uint8_t *dst) { std::memset(dst, value, kMaskSize); });
+}
+
+} // namespace
+
+TEST(MaskBufferTest, InitialMaskIsZeroAtGenerationZero)
+{
+	MaskBuffer maskBuffer(kMaskSize);
+
+	const std::uint8_t *mask = maskBuffer.read();
+	EXPECT_TRUE(std::all_of(mask, mask + kMaskSize, [](std::uint8_t value) { return value == 0; }));
+	EXPECT_EQ(maskBuffer.getGeneration(), 0u);
+}
+
+TEST(MaskBufferTest, ReadReturnsLatestWrite)
+{
+	MaskBuffer maskBuffer(kMaskSize);
+
+	writeFilled(maskBuffer, 1);
+	writeFilled(maskBuffer, 2);
+
+	EXPECT_EQ(maskBuffer.read()[0], 2);
+	EXPECT_EQ(maskBuffer.read()[kMaskSize - 1], 2);
+	EXPECT_EQ(maskBuffer.getGeneration(), 2u);
+}
+
+TEST(MaskBufferTest, ReadGenerationFollowsReadRatherThanWrite)
+{
+	MaskBuffer maskBuffer(kMaskSize);
+
+	writeFilled(maskBuffer, 1);
+	EXPECT_EQ(maskBuffer.getReadGeneration(), 0u);
+
+	EXPECT_EQ(maskBuffer.read()[0], 1);
+	writeFilled(maskBuffer, 2);
+	EXPECT_EQ(maskBuffer.getReadGeneration(), 1u);
+	EXPECT_EQ(maskBuffer.getGeneration(), 2u);
+}
+
+TEST(MaskBufferTest, ReaderTracksGenerationStalenessAndSkips)
+{
+	MaskBuffer maskBuffer(kMaskSize);
+	MaskBuffer::Reader reader = maskBuffer.makeReader();
+
+	EXPECT_EQ(reader.getGeneration(), 0u);
+	EXPECT_FALSE(reader.isStale());
+
+	writeFilled(maskBuffer, 1);
+	EXPECT_TRUE(reader.isStale());
+	EXPECT_EQ(reader.read()[0], 1);
+	EXPECT_EQ(reader.getGeneration(), 1u);
+	EXPECT_FALSE(reader.isStale());
+	EXPECT_EQ(reader.getSkippedCount(), 0u);
+
+	writeFilled(maskBuffer, 2);
+	writeFilled(maskBuffer, 3);
+	writeFilled(maskBuffer, 4);
+	EXPECT_EQ(reader.read()[0], 4);
+	EXPECT_EQ(reader.getGeneration(), 4u);
+	EXPECT_EQ(reader.getSkippedCount(), 2u);
+}
+
+TEST(MaskBufferTest, PinnedMaskSurvivesLaterWrites)
+{
+	MaskBuffer maskBuffer(kMaskSize, 3);
+	MaskBuffer::Reader slowReader = maskBuffer.makeReader();
+	MaskBuffer::Reader fastReader = maskBuffer.makeReader();
+
+	writeFilled(maskBuffer, 7);
+	const std::uint8_t *pinned = slowReader.read();
+
+	// The writer has to cycle through the other slots while one stays pinned
+	for (int i = 0; i < 20; ++i) {
+		writeFilled(maskBuffer, static_cast<std::uint8_t>(100 + i));
+		EXPECT_EQ(fastReader.read()[0], 100 + i);
+		EXPECT_EQ(maskBuffer.read()[0], 100 + i);
+		EXPECT_EQ(pinned[0], 7);
+		EXPECT_EQ(pinned[kMaskSize - 1], 7);
+	}
+}
+
+TEST(MaskBufferTest, ReadersAreLimitedAndReleasedOnDestruction)
+{
+	MaskBuffer maskBuffer(kMaskSize, 2);
+
+	{
+		MaskBuffer::Reader reader = maskBuffer.makeReader();
+		EXPECT_THROW(maskBuffer.makeReader(), std::runtime_error);
+	}
+
+	EXPECT_NO_THROW(maskBuffer.makeReader());
+}
+
+TEST(MaskBufferTest, MovedReaderKeepsItsRegistration)
+{
+	MaskBuffer maskBuffer(kMaskSize, 2);
+	MaskBuffer::Reader reader = maskBuffer.makeReader();
+	writeFilled(maskBuffer, 5);
+
+	MaskBuffer::Reader movedReader = std::move(reader);
+	EXPECT_EQ(movedReader.read()[0], 5);
+	EXPECT_THROW(maskBuffer.makeReader(), std::runtime_error);
+}
+
+TEST(MaskBufferTest, ConstructorRejectsZeroReaders)
+{
+	EXPECT_THROW(MaskBuffer(kMaskSize, 0), std::invalid_argument);
+}
+
+// Run under -DENABLE_TSAN=ON to have ThreadSanitizer check the slot hand-off as well as torn reads
+TEST(MaskBufferTest, StressConcurrentWriterAndReaders)
+{
+	constexpr int kReaderCount = 3;
+	constexpr std::uint64_t kWriteCount = 20000;
+
+	MaskBuffer maskBuffer(kMaskSize, kReaderCount + 1);
+	std::atomic<bool> isWriting{true};
+	std::atomic<int> tornReadCount{0};
+	std::atomic<int> regressionCount{0};
+
+	std::vector<std::thread> readers;
+	for (int r = 0; r < kReaderCount; ++r) {
+		readers.emplace_back([&] {
+			MaskBuffer::Reader reader = maskBuffer.makeReader();
+			std::uint64_t lastGeneration = 0;
+			do {
+				const std::uint8_t *mask = reader.read();
+				const std::uint64_t generation = reader.getGeneration();
+
+				// Every write fills the whole mask with the low byte of its generation
+				const auto expected = static_cast<std::uint8_t>(generation);
+				if (mask[0] != expected || mask[kMaskSize / 2] != expected || mask[kMaskSize - 1] != expected) {
+					tornReadCount.fetch_add(1, std::memory_order_relaxed);
+				}
+				if (generation < lastGeneration) {
+					regressionCount.fetch_add(1, std::memory_order_relaxed);
+				}
+				lastGeneration = generation;
+			} while (isWriting.load(std::memory_order_acquire));
+		});
+	}
+
+	for (std::uint64_t generation = 1; generation <= kWriteCount; ++generation) {
+		writeFilled(maskBuffer, static_cast<std::uint8_t>(generation));
+	}
+	isWriting.store(false, std::memory_order_release);
+
+	for (std::thread &reader : readers) {
+		reader.join();
+	}
+
+	EXPECT_EQ(tornReadCount.load(), 0);
+	EXPECT_EQ(regressionCount.load(), 0);
+	EXPECT_EQ(maskBuffer.getGeneration(), kWriteCount);
+}
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <KaitoTokyo/Logger/NullLogger.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnAutoTuner.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnInferenceOptions.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+using namespace KaitoTokyo;
+using namespace KaitoTokyo::SelfieSegmenter;
+
+extern "C" const unsigned char mediapipe_selfie_segmentation_landscape_int8_ncnn_bin[];
+extern "C" const unsigned int mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len;
+extern "C" const char mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text[];
+
+namespace {
+
+/**
+ * @brief A cost with a single optimum at 4 threads, no packing, fp16 storage only and blocktime 20.
+ */
+double syntheticCost(const NcnnInferenceOptions &options)
+{
+	double cost = 100.0;
+	cost += 10.0 * std::abs(options.numThreads - 4);
+	cost += options.usePackingLayout ? 10.0 : 0.0;
+	cost += options.useFp16Storage ? 0.0 : 10.0;
+	cost += options.useFp16Storage && options.useFp16Arithmetic ? 5.0 : 0.0;
+	cost += options.openmpBlocktime == 20 ? 0.0 : 10.0;
+	return cost;
+}
+
+} // namespace
+
+TEST(NcnnInferenceOptionsTest, SerializeRoundTrips)
+{
+	NcnnInferenceOptions options;
+	options.numThreads = 6;
+	options.usePackingLayout = false;
+	options.useFp16Arithmetic = false;
+	options.useSgemmConvolution = false;
+	options.openmpBlocktime = 0;
+
+	const auto parsed = NcnnInferenceOptions::parse(options.serialize());
+	ASSERT_TRUE(parsed.has_value());
+	EXPECT_EQ(*parsed, options);
+}
+
+TEST(NcnnInferenceOptionsTest, MissingKeysKeepTheirDefaults)
+{
+	const auto parsed = NcnnInferenceOptions::parse("numThreads=2\r\n\r\n");
+	ASSERT_TRUE(parsed.has_value());
+
+	NcnnInferenceOptions expected;
+	expected.numThreads = 2;
+	EXPECT_EQ(*parsed, expected);
+}
+
+TEST(NcnnInferenceOptionsTest, ParseRejectsMalformedText)
+{
+	EXPECT_FALSE(NcnnInferenceOptions::parse("numThreads").has_value());
+	EXPECT_FALSE(NcnnInferenceOptions::parse("numThreads=0\n").has_value());
+	EXPECT_FALSE(NcnnInferenceOptions::parse("numThreads=4x\n").has_value());
+	EXPECT_FALSE(NcnnInferenceOptions::parse("usePackingLayout=yes\n").has_value());
+	EXPECT_FALSE(NcnnInferenceOptions::parse("useTensorCores=1\n").has_value());
+}
+
+TEST(NcnnInferenceOptionsTest, NetKeyIgnoresTheThreadCount)
+{
+	NcnnInferenceOptions oneThread;
+	NcnnInferenceOptions fourThreads;
+	fourThreads.numThreads = 4;
+	EXPECT_EQ(oneThread.getNetKey(), fourThreads.getNetKey());
+
+	NcnnInferenceOptions noPacking;
+	noPacking.usePackingLayout = false;
+	EXPECT_NE(oneThread.getNetKey(), noPacking.getNetKey());
+}
+
+TEST(NcnnAutoTunerTest, ConstructorRejectsInvalidArguments)
+{
+	EXPECT_THROW(NcnnAutoTuner(nullptr, 4), std::invalid_argument);
+	EXPECT_THROW(NcnnAutoTuner(Logger::NullLogger::instance(), 0), std::invalid_argument);
+}
+
+TEST(NcnnAutoTunerTest, SearchFindsTheOptimumOfASeparableCost)
+{
+	const NcnnAutoTuner tuner(Logger::NullLogger::instance(), 8);
+	const NcnnAutoTuner::Result result = tuner.search(syntheticCost);
+
+	EXPECT_EQ(result.bestOptions.numThreads, 4);
+	EXPECT_FALSE(result.bestOptions.usePackingLayout);
+	EXPECT_TRUE(result.bestOptions.useFp16Storage);
+	EXPECT_FALSE(result.bestOptions.useFp16Arithmetic);
+	EXPECT_EQ(result.bestOptions.openmpBlocktime, 20);
+	EXPECT_DOUBLE_EQ(result.bestElapsedMs, 100.0);
+
+	ASSERT_FALSE(result.trials.empty());
+	EXPECT_EQ(result.trials.front().options, NcnnInferenceOptions{});
+}
+
+TEST(NcnnAutoTunerTest, SearchKeepsTheDefaultsAgainstNoise)
+{
+	// Alternating costs within the improvement margin must not be mistaken for a speedup
+	int callCount = 0;
+	const NcnnAutoTuner tuner(Logger::NullLogger::instance(), 4);
+	const NcnnAutoTuner::Result result =
+		tuner.search([&callCount](const NcnnInferenceOptions &) { return callCount++ % 2 == 0 ? 10.0 : 9.8; });
+
+	EXPECT_EQ(result.bestOptions, NcnnInferenceOptions{});
+}
+
+TEST(NcnnAutoTunerTest, SearchStopsOnceCancelled)
+{
+	std::atomic<bool> cancelled{false};
+	int callCount = 0;
+	const NcnnAutoTuner tuner(Logger::NullLogger::instance(), 8);
+	const NcnnAutoTuner::Result result = tuner.search(
+		[&](const NcnnInferenceOptions &options) {
+			if (++callCount == 3) {
+				cancelled = true;
+			}
+			return syntheticCost(options);
+		},
+		&cancelled);
+
+	EXPECT_EQ(callCount, 3);
+	EXPECT_EQ(result.trials.size(), 3u);
+}
+
+TEST(NcnnAutoTunerTest, TuneRunsTheRealModel)
+{
+	const NcnnAutoTuner tuner(Logger::NullLogger::instance(), 2);
+	const NcnnAutoTuner::Result result = tuner.tune(
+		mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text,
+		static_cast<int>(mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len),
+		mediapipe_selfie_segmentation_landscape_int8_ncnn_bin, 1, 1);
+
+	EXPECT_GT(result.bestElapsedMs, 0.0);
+	EXPECT_LE(result.bestElapsedMs, result.trials.front().elapsedMs);
+	EXPECT_GE(result.bestOptions.numThreads, 1);
+	EXPECT_LE(result.bestOptions.numThreads, 2);
+}
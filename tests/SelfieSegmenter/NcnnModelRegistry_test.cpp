@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <KaitoTokyo/Logger/NullLogger.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnInferenceOptions.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnModelRegistry.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+using namespace KaitoTokyo;
+using namespace KaitoTokyo::SelfieSegmenter;
+
+extern "C" const unsigned char mediapipe_selfie_segmentation_landscape_int8_ncnn_bin[];
+extern "C" const unsigned int mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len;
+extern "C" const char mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text[];
+
+namespace {
+
+constexpr auto kModelKey = "mediapipe_selfie_segmentation_landscape_int8";
+
+std::shared_ptr<const ncnn::Net> acquireModel(NcnnModelRegistry &registry,
+					      const NcnnInferenceOptions &options = NcnnInferenceOptions{})
+{
+	return registry.acquire(kModelKey, mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text,
+				static_cast<int>(mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len),
+				mediapipe_selfie_segmentation_landscape_int8_ncnn_bin, options);
+}
+
+} // namespace
+
+TEST(NcnnModelRegistryTest, ConstructorRejectsNullLogger)
+{
+	EXPECT_THROW(NcnnModelRegistry(nullptr), std::invalid_argument);
+}
+
+TEST(NcnnModelRegistryTest, SameKeyReturnsTheSameNet)
+{
+	NcnnModelRegistry registry(Logger::NullLogger::instance());
+
+	const auto first = acquireModel(registry);
+	const auto second = acquireModel(registry);
+
+	ASSERT_NE(first, nullptr);
+	EXPECT_EQ(first, second);
+}
+
+TEST(NcnnModelRegistryTest, DifferentOptionsReturnADifferentNet)
+{
+	NcnnModelRegistry registry(Logger::NullLogger::instance());
+	NcnnInferenceOptions unpackedOptions;
+	unpackedOptions.usePackingLayout = false;
+
+	const auto packed = acquireModel(registry);
+	const auto unpacked = acquireModel(registry, unpackedOptions);
+
+	EXPECT_NE(packed, unpacked);
+	EXPECT_FALSE(unpacked->opt.use_packing_layout);
+	EXPECT_EQ(registry.getStats().loadedModelCount, 2u);
+}
+
+TEST(NcnnModelRegistryTest, StatsCountUsersAndSavedBytes)
+{
+	NcnnModelRegistry registry(Logger::NullLogger::instance());
+	const std::size_t binSize = mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len;
+
+	const auto first = acquireModel(registry);
+	NcnnModelRegistry::Stats stats = registry.getStats();
+	EXPECT_EQ(stats.loadedModelCount, 1u);
+	EXPECT_EQ(stats.activeUserCount, 1u);
+	EXPECT_EQ(stats.savedBytes, 0u);
+
+	const auto second = acquireModel(registry);
+	const auto third = acquireModel(registry);
+	stats = registry.getStats();
+	EXPECT_EQ(stats.loadedModelCount, 1u);
+	EXPECT_EQ(stats.activeUserCount, 3u);
+	EXPECT_EQ(stats.savedBytes, 2 * binSize);
+}
+
+TEST(NcnnModelRegistryTest, LatestNetStaysLoadedAfterEveryUserReleasedIt)
+{
+	NcnnModelRegistry registry(Logger::NullLogger::instance());
+
+	std::shared_ptr<const ncnn::Net> net = acquireModel(registry);
+	const ncnn::Net *const rawNet = net.get();
+	net.reset();
+
+	const NcnnModelRegistry::Stats releasedStats = registry.getStats();
+	EXPECT_EQ(releasedStats.loadedModelCount, 1u);
+	EXPECT_EQ(releasedStats.activeUserCount, 0u);
+
+	net = acquireModel(registry);
+	EXPECT_EQ(net.get(), rawNet);
+	EXPECT_EQ(registry.getStats().activeUserCount, 1u);
+}
+
+TEST(NcnnModelRegistryTest, SupersededOptionsAreUnloadedWithTheirLastUser)
+{
+	NcnnModelRegistry registry(Logger::NullLogger::instance());
+	NcnnInferenceOptions unpackedOptions;
+	unpackedOptions.usePackingLayout = false;
+
+	std::shared_ptr<const ncnn::Net> packed = acquireModel(registry);
+	const std::shared_ptr<const ncnn::Net> unpacked = acquireModel(registry, unpackedOptions);
+	EXPECT_EQ(registry.getStats().loadedModelCount, 2u);
+
+	packed.reset();
+	const NcnnModelRegistry::Stats stats = registry.getStats();
+	EXPECT_EQ(stats.loadedModelCount, 1u);
+	EXPECT_EQ(stats.activeUserCount, 1u);
+}
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <KaitoTokyo/SelfieSegmenter/NcnnPoolAllocator.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+using namespace KaitoTokyo::SelfieSegmenter;
+
+TEST(NcnnPoolAllocatorTest, ReusesFreedBlockOfSameSize)
+{
+	NcnnPoolAllocator allocator;
+
+	void *first = allocator.fastMalloc(1000);
+	allocator.fastFree(first);
+	void *second = allocator.fastMalloc(1000);
+	allocator.fastFree(second);
+
+	EXPECT_EQ(first, second);
+	const auto stats = allocator.getStats();
+	EXPECT_EQ(stats.systemAllocationCount, 1u);
+	EXPECT_EQ(stats.pooledAllocationCount, 1u);
+	EXPECT_EQ(stats.sizeClassCount, 1u);
+}
+
+TEST(NcnnPoolAllocatorTest, ReturnsAlignedWritableBlocks)
+{
+	NcnnPoolAllocator allocator;
+
+	for (std::size_t size : {1u, 63u, 64u, 4097u, 1u << 20}) {
+		void *ptr = allocator.fastMalloc(size);
+		ASSERT_NE(ptr, nullptr);
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % NcnnPoolAllocator::kAlignment, 0u);
+		std::memset(ptr, 0xab, size);
+		allocator.fastFree(ptr);
+	}
+}
+
+TEST(NcnnPoolAllocatorTest, RepeatedAllocationPatternStopsAllocating)
+{
+	NcnnPoolAllocator allocator;
+
+	// Mimics one inference: several live buffers of a few sizes, freed in a different order
+	auto runPattern = [&allocator] {
+		void *a = allocator.fastMalloc(256 * 144 * 3 * sizeof(float));
+		void *b = allocator.fastMalloc(4096);
+		void *c = allocator.fastMalloc(4096);
+		allocator.fastFree(b);
+		void *d = allocator.fastMalloc(256 * 144 * sizeof(float));
+		allocator.fastFree(a);
+		allocator.fastFree(d);
+		allocator.fastFree(c);
+	};
+
+	runPattern();
+	const std::size_t warmedUpCount = allocator.getStats().systemAllocationCount;
+
+	for (int i = 0; i < 10; ++i) {
+		runPattern();
+	}
+
+	EXPECT_EQ(allocator.getStats().systemAllocationCount, warmedUpCount);
+	EXPECT_EQ(allocator.getStats().pooledAllocationCount, 10u * 4u);
+}
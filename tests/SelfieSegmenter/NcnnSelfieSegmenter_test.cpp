@@ -4,6 +4,7 @@
 
 #include <gtest/gtest.h>
 
+#include <KaitoTokyo/SelfieSegmenter/NcnnModelRegistry.hpp>
 #include <KaitoTokyo/SelfieSegmenter/NcnnSelfieSegmenter.hpp>
 
 #include <cstddef>
@@ -86,3 +87,63 @@ TEST(NcnnSelfieSegmenterTest, ProcessRealImage)
 	}
 	EXPECT_LT(totalDiff, width * height);
 }
+
+TEST(NcnnSelfieSegmenterTest, SteadyStateProcessDoesNotAllocate)
+{
+	NcnnSelfieSegmenter selfieSegmenter(mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text,
+					    mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len,
+					    mediapipe_selfie_segmentation_landscape_int8_ncnn_bin, 2);
+
+	std::vector<std::uint8_t> input(selfieSegmenter.getPixelCount() * 4, 128);
+
+	// The first run sizes the pool
+	selfieSegmenter.process(input.data());
+	const auto warmedUpStats = selfieSegmenter.getAllocatorStats();
+	ASSERT_GT(warmedUpStats.systemAllocationCount, 0u);
+
+	for (int i = 0; i < 5; ++i) {
+		selfieSegmenter.process(input.data());
+	}
+
+	const auto stats = selfieSegmenter.getAllocatorStats();
+	EXPECT_EQ(stats.systemAllocationCount, warmedUpStats.systemAllocationCount);
+	EXPECT_EQ(stats.reservedBytes, warmedUpStats.reservedBytes);
+	EXPECT_GT(stats.pooledAllocationCount, warmedUpStats.pooledAllocationCount);
+}
+
+TEST(NcnnSelfieSegmenterTest, RawPixelsInputIsTheNormalizedInputScaledBy255)
+{
+	const auto net = NcnnModelRegistry::loadNet(mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text,
+						    mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len,
+						    mediapipe_selfie_segmentation_landscape_int8_ncnn_bin);
+	NcnnSelfieSegmenter normalizedSegmenter(net, 1);
+	NcnnSelfieSegmenter rawSegmenter(net, 1, NcnnSelfieSegmenter::InputMode::RawPixels);
+
+	// Distinct values per channel so that a swapped channel order would show up
+	const std::size_t pixelCount = normalizedSegmenter.getPixelCount();
+	std::vector<std::uint8_t> input(pixelCount * 4);
+	for (std::size_t i = 0; i < pixelCount; i++) {
+		input[i * 4 + 0] = static_cast<std::uint8_t>(i % 256);
+		input[i * 4 + 1] = static_cast<std::uint8_t>((i / 7) % 256);
+		input[i * 4 + 2] = static_cast<std::uint8_t>(255 - i % 256);
+		input[i * 4 + 3] = 255;
+	}
+
+	normalizedSegmenter.process(input.data());
+	rawSegmenter.process(input.data());
+
+	const ncnn::Mat &normalizedInput = normalizedSegmenter.getInputMat();
+	const ncnn::Mat &rawInput = rawSegmenter.getInputMat();
+	ASSERT_EQ(rawInput.w, normalizedInput.w);
+	ASSERT_EQ(rawInput.h, normalizedInput.h);
+	ASSERT_EQ(rawInput.c, normalizedInput.c);
+
+	for (int c = 0; c < rawInput.c; c++) {
+		const float *normalizedChannel = normalizedInput.channel(c);
+		const float *rawChannel = rawInput.channel(c);
+		for (std::size_t i = 0; i < pixelCount; i++) {
+			ASSERT_NEAR(rawChannel[i], 255.0f * normalizedChannel[i], 1e-3f)
+				<< "channel " << c << ", pixel " << i;
+		}
+	}
+}
@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <KaitoTokyo/SelfieSegmenter/RoiTracker.hpp>
+
+using namespace KaitoTokyo::SelfieSegmenter;
+
+namespace {
+
+constexpr double kFrameWidth = 1920.0;
+constexpr double kFrameHeight = 1080.0;
+constexpr double kAspectRatio = 256.0 / 144.0;
+constexpr std::uint32_t kInputWidth = 256;
+constexpr std::uint32_t kInputHeight = 144;
+
+bool contains(const RoiRect &outer, const RoiRect &inner)
+{
+	return outer.x <= inner.x && outer.y <= inner.y && outer.right() >= inner.right() &&
+	       outer.bottom() >= inner.bottom();
+}
+
+/**
+ * @brief Draws the mask a segmenter would return for @p subject in an input placed with @p transform.
+ */
+std::vector<std::uint8_t> makeMask(const SegmenterInputTransform &transform, const RoiRect &subject)
+{
+	std::vector<std::uint8_t> mask(kInputWidth * kInputHeight, 0);
+	for (std::uint32_t y = 0; y < kInputHeight; ++y) {
+		for (std::uint32_t x = 0; x < kInputWidth; ++x) {
+			const double frameX = (x + 0.5 - transform.x) / transform.scale;
+			const double frameY = (y + 0.5 - transform.y) / transform.scale;
+			if (frameX >= subject.x && frameX < subject.right() && frameY >= subject.y &&
+			    frameY < subject.bottom()) {
+				mask[y * kInputWidth + x] = 255;
+			}
+		}
+	}
+	return mask;
+}
+
+} // namespace
+
+TEST(RoiTrackerTest, StartsWithFullFrame)
+{
+	RoiTracker tracker(kFrameWidth, kFrameHeight, kAspectRatio);
+
+	EXPECT_TRUE(tracker.isFullFrame());
+	EXPECT_DOUBLE_EQ(tracker.getRoi().width, kFrameWidth);
+	EXPECT_DOUBLE_EQ(tracker.getRoi().height, kFrameHeight);
+}
+
+TEST(RoiTrackerTest, ConvergesToPaddedSubjectAndKeepsItInside)
+{
+	RoiTracker tracker(kFrameWidth, kFrameHeight, kAspectRatio);
+	const RoiRect subject{800.0, 300.0, 300.0, 500.0};
+
+	for (int i = 0; i < 100; ++i) {
+		const RoiRect &roi = tracker.update(subject);
+		ASSERT_TRUE(contains(roi, subject));
+		ASSERT_GE(roi.x, 0.0);
+		ASSERT_GE(roi.y, 0.0);
+		ASSERT_LE(roi.right(), kFrameWidth);
+		ASSERT_LE(roi.bottom(), kFrameHeight);
+	}
+
+	const RoiRect &roi = tracker.getRoi();
+	EXPECT_FALSE(tracker.isFullFrame());
+	EXPECT_LT(roi.width, kFrameWidth);
+	EXPECT_NEAR(roi.width / roi.height, kAspectRatio, 1e-6);
+}
+
+TEST(RoiTrackerTest, GrowsImmediatelyWhenSubjectMovesOut)
+{
+	RoiTracker tracker(kFrameWidth, kFrameHeight, kAspectRatio);
+
+	for (int i = 0; i < 100; ++i) {
+		tracker.update(RoiRect{800.0, 300.0, 300.0, 500.0});
+	}
+
+	const RoiRect moved{1300.0, 300.0, 300.0, 500.0};
+	EXPECT_TRUE(contains(tracker.update(moved), moved));
+}
+
+TEST(RoiTrackerTest, FallsBackToFullFrameWhenSubjectIsLost)
+{
+	RoiTracker::Config config;
+	config.maxMissedUpdates = 3;
+	RoiTracker tracker(kFrameWidth, kFrameHeight, kAspectRatio, config);
+
+	for (int i = 0; i < 100; ++i) {
+		tracker.update(RoiRect{800.0, 300.0, 300.0, 500.0});
+	}
+	ASSERT_FALSE(tracker.isFullFrame());
+
+	for (std::uint32_t i = 0; i < config.maxMissedUpdates; ++i) {
+		tracker.update(std::nullopt);
+		EXPECT_FALSE(tracker.isFullFrame());
+	}
+
+	tracker.update(std::nullopt);
+	EXPECT_TRUE(tracker.isFullFrame());
+}
+
+TEST(RoiTrackerTest, InputTransformCentersTheRoiInTheSegmenterInput)
+{
+	RoiTracker tracker(kFrameWidth, kFrameHeight, kAspectRatio);
+
+	const SegmenterInputTransform fullFrame = tracker.getInputTransform(kInputWidth, kInputHeight);
+	EXPECT_DOUBLE_EQ(fullFrame.scale, kInputWidth / kFrameWidth);
+	EXPECT_EQ(fullFrame.width, kInputWidth);
+	EXPECT_EQ(fullFrame.height, kInputHeight);
+	EXPECT_FLOAT_EQ(fullFrame.x, 0.0f);
+	EXPECT_FLOAT_EQ(fullFrame.y, 0.0f);
+
+	for (int i = 0; i < 100; ++i) {
+		tracker.update(RoiRect{800.0, 300.0, 300.0, 500.0});
+	}
+
+	const RoiRect &roi = tracker.getRoi();
+	const SegmenterInputTransform cropped = tracker.getInputTransform(kInputWidth, kInputHeight);
+	EXPECT_GT(cropped.scale, fullFrame.scale);
+	EXPECT_EQ(cropped.width, static_cast<std::uint32_t>(std::round(kFrameWidth * cropped.scale)));
+	EXPECT_NEAR((roi.x + roi.width / 2.0) * cropped.scale + cropped.x, kInputWidth / 2.0, 1e-3);
+	EXPECT_NEAR((roi.y + roi.height / 2.0) * cropped.scale + cropped.y, kInputHeight / 2.0, 1e-3);
+}
+
+TEST(RoiTrackerTest, OutputPlacementUndoesTheInputTransform)
+{
+	RoiTracker tracker(kFrameWidth, kFrameHeight, kAspectRatio);
+	constexpr double kMaskScale = 0.25;
+
+	const SegmenterOutputPlacement fullFrame = getSegmenterOutputPlacement(
+		tracker.getInputTransform(kInputWidth, kInputHeight), kInputWidth, kInputHeight, kMaskScale, kMaskScale);
+	EXPECT_EQ(fullFrame.width, static_cast<std::uint32_t>(kFrameWidth * kMaskScale));
+	EXPECT_EQ(fullFrame.height, static_cast<std::uint32_t>(kFrameHeight * kMaskScale));
+	EXPECT_FLOAT_EQ(fullFrame.x, 0.0f);
+	EXPECT_FLOAT_EQ(fullFrame.y, 0.0f);
+
+	for (int i = 0; i < 100; ++i) {
+		tracker.update(RoiRect{800.0, 300.0, 300.0, 500.0});
+	}
+
+	// The center of the segmenter input lands on the center of the ROI in the mask
+	const RoiRect &roi = tracker.getRoi();
+	const SegmenterOutputPlacement cropped = getSegmenterOutputPlacement(
+		tracker.getInputTransform(kInputWidth, kInputHeight), kInputWidth, kInputHeight, kMaskScale, kMaskScale);
+	EXPECT_NEAR(cropped.x + cropped.width / 2.0, (roi.x + roi.width / 2.0) * kMaskScale, 1.0);
+	EXPECT_NEAR(cropped.y + cropped.height / 2.0, (roi.y + roi.height / 2.0) * kMaskScale, 1.0);
+}
+
+TEST(RoiTrackerTest, UpdateFromMaskMapsTheSubjectBackToTheFrame)
+{
+	RoiTracker tracker(kFrameWidth, kFrameHeight, kAspectRatio);
+	const RoiRect subject{800.0, 300.0, 300.0, 500.0};
+
+	for (int i = 0; i < 100; ++i) {
+		const SegmenterInputTransform transform = tracker.getInputTransform(kInputWidth, kInputHeight);
+		const std::vector<std::uint8_t> mask = makeMask(transform, subject);
+		const RoiRect &roi = tracker.updateFromMask(mask.data(), transform, kInputWidth, kInputHeight);
+		ASSERT_TRUE(contains(roi, subject));
+	}
+
+	EXPECT_FALSE(tracker.isFullFrame());
+	EXPECT_LT(tracker.getRoi().width, kFrameWidth);
+}
+
+TEST(RoiTrackerTest, EmptyMaskCountsAsAMissedUpdate)
+{
+	RoiTracker::Config config;
+	config.maxMissedUpdates = 0;
+	RoiTracker tracker(kFrameWidth, kFrameHeight, kAspectRatio, config);
+
+	for (int i = 0; i < 100; ++i) {
+		tracker.update(RoiRect{800.0, 300.0, 300.0, 500.0});
+	}
+	ASSERT_FALSE(tracker.isFullFrame());
+
+	const std::vector<std::uint8_t> mask(kInputWidth * kInputHeight, 0);
+	tracker.updateFromMask(mask.data(), tracker.getInputTransform(kInputWidth, kInputHeight), kInputWidth,
+			       kInputHeight);
+	EXPECT_TRUE(tracker.isFullFrame());
+}
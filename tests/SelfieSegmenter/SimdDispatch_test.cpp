@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <KaitoTokyo/Memory/AlignedAllocator.hpp>
+#include <KaitoTokyo/SelfieSegmenter/BoundingBox.hpp>
+#include <KaitoTokyo/SelfieSegmenter/SimdDispatch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace KaitoTokyo;
+using namespace KaitoTokyo::SelfieSegmenter;
+
+namespace {
+
+template<typename T> using AlignedVector = std::vector<T, Memory::AlignedAllocator<T>>;
+
+// Sizes around every vector width (4, 8, 16, 32 and 64 elements) plus a full mask with a ragged tail
+constexpr std::size_t kSizes[] = {0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 257, 256 * 144 + 13};
+
+// Element offsets from a 64-byte boundary
+constexpr std::size_t kOffsets[] = {0, 1, 2, 3};
+
+constexpr std::uint32_t kWidth = 256;
+constexpr std::uint32_t kHeight = 144;
+
+template<typename T> AlignedVector<T> makeBuffer(std::size_t size)
+{
+	return AlignedVector<T>(size + 64, T{}, Memory::AlignedAllocator<T>(64));
+}
+
+class SimdDispatchTest : public ::testing::TestWithParam<SimdTier> {
+protected:
+	void SetUp() override
+	{
+		if (!isSimdTierSupported(GetParam())) {
+			GTEST_SKIP() << getSimdTierName(GetParam()) << " is not supported on this machine";
+		}
+	}
+
+	const SimdKernels &kernels() const { return getSimdKernelsForTier(GetParam()); }
+	const SimdKernels &scalar() const { return getSimdKernelsForTier(SimdTier::Scalar); }
+};
+
+} // namespace
+
+TEST_P(SimdDispatchTest, CopyR8BgraToFloatChwIsBitExactWithScalar)
+{
+	std::mt19937 rng(1);
+
+	for (std::size_t size : kSizes) {
+		for (std::size_t offset : kOffsets) {
+			auto bgra = makeBuffer<std::uint8_t>(size * 4);
+			for (auto &value : bgra) {
+				value = static_cast<std::uint8_t>(rng());
+			}
+
+			auto expectedR = makeBuffer<float>(size);
+			auto expectedG = makeBuffer<float>(size);
+			auto expectedB = makeBuffer<float>(size);
+			scalar().copyR8BgraToFloatChw(expectedR.data(), expectedG.data(), expectedB.data(),
+						      bgra.data() + offset, size);
+
+			auto actualR = makeBuffer<float>(size);
+			auto actualG = makeBuffer<float>(size);
+			auto actualB = makeBuffer<float>(size);
+			kernels().copyR8BgraToFloatChw(actualR.data() + offset, actualG.data() + offset,
+						       actualB.data() + offset, bgra.data() + offset, size);
+
+			SCOPED_TRACE(testing::Message() << "size=" << size << " offset=" << offset);
+			EXPECT_EQ(std::memcmp(actualR.data() + offset, expectedR.data(), size * sizeof(float)), 0);
+			EXPECT_EQ(std::memcmp(actualG.data() + offset, expectedG.data(), size * sizeof(float)), 0);
+			EXPECT_EQ(std::memcmp(actualB.data() + offset, expectedB.data(), size * sizeof(float)), 0);
+		}
+	}
+}
+
+TEST_P(SimdDispatchTest, CopyFloat32ToR8IsBitExactWithScalar)
+{
+	std::mt19937 rng(2);
+	std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+	for (std::size_t size : kSizes) {
+		for (std::size_t offset : kOffsets) {
+			auto src = makeBuffer<float>(size);
+			for (std::size_t i = 0; i < src.size(); ++i) {
+				// Mix exact multiples of 1/255, which sit right on a truncation boundary, with random values
+				src[i] = i % 3 == 0 ? static_cast<float>(i % 256) / 255.0f : distribution(rng);
+			}
+			src[offset] = 1.0f;
+
+			auto expected = makeBuffer<std::uint8_t>(size);
+			scalar().copyFloat32ToR8(expected.data(), src.data() + offset, size);
+
+			// Prefill so that writes past the end would show up as a mismatch in the guard area
+			auto actual = makeBuffer<std::uint8_t>(size);
+			std::memset(actual.data(), 0xAB, actual.size());
+			kernels().copyFloat32ToR8(actual.data() + offset, src.data() + offset, size);
+
+			SCOPED_TRACE(testing::Message() << "size=" << size << " offset=" << offset);
+			EXPECT_EQ(std::memcmp(actual.data() + offset, expected.data(), size), 0);
+			EXPECT_EQ(actual[offset + size], 0xAB);
+		}
+	}
+}
+
+TEST_P(SimdDispatchTest, BoundingBoxMatchesScalar)
+{
+	struct Rect {
+		std::uint32_t left, top, right, bottom;
+	};
+	const Rect rects[] = {
+		{0, 0, 0, 0},        {0, 0, 1, 1},          {255, 143, 256, 144}, {0, 0, 256, 144},
+		{15, 10, 17, 11},    {31, 0, 33, 144},      {63, 5, 65, 6},       {127, 70, 129, 72},
+		{191, 1, 193, 2},    {100, 20, 101, 140},   {1, 0, 255, 1},       {250, 100, 256, 144},
+	};
+
+	for (const Rect &rect : rects) {
+		for (std::size_t offset : kOffsets) {
+			auto mask = makeBuffer<std::uint8_t>(kWidth * kHeight);
+			for (std::uint32_t y = rect.top; y < rect.bottom; ++y) {
+				for (std::uint32_t x = rect.left; x < rect.right; ++x) {
+					mask[offset + y * kWidth + x] = 200;
+				}
+			}
+
+			for (std::uint8_t threshold : {std::uint8_t{0}, std::uint8_t{127}, std::uint8_t{199},
+						       std::uint8_t{200}, std::uint8_t{255}}) {
+				BoundingBox expected{1, 2, 3, 4};
+				const bool expectedFound =
+					scalar().calculateBoundingBox256x144(&expected, mask.data() + offset, threshold);
+
+				BoundingBox actual{1, 2, 3, 4};
+				const bool actualFound =
+					kernels().calculateBoundingBox256x144(&actual, mask.data() + offset, threshold);
+
+				SCOPED_TRACE(testing::Message() << "rect=" << rect.left << "," << rect.top << ","
+								<< rect.right << "," << rect.bottom << " offset=" << offset
+								<< " threshold=" << static_cast<int>(threshold));
+				ASSERT_EQ(actualFound, expectedFound);
+				EXPECT_EQ(actual.x, expected.x);
+				EXPECT_EQ(actual.y, expected.y);
+				EXPECT_EQ(actual.width, expected.width);
+				EXPECT_EQ(actual.height, expected.height);
+			}
+		}
+	}
+}
+
+TEST_P(SimdDispatchTest, BoundingBoxMatchesScalarOnNoise)
+{
+	std::mt19937 rng(3);
+
+	for (int trial = 0; trial < 16; ++trial) {
+		auto mask = makeBuffer<std::uint8_t>(kWidth * kHeight);
+		for (auto &value : mask) {
+			// Sparse bright pixels so that the box edges land at arbitrary positions
+			value = rng() % 4096 == 0 ? static_cast<std::uint8_t>(128 + rng() % 128)
+						  : static_cast<std::uint8_t>(rng() % 128);
+		}
+
+		BoundingBox expected{};
+		const bool expectedFound = scalar().calculateBoundingBox256x144(&expected, mask.data() + 1, 127);
+
+		BoundingBox actual{};
+		const bool actualFound = kernels().calculateBoundingBox256x144(&actual, mask.data() + 1, 127);
+
+		ASSERT_EQ(actualFound, expectedFound);
+		EXPECT_EQ(actual.x, expected.x);
+		EXPECT_EQ(actual.y, expected.y);
+		EXPECT_EQ(actual.width, expected.width);
+		EXPECT_EQ(actual.height, expected.height);
+	}
+}
+
+INSTANTIATE_TEST_SUITE_P(AllTiers, SimdDispatchTest,
+			 ::testing::Values(SimdTier::Scalar, SimdTier::SSE41, SimdTier::AVX2, SimdTier::AVX512BW,
+					   SimdTier::NEON),
+			 [](const ::testing::TestParamInfo<SimdTier> &info) {
+				 switch (info.param) {
+				 case SimdTier::SSE41:
+					 return std::string("SSE41");
+				 case SimdTier::AVX512BW:
+					 return std::string("AVX512BW");
+				 default:
+					 return std::string(getSimdTierName(info.param));
+				 }
+			 });
+
+TEST(SimdDispatchSelectionTest, SelectsASupportedTierOnce)
+{
+	const SimdKernels &kernels = getSimdKernels();
+
+	EXPECT_TRUE(isSimdTierSupported(kernels.tier));
+	EXPECT_EQ(&getSimdKernels(), &kernels);
+}
+
+TEST(SimdDispatchSelectionTest, RejectsUnsupportedTier)
+{
+	for (SimdTier tier : {SimdTier::SSE41, SimdTier::AVX2, SimdTier::AVX512BW, SimdTier::NEON}) {
+		if (!isSimdTierSupported(tier)) {
+			EXPECT_THROW(getSimdKernelsForTier(tier), std::invalid_argument);
+		}
+	}
+}
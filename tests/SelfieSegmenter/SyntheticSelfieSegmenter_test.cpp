@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <KaitoTokyo/SelfieSegmenter/SyntheticSelfieSegmenter.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace KaitoTokyo::SelfieSegmenter;
+
+namespace {
+
+std::vector<bool> runOutcomes(const SyntheticSelfieSegmenter::Config &config, int count)
+{
+	SyntheticSelfieSegmenter segmenter(config);
+	std::vector<bool> outcomes;
+	for (int i = 0; i < count; ++i) {
+		try {
+			segmenter.process(nullptr);
+			outcomes.push_back(true);
+		} catch (const std::runtime_error &) {
+			outcomes.push_back(false);
+		}
+	}
+	return outcomes;
+}
+
+} // namespace
+
+TEST(SyntheticSelfieSegmenterTest, FullAndEmptyPatternsFillTheMask)
+{
+	SyntheticSelfieSegmenter::Config config;
+	config.pattern = SyntheticSelfieSegmenter::MaskPattern::Full;
+	SyntheticSelfieSegmenter full(config);
+	full.process(nullptr);
+	const std::uint8_t *fullMask = full.getMask();
+	EXPECT_TRUE(std::all_of(fullMask, fullMask + full.getPixelCount(), [](std::uint8_t v) { return v == 255; }));
+
+	config.pattern = SyntheticSelfieSegmenter::MaskPattern::Empty;
+	SyntheticSelfieSegmenter empty(config);
+	empty.process(nullptr);
+	const std::uint8_t *emptyMask = empty.getMask();
+	EXPECT_TRUE(std::all_of(emptyMask, emptyMask + empty.getPixelCount(), [](std::uint8_t v) { return v == 0; }));
+}
+
+TEST(SyntheticSelfieSegmenterTest, EllipseCoversTheCenterButNotTheCorners)
+{
+	SyntheticSelfieSegmenter segmenter;
+	segmenter.process(nullptr);
+
+	const std::uint8_t *mask = segmenter.getMask();
+	const std::size_t width = segmenter.getWidth();
+	const std::size_t height = segmenter.getHeight();
+	EXPECT_EQ(mask[(height / 2) * width + width / 2], 255);
+	EXPECT_EQ(mask[0], 0);
+	EXPECT_EQ(mask[width - 1], 0);
+	EXPECT_EQ(mask[(height - 1) * width], 0);
+}
+
+TEST(SyntheticSelfieSegmenterTest, SweepingEllipseMovesBetweenMasks)
+{
+	SyntheticSelfieSegmenter::Config config;
+	config.pattern = SyntheticSelfieSegmenter::MaskPattern::SweepingEllipse;
+	SyntheticSelfieSegmenter segmenter(config);
+
+	segmenter.process(nullptr);
+	const std::vector<std::uint8_t> first(segmenter.getMask(), segmenter.getMask() + segmenter.getPixelCount());
+	for (int i = 0; i < 16; ++i) {
+		segmenter.process(nullptr);
+	}
+	const std::vector<std::uint8_t> later(segmenter.getMask(), segmenter.getMask() + segmenter.getPixelCount());
+
+	EXPECT_NE(first, later);
+	EXPECT_EQ(segmenter.getProcessedCount(), 17u);
+}
+
+TEST(SyntheticSelfieSegmenterTest, FailuresAreDeterministicForASeed)
+{
+	SyntheticSelfieSegmenter::Config config;
+	config.failureProbability = 0.5;
+	config.seed = 42;
+
+	const std::vector<bool> first = runOutcomes(config, 200);
+	const std::vector<bool> second = runOutcomes(config, 200);
+	EXPECT_EQ(first, second);
+
+	const auto successCount = std::count(first.begin(), first.end(), true);
+	EXPECT_GT(successCount, 60);
+	EXPECT_LT(successCount, 140);
+
+	config.seed = 43;
+	EXPECT_NE(runOutcomes(config, 200), first);
+}
+
+TEST(SyntheticSelfieSegmenterTest, FailureKeepsThePreviousMask)
+{
+	SyntheticSelfieSegmenter::Config config;
+	config.pattern = SyntheticSelfieSegmenter::MaskPattern::Full;
+	config.failureProbability = 1.0;
+	SyntheticSelfieSegmenter segmenter(config);
+
+	EXPECT_THROW(segmenter.process(nullptr), std::runtime_error);
+	EXPECT_EQ(segmenter.getMask()[0], 0);
+	EXPECT_EQ(segmenter.getProcessedCount(), 0u);
+	EXPECT_EQ(segmenter.getFailedCount(), 1u);
+}
+
+TEST(SyntheticSelfieSegmenterTest, ProcessTakesAtLeastTheLatency)
+{
+	SyntheticSelfieSegmenter::Config config;
+	config.latency = std::chrono::microseconds(2000);
+	config.waitMode = SyntheticSelfieSegmenter::WaitMode::Spin;
+	SyntheticSelfieSegmenter segmenter(config);
+
+	const auto start = std::chrono::steady_clock::now();
+	segmenter.process(nullptr);
+	EXPECT_GE(std::chrono::steady_clock::now() - start, config.latency);
+}
+
+TEST(SyntheticSelfieSegmenterTest, ConstructorRejectsInvalidConfig)
+{
+	SyntheticSelfieSegmenter::Config config;
+	config.failureProbability = 1.5;
+	EXPECT_THROW(SyntheticSelfieSegmenter{config}, std::invalid_argument);
+
+	config.failureProbability = 0.0;
+	config.jitter = std::chrono::microseconds(-1);
+	EXPECT_THROW(SyntheticSelfieSegmenter{config}, std::invalid_argument);
+}
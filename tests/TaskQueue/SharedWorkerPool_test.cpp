@@ -0,0 +1,345 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <KaitoTokyo/Logger/NullLogger.hpp>
+#include <KaitoTokyo/TaskQueue/SharedWorkerPool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace KaitoTokyo;
+using KaitoTokyo::TaskQueue::SharedWorkerPool;
+
+namespace {
+
+using CancellationToken = SharedWorkerPool::CancellationToken;
+using Priority = SharedWorkerPool::Priority;
+
+std::shared_ptr<SharedWorkerPool> makePool(std::size_t workerCount)
+{
+	return std::make_shared<SharedWorkerPool>(Logger::NullLogger::instance(), workerCount);
+}
+
+/**
+ * @brief Occupies @p queue until the returned promise is fulfilled.
+ */
+std::promise<void> blockQueue(SharedWorkerPool::Queue &queue)
+{
+	std::promise<void> release;
+	auto started = std::make_shared<std::promise<void>>();
+	std::future<void> startedFuture = started->get_future();
+	queue.push([releaseFuture = release.get_future().share(), started](const CancellationToken &) {
+		started->set_value();
+		releaseFuture.wait();
+	});
+	startedFuture.wait();
+	return release;
+}
+
+} // namespace
+
+TEST(SharedWorkerPoolTest, ConstructorRejectsInvalidArguments)
+{
+	EXPECT_THROW(SharedWorkerPool(nullptr, 1), std::invalid_argument);
+	EXPECT_THROW(SharedWorkerPool(Logger::NullLogger::instance(), 0), std::invalid_argument);
+	EXPECT_THROW(makePool(1)->createQueue("queue", 0), std::invalid_argument);
+}
+
+TEST(SharedWorkerPoolTest, TasksOfOneQueueRunInOrderOneAtATime)
+{
+	auto pool = makePool(4);
+	auto queue = pool->createQueue("queue", 64);
+
+	std::mutex mutex;
+	std::vector<int> order;
+	std::atomic<int> runningCount = 0;
+	std::atomic<bool> overlapped = false;
+	for (int i = 0; i < 32; ++i) {
+		queue->push([&, i](const CancellationToken &) {
+			if (runningCount.fetch_add(1) != 0) {
+				overlapped = true;
+			}
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				order.push_back(i);
+			}
+			runningCount.fetch_sub(1);
+		});
+	}
+	queue->push([](const CancellationToken &) {});
+	while (queue->getStats().completedCount < 33) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	EXPECT_FALSE(overlapped);
+	ASSERT_EQ(order.size(), 32u);
+	for (int i = 0; i < 32; ++i) {
+		EXPECT_EQ(order[i], i);
+	}
+}
+
+TEST(SharedWorkerPoolTest, QueuesRunInParallelAcrossWorkers)
+{
+	auto pool = makePool(2);
+	auto first = pool->createQueue("first", 1);
+	auto second = pool->createQueue("second", 1);
+
+	// Each task waits for the other, which only completes if both run at once
+	std::promise<void> firstStarted;
+	std::promise<void> secondStarted;
+	std::shared_future<void> firstStartedFuture = firstStarted.get_future().share();
+	std::shared_future<void> secondStartedFuture = secondStarted.get_future().share();
+	std::promise<void> firstFinished;
+	std::promise<void> secondFinished;
+	std::atomic<int> completedCount = 0;
+
+	first->push([&](const CancellationToken &) {
+		firstStarted.set_value();
+		if (secondStartedFuture.wait_for(std::chrono::seconds(5)) == std::future_status::ready) {
+			completedCount++;
+		}
+		firstFinished.set_value();
+	});
+	second->push([&](const CancellationToken &) {
+		secondStarted.set_value();
+		if (firstStartedFuture.wait_for(std::chrono::seconds(5)) == std::future_status::ready) {
+			completedCount++;
+		}
+		secondFinished.set_value();
+	});
+
+	// Shutting down earlier would cancel a task that has not started yet
+	firstFinished.get_future().wait();
+	secondFinished.get_future().wait();
+	first->shutdown();
+	second->shutdown();
+	EXPECT_EQ(completedCount.load(), 2);
+}
+
+TEST(SharedWorkerPoolTest, FullQueueCancelsTheOldestTask)
+{
+	auto pool = makePool(1);
+	auto queue = pool->createQueue("queue", 2);
+	std::promise<void> release = blockQueue(*queue);
+
+	const CancellationToken oldest = queue->push([](const CancellationToken &) {});
+	const CancellationToken middle = queue->push([](const CancellationToken &) {});
+	const CancellationToken newest = queue->push([](const CancellationToken &) {});
+
+	EXPECT_TRUE(oldest->load());
+	EXPECT_FALSE(middle->load());
+	EXPECT_FALSE(newest->load());
+
+	release.set_value();
+	queue->shutdown();
+	EXPECT_EQ(queue->getStats().droppedCount, 1u);
+	EXPECT_EQ(queue->getStats().pushedCount, 4u);
+}
+
+TEST(SharedWorkerPoolTest, KeyedPushReplacesTheQueuedTaskInPlace)
+{
+	auto pool = makePool(1);
+	auto queue = pool->createQueue("queue", 8);
+	std::promise<void> release = blockQueue(*queue);
+
+	std::mutex mutex;
+	std::vector<std::string> ran;
+	const auto record = [&](std::string name) {
+		return [&, name](const CancellationToken &) {
+			std::lock_guard<std::mutex> lock(mutex);
+			ran.push_back(name);
+		};
+	};
+
+	const CancellationToken firstA = queue->push("a", record("a1"));
+	queue->push("b", record("b1"));
+	queue->push("a", record("a2"));
+	queue->push(record("unkeyed"));
+
+	EXPECT_TRUE(firstA->load());
+
+	release.set_value();
+	while (queue->getStats().completedCount < 4) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	EXPECT_EQ(ran, (std::vector<std::string>{"a2", "b1", "unkeyed"}));
+	EXPECT_EQ(queue->getStats().coalescedCount, 1u);
+}
+
+TEST(SharedWorkerPoolTest, ResubmittedKeyKeepsItsTurn)
+{
+	auto pool = makePool(1);
+	auto queue = pool->createQueue("queue", 8);
+	std::promise<void> release = blockQueue(*queue);
+
+	std::mutex mutex;
+	std::vector<std::string> ran;
+	const auto record = [&](std::string name) {
+		return [&, name](const CancellationToken &) {
+			std::lock_guard<std::mutex> lock(mutex);
+			ran.push_back(name);
+		};
+	};
+
+	// A key pushed again and again must not fall behind the tasks queued after its first push
+	queue->push("a", record("a0"));
+	queue->push("b", record("b"));
+	for (int i = 1; i < 100; ++i) {
+		queue->push("a", record("a" + std::to_string(i)));
+	}
+
+	release.set_value();
+	while (queue->getStats().completedCount < 3) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	EXPECT_EQ(ran, (std::vector<std::string>{"a99", "b"}));
+	EXPECT_EQ(queue->getStats().coalescedCount, 99u);
+}
+
+TEST(SharedWorkerPoolTest, InteractiveTasksRunFirst)
+{
+	auto pool = makePool(1);
+	auto queue = pool->createQueue("queue", 8);
+	std::promise<void> release = blockQueue(*queue);
+
+	std::mutex mutex;
+	std::vector<std::string> ran;
+	const auto record = [&](std::string name) {
+		return [&, name](const CancellationToken &) {
+			std::lock_guard<std::mutex> lock(mutex);
+			ran.push_back(name);
+		};
+	};
+
+	queue->push(record("normal1"));
+	queue->push(record("interactive1"), Priority::Interactive);
+	queue->push("a", record("normal2"));
+	// Moves the keyed task into the interactive class
+	queue->push("a", record("interactive2"), Priority::Interactive);
+
+	release.set_value();
+	while (queue->getStats().completedCount < 4) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	EXPECT_EQ(ran, (std::vector<std::string>{"interactive1", "interactive2", "normal1"}));
+}
+
+TEST(SharedWorkerPoolTest, FullQueueRefusesATaskOutrankedByEveryQueuedTask)
+{
+	auto pool = makePool(1);
+	auto queue = pool->createQueue("queue", 1);
+	std::promise<void> release = blockQueue(*queue);
+
+	const CancellationToken interactive = queue->push([](const CancellationToken &) {}, Priority::Interactive);
+	const CancellationToken normal = queue->push([](const CancellationToken &) {});
+
+	EXPECT_FALSE(interactive->load());
+	EXPECT_TRUE(normal->load());
+
+	release.set_value();
+	queue->shutdown();
+	EXPECT_EQ(queue->getStats().droppedCount, 1u);
+}
+
+TEST(SharedWorkerPoolTest, ShutdownCancelsAndWaitsForTheRunningTask)
+{
+	auto pool = makePool(1);
+	auto queue = pool->createQueue("queue", 4);
+
+	std::promise<void> started;
+	std::atomic<bool> finished = false;
+	queue->push([&](const CancellationToken &token) {
+		started.set_value();
+		while (!token->load()) {
+			std::this_thread::yield();
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		finished = true;
+	});
+	const CancellationToken queued = queue->push([](const CancellationToken &) {});
+	started.get_future().wait();
+
+	queue->shutdown();
+
+	EXPECT_TRUE(finished.load());
+	EXPECT_TRUE(queued->load());
+	EXPECT_THROW(queue->push([](const CancellationToken &) {}), std::runtime_error);
+}
+
+TEST(SharedWorkerPoolTest, StatsCountFailuresAndWaits)
+{
+	auto pool = makePool(1);
+	auto queue = pool->createQueue("queue", 4);
+
+	queue->push([](const CancellationToken &) { std::this_thread::sleep_for(std::chrono::milliseconds(5)); });
+	queue->push([](const CancellationToken &) { throw std::runtime_error("failure"); });
+	queue->push([](const CancellationToken &) {});
+	while (queue->getStats().completedCount + queue->getStats().failedCount < 3) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	const SharedWorkerPool::QueueStats stats = queue->getStats();
+	EXPECT_EQ(stats.completedCount, 2u);
+	EXPECT_EQ(stats.failedCount, 1u);
+	EXPECT_GE(stats.totalRunTime, std::chrono::milliseconds(5));
+	EXPECT_GE(stats.maxWaitTime, std::chrono::milliseconds(4));
+	EXPECT_GE(stats.totalWaitTime, stats.maxWaitTime);
+}
+
+TEST(SharedWorkerPoolTest, PoolShutdownCancelsEveryQueue)
+{
+	auto pool = makePool(1);
+	auto first = pool->createQueue("first", 4);
+	auto second = pool->createQueue("second", 4);
+	std::promise<void> release = blockQueue(*first);
+
+	const CancellationToken firstQueued = first->push([](const CancellationToken &) {});
+	const CancellationToken secondQueued = second->push([](const CancellationToken &) {});
+
+	pool->shutdown();
+	release.set_value();
+
+	EXPECT_TRUE(firstQueued->load());
+	EXPECT_TRUE(secondQueued->load());
+	EXPECT_THROW(second->push([](const CancellationToken &) {}), std::runtime_error);
+}
+
+TEST(SharedWorkerPoolTest, TaskCanHoldTheLastReferenceToThePool)
+{
+	// The pool is observed through its logger, as even a weak_ptr would keep its memory allocated
+	std::promise<void> destroyed;
+	std::future<void> destroyedFuture = destroyed.get_future();
+	std::promise<void> dropped;
+	{
+		std::shared_ptr<const Logger::ILogger> logger(
+			Logger::NullLogger::instance().get(),
+			[&destroyed, instance = Logger::NullLogger::instance()](const Logger::ILogger *) {
+				destroyed.set_value();
+			});
+		auto pool = std::make_shared<SharedWorkerPool>(std::move(logger), 2);
+		auto queue = pool->createQueue("queue", 1);
+		// The task owns its own queue, and the queue owns the pool
+		queue->push([queue, droppedFuture = dropped.get_future().share()](const CancellationToken &) {
+			droppedFuture.wait();
+		});
+	}
+	dropped.set_value();
+
+	ASSERT_EQ(destroyedFuture.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+	// Gives the orphaned worker time to leave, so that a sanitizer sees any access to the destroyed pool
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+}
@@ -0,0 +1,257 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <KaitoTokyo/Logger/NullLogger.hpp>
+#include <KaitoTokyo/TaskQueue/ThrottledTaskQueue.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace KaitoTokyo;
+using KaitoTokyo::TaskQueue::ThrottledTaskQueue;
+
+namespace {
+
+using CancellationToken = ThrottledTaskQueue::CancellationToken;
+using Priority = ThrottledTaskQueue::Priority;
+
+/**
+ * @brief Occupies the worker of @p queue until the returned promise is fulfilled.
+ */
+std::promise<void> blockQueue(ThrottledTaskQueue &queue)
+{
+	std::promise<void> release;
+	auto started = std::make_shared<std::promise<void>>();
+	std::future<void> startedFuture = started->get_future();
+	queue.push([releaseFuture = release.get_future().share(), started](const CancellationToken &) {
+		started->set_value();
+		releaseFuture.wait();
+	});
+	startedFuture.wait();
+	return release;
+}
+
+/**
+ * @brief Records the names of the tasks in the order they run.
+ *
+ * Declare it before the queue so that it outlives the worker.
+ */
+class RunLog {
+public:
+	ThrottledTaskQueue::CancellableTask task(std::string name)
+	{
+		return [this, name = std::move(name)](const CancellationToken &) {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				names_.push_back(name);
+			}
+			cond_.notify_all();
+		};
+	}
+
+	/**
+	 * @brief Waits until @p count tasks have run and returns their names.
+	 */
+	std::vector<std::string> waitFor(std::size_t count)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		cond_.wait_for(lock, std::chrono::seconds(5), [this, count] { return names_.size() >= count; });
+		return names_;
+	}
+
+private:
+	std::mutex mutex_;
+	std::condition_variable cond_;
+	std::vector<std::string> names_;
+};
+
+} // namespace
+
+TEST(ThrottledTaskQueueTest, FullQueueCancelsTheOldestTask)
+{
+	ThrottledTaskQueue queue(Logger::NullLogger::instance(), 2);
+	std::promise<void> release = blockQueue(queue);
+
+	const CancellationToken oldest = queue.push([](const CancellationToken &) {});
+	const CancellationToken middle = queue.push([](const CancellationToken &) {});
+	const CancellationToken newest = queue.push([](const CancellationToken &) {});
+
+	EXPECT_TRUE(oldest->load());
+	EXPECT_FALSE(middle->load());
+	EXPECT_FALSE(newest->load());
+
+	release.set_value();
+	queue.shutdown();
+}
+
+TEST(ThrottledTaskQueueTest, KeyedPushReplacesThePendingTaskInPlace)
+{
+	RunLog log;
+	ThrottledTaskQueue queue(Logger::NullLogger::instance(), 8);
+	std::promise<void> release = blockQueue(queue);
+
+	const CancellationToken firstA = queue.push("a", log.task("a1"));
+	queue.push("b", log.task("b1"));
+	queue.push("a", log.task("a2"));
+	queue.push(log.task("unkeyed"));
+
+	EXPECT_TRUE(firstA->load());
+
+	release.set_value();
+	EXPECT_EQ(log.waitFor(3), (std::vector<std::string>{"a2", "b1", "unkeyed"}));
+}
+
+TEST(ThrottledTaskQueueTest, ResubmittedKeyKeepsItsTurn)
+{
+	RunLog log;
+	ThrottledTaskQueue queue(Logger::NullLogger::instance(), 8);
+	std::promise<void> release = blockQueue(queue);
+
+	// A key pushed again and again must not fall behind the tasks queued after its first push
+	queue.push("a", log.task("a0"));
+	queue.push("b", log.task("b"));
+	for (int i = 1; i < 100; ++i) {
+		queue.push("a", log.task("a" + std::to_string(i)));
+	}
+
+	release.set_value();
+	EXPECT_EQ(log.waitFor(2), (std::vector<std::string>{"a99", "b"}));
+}
+
+TEST(ThrottledTaskQueueTest, InteractiveTasksRunFirst)
+{
+	RunLog log;
+	ThrottledTaskQueue queue(Logger::NullLogger::instance(), 8);
+	std::promise<void> release = blockQueue(queue);
+
+	queue.push(log.task("normal1"));
+	queue.push(log.task("interactive1"), Priority::Interactive);
+	queue.push(log.task("normal2"));
+	queue.push(log.task("interactive2"), Priority::Interactive);
+
+	release.set_value();
+	EXPECT_EQ(log.waitFor(4), (std::vector<std::string>{"interactive1", "interactive2", "normal1", "normal2"}));
+}
+
+TEST(ThrottledTaskQueueTest, FullQueueDropsNormalTasksFirst)
+{
+	ThrottledTaskQueue queue(Logger::NullLogger::instance(), 2);
+	std::promise<void> release = blockQueue(queue);
+
+	const CancellationToken interactive = queue.push([](const CancellationToken &) {}, Priority::Interactive);
+	const CancellationToken normal = queue.push([](const CancellationToken &) {});
+	const CancellationToken newest = queue.push([](const CancellationToken &) {});
+
+	EXPECT_FALSE(interactive->load());
+	EXPECT_TRUE(normal->load());
+	EXPECT_FALSE(newest->load());
+
+	release.set_value();
+	queue.shutdown();
+}
+
+TEST(ThrottledTaskQueueTest, FullQueueRejectsALowerPriorityTask)
+{
+	RunLog log;
+	ThrottledTaskQueue queue(Logger::NullLogger::instance(), 1);
+	std::promise<void> release = blockQueue(queue);
+
+	const CancellationToken interactive = queue.push("a", log.task("interactive"), Priority::Interactive);
+	const CancellationToken normal = queue.push("b", log.task("normal"));
+
+	EXPECT_FALSE(interactive->load());
+	EXPECT_TRUE(normal->load());
+
+	// The refused key is free again
+	const CancellationToken retried = queue.push("b", log.task("retried"), Priority::Interactive);
+	EXPECT_TRUE(interactive->load());
+	EXPECT_FALSE(retried->load());
+
+	release.set_value();
+	EXPECT_EQ(log.waitFor(1), std::vector<std::string>{"retried"});
+}
+
+TEST(ThrottledTaskQueueTest, KeyedPushWithAnotherPriorityMovesTheTask)
+{
+	RunLog log;
+	ThrottledTaskQueue queue(Logger::NullLogger::instance(), 8);
+	std::promise<void> release = blockQueue(queue);
+
+	queue.push("a", log.task("a1"));
+	const CancellationToken replaced = queue.push("b", log.task("b1"));
+	queue.push("b", log.task("b2"), Priority::Interactive);
+
+	EXPECT_TRUE(replaced->load());
+
+	release.set_value();
+	EXPECT_EQ(log.waitFor(2), (std::vector<std::string>{"b2", "a1"}));
+}
+
+TEST(ThrottledTaskQueueTest, BusyProducerCannotStarveTheOthers)
+{
+	// Without keys, a thousand tasks of one producer would push every other task out of a queue of three
+	RunLog log;
+	ThrottledTaskQueue queue(Logger::NullLogger::instance(), 3);
+	std::promise<void> release = blockQueue(queue);
+
+	queue.push("quiet1", log.task("quiet1"));
+	for (int i = 0; i < 1000; ++i) {
+		queue.push("busy", log.task("busy" + std::to_string(i)));
+	}
+	queue.push("quiet2", log.task("quiet2"));
+
+	release.set_value();
+	EXPECT_EQ(log.waitFor(3), (std::vector<std::string>{"quiet1", "busy999", "quiet2"}));
+}
+
+TEST(ThrottledTaskQueueTest, KeyCanBeReusedAfterItsTaskRan)
+{
+	RunLog log;
+	ThrottledTaskQueue queue(Logger::NullLogger::instance(), 4);
+	std::promise<void> release = blockQueue(queue);
+
+	queue.push("a", log.task("a1"));
+	release.set_value();
+	log.waitFor(1);
+
+	const CancellationToken second = queue.push("a", log.task("a2"));
+
+	EXPECT_EQ(log.waitFor(2), (std::vector<std::string>{"a1", "a2"}));
+	EXPECT_FALSE(second->load());
+}
+
+TEST(ThrottledTaskQueueTest, ShutdownCancelsPendingTasks)
+{
+	ThrottledTaskQueue queue(Logger::NullLogger::instance(), 4);
+
+	// The running task returns only once shutdown cancels it, so nothing pending can start before that
+	std::promise<void> started;
+	const CancellationToken running = queue.push([&started](const CancellationToken &token) {
+		started.set_value();
+		while (!token->load()) {
+			std::this_thread::yield();
+		}
+	});
+	started.get_future().wait();
+
+	const CancellationToken keyed = queue.push("a", [](const CancellationToken &) {}, Priority::Interactive);
+	const CancellationToken unkeyed = queue.push([](const CancellationToken &) {});
+
+	queue.shutdown();
+
+	EXPECT_TRUE(running->load());
+	EXPECT_TRUE(keyed->load());
+	EXPECT_TRUE(unkeyed->load());
+	EXPECT_THROW(queue.push([](const CancellationToken &) {}), std::runtime_error);
+}
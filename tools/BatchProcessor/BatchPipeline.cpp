@@ -0,0 +1,258 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "BatchPipeline.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <PluginProperty.hpp>
+
+using KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect::Texture;
+using KaitoTokyo::LiveBackgroundRemovalLite::ReferenceEffect::TextureFormat;
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor {
+
+namespace {
+
+constexpr std::array<float, 4> kBlackColor{0.0f, 0.0f, 0.0f, 1.0f};
+
+std::uint32_t getSubsampledSize(std::uint32_t size, std::uint32_t subsamplingRate)
+{
+	if (subsamplingRate == 0 || size / subsamplingRate < 2) {
+		throw std::invalid_argument("SizeTooSmallForSubsamplingRateError(BatchPipeline::BatchPipeline)");
+	}
+	return (size / subsamplingRate) & ~1u;
+}
+
+/**
+ * @brief Resolves the box radius the same way RenderingContext::applyPluginProperty does, with 0 meaning auto.
+ */
+std::uint32_t getGuidedFilterBoxRadius(int boxRadius, std::uint32_t subHeight)
+{
+	if (boxRadius == 0) {
+		return static_cast<std::uint32_t>(MainFilter::getAutoGuidedFilterBoxRadius(subHeight));
+	}
+	return static_cast<std::uint32_t>(
+		std::clamp(boxRadius, MainFilter::kMinGuidedFilterBoxRadius, MainFilter::kMaxGuidedFilterBoxRadius));
+}
+
+std::uint32_t getMaskRoiSize(std::uint32_t size, double scale)
+{
+	return static_cast<std::uint32_t>(std::round(size * scale));
+}
+
+double getMaskRoiScale(const SelfieSegmenter::ISelfieSegmenter &selfieSegmenter, std::uint32_t width,
+		       std::uint32_t height)
+{
+	return std::min(static_cast<double>(selfieSegmenter.getWidth()) / width,
+			static_cast<double>(selfieSegmenter.getHeight()) / height);
+}
+
+std::vector<Texture> createDualKawasePyramid(std::uint32_t width, std::uint32_t height, int blurSize)
+{
+	std::vector<Texture> pyramid;
+	pyramid.emplace_back(width, height, TextureFormat::BGRX);
+	for (int i = 0; i < blurSize; ++i) {
+		width = std::max(1u, (width + 1) / 2);
+		height = std::max(1u, (height + 1) / 2);
+		pyramid.emplace_back(width, height, TextureFormat::BGRX);
+	}
+	return pyramid;
+}
+
+} // anonymous namespace
+
+const char *getBatchStageName(BatchStage stage) noexcept
+{
+	switch (stage) {
+	case BatchStage::DrawSource:
+		return "drawSource";
+	case BatchStage::SegmenterInput:
+		return "segmenterInput";
+	case BatchStage::Inference:
+		return "inference";
+	case BatchStage::MaskUpload:
+		return "maskUpload";
+	case BatchStage::Luma:
+		return "luma";
+	case BatchStage::DualKawaseBlur:
+		return "dualKawaseBlur";
+	case BatchStage::GuidedFilter:
+		return "guidedFilter";
+	case BatchStage::TimeAveragedFilter:
+		return "timeAveragedFilter";
+	case BatchStage::FinalDraw:
+		return "finalDraw";
+	}
+	return "unknown";
+}
+
+BatchPipeline::BatchPipeline(SelfieSegmenter::ISelfieSegmenter &selfieSegmenter, std::uint32_t width,
+			     std::uint32_t height, const BatchPipelineSettings &settings)
+	: selfieSegmenter_(selfieSegmenter),
+	  settings_(settings.blurSize >= 0
+			    ? settings
+			    : throw std::invalid_argument("BlurSizeIsNegativeError(BatchPipeline::BatchPipeline)")),
+	  width_(width),
+	  height_(height),
+	  subWidth_(getSubsampledSize(width, settings.subsamplingRate)),
+	  subHeight_(getSubsampledSize(height, settings.subsamplingRate)),
+	  guidedFilterBoxRadius_(getGuidedFilterBoxRadius(settings.guidedFilterBoxRadius, subHeight_)),
+	  maskRoiWidth_(getMaskRoiSize(width, getMaskRoiScale(selfieSegmenter, width, height))),
+	  maskRoiHeight_(getMaskRoiSize(height, getMaskRoiScale(selfieSegmenter, width, height))),
+	  roiTracker_(static_cast<double>(width), static_cast<double>(height),
+		      static_cast<double>(selfieSegmenter.getWidth()) / static_cast<double>(selfieSegmenter.getHeight())),
+	  inputTransform_(roiTracker_.getInputTransform(static_cast<std::uint32_t>(selfieSegmenter.getWidth()),
+							static_cast<std::uint32_t>(selfieSegmenter.getHeight()))),
+	  frame_(width, height, TextureFormat::BGRA),
+	  bgrxSource_(width, height, TextureFormat::BGRX),
+	  r32fLuma_(width, height, TextureFormat::R32F),
+	  r32fSubLuma_(subWidth_, subHeight_, TextureFormat::R32F),
+	  bgrxSegmenterInput_(static_cast<std::uint32_t>(selfieSegmenter.getWidth()),
+			      static_cast<std::uint32_t>(selfieSegmenter.getHeight()), TextureFormat::BGRX),
+	  segmenterInputBuffer_(selfieSegmenter.getPixelCount() * 4),
+	  r8SegmenterOutput_(static_cast<std::uint32_t>(selfieSegmenter.getWidth()),
+			     static_cast<std::uint32_t>(selfieSegmenter.getHeight()), TextureFormat::R8),
+	  r8SegmentationMask_(maskRoiWidth_, maskRoiHeight_, TextureFormat::R8),
+	  r8FrameMask_(width, height, TextureFormat::R8),
+	  r32fSubGFSource_(subWidth_, subHeight_, TextureFormat::R32F),
+	  rgba32fSubGFIntermediate_(subWidth_, subHeight_, TextureFormat::RGBA32F),
+	  rgba32fSubGFMeans_(subWidth_, subHeight_, TextureFormat::RGBA32F),
+	  r32fSubGFA_(subWidth_, subHeight_, TextureFormat::R32F),
+	  r32fSubGFB_(subWidth_, subHeight_, TextureFormat::R32F),
+	  r8GuidedFilterResult_(width, height, TextureFormat::R8),
+	  r8TimeAveragedMasks_{Texture(width, height, TextureFormat::R8), Texture(width, height, TextureFormat::R8)},
+	  bgrxDualKawasePyramid_(createDualKawasePyramid(width, height, settings.blurSize)),
+	  bgraOutput_(width, height, TextureFormat::BGRA)
+{
+}
+
+void BatchPipeline::process(const std::uint8_t *bgraFrame)
+{
+	const BatchFilterLevel filterLevel = settings_.filterLevel;
+
+	{
+		Profiling::ScopedLatencyTimer timer(getHistogram(BatchStage::DrawSource));
+		frame_.setImage(bgraFrame, width_ * 4);
+		effect_.drawSource(bgrxSource_, frame_);
+	}
+
+	// The transform is taken before the mask updates the tracker, as the scheduler would see it
+	const SelfieSegmenter::SegmenterInputTransform transform = inputTransform_;
+	{
+		Profiling::ScopedLatencyTimer timer(getHistogram(BatchStage::SegmenterInput));
+		effect_.drawRoi(bgrxSegmenterInput_, bgrxSource_, kBlackColor, transform.width, transform.height,
+				transform.x, transform.y);
+		bgrxSegmenterInput_.getImage(segmenterInputBuffer_.data(),
+					     static_cast<std::uint32_t>(selfieSegmenter_.getWidth() * 4));
+	}
+
+	{
+		Profiling::ScopedLatencyTimer timer(getHistogram(BatchStage::Inference));
+		selfieSegmenter_.process(segmenterInputBuffer_.data());
+	}
+
+	{
+		Profiling::ScopedLatencyTimer timer(getHistogram(BatchStage::MaskUpload));
+		uploadMask(selfieSegmenter_.getMask(), transform);
+	}
+
+	if (filterLevel >= BatchFilterLevel::GuidedFilter) {
+		Profiling::ScopedLatencyTimer timer(getHistogram(BatchStage::Luma));
+		effect_.convertToLuma(r32fLuma_, bgrxSource_);
+		effect_.resampleByNearestR8(r32fSubLuma_, r32fLuma_);
+	}
+
+	if (settings_.blurSize > 0) {
+		Profiling::ScopedLatencyTimer timer(getHistogram(BatchStage::DualKawaseBlur));
+		bgrxDualKawasePyramid_[0] = bgrxSource_;
+		effect_.dualKawaseBlur(bgrxDualKawasePyramid_, settings_.blurSize);
+	}
+
+	if (filterLevel >= BatchFilterLevel::GuidedFilter) {
+		Profiling::ScopedLatencyTimer timer(getHistogram(BatchStage::GuidedFilter));
+		effect_.resampleByNearestR8(r32fSubGFSource_, r8SegmentationMask_);
+
+		effect_.applyGuidedFilterMeans(rgba32fSubGFMeans_, r32fSubLuma_, r32fSubGFSource_,
+					       rgba32fSubGFIntermediate_, guidedFilterBoxRadius_);
+
+		effect_.calculateGuidedFilterAAndBFromMeans(r32fSubGFA_, r32fSubGFB_, rgba32fSubGFMeans_,
+							    settings_.guidedFilterEps);
+
+		effect_.finalizeGuidedFilter(r8GuidedFilterResult_, r32fLuma_, r32fSubGFA_, r32fSubGFB_);
+	}
+
+	if (filterLevel >= BatchFilterLevel::TimeAveragedFilter) {
+		Profiling::ScopedLatencyTimer timer(getHistogram(BatchStage::TimeAveragedFilter));
+		const std::size_t nextIndex = 1 - currentTimeAveragedMaskIndex_;
+		effect_.timeAveragedFiltering(r8TimeAveragedMasks_[nextIndex],
+					      r8TimeAveragedMasks_[currentTimeAveragedMaskIndex_], r8GuidedFilterResult_,
+					      settings_.timeAveragedFilteringAlpha);
+		currentTimeAveragedMaskIndex_ = nextIndex;
+	}
+
+	Profiling::ScopedLatencyTimer timer(getHistogram(BatchStage::FinalDraw));
+	if (filterLevel == BatchFilterLevel::Segmentation) {
+		effect_.resampleByNearestR8(r8FrameMask_, r8SegmentationMask_);
+		if (settings_.blurSize > 0) {
+			effect_.directDrawWithBlurredBackground(bgraOutput_, bgrxSource_, r8SegmentationMask_,
+								bgrxDualKawasePyramid_[0]);
+		} else {
+			effect_.directDrawWithMask(bgraOutput_, bgrxSource_, r8SegmentationMask_);
+		}
+	} else if (settings_.blurSize > 0) {
+		effect_.directDrawWithRefinedBlurredBackground(bgraOutput_, bgrxSource_, getFinalMask(),
+							       settings_.maskGamma, settings_.maskLowerBound,
+							       settings_.maskUpperBoundMargin, bgrxDualKawasePyramid_[0]);
+	} else {
+		effect_.directDrawWithRefinedMask(bgraOutput_, bgrxSource_, getFinalMask(), settings_.maskGamma,
+						  settings_.maskLowerBound, settings_.maskUpperBoundMargin);
+	}
+}
+
+void BatchPipeline::getMask(std::uint8_t *r8Mask) const
+{
+	getFinalMask().getImage(r8Mask, width_);
+}
+
+void BatchPipeline::getComposite(std::uint8_t *bgraComposite) const
+{
+	bgraOutput_.getImage(bgraComposite, width_ * 4);
+}
+
+void BatchPipeline::uploadMask(const std::uint8_t *mask, const SelfieSegmenter::SegmenterInputTransform &transform)
+{
+	r8SegmenterOutput_.setImage(mask, static_cast<std::uint32_t>(selfieSegmenter_.getWidth()));
+
+	const auto segmenterWidth = static_cast<std::uint32_t>(selfieSegmenter_.getWidth());
+	const auto segmenterHeight = static_cast<std::uint32_t>(selfieSegmenter_.getHeight());
+
+	// Map the mask back from the segmenter input onto the frame; anything outside the crop is background
+	const SelfieSegmenter::SegmenterOutputPlacement placement = SelfieSegmenter::getSegmenterOutputPlacement(
+		transform, segmenterWidth, segmenterHeight,
+		static_cast<double>(maskRoiWidth_) / static_cast<double>(width_),
+		static_cast<double>(maskRoiHeight_) / static_cast<double>(height_));
+	effect_.drawRoi(r8SegmentationMask_, r8SegmenterOutput_, kBlackColor, placement.width, placement.height,
+			placement.x, placement.y);
+
+	roiTracker_.updateFromMask(mask, transform, segmenterWidth, segmenterHeight);
+	inputTransform_ = roiTracker_.getInputTransform(segmenterWidth, segmenterHeight);
+}
+
+const Texture &BatchPipeline::getFinalMask() const noexcept
+{
+	switch (settings_.filterLevel) {
+	case BatchFilterLevel::Segmentation:
+		return r8FrameMask_;
+	case BatchFilterLevel::GuidedFilter:
+		return r8GuidedFilterResult_;
+	case BatchFilterLevel::TimeAveragedFilter:
+		break;
+	}
+	return r8TimeAveragedMasks_[currentTimeAveragedMaskIndex_];
+}
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <KaitoTokyo/Profiling/LatencyHistogram.hpp>
+#include <KaitoTokyo/SelfieSegmenter/ISelfieSegmenter.hpp>
+#include <KaitoTokyo/SelfieSegmenter/RoiTracker.hpp>
+
+#include <ReferenceMainEffect.hpp>
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor {
+
+/**
+ * @brief The parts of BatchPipeline::process that are timed separately.
+ */
+enum class BatchStage : std::size_t {
+	DrawSource,
+	SegmenterInput,
+	Inference,
+	MaskUpload,
+	Luma,
+	DualKawaseBlur,
+	GuidedFilter,
+	TimeAveragedFilter,
+	FinalDraw,
+};
+
+constexpr std::size_t kBatchStageCount = static_cast<std::size_t>(BatchStage::FinalDraw) + 1;
+
+const char *getBatchStageName(BatchStage stage) noexcept;
+
+/**
+ * @brief How far a frame is refined, named after the FilterLevel values of the filter.
+ */
+enum class BatchFilterLevel {
+	Segmentation,
+	GuidedFilter,
+	TimeAveragedFilter,
+};
+
+struct BatchPipelineSettings {
+	std::uint32_t subsamplingRate = 4;
+	BatchFilterLevel filterLevel = BatchFilterLevel::TimeAveragedFilter;
+	float guidedFilterEps = 1e-4f;
+	/// 0 picks the radius from the frame size like the filter does.
+	int guidedFilterBoxRadius = 0;
+	float timeAveragedFilteringAlpha = 0.25f;
+	double maskGamma = 2.5;
+	double maskLowerBound = 0.056234;
+	double maskUpperBoundMargin = 0.056234;
+	int blurSize = 0;
+};
+
+/**
+ * @brief Runs the passes of RenderingContext::videoRender on the CPU, one frame at a time.
+ *
+ * The textures, sizes and ROI tracking follow RenderingContext, with ReferenceMainEffect standing in for the
+ * shaders. Inference runs synchronously on every frame, so the mask applied to a frame is always its own rather
+ * than the latest one the asynchronous scheduler has finished.
+ */
+class BatchPipeline {
+public:
+	BatchPipeline(SelfieSegmenter::ISelfieSegmenter &selfieSegmenter, std::uint32_t width, std::uint32_t height,
+		      const BatchPipelineSettings &settings);
+
+	BatchPipeline(const BatchPipeline &) = delete;
+	BatchPipeline &operator=(const BatchPipeline &) = delete;
+	BatchPipeline(BatchPipeline &&) = delete;
+	BatchPipeline &operator=(BatchPipeline &&) = delete;
+
+	/**
+	 * @brief Processes one frame.
+	 *
+	 * @param bgraFrame The frame as width * height BGRA pixels without row padding.
+	 */
+	void process(const std::uint8_t *bgraFrame);
+
+	/**
+	 * @brief Writes the refined mask of the last frame as width * height R8 pixels.
+	 */
+	void getMask(std::uint8_t *r8Mask) const;
+
+	/**
+	 * @brief Writes the composite of the last frame as width * height BGRA pixels.
+	 *
+	 * Without a background blur the background is transparent; with one the frame is opaque.
+	 */
+	void getComposite(std::uint8_t *bgraComposite) const;
+
+	const Profiling::LatencyHistogram &getStageDurations(BatchStage stage) const noexcept
+	{
+		return stageDurations_[static_cast<std::size_t>(stage)];
+	}
+
+private:
+	void uploadMask(const std::uint8_t *mask, const SelfieSegmenter::SegmenterInputTransform &transform);
+	const ReferenceEffect::Texture &getFinalMask() const noexcept;
+
+	Profiling::LatencyHistogram &getHistogram(BatchStage stage) noexcept
+	{
+		return stageDurations_[static_cast<std::size_t>(stage)];
+	}
+
+	SelfieSegmenter::ISelfieSegmenter &selfieSegmenter_;
+	const BatchPipelineSettings settings_;
+	const ReferenceEffect::ReferenceMainEffect effect_{};
+
+	const std::uint32_t width_;
+	const std::uint32_t height_;
+	const std::uint32_t subWidth_;
+	const std::uint32_t subHeight_;
+	const std::uint32_t guidedFilterBoxRadius_;
+	const std::uint32_t maskRoiWidth_;
+	const std::uint32_t maskRoiHeight_;
+
+	SelfieSegmenter::RoiTracker roiTracker_;
+	SelfieSegmenter::SegmenterInputTransform inputTransform_;
+
+	ReferenceEffect::Texture frame_;
+	ReferenceEffect::Texture bgrxSource_;
+	ReferenceEffect::Texture r32fLuma_;
+	ReferenceEffect::Texture r32fSubLuma_;
+	ReferenceEffect::Texture bgrxSegmenterInput_;
+	std::vector<std::uint8_t> segmenterInputBuffer_;
+	ReferenceEffect::Texture r8SegmenterOutput_;
+	ReferenceEffect::Texture r8SegmentationMask_;
+	ReferenceEffect::Texture r8FrameMask_;
+	ReferenceEffect::Texture r32fSubGFSource_;
+	ReferenceEffect::Texture rgba32fSubGFIntermediate_;
+	ReferenceEffect::Texture rgba32fSubGFMeans_;
+	ReferenceEffect::Texture r32fSubGFA_;
+	ReferenceEffect::Texture r32fSubGFB_;
+	ReferenceEffect::Texture r8GuidedFilterResult_;
+	std::vector<ReferenceEffect::Texture> r8TimeAveragedMasks_;
+	std::size_t currentTimeAveragedMaskIndex_ = 0;
+	std::vector<ReferenceEffect::Texture> bgrxDualKawasePyramid_;
+	ReferenceEffect::Texture bgraOutput_;
+
+	std::array<Profiling::LatencyHistogram, kBatchStageCount> stageDurations_;
+};
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor
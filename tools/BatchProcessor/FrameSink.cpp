@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "FrameSink.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "FrameSource.hpp"
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor {
+
+RawFrameSink::RawFrameSink(const std::string &path, std::uint32_t width, std::uint32_t height,
+			   std::uint32_t channelCount)
+	: stream_(path, std::ios::binary | std::ios::trunc),
+	  frameSize_(static_cast<std::size_t>(width) * height * channelCount)
+{
+	if (!stream_) {
+		throw std::runtime_error("FileOpenError(RawFrameSink::RawFrameSink): " + path);
+	}
+}
+
+void RawFrameSink::write(const std::uint8_t *pixels)
+{
+	stream_.write(reinterpret_cast<const char *>(pixels), static_cast<std::streamsize>(frameSize_));
+	if (!stream_) {
+		throw std::runtime_error("FileWriteError(RawFrameSink::write)");
+	}
+}
+
+PngSequenceFrameSink::PngSequenceFrameSink(const std::string &pattern, int startNumber, std::uint32_t width,
+					   std::uint32_t height, std::uint32_t channelCount)
+	: pattern_(pattern),
+	  nextNumber_(startNumber),
+	  width_(width),
+	  height_(height),
+	  channelCount_(channelCount == 1 || channelCount == 4
+				? channelCount
+				: throw std::invalid_argument(
+					  "UnsupportedChannelCountError(PngSequenceFrameSink::PngSequenceFrameSink)"))
+{
+	// Fail before any frame is processed if the pattern has no frame number
+	formatSequencePath(pattern_, nextNumber_);
+}
+
+void PngSequenceFrameSink::write(const std::uint8_t *pixels)
+{
+	const std::string path = formatSequencePath(pattern_, nextNumber_);
+	const auto width = static_cast<int>(width_);
+	const auto height = static_cast<int>(height_);
+
+	int result = 0;
+	if (channelCount_ == 1) {
+		result = stbi_write_png(path.c_str(), width, height, 1, pixels, width);
+	} else {
+		// PNG stores RGBA, so the BGRA composite is swizzled first
+		const std::size_t pixelCount = static_cast<std::size_t>(width_) * height_;
+		std::vector<std::uint8_t> rgba(pixelCount * 4);
+		for (std::size_t i = 0; i < pixelCount; ++i) {
+			rgba[i * 4 + 0] = pixels[i * 4 + 2];
+			rgba[i * 4 + 1] = pixels[i * 4 + 1];
+			rgba[i * 4 + 2] = pixels[i * 4 + 0];
+			rgba[i * 4 + 3] = pixels[i * 4 + 3];
+		}
+		result = stbi_write_png(path.c_str(), width, height, 4, rgba.data(), width * 4);
+	}
+
+	if (!result) {
+		throw std::runtime_error("ImageWriteError(PngSequenceFrameSink::write): " + path);
+	}
+	++nextNumber_;
+}
+
+std::unique_ptr<IFrameSink> openFrameSink(const std::string &path, int startNumber, std::uint32_t width,
+					  std::uint32_t height, std::uint32_t channelCount)
+{
+	if (path.find('%') != std::string::npos) {
+		return std::make_unique<PngSequenceFrameSink>(path, startNumber, width, height, channelCount);
+	}
+	return std::make_unique<RawFrameSink>(path, width, height, channelCount);
+}
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor
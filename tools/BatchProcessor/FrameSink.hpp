@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor {
+
+/**
+ * @brief A destination for processed frames of one fixed size and channel count.
+ */
+class IFrameSink {
+protected:
+	IFrameSink() = default;
+
+public:
+	virtual ~IFrameSink() = default;
+
+	/**
+	 * @param pixels width * height pixels of the sink's channel count, without row padding.
+	 * @throw std::runtime_error If the frame cannot be written.
+	 */
+	virtual void write(const std::uint8_t *pixels) = 0;
+
+	IFrameSink(const IFrameSink &) = delete;
+	IFrameSink &operator=(const IFrameSink &) = delete;
+	IFrameSink(IFrameSink &&) = delete;
+	IFrameSink &operator=(IFrameSink &&) = delete;
+};
+
+/**
+ * @brief Appends frames to a single file as raw R8 or BGRA pixels.
+ */
+class RawFrameSink final : public IFrameSink {
+public:
+	RawFrameSink(const std::string &path, std::uint32_t width, std::uint32_t height, std::uint32_t channelCount);
+
+	void write(const std::uint8_t *pixels) override;
+
+private:
+	std::ofstream stream_;
+	const std::size_t frameSize_;
+};
+
+/**
+ * @brief Writes each frame to a numbered PNG file, as grayscale for masks and RGBA for composites.
+ *
+ * The pattern follows the same %d or %0Nd convention as ImageSequenceFrameSource.
+ */
+class PngSequenceFrameSink final : public IFrameSink {
+public:
+	PngSequenceFrameSink(const std::string &pattern, int startNumber, std::uint32_t width, std::uint32_t height,
+			     std::uint32_t channelCount);
+
+	void write(const std::uint8_t *pixels) override;
+
+private:
+	const std::string pattern_;
+	int nextNumber_;
+	const std::uint32_t width_;
+	const std::uint32_t height_;
+	const std::uint32_t channelCount_;
+};
+
+/**
+ * @brief Opens @p path as a PNG sequence if it contains a frame number conversion, or else as a raw file.
+ *
+ * @param channelCount 1 for R8 masks or 4 for BGRA composites.
+ */
+std::unique_ptr<IFrameSink> openFrameSink(const std::string &path, int startNumber, std::uint32_t width,
+					  std::uint32_t height, std::uint32_t channelCount);
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor
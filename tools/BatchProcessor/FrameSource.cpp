@@ -0,0 +1,250 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "FrameSource.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor {
+
+namespace {
+
+std::uint8_t clampToByte(int value) noexcept
+{
+	return static_cast<std::uint8_t>(std::clamp(value, 0, 255));
+}
+
+bool endsWith(const std::string &value, const std::string &suffix)
+{
+	return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // anonymous namespace
+
+Y4mFrameSource::Y4mFrameSource(const std::string &path) : stream_(path, std::ios::binary)
+{
+	if (!stream_) {
+		throw std::runtime_error("FileOpenError(Y4mFrameSource::Y4mFrameSource): " + path);
+	}
+
+	std::string header;
+	if (!std::getline(stream_, header) || header.rfind("YUV4MPEG2", 0) != 0) {
+		throw std::runtime_error("InvalidHeaderError(Y4mFrameSource::Y4mFrameSource): " + path);
+	}
+
+	std::istringstream fields(header.substr(9));
+	std::string field;
+	std::string colorspace = "420jpeg";
+	while (fields >> field) {
+		switch (field[0]) {
+		case 'W':
+			width_ = static_cast<std::uint32_t>(std::stoul(field.substr(1)));
+			break;
+		case 'H':
+			height_ = static_cast<std::uint32_t>(std::stoul(field.substr(1)));
+			break;
+		case 'C':
+			colorspace = field.substr(1);
+			break;
+		case 'X':
+			if (field == "XCOLORRANGE=FULL") {
+				isFullRange_ = true;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (width_ == 0 || height_ == 0) {
+		throw std::runtime_error("MissingFrameSizeError(Y4mFrameSource::Y4mFrameSource): " + path);
+	}
+
+	if (colorspace == "420" || colorspace == "420jpeg" || colorspace == "420paldv" || colorspace == "420mpeg2") {
+		chromaShiftX_ = 1;
+		chromaShiftY_ = 1;
+	} else if (colorspace == "422") {
+		chromaShiftX_ = 1;
+		chromaShiftY_ = 0;
+	} else if (colorspace == "444") {
+		chromaShiftX_ = 0;
+		chromaShiftY_ = 0;
+	} else if (colorspace == "mono") {
+		isMono_ = true;
+	} else {
+		throw std::runtime_error("UnsupportedColorspaceError(Y4mFrameSource::Y4mFrameSource): " + colorspace);
+	}
+
+	chromaWidth_ = (width_ + (1u << chromaShiftX_) - 1) >> chromaShiftX_;
+	const std::uint32_t chromaHeight = (height_ + (1u << chromaShiftY_) - 1) >> chromaShiftY_;
+	chromaPlaneSize_ = isMono_ ? 0 : static_cast<std::size_t>(chromaWidth_) * chromaHeight;
+	planes_.resize(static_cast<std::size_t>(width_) * height_ + 2 * chromaPlaneSize_);
+}
+
+bool Y4mFrameSource::read(std::uint8_t *bgraFrame)
+{
+	std::string frameHeader;
+	if (!std::getline(stream_, frameHeader)) {
+		return false;
+	}
+	if (frameHeader.rfind("FRAME", 0) != 0) {
+		throw std::runtime_error("InvalidFrameHeaderError(Y4mFrameSource::read)");
+	}
+
+	stream_.read(reinterpret_cast<char *>(planes_.data()), static_cast<std::streamsize>(planes_.size()));
+	if (stream_.gcount() != static_cast<std::streamsize>(planes_.size())) {
+		throw std::runtime_error("TruncatedFrameError(Y4mFrameSource::read)");
+	}
+
+	const std::uint8_t *lumaPlane = planes_.data();
+	const std::uint8_t *cbPlane = lumaPlane + static_cast<std::size_t>(width_) * height_;
+	const std::uint8_t *crPlane = cbPlane + chromaPlaneSize_;
+
+	// BT.601 in 16.16 fixed point
+	const int lumaOffset = isFullRange_ ? 0 : 16;
+	const int lumaScale = isFullRange_ ? 65536 : 76309;
+	const int crToR = isFullRange_ ? 91881 : 104597;
+	const int cbToG = isFullRange_ ? 22554 : 25675;
+	const int crToG = isFullRange_ ? 46802 : 53279;
+	const int cbToB = isFullRange_ ? 116130 : 132201;
+
+	for (std::uint32_t y = 0; y < height_; ++y) {
+		const std::uint8_t *lumaRow = lumaPlane + static_cast<std::size_t>(y) * width_;
+		const std::size_t chromaRowOffset = static_cast<std::size_t>(y >> chromaShiftY_) * chromaWidth_;
+		std::uint8_t *bgraRow = bgraFrame + static_cast<std::size_t>(y) * width_ * 4;
+
+		for (std::uint32_t x = 0; x < width_; ++x) {
+			const int luma = (lumaRow[x] - lumaOffset) * lumaScale;
+			int cb = 0;
+			int cr = 0;
+			if (!isMono_) {
+				cb = cbPlane[chromaRowOffset + (x >> chromaShiftX_)] - 128;
+				cr = crPlane[chromaRowOffset + (x >> chromaShiftX_)] - 128;
+			}
+
+			bgraRow[x * 4 + 0] = clampToByte((luma + cbToB * cb + 32768) >> 16);
+			bgraRow[x * 4 + 1] = clampToByte((luma - cbToG * cb - crToG * cr + 32768) >> 16);
+			bgraRow[x * 4 + 2] = clampToByte((luma + crToR * cr + 32768) >> 16);
+			bgraRow[x * 4 + 3] = 255;
+		}
+	}
+	return true;
+}
+
+RawBgraFrameSource::RawBgraFrameSource(const std::string &path, std::uint32_t width, std::uint32_t height)
+	: stream_(path, std::ios::binary),
+	  width_(width > 0 ? width : throw std::invalid_argument("WidthIsZeroError(RawBgraFrameSource::RawBgraFrameSource)")),
+	  height_(height > 0 ? height
+			     : throw std::invalid_argument("HeightIsZeroError(RawBgraFrameSource::RawBgraFrameSource)"))
+{
+	if (!stream_) {
+		throw std::runtime_error("FileOpenError(RawBgraFrameSource::RawBgraFrameSource): " + path);
+	}
+}
+
+bool RawBgraFrameSource::read(std::uint8_t *bgraFrame)
+{
+	const auto frameSize = static_cast<std::streamsize>(static_cast<std::size_t>(width_) * height_ * 4);
+	stream_.read(reinterpret_cast<char *>(bgraFrame), frameSize);
+	if (stream_.gcount() == 0) {
+		return false;
+	}
+	if (stream_.gcount() != frameSize) {
+		throw std::runtime_error("TruncatedFrameError(RawBgraFrameSource::read)");
+	}
+	return true;
+}
+
+ImageSequenceFrameSource::ImageSequenceFrameSource(const std::string &pattern, int startNumber)
+	: pattern_(pattern),
+	  nextNumber_(startNumber)
+{
+	const std::string firstPath = formatSequencePath(pattern_, nextNumber_);
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	if (!stbi_info(firstPath.c_str(), &width, &height, &channels)) {
+		throw std::runtime_error("ImageLoadError(ImageSequenceFrameSource::ImageSequenceFrameSource): " +
+					 firstPath);
+	}
+	width_ = static_cast<std::uint32_t>(width);
+	height_ = static_cast<std::uint32_t>(height);
+}
+
+bool ImageSequenceFrameSource::read(std::uint8_t *bgraFrame)
+{
+	const std::string path = formatSequencePath(pattern_, nextNumber_);
+	if (!std::filesystem::exists(path)) {
+		return false;
+	}
+
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> rgba(stbi_load(path.c_str(), &width, &height, &channels, 4),
+								   &stbi_image_free);
+	if (!rgba) {
+		throw std::runtime_error("ImageLoadError(ImageSequenceFrameSource::read): " + path);
+	}
+	if (static_cast<std::uint32_t>(width) != width_ || static_cast<std::uint32_t>(height) != height_) {
+		throw std::runtime_error("ImageSizeMismatchError(ImageSequenceFrameSource::read): " + path);
+	}
+
+	const std::size_t pixelCount = static_cast<std::size_t>(width_) * height_;
+	for (std::size_t i = 0; i < pixelCount; ++i) {
+		bgraFrame[i * 4 + 0] = rgba.get()[i * 4 + 2];
+		bgraFrame[i * 4 + 1] = rgba.get()[i * 4 + 1];
+		bgraFrame[i * 4 + 2] = rgba.get()[i * 4 + 0];
+		bgraFrame[i * 4 + 3] = rgba.get()[i * 4 + 3];
+	}
+
+	++nextNumber_;
+	return true;
+}
+
+std::string formatSequencePath(const std::string &pattern, int number)
+{
+	const std::size_t percent = pattern.find('%');
+	if (percent != std::string::npos) {
+		std::size_t end = percent + 1;
+		std::size_t width = 0;
+		const bool zeroPadded = end < pattern.size() && pattern[end] == '0';
+		while (end < pattern.size() && pattern[end] >= '0' && pattern[end] <= '9') {
+			width = width * 10 + static_cast<std::size_t>(pattern[end] - '0');
+			++end;
+		}
+
+		if (end < pattern.size() && pattern[end] == 'd') {
+			std::string digits = std::to_string(number);
+			if (digits.size() < width) {
+				digits.insert(0, width - digits.size(), zeroPadded ? '0' : ' ');
+			}
+			return pattern.substr(0, percent) + digits + pattern.substr(end + 1);
+		}
+	}
+
+	throw std::invalid_argument("MissingFrameNumberError(formatSequencePath): " + pattern);
+}
+
+std::unique_ptr<IFrameSource> openFrameSource(const std::string &path, std::uint32_t rawWidth,
+					      std::uint32_t rawHeight, int startNumber)
+{
+	if (endsWith(path, ".y4m")) {
+		return std::make_unique<Y4mFrameSource>(path);
+	}
+	if (rawWidth > 0 || rawHeight > 0) {
+		return std::make_unique<RawBgraFrameSource>(path, rawWidth, rawHeight);
+	}
+	return std::make_unique<ImageSequenceFrameSource>(path, startNumber);
+}
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor
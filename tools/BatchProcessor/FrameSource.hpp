@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor {
+
+/**
+ * @brief A sequence of frames decoded to BGRA.
+ */
+class IFrameSource {
+protected:
+	IFrameSource() = default;
+
+public:
+	virtual ~IFrameSource() = default;
+
+	virtual std::uint32_t getWidth() const noexcept = 0;
+	virtual std::uint32_t getHeight() const noexcept = 0;
+
+	/**
+	 * @brief Decodes the next frame as width * height BGRA pixels without row padding.
+	 *
+	 * @return false when there are no more frames.
+	 * @throw std::runtime_error If the input is malformed.
+	 */
+	virtual bool read(std::uint8_t *bgraFrame) = 0;
+
+	IFrameSource(const IFrameSource &) = delete;
+	IFrameSource &operator=(const IFrameSource &) = delete;
+	IFrameSource(IFrameSource &&) = delete;
+	IFrameSource &operator=(IFrameSource &&) = delete;
+};
+
+/**
+ * @brief Reads a YUV4MPEG2 stream with 4:2:0, 4:2:2, 4:4:4 or mono 8-bit chroma.
+ *
+ * Pixels are converted with BT.601 limited-range coefficients unless the stream declares full range.
+ */
+class Y4mFrameSource final : public IFrameSource {
+public:
+	explicit Y4mFrameSource(const std::string &path);
+
+	std::uint32_t getWidth() const noexcept override { return width_; }
+	std::uint32_t getHeight() const noexcept override { return height_; }
+
+	bool read(std::uint8_t *bgraFrame) override;
+
+private:
+	std::ifstream stream_;
+	std::uint32_t width_ = 0;
+	std::uint32_t height_ = 0;
+	std::uint32_t chromaShiftX_ = 1;
+	std::uint32_t chromaShiftY_ = 1;
+	std::uint32_t chromaWidth_ = 0;
+	std::size_t chromaPlaneSize_ = 0;
+	bool isMono_ = false;
+	bool isFullRange_ = false;
+	std::vector<std::uint8_t> planes_;
+};
+
+/**
+ * @brief Reads a file of concatenated BGRA frames of a size given up front.
+ */
+class RawBgraFrameSource final : public IFrameSource {
+public:
+	RawBgraFrameSource(const std::string &path, std::uint32_t width, std::uint32_t height);
+
+	std::uint32_t getWidth() const noexcept override { return width_; }
+	std::uint32_t getHeight() const noexcept override { return height_; }
+
+	bool read(std::uint8_t *bgraFrame) override;
+
+private:
+	std::ifstream stream_;
+	const std::uint32_t width_;
+	const std::uint32_t height_;
+};
+
+/**
+ * @brief Reads numbered images that stb_image can decode, such as PNG or JPEG files.
+ *
+ * The pattern holds one printf-style integer conversion, %d or %0Nd, for the frame number. The sequence ends
+ * at the first number without a file. Every image must have the size of the first one.
+ */
+class ImageSequenceFrameSource final : public IFrameSource {
+public:
+	ImageSequenceFrameSource(const std::string &pattern, int startNumber);
+
+	std::uint32_t getWidth() const noexcept override { return width_; }
+	std::uint32_t getHeight() const noexcept override { return height_; }
+
+	bool read(std::uint8_t *bgraFrame) override;
+
+private:
+	const std::string pattern_;
+	int nextNumber_;
+	std::uint32_t width_ = 0;
+	std::uint32_t height_ = 0;
+};
+
+/**
+ * @brief Returns the path for frame @p number of a sequence pattern containing %d or %0Nd.
+ *
+ * @throw std::invalid_argument If the pattern has no such conversion.
+ */
+std::string formatSequencePath(const std::string &pattern, int number);
+
+/**
+ * @brief Opens @p path as Y4M if it ends in .y4m, as raw BGRA if a raw size is given, or else as an image
+ * sequence.
+ *
+ * @param rawWidth The frame width of a raw BGRA file, or 0 if the input is not raw.
+ * @param rawHeight The frame height of a raw BGRA file, or 0 if the input is not raw.
+ */
+std::unique_ptr<IFrameSource> openFrameSource(const std::string &path, std::uint32_t rawWidth,
+					      std::uint32_t rawHeight, int startNumber);
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor
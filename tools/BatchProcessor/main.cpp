@@ -0,0 +1,280 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <KaitoTokyo/SelfieSegmenter/NcnnModelRegistry.hpp>
+#include <KaitoTokyo/SelfieSegmenter/NcnnSelfieSegmenter.hpp>
+
+#include <PeakMemory.hpp>
+
+#include "BatchPipeline.hpp"
+#include "FrameSink.hpp"
+#include "FrameSource.hpp"
+
+extern "C" const unsigned char mediapipe_selfie_segmentation_landscape_int8_ncnn_bin[];
+extern "C" const unsigned int mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len;
+extern "C" const char mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text[];
+
+using namespace KaitoTokyo::LiveBackgroundRemovalLite::BatchProcessor;
+using KaitoTokyo::LiveBackgroundRemovalLite::Tools::getPeakResidentBytes;
+using KaitoTokyo::SelfieSegmenter::NcnnModelRegistry;
+using KaitoTokyo::SelfieSegmenter::NcnnSelfieSegmenter;
+
+namespace {
+
+constexpr char kUsage[] =
+	R"(Usage: live-backgroundremoval-lite-batch --input PATH [options]
+
+Runs the background removal pipeline on the CPU over a Y4M file, a raw BGRA file or an image sequence,
+and reports throughput, per-stage latency and peak memory.
+
+Input:
+  --input PATH               A .y4m file, a raw BGRA file with --raw-size, or an image sequence
+                             pattern such as frames/%05d.png
+  --raw-size WxH             The frame size of a raw BGRA input
+  --start-number N           The first frame number of an image sequence (default: 0)
+  --max-frames N             Stop after N frames (default: all)
+
+Output:
+  --output PATH              A raw file, or a PNG sequence if PATH contains %d or %0Nd (default: none)
+  --output-kind KIND         mask or composite (default: mask)
+
+Pipeline:
+  --threads N                Threads used by the segmenter (default: 1)
+  --filter-level LEVEL       segmentation, guided-filter or time-averaged-filter
+                             (default: time-averaged-filter)
+  --subsampling-rate N       Subsampling rate of the guided filter (default: 4)
+  --guided-filter-radius N   Box radius of the guided filter from 5 to 33, or 0 to follow the frame size
+                             (default: 0)
+  --blur-size N              Levels of the background blur, 0 to disable (default: 0)
+
+Model:
+  --model-param PATH         An ncnn param file to use instead of the bundled model
+  --model-bin PATH           The ncnn weights that go with --model-param
+  --raw-pixel-input          The model takes [0, 255] input with normalization folded in;
+                             requires --model-param and --model-bin pointing at a model
+                             made by fold_input_normalization.py
+)";
+
+struct Options {
+	std::string inputPath;
+	std::uint32_t rawWidth = 0;
+	std::uint32_t rawHeight = 0;
+	int startNumber = 0;
+	std::uint64_t maxFrames = 0;
+	std::string outputPath;
+	bool writesComposite = false;
+	int numThreads = 1;
+	std::string modelParamPath;
+	std::string modelBinPath;
+	bool usesRawPixelInput = false;
+	BatchPipelineSettings settings;
+};
+
+std::uint64_t parseNumber(std::string_view name, const std::string &value)
+{
+	try {
+		std::size_t end = 0;
+		const unsigned long long number = std::stoull(value, &end);
+		if (end == value.size()) {
+			return number;
+		}
+	} catch (const std::exception &) {
+	}
+	throw std::invalid_argument("Invalid value for " + std::string(name) + ": " + value);
+}
+
+Options parseOptions(int argc, char **argv)
+{
+	Options options;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view name = argv[i];
+		if (name == "--help" || name == "-h") {
+			std::fputs(kUsage, stdout);
+			std::exit(EXIT_SUCCESS);
+		}
+		if (name == "--raw-pixel-input") {
+			options.usesRawPixelInput = true;
+			continue;
+		}
+
+		if (i + 1 >= argc) {
+			throw std::invalid_argument("Missing value for " + std::string(name));
+		}
+		const std::string value = argv[++i];
+
+		if (name == "--input") {
+			options.inputPath = value;
+		} else if (name == "--raw-size") {
+			const std::size_t separator = value.find('x');
+			if (separator == std::string::npos) {
+				throw std::invalid_argument("Invalid value for --raw-size: " + value);
+			}
+			options.rawWidth = static_cast<std::uint32_t>(parseNumber(name, value.substr(0, separator)));
+			options.rawHeight = static_cast<std::uint32_t>(parseNumber(name, value.substr(separator + 1)));
+		} else if (name == "--start-number") {
+			options.startNumber = static_cast<int>(parseNumber(name, value));
+		} else if (name == "--max-frames") {
+			options.maxFrames = parseNumber(name, value);
+		} else if (name == "--output") {
+			options.outputPath = value;
+		} else if (name == "--output-kind") {
+			if (value != "mask" && value != "composite") {
+				throw std::invalid_argument("Invalid value for --output-kind: " + value);
+			}
+			options.writesComposite = value == "composite";
+		} else if (name == "--threads") {
+			options.numThreads = static_cast<int>(parseNumber(name, value));
+		} else if (name == "--filter-level") {
+			if (value == "segmentation") {
+				options.settings.filterLevel = BatchFilterLevel::Segmentation;
+			} else if (value == "guided-filter") {
+				options.settings.filterLevel = BatchFilterLevel::GuidedFilter;
+			} else if (value == "time-averaged-filter") {
+				options.settings.filterLevel = BatchFilterLevel::TimeAveragedFilter;
+			} else {
+				throw std::invalid_argument("Invalid value for --filter-level: " + value);
+			}
+		} else if (name == "--subsampling-rate") {
+			options.settings.subsamplingRate = static_cast<std::uint32_t>(parseNumber(name, value));
+		} else if (name == "--guided-filter-radius") {
+			options.settings.guidedFilterBoxRadius = static_cast<int>(parseNumber(name, value));
+		} else if (name == "--blur-size") {
+			options.settings.blurSize = static_cast<int>(parseNumber(name, value));
+		} else if (name == "--model-param") {
+			options.modelParamPath = value;
+		} else if (name == "--model-bin") {
+			options.modelBinPath = value;
+		} else {
+			throw std::invalid_argument("Unknown option: " + std::string(name));
+		}
+	}
+
+	if (options.inputPath.empty()) {
+		throw std::invalid_argument("--input is required");
+	}
+	if (options.modelParamPath.empty() != options.modelBinPath.empty()) {
+		throw std::invalid_argument("--model-param and --model-bin must be given together");
+	}
+	if (options.usesRawPixelInput && options.modelParamPath.empty()) {
+		throw std::invalid_argument("--raw-pixel-input requires --model-param and --model-bin");
+	}
+	return options;
+}
+
+std::vector<char> readFile(const std::string &path)
+{
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream) {
+		throw std::runtime_error("FileOpenError(readFile): " + path);
+	}
+	return std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+void printReport(const BatchPipeline &pipeline, std::uint64_t frameCount, std::chrono::nanoseconds elapsed)
+{
+	const double elapsedSeconds = std::chrono::duration<double>(elapsed).count();
+	std::printf("frames=%llu\telapsedSeconds=%.3f\tfps=%.2f\n", static_cast<unsigned long long>(frameCount),
+		    elapsedSeconds, elapsedSeconds > 0.0 ? static_cast<double>(frameCount) / elapsedSeconds : 0.0);
+
+	for (std::size_t i = 0; i < kBatchStageCount; ++i) {
+		const auto stage = static_cast<BatchStage>(i);
+		const auto summary = pipeline.getStageDurations(stage).snapshot().summarize();
+		if (summary.count == 0) {
+			continue;
+		}
+		std::printf("stage=%s\tsamples=%llu\tp50Us=%.1f\tp95Us=%.1f\tp99Us=%.1f\n", getBatchStageName(stage),
+			    static_cast<unsigned long long>(summary.count),
+			    static_cast<double>(summary.p50.count()) / 1000.0,
+			    static_cast<double>(summary.p95.count()) / 1000.0,
+			    static_cast<double>(summary.p99.count()) / 1000.0);
+	}
+
+	std::printf("peakResidentMiB=%.1f\n", static_cast<double>(getPeakResidentBytes()) / (1024.0 * 1024.0));
+}
+
+int run(const Options &options)
+{
+	// ncnn keeps referencing the weights in place, so they must outlive the segmenter
+	std::vector<char> modelParam;
+	std::vector<char> modelBin;
+	std::shared_ptr<const ncnn::Net> net;
+	if (options.modelParamPath.empty()) {
+		net = NcnnModelRegistry::loadNet(mediapipe_selfie_segmentation_landscape_int8_ncnn_param_text,
+						 static_cast<int>(mediapipe_selfie_segmentation_landscape_int8_ncnn_bin_len),
+						 mediapipe_selfie_segmentation_landscape_int8_ncnn_bin);
+	} else {
+		modelParam = readFile(options.modelParamPath);
+		modelParam.push_back('\0');
+		modelBin = readFile(options.modelBinPath);
+		net = NcnnModelRegistry::loadNet(modelParam.data(), static_cast<int>(modelBin.size()),
+						 reinterpret_cast<const unsigned char *>(modelBin.data()));
+	}
+
+	NcnnSelfieSegmenter selfieSegmenter(std::move(net), options.numThreads,
+					    options.usesRawPixelInput ? NcnnSelfieSegmenter::InputMode::RawPixels
+								      : NcnnSelfieSegmenter::InputMode::NormalizedFloat);
+
+	const std::unique_ptr<IFrameSource> source =
+		openFrameSource(options.inputPath, options.rawWidth, options.rawHeight, options.startNumber);
+	const std::uint32_t width = source->getWidth();
+	const std::uint32_t height = source->getHeight();
+
+	BatchPipeline pipeline(selfieSegmenter, width, height, options.settings);
+
+	const std::uint32_t outputChannelCount = options.writesComposite ? 4 : 1;
+	std::unique_ptr<IFrameSink> sink;
+	if (!options.outputPath.empty()) {
+		sink = openFrameSink(options.outputPath, options.startNumber, width, height, outputChannelCount);
+	}
+
+	std::vector<std::uint8_t> frame(static_cast<std::size_t>(width) * height * 4);
+	std::vector<std::uint8_t> output(static_cast<std::size_t>(width) * height * outputChannelCount);
+
+	// Decoding and encoding are excluded from the throughput so that it reflects the pipeline alone
+	std::uint64_t frameCount = 0;
+	std::chrono::nanoseconds elapsed{0};
+	while ((options.maxFrames == 0 || frameCount < options.maxFrames) && source->read(frame.data())) {
+		const auto start = std::chrono::steady_clock::now();
+		pipeline.process(frame.data());
+		elapsed += std::chrono::steady_clock::now() - start;
+		++frameCount;
+
+		if (sink) {
+			if (options.writesComposite) {
+				pipeline.getComposite(output.data());
+			} else {
+				pipeline.getMask(output.data());
+			}
+			sink->write(output.data());
+		}
+	}
+
+	printReport(pipeline, frameCount, elapsed);
+	return EXIT_SUCCESS;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+	try {
+		return run(parseOptions(argc, argv));
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "error: %s\nRun with --help for usage.\n", e.what());
+		return EXIT_FAILURE;
+	}
+}
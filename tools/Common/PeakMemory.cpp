@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "PeakMemory.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::Tools {
+
+std::uint64_t getPeakResidentBytes() noexcept
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters{};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return 0;
+	}
+	return static_cast<std::uint64_t>(counters.PeakWorkingSetSize);
+#else
+	struct rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+#ifdef __APPLE__
+	// macOS reports bytes, Linux and the BSDs report kilobytes
+	return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+	return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::Tools
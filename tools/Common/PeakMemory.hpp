@@ -0,0 +1,16 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::Tools {
+
+/**
+ * @brief Returns the peak resident set size of this process in bytes, or 0 if the platform does not report it.
+ */
+std::uint64_t getPeakResidentBytes() noexcept;
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::Tools
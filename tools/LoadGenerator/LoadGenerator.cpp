@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LoadGenerator.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+using namespace KaitoTokyo::SelfieSegmenter;
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::LoadGenerator {
+
+namespace {
+
+std::int64_t toTicks(std::chrono::steady_clock::time_point timePoint) noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(timePoint.time_since_epoch()).count();
+}
+
+} // anonymous namespace
+
+LoadGenerator::LoadGenerator(std::shared_ptr<const Logger::ILogger> logger, LoadGeneratorSettings settings)
+	: logger_(logger ? std::move(logger)
+			 : throw std::invalid_argument("LoggerIsNullError(LoadGenerator::LoadGenerator)")),
+	  settings_(settings)
+{
+	if (settings_.instanceCount == 0 || settings_.schedulerCount == 0) {
+		throw std::invalid_argument("ZeroCountError(LoadGenerator::LoadGenerator)");
+	}
+	if (settings_.fps == 0 || settings_.submitInterval == 0) {
+		throw std::invalid_argument("ZeroRateError(LoadGenerator::LoadGenerator)");
+	}
+
+	for (std::size_t i = 0; i < settings_.schedulerCount; ++i) {
+		schedulers_.push_back(std::make_unique<InferenceScheduler>(logger_, settings_.gatherWindow));
+	}
+
+	for (std::size_t i = 0; i < settings_.instanceCount; ++i) {
+		SyntheticSelfieSegmenter::Config segmenterConfig = settings_.segmenterConfig;
+		segmenterConfig.seed += i;
+
+		auto instance = std::make_unique<Instance>();
+		instance->segmenter = std::make_shared<SyntheticSelfieSegmenter>(segmenterConfig);
+		instance->client = schedulers_[i % schedulers_.size()]->registerClient(instance->segmenter,
+											"instance" + std::to_string(i));
+		instance->inputPool = Memory::MemoryBlockPool::create(logger_, instance->segmenter->getPixelCount() * 4);
+		instance->uploadedMask.resize(instance->segmenter->getPixelCount());
+		instances_.push_back(std::move(instance));
+	}
+}
+
+LoadGenerator::~LoadGenerator() noexcept
+{
+	// Stop the workers before the instances their completion callbacks point to go away
+	for (auto &scheduler : schedulers_) {
+		scheduler->shutdown();
+	}
+}
+
+LoadReport LoadGenerator::run()
+{
+	const auto frameInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(1.0 / settings_.fps));
+	const auto tickCount = static_cast<std::uint64_t>(
+		std::chrono::duration<double>(settings_.duration).count() * settings_.fps);
+
+	LoadReport report{};
+	const auto start = std::chrono::steady_clock::now();
+
+	for (std::uint64_t tick = 0; tick < tickCount; ++tick) {
+		// Ticks are due on a fixed grid, so a slow tick makes the next ones late instead of shifting them
+		const auto dueAt = start + frameInterval * static_cast<std::int64_t>(tick);
+		std::this_thread::sleep_until(dueAt);
+		if (std::chrono::steady_clock::now() - dueAt > frameInterval) {
+			report.lateTickCount++;
+		}
+
+		const bool submits = tick % settings_.submitInterval == 0;
+		for (auto &instance : instances_) {
+			tickInstance(*instance, submits);
+		}
+		report.tickCount++;
+	}
+
+	report.elapsed = std::chrono::steady_clock::now() - start;
+
+	for (auto &instance : instances_) {
+		report.instances.push_back(InstanceReport{instance->client->getName(), instance->client->getStats(),
+							  instance->uploadedCount,
+							  instance->inputPool->getAllocatedCount()});
+	}
+
+	return report;
+}
+
+Profiling::LatencyHistogram::Snapshot LoadGenerator::getStageDurations(Stage stage) const noexcept
+{
+	switch (stage) {
+	case Stage::InstanceTick:
+		return instanceTickDurations_.snapshot();
+	case Stage::SubmitToUpload:
+		return submitToUploadDurations_.snapshot();
+	case Stage::Inference:
+		break;
+	}
+
+	Profiling::LatencyHistogram::Snapshot inferenceDurations;
+	for (const auto &instance : instances_) {
+		inferenceDurations += instance->client->getInferenceDurations().snapshot();
+	}
+	return inferenceDurations;
+}
+
+void LoadGenerator::tickInstance(Instance &instance, bool submits)
+{
+	Profiling::ScopedLatencyTimer tickTimer(instanceTickDurations_);
+
+	// Stands in for uploadSegmentationMask
+	if (instance.hasNewMask.exchange(false, std::memory_order_acquire)) {
+		std::memcpy(instance.uploadedMask.data(), instance.segmenter->getMask(), instance.uploadedMask.size());
+		instance.uploadedCount++;
+
+		const auto submittedAt = std::chrono::steady_clock::time_point(
+			std::chrono::nanoseconds(instance.completedSubmittedAt.load(std::memory_order_relaxed)));
+		submitToUploadDurations_.record(std::chrono::steady_clock::now() - submittedAt);
+	}
+
+	if (!submits) {
+		return;
+	}
+
+	// Stands in for submitSegmenterInput, with the texture readback replaced by a fill
+	auto input = instance.inputPool->acquire();
+	if (!input) {
+		logger_->error("MemoryBlockAcquisitionError");
+		return;
+	}
+	std::memset(input->data(), 0x80, input->size());
+
+	const std::int64_t submittedAt = toTicks(std::chrono::steady_clock::now());
+	instance.client->submit(std::move(input), [&instance, submittedAt] {
+		instance.completedSubmittedAt.store(submittedAt, std::memory_order_relaxed);
+		instance.hasNewMask.store(true, std::memory_order_release);
+	});
+}
+
+const char *getStageName(LoadGenerator::Stage stage) noexcept
+{
+	switch (stage) {
+	case LoadGenerator::Stage::InstanceTick:
+		return "instanceTick";
+	case LoadGenerator::Stage::SubmitToUpload:
+		return "submitToUpload";
+	case LoadGenerator::Stage::Inference:
+		return "inference";
+	}
+	return "unknown";
+}
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::LoadGenerator
@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <KaitoTokyo/Logger/ILogger.hpp>
+#include <KaitoTokyo/Memory/MemoryBlockPool.hpp>
+#include <KaitoTokyo/Profiling/LatencyHistogram.hpp>
+#include <KaitoTokyo/SelfieSegmenter/InferenceScheduler.hpp>
+#include <KaitoTokyo/SelfieSegmenter/SyntheticSelfieSegmenter.hpp>
+
+namespace KaitoTokyo::LiveBackgroundRemovalLite::LoadGenerator {
+
+struct LoadGeneratorSettings {
+	/// The number of simulated filter instances.
+	std::size_t instanceCount = 1;
+	/// The frame rate the render thread ticks at.
+	std::uint32_t fps = 30;
+	/// How long to tick for.
+	std::chrono::milliseconds duration{10000};
+	/// Submit an input every this many ticks, like a filter whose motion gate only opens now and then.
+	std::uint32_t submitInterval = 1;
+	/// The number of inference schedulers, each with its own worker. Instances are spread over them in turn.
+	std::size_t schedulerCount = 1;
+	std::chrono::microseconds gatherWindow{2000};
+	/// The configuration of every instance's segmenter. Each instance adds its index to the seed.
+	SelfieSegmenter::SyntheticSelfieSegmenter::Config segmenterConfig;
+};
+
+/**
+ * @brief What one simulated filter instance went through.
+ */
+struct InstanceReport {
+	std::string name;
+	SelfieSegmenter::InferenceScheduler::ClientStats clientStats;
+	/// Masks the render thread picked up.
+	std::uint64_t uploadedCount;
+	/// Blocks the instance's input pool had to allocate.
+	std::size_t allocatedBlockCount;
+};
+
+struct LoadReport {
+	std::uint64_t tickCount;
+	/// Ticks that started later than one frame interval after they were due.
+	std::uint64_t lateTickCount;
+	std::chrono::nanoseconds elapsed;
+	std::vector<InstanceReport> instances;
+};
+
+/**
+ * @brief Drives simulated filter instances through the same submission path as the plugin, without a GPU.
+ *
+ * One thread stands in for the OBS graphics thread. Each tick, every instance uploads a mask that completed
+ * since its previous tick and, on its submission ticks, fills a block from its own MemoryBlockPool and
+ * submits it to its InferenceScheduler client, as RenderingContext does. The segmenters are synthetic, so
+ * the latency distribution is exactly the configured one and any change in the results comes from the
+ * scheduling itself.
+ */
+class LoadGenerator {
+public:
+	enum class Stage : std::size_t {
+		/// The render thread's work for one instance in one tick.
+		InstanceTick = 0,
+		/// From submission until the render thread uploads the resulting mask.
+		SubmitToUpload,
+		/// The time spent in each segmenter, excluding any wait in the queue.
+		Inference,
+	};
+
+	constexpr static std::size_t kStageCount = 3;
+
+	LoadGenerator(std::shared_ptr<const Logger::ILogger> logger, LoadGeneratorSettings settings);
+	~LoadGenerator() noexcept;
+
+	LoadGenerator(const LoadGenerator &) = delete;
+	LoadGenerator &operator=(const LoadGenerator &) = delete;
+	LoadGenerator(LoadGenerator &&) = delete;
+	LoadGenerator &operator=(LoadGenerator &&) = delete;
+
+	/**
+	 * @brief Ticks every instance for the configured duration and returns what happened.
+	 */
+	LoadReport run();
+
+	/**
+	 * @brief Returns the durations of @p stage across all instances.
+	 */
+	Profiling::LatencyHistogram::Snapshot getStageDurations(Stage stage) const noexcept;
+
+private:
+	struct Instance {
+		std::shared_ptr<SelfieSegmenter::SyntheticSelfieSegmenter> segmenter;
+		std::shared_ptr<SelfieSegmenter::InferenceScheduler::Client> client;
+		std::shared_ptr<Memory::MemoryBlockPool> inputPool;
+		std::vector<std::uint8_t> uploadedMask;
+
+		// Written by the scheduler's worker, read by the render thread
+		std::atomic<bool> hasNewMask{false};
+		std::atomic<std::int64_t> completedSubmittedAt{0};
+
+		std::uint64_t uploadedCount = 0;
+	};
+
+	void tickInstance(Instance &instance, bool submits);
+
+	const std::shared_ptr<const Logger::ILogger> logger_;
+	const LoadGeneratorSettings settings_;
+
+	std::vector<std::unique_ptr<SelfieSegmenter::InferenceScheduler>> schedulers_;
+	std::vector<std::unique_ptr<Instance>> instances_;
+	// The inference durations are kept by each scheduler client instead
+	Profiling::LatencyHistogram instanceTickDurations_;
+	Profiling::LatencyHistogram submitToUploadDurations_;
+};
+
+const char *getStageName(LoadGenerator::Stage stage) noexcept;
+
+} // namespace KaitoTokyo::LiveBackgroundRemovalLite::LoadGenerator
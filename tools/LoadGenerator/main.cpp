@@ -0,0 +1,225 @@
+// SPDX-FileCopyrightText: 2025-2026 Kaito Udagawa <umireon@kaito.tokyo>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <KaitoTokyo/Logger/NullLogger.hpp>
+#include <KaitoTokyo/Logger/PrintLogger.hpp>
+
+#include <PeakMemory.hpp>
+
+#include "LoadGenerator.hpp"
+
+using namespace KaitoTokyo::LiveBackgroundRemovalLite::LoadGenerator;
+using KaitoTokyo::LiveBackgroundRemovalLite::Tools::getPeakResidentBytes;
+using KaitoTokyo::SelfieSegmenter::SyntheticSelfieSegmenter;
+
+namespace {
+
+constexpr char kUsage[] =
+	R"(Usage: live-backgroundremoval-lite-loadgen [options]
+
+Simulates filter instances submitting frames to the inference schedulers the way the plugin does,
+with synthetic segmenters in place of the model, and reports queueing, latency and memory.
+
+Load:
+  --instances N              Simulated filter instances (default: 1)
+  --fps N                    Render ticks per second: 30, 60 or 120 in practice (default: 30)
+  --duration-ms N            How long to run (default: 10000)
+  --submit-interval N        Submit an input every N ticks (default: 1)
+
+Scheduling:
+  --schedulers N             Inference schedulers, each with its own worker (default: 1)
+  --gather-window-us N       How long a scheduler waits for other instances (default: 2000)
+
+Synthetic segmenter:
+  --latency-us N             Time every inference takes (default: 10000)
+  --jitter-us N              Upper bound of a uniform extra time per inference (default: 0)
+  --wait-mode MODE           sleep or spin (default: spin)
+  --pattern PATTERN          empty, full, ellipse, sweeping-ellipse or checkerboard (default: ellipse)
+  --failure-rate P           Probability in [0, 1] that an inference fails (default: 0)
+  --seed N                   Seed of the jitter and failures (default: 0)
+
+Output:
+  --verbose                  Print the schedulers' log messages
+)";
+
+struct Options {
+	LoadGeneratorSettings settings;
+	bool isVerbose = false;
+};
+
+std::uint64_t parseNumber(std::string_view name, const std::string &value)
+{
+	try {
+		std::size_t end = 0;
+		const unsigned long long number = std::stoull(value, &end);
+		if (end == value.size()) {
+			return number;
+		}
+	} catch (const std::exception &) {
+	}
+	throw std::invalid_argument("Invalid value for " + std::string(name) + ": " + value);
+}
+
+double parseProbability(std::string_view name, const std::string &value)
+{
+	try {
+		std::size_t end = 0;
+		const double number = std::stod(value, &end);
+		if (end == value.size() && number >= 0.0 && number <= 1.0) {
+			return number;
+		}
+	} catch (const std::exception &) {
+	}
+	throw std::invalid_argument("Invalid value for " + std::string(name) + ": " + value);
+}
+
+SyntheticSelfieSegmenter::MaskPattern parsePattern(const std::string &value)
+{
+	if (value == "empty") {
+		return SyntheticSelfieSegmenter::MaskPattern::Empty;
+	} else if (value == "full") {
+		return SyntheticSelfieSegmenter::MaskPattern::Full;
+	} else if (value == "ellipse") {
+		return SyntheticSelfieSegmenter::MaskPattern::Ellipse;
+	} else if (value == "sweeping-ellipse") {
+		return SyntheticSelfieSegmenter::MaskPattern::SweepingEllipse;
+	} else if (value == "checkerboard") {
+		return SyntheticSelfieSegmenter::MaskPattern::Checkerboard;
+	}
+	throw std::invalid_argument("Invalid value for --pattern: " + value);
+}
+
+Options parseOptions(int argc, char **argv)
+{
+	Options options;
+	LoadGeneratorSettings &settings = options.settings;
+	settings.segmenterConfig.latency = std::chrono::microseconds(10000);
+	settings.segmenterConfig.waitMode = SyntheticSelfieSegmenter::WaitMode::Spin;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view name = argv[i];
+		if (name == "--help" || name == "-h") {
+			std::fputs(kUsage, stdout);
+			std::exit(EXIT_SUCCESS);
+		}
+		if (name == "--verbose") {
+			options.isVerbose = true;
+			continue;
+		}
+
+		if (i + 1 >= argc) {
+			throw std::invalid_argument("Missing value for " + std::string(name));
+		}
+		const std::string value = argv[++i];
+
+		if (name == "--instances") {
+			settings.instanceCount = static_cast<std::size_t>(parseNumber(name, value));
+		} else if (name == "--fps") {
+			settings.fps = static_cast<std::uint32_t>(parseNumber(name, value));
+		} else if (name == "--duration-ms") {
+			settings.duration = std::chrono::milliseconds(parseNumber(name, value));
+		} else if (name == "--submit-interval") {
+			settings.submitInterval = static_cast<std::uint32_t>(parseNumber(name, value));
+		} else if (name == "--schedulers") {
+			settings.schedulerCount = static_cast<std::size_t>(parseNumber(name, value));
+		} else if (name == "--gather-window-us") {
+			settings.gatherWindow = std::chrono::microseconds(parseNumber(name, value));
+		} else if (name == "--latency-us") {
+			settings.segmenterConfig.latency = std::chrono::microseconds(parseNumber(name, value));
+		} else if (name == "--jitter-us") {
+			settings.segmenterConfig.jitter = std::chrono::microseconds(parseNumber(name, value));
+		} else if (name == "--wait-mode") {
+			if (value == "sleep") {
+				settings.segmenterConfig.waitMode = SyntheticSelfieSegmenter::WaitMode::Sleep;
+			} else if (value == "spin") {
+				settings.segmenterConfig.waitMode = SyntheticSelfieSegmenter::WaitMode::Spin;
+			} else {
+				throw std::invalid_argument("Invalid value for --wait-mode: " + value);
+			}
+		} else if (name == "--pattern") {
+			settings.segmenterConfig.pattern = parsePattern(value);
+		} else if (name == "--failure-rate") {
+			settings.segmenterConfig.failureProbability = parseProbability(name, value);
+		} else if (name == "--seed") {
+			settings.segmenterConfig.seed = parseNumber(name, value);
+		} else {
+			throw std::invalid_argument("Unknown option: " + std::string(name));
+		}
+	}
+
+	return options;
+}
+
+void printReport(const LoadGenerator &loadGenerator, const LoadReport &report)
+{
+	const double elapsedSeconds = std::chrono::duration<double>(report.elapsed).count();
+	std::printf("ticks=%llu\tlateTicks=%llu\telapsedSeconds=%.3f\n",
+		    static_cast<unsigned long long>(report.tickCount),
+		    static_cast<unsigned long long>(report.lateTickCount), elapsedSeconds);
+
+	for (std::size_t i = 0; i < LoadGenerator::kStageCount; ++i) {
+		const auto stage = static_cast<LoadGenerator::Stage>(i);
+		const auto summary = loadGenerator.getStageDurations(stage).summarize();
+		if (summary.count == 0) {
+			continue;
+		}
+		std::printf("stage=%s\tsamples=%llu\tp50Us=%.1f\tp95Us=%.1f\tp99Us=%.1f\n", getStageName(stage),
+			    static_cast<unsigned long long>(summary.count),
+			    static_cast<double>(summary.p50.count()) / 1000.0,
+			    static_cast<double>(summary.p95.count()) / 1000.0,
+			    static_cast<double>(summary.p99.count()) / 1000.0);
+	}
+
+	for (const InstanceReport &instance : report.instances) {
+		const auto &stats = instance.clientStats;
+		std::printf("instance=%s\tsubmitted=%llu\tprocessed=%llu\tdropped=%llu\tfailed=%llu\tuploaded=%llu\t"
+			    "meanLatencyUs=%lld\tmaxLatencyUs=%lld\tallocatedBlocks=%zu\n",
+			    instance.name.c_str(), static_cast<unsigned long long>(stats.submittedCount),
+			    static_cast<unsigned long long>(stats.processedCount),
+			    static_cast<unsigned long long>(stats.droppedCount),
+			    static_cast<unsigned long long>(stats.failedCount),
+			    static_cast<unsigned long long>(instance.uploadedCount),
+			    static_cast<long long>(stats.meanLatency.count()),
+			    static_cast<long long>(stats.maxLatency.count()), instance.allocatedBlockCount);
+	}
+
+	std::printf("peakResidentMiB=%.1f\n", static_cast<double>(getPeakResidentBytes()) / (1024.0 * 1024.0));
+}
+
+int run(const Options &options)
+{
+	// Injected failures are logged on every occurrence, which would drown the report
+	std::shared_ptr<const KaitoTokyo::Logger::ILogger> logger;
+	if (options.isVerbose) {
+		logger = KaitoTokyo::Logger::PrintLogger::instance();
+	} else {
+		logger = KaitoTokyo::Logger::NullLogger::instance();
+	}
+
+	LoadGenerator loadGenerator(logger, options.settings);
+	const LoadReport report = loadGenerator.run();
+	printReport(loadGenerator, report);
+	return EXIT_SUCCESS;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+	try {
+		return run(parseOptions(argc, argv));
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "error: %s\nRun with --help for usage.\n", e.what());
+		return EXIT_FAILURE;
+	}
+}